@@ -0,0 +1,71 @@
+// async_echo.g - TASKS tác vụ async trên một luồng: một nửa là server echo, một
+// nửa là client, mỗi cặp nối bằng một socket_pair. Mỗi client gửi ROUNDS tin MSG
+// byte và chờ nhận lại đủ từng tin; server đọc đủ rồi ghi trả. Mọi tác vụ chỉ
+// là khung trạng thái trên heap (không stack riêng), executor chờ trên epoll.
+// Chạy:  ./gc bench/async_echo.g -O 2 --release -r
+// Mỗi cặp tốn 2 fd: nếu giới hạn cứng RLIMIT_NOFILE không đủ cho TASKS thì số
+// cặp được hạ xuống vừa giới hạn (có in ghi chú).
+import std
+
+const TASKS = 100000
+const ROUNDS = 20
+const MSG = 64
+
+async fn server(fd: int) {
+    let mut buf: [MSG]u8
+    loop {
+        let n = await aread_exact(fd, &buf[0], MSG)
+        if n != MSG {
+            break
+        }
+        await awrite(fd, &buf[0], MSG)
+    }
+    aclose(fd)
+}
+
+async fn client(fd: int, id: int, ok: *int) {
+    let mut buf: [MSG]u8
+    for r in 0..ROUNDS {
+        buf[0] = (id + r) as u8
+        let w = await awrite(fd, &buf[0], MSG)
+        let n = await aread_exact(fd, &buf[0], MSG)
+        if w == MSG && n == MSG && buf[0] == (id + r) as u8 {
+            *ok += 1
+        }
+    }
+    aclose(fd)
+}
+
+fn main() -> int {
+    let mut pairs = TASKS / 2
+    let lim = raise_fd_limit(TASKS + 64)
+    if lim < TASKS + 64 {
+        pairs = (lim - 64) / 2
+        println("ghi chú: RLIMIT_NOFILE = {} -> chỉ {} tác vụ ({} cặp)", lim, pairs * 2, pairs)
+    }
+    let mut ok = 0
+    let t0 = now_ns()
+    for i in 0..pairs {
+        let mut sv: [2]int
+        if socket_pair(&sv[0]) != 0 {
+            eprintln("socket_pair lỗi ở cặp {}", i)
+            return 1
+        }
+        spawn(server(sv[0]))
+        spawn(client(sv[1], i, &ok))
+    }
+    let t1 = now_ns()
+    async_run()
+    let dt = now_ns() - t1
+    let msgs = pairs * ROUNDS
+    println("{} tác vụ, {} tin x {} byte (dựng: {f:.1} ms)", pairs * 2, msgs, MSG,
+            ((t1 - t0) as f64) / 1.0e6)
+    println("{f:10.1} ms", (dt as f64) / 1.0e6)
+    println("{f:10.0} lượt đi-về/s", (msgs as f64) / ((dt as f64) / 1.0e9))
+    println("{f:10.3} µs mỗi lượt đi-về (chia đều)", (dt as f64) / 1.0e3 / (msgs as f64))
+    if ok != msgs {
+        eprintln("LỖI: chỉ {} / {} lượt đúng", ok, msgs)
+        return 1
+    }
+    return 0
+}
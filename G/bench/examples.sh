@@ -0,0 +1,35 @@
+#!/usr/bin/env bash
+# Đo thời gian chạy examples/*.g và bench/opt_bench.g ở -O2, có và không có
+# các pass tối ưu AST (gc --no-opt). Mỗi chương trình chạy REPS lần, lấy thời
+# gian nhỏ nhất (ms) để bớt nhiễu; output của hai bản phải giống hệt nhau.
+#   bench/examples.sh            # REPS=5
+#   REPS=20 bench/examples.sh
+set -u
+cd "$(dirname "$0")/.."
+
+REPS=${REPS:-5}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+best_ms() {
+    local bin=$1 best="" t0 t1 ms
+    for _ in $(seq "$REPS"); do
+        t0=$(date +%s%N)
+        "$bin" </dev/null >/dev/null 2>&1
+        t1=$(date +%s%N)
+        ms=$(( (t1 - t0) / 1000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    printf "%d.%03d" $((best / 1000)) $((best % 1000))
+}
+
+printf "%-22s %12s %14s\n" "-O2" "opt (ms)" "--no-opt (ms)"
+for src in examples/*.g bench/opt_bench.g; do
+    name=$(basename "$src" .g)
+    ./gc "$src" -O 2 -o "$TMP/$name.opt" >/dev/null 2>&1 || { echo "$name: lỗi biên dịch"; continue; }
+    ./gc "$src" -O 2 --no-opt -o "$TMP/$name.raw" >/dev/null 2>&1 || { echo "$name: lỗi biên dịch (--no-opt)"; continue; }
+    if [ "$name" != opt_bench ] && ! cmp -s <("$TMP/$name.opt" </dev/null 2>&1) <("$TMP/$name.raw" </dev/null 2>&1); then
+        echo "$name: output khác nhau giữa hai chế độ!"
+    fi
+    printf "%-22s %12s %14s\n" "$name" "$(best_ms "$TMP/$name.opt")" "$(best_ms "$TMP/$name.raw")"
+done
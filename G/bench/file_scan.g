@@ -0,0 +1,93 @@
+// file_scan.g - quét tệp log theo dòng: map_file / reader (map) / reader (đệm)
+// Chạy:  ./gc bench/file_scan.g -O 2 -r
+// Dựng một tệp ~MB MiB trong /tmp (dòng "INFO|ERROR <i> ...") rồi đếm dòng và
+// số dòng ERROR theo từng cách; in MB/s và checksum (các cột phải khớp nhau).
+// Lần quét đầu đã nằm trong page cache, nên đây là chi phí CPU của đường đọc
+// (chép từ kernel + tách dòng), không phải tốc độ đĩa.
+import std
+
+extern fn unlink(path: str) -> int
+
+const PATH: str = "/tmp/g_file_scan.log"
+const MB = 256
+
+fn report(name: str, ns: i64, size: usize, lines: int, errors: int) {
+    let mbs = (size as f64) / 1048576.0 / ((ns as f64) / 1e9)
+    println("{s:<22} {f:>8.1} MB/s   {} dòng, {} ERROR", name, mbs, lines, errors)
+}
+
+// Đếm dòng + dòng bắt đầu bằng "ERROR" qua reader (map hoặc đệm)
+fn scan(r: *reader, errors: *int) -> int {
+    let mut line: bytes
+    let mut n = 0
+    let mut e = 0
+    while next_line(r, &line) {
+        n += 1
+        if bytes_starts_with(line, "ERROR") {
+            e += 1
+        }
+    }
+    *errors = e
+    return n
+}
+
+fn main() -> int {
+    let mut sb = sb_new()
+    let mut i = 0
+    while len(sb) < (MB as usize) * 1048576 {
+        if i % 97 == 0 {
+            sb_push(&sb, "ERROR ")
+        } else {
+            sb_push(&sb, "INFO ")
+        }
+        sb_push_int(&sb, i)
+        sb_push(&sb, " GET /api/v1/items?page=")
+        sb_push_int(&sb, i % 1000)
+        sb_push(&sb, " 200 1234ms\n")
+        i += 1
+    }
+    if !write_file(PATH, sb_bytes(&sb)) {
+        println("không ghi được {s}", PATH)
+        return 1
+    }
+    let size = len(sb)
+    sb_free(&sb)
+    println("tệp {} MiB, {} dòng", size / 1048576, i)
+
+    // 1) map_file + bytes_count: memchr trên cả vùng map
+    let mut t0 = now_ns()
+    let mut m = map_file(PATH)
+    let n1 = bytes_count(m, '\n') as int
+    unmap(&m)
+    report("map_file+bytes_count", now_ns() - t0, size, n1, 0)
+
+    // 2) open_reader (map): lát cắt thẳng vào tệp
+    let mut e2 = 0
+    t0 = now_ns()
+    let mut r = open_reader(PATH)
+    let n2 = scan(&r, &e2)
+    close_reader(&r)
+    report("open_reader (map)", now_ns() - t0, size, n2, e2)
+
+    // 3) stream_reader: read() vào bộ đệm 1 MiB rồi tách dòng
+    let mut e3 = 0
+    t0 = now_ns()
+    let mut s = stream_reader(PATH)
+    let n3 = scan(&s, &e3)
+    close_reader(&s)
+    report("stream_reader (read)", now_ns() - t0, size, n3, e3)
+
+    // 4) next_chunk: khối ~1 MiB trọn dòng, đếm bằng memchr
+    t0 = now_ns()
+    let mut c = open_reader(PATH)
+    let mut chunk: bytes
+    let mut n4 = 0
+    while next_chunk(&c, &chunk) {
+        n4 += bytes_count(chunk, '\n') as int
+    }
+    close_reader(&c)
+    report("next_chunk+count", now_ns() - t0, size, n4, 0)
+
+    unlink(PATH)
+    return 0
+}
@@ -0,0 +1,90 @@
+// map_bench.g - Map[K, V] so với quét tuyến tính trên Vec (bảng ký hiệu "tự chế")
+// Chạy:  ./gc bench/map_bench.g -O 3 --release -r
+// Mỗi cỡ n: dựng bảng n khoá, rồi tra một nửa trúng / một nửa trượt.
+// Quét tuyến tính O(n) mỗi lần tra nên chỉ chạy đủ số lần để đo ổn định
+// (~2e8 phép so sánh); cột cuối là tỉ lệ ns/lần tra giữa hai cách.
+import std
+
+// Khoá thứ i: song ánh trên [0, 2^31 - 1) (nhân với số nguyên tố cùng nhau
+// modulo số nguyên tố) -> mọi khoá khác nhau, phân bố trông như ngẫu nhiên.
+fn key_of(i: int) -> int {
+    return ((i as i64 * 2654435761) % 2147483647) as int
+}
+
+fn xorshift(s: *u64) -> u64 {
+    let mut x = *s
+    x ^= x << 13
+    x ^= x >> 7
+    x ^= x << 17
+    *s = x
+    return x
+}
+
+fn probe(seed: *u64, n: int) -> int {
+    let r = (xorshift(seed) % ((2 * n) as u64)) as int
+    return key_of(r)          // r < n: trúng, r >= n: trượt
+}
+
+fn bench(n: int) {
+    let mut m: Map[int, int]
+    let mut keys: Vec[int]
+    keys.reserve(n as usize)
+
+    let t0 = now_ns()
+    for i in 0..n {
+        m.set(key_of(i), i)
+    }
+    let t_build = now_ns() - t0
+    for i in 0..n {
+        keys.push(key_of(i))
+    }
+
+    let q = 2000000
+    let mut seed: u64 = 88172645463325252
+    let mut hits = 0
+    let t1 = now_ns()
+    for j in 0..q {
+        if m.has(probe(&seed, n)) {
+            hits += 1
+        }
+    }
+    let t_map = now_ns() - t1
+
+    let mut q_lin = 200000000 / n
+    if q_lin < 4 {
+        q_lin = 4
+    }
+    seed = 88172645463325252
+    let mut lin_hits = 0
+    let t2 = now_ns()
+    for j in 0..q_lin {
+        let k = probe(&seed, n)
+        for x in keys {
+            if x == k {
+                lin_hits += 1
+                break
+            }
+        }
+    }
+    let t_lin = now_ns() - t2
+
+    let map_ns = (t_map as f64) / (q as f64)
+    let lin_ns = (t_lin as f64) / (q_lin as f64)
+    // in số lần trúng của cả hai (cũng để C không bỏ vòng quét "vô dụng")
+    println("{d:>9} {f:10.1} {f:12.1} {f:14.1} {f:10.0}x  trúng {d}/{d}, {d}/{d}",
+            n, (t_build as f64) / (n as f64), map_ns, lin_ns, lin_ns / map_ns,
+            hits, q, lin_hits, q_lin)
+    m.free()
+    keys.free()
+}
+
+fn main() -> int {
+    println("{s:>9} {s:>10} {s:>12} {s:>14} {s:>11}", "n", "set ns/op",
+            "Map ns/tra", "quét ns/tra", "tỉ lệ")
+    let mut n = 1000
+    while n <= 10000000 {
+        bench(n)
+        n *= 10
+    }
+    return 0
+}
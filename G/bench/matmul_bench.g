@@ -0,0 +1,135 @@
+// matmul_bench.g - GFLOP/s của Mat.matmul (GEMM chia khối của runtime) ở các
+// cỡ 64..4096, so với vòng for ba tầng i-j-p (kiểu examples/matrix.g) ở cỡ nhỏ.
+// Chạy:  ./gc bench/matmul_bench.g -O 2 --release -r
+//        G_SIMD=scalar|sse2|avx2 ép nhân vi mô; G_THREADS=1 chạy một luồng.
+// Mỗi cỡ lặp tới khi đủ ~0.3 s; GFLOP/s = 2·n³·số_lần / thời_gian. Cột checksum
+// là c[n-1][n-1] để hai bản (kernel / vòng for) so được với nhau.
+import std
+
+const MIN_NS = 300000000
+const NAIVE_MAX = 512
+const INT_MAX = 2048
+
+fn fill_f64(m: *Mat[f64], n: usize, seed: int) {
+    (*m).init(n, n)
+    for i in 0..n {
+        let r = m.row(i)
+        for j in 0..n {
+            r[j] = (((i * 7 + j * 3 + seed) % 17) as f64 - 8.0) * 0.125
+        }
+    }
+}
+
+fn naive_f64(a: *Mat[f64], b: *Mat[f64], c: *Mat[f64]) {
+    let n = a.rows()
+    (*c).init(n, n)
+    for i in 0..n {
+        for j in 0..n {
+            let mut s: f64 = 0.0
+            for p in 0..n {
+                s += (*a)[i][p] * (*b)[p][j]
+            }
+            (*c)[i][j] = s
+        }
+    }
+}
+
+fn gflops(n: usize, reps: int, ns: i64) -> f64 {
+    let nf = n as f64
+    return 2.0 * nf * nf * nf * (reps as f64) / (ns as f64)
+}
+
+fn bench_f64(n: usize) {
+    let mut a: Mat[f64]
+    let mut b: Mat[f64]
+    let mut c: Mat[f64]
+    fill_f64(&a, n, 1)
+    fill_f64(&b, n, 5)
+    let mut reps = 0
+    let t0 = now_ns()
+    while reps == 0 || now_ns() - t0 < MIN_NS {
+        c.matmul(a, b)
+        reps += 1
+    }
+    let dt = now_ns() - t0
+    print("{:>6} {s:>5} {f:10.2}", n, "f64", gflops(n, reps, dt))
+    if n <= NAIVE_MAX {
+        let mut r: Mat[f64]
+        reps = 0
+        let t1 = now_ns()
+        while reps == 0 || now_ns() - t1 < MIN_NS {
+            naive_f64(&a, &b, &r)
+            reps += 1
+        }
+        let dn = now_ns() - t1
+        print(" {f:10.2} {f:14.4} {f:14.4}", gflops(n, reps, dn), c[n - 1][n - 1], r[n - 1][n - 1])
+        r.free()
+    }
+    println("")
+    a.free()
+    b.free()
+    c.free()
+}
+
+fn bench_f32(n: usize) {
+    let mut a: Mat[f32]
+    let mut b: Mat[f32]
+    let mut c: Mat[f32]
+    a.init(n, n)
+    b.init(n, n)
+    for i in 0..n {
+        for j in 0..n {
+            a[i][j] = ((i + j * 5) % 13) as f32 * 0.25
+            b[i][j] = ((i * 3 + j) % 11) as f32 * 0.5
+        }
+    }
+    let mut reps = 0
+    let t0 = now_ns()
+    while reps == 0 || now_ns() - t0 < MIN_NS {
+        c.matmul(a, b)
+        reps += 1
+    }
+    println("{:>6} {s:>5} {f:10.2}", n, "f32", gflops(n, reps, now_ns() - t0))
+    a.free()
+    b.free()
+    c.free()
+}
+
+fn bench_int(n: usize) {
+    let mut a: Mat[int]
+    let mut b: Mat[int]
+    let mut c: Mat[int]
+    a.init(n, n)
+    b.init(n, n)
+    for i in 0..n {
+        for j in 0..n {
+            a[i][j] = ((i + j) % 7) as int - 3
+            b[i][j] = ((i * j) % 5) as int - 2
+        }
+    }
+    let mut reps = 0
+    let t0 = now_ns()
+    while reps == 0 || now_ns() - t0 < MIN_NS {
+        c.matmul(a, b)
+        reps += 1
+    }
+    println("{:>6} {s:>5} {f:10.2}", n, "int", gflops(n, reps, now_ns() - t0))
+    a.free()
+    b.free()
+    c.free()
+}
+
+fn main() -> int {
+    println("{s:>6} {s:>5} {s:>10} {s:>10} {s:>14} {s:>14}", "n", "kiểu", "GFLOP/s", "for i-j-p",
+        "checksum", "checksum for")
+    let mut n: usize = 64
+    while n <= 4096 {
+        bench_f64(n)
+        bench_f32(n)
+        if n <= INT_MAX {
+            bench_int(n)
+        }
+        n *= 2
+    }
+    return 0
+}
@@ -0,0 +1,116 @@
+// opt_bench.g - các mẫu mã mà pass tối ưu (compiler/optimize.py) nhắm tới
+// Chạy:  ./gc bench/opt_bench.g -r            (mặc định: có tối ưu)
+//        ./gc bench/opt_bench.g --no-opt -r   (so sánh: tắt tối ưu)
+// hoặc bench/examples.sh để đo cả examples/ lẫn file này ở -O2, hai chế độ.
+// Mỗi phép đo in ns/vòng lặp trong và một checksum (để C không bỏ đi vòng
+// lặp "vô dụng", và để so hai chế độ cho ra cùng kết quả).
+import std
+
+const N = 65536
+const REPS = 500
+const WIDTH = 64
+const MASK = (1 << 12) - 1
+
+struct Rect {
+    w: int
+    h: int
+}
+
+impl Rect {
+    fn area(self) -> int {
+        return self.w * self.h
+    }
+
+    fn perimeter(self) -> int {
+        return 2 * (self.w + self.h)
+    }
+}
+
+// while i < len(s): không tối ưu thì strlen chạy lại mỗi vòng -> O(n²)
+fn count_char(s: str, c: char) -> int {
+    let mut n = 0
+    let mut i: usize = 0
+    while i < len(s) {
+        if s[i] == c {
+            n += 1
+        }
+        i += 1
+    }
+    return n
+}
+
+// for i in 0..len(v): v[i] không cần g_bounds
+fn dot(a: *Vec[int], b: *Vec[int]) -> i64 {
+    let mut t: i64 = 0
+    for i in 0..len(a) {
+        t += ((*a)[i] * (*b)[i]) as i64
+    }
+    return t
+}
+
+fn scale_all(v: *Vec[int], k: int) {
+    for i in 0..len(v) {
+        (*v)[i] = (*v)[i] * k + WIDTH * 2 - 1
+    }
+}
+
+fn shapes(rs: *Vec[Rect]) -> i64 {
+    let mut t: i64 = 0
+    for i in 0..len(rs) {
+        let r = (*rs)[i]
+        t += (r.area() + r.perimeter()) as i64
+    }
+    return t
+}
+
+fn main() -> int {
+    let mut sb = sb_new()
+    for i in 0..20000 {
+        sb_push(&sb, i % 7 == 0 ? "a b " : "xyz ")
+    }
+    let text = sb_str(&sb)
+
+    let mut a: Vec[int]
+    let mut b: Vec[int]
+    let mut rs: Vec[Rect]
+    for i in 0..N {
+        a.push(i & MASK)
+        b.push((i * 7) & MASK)
+        rs.push(Rect { w: i & 63, h: (i >> 6) & 63 })
+    }
+
+    println("{s:>14} {s:>12} {s:>20}", "kernel", "ns/vòng", "checksum")
+
+    let mut t0 = now_ns()
+    let spaces = count_char(text, ' ')
+    let mut dt = now_ns() - t0
+    println("{s:>14} {f:12.3} {:>20}", "while len(s)", (dt as f64) / (len(text) as f64), spaces)
+
+    t0 = now_ns()
+    let mut d: i64 = 0
+    for r in 0..REPS {
+        d += dot(&a, &b)
+    }
+    dt = now_ns() - t0
+    println("{s:>14} {f:12.3} {:>20}", "dot Vec", (dt as f64) / ((N * REPS) as f64), d)
+
+    t0 = now_ns()
+    for r in 0..REPS {
+        scale_all(&a, 1)
+    }
+    dt = now_ns() - t0
+    println("{s:>14} {f:12.3} {:>20}", "scale Vec", (dt as f64) / ((N * REPS) as f64), a[N - 1])
+
+    t0 = now_ns()
+    let mut s: i64 = 0
+    for r in 0..REPS {
+        s += shapes(&rs)
+    }
+    dt = now_ns() - t0
+    println("{s:>14} {f:12.3} {:>20}", "method inline", (dt as f64) / ((N * REPS) as f64), s)
+
+    a.free()
+    b.free()
+    rs.free()
+    return 0
+}
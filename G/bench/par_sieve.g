@@ -0,0 +1,101 @@
+// par_sieve.g - examples/sieve.g cho N lớn: sàng Eratosthenes phân đoạn, mỗi
+// đoạn SEG số dùng một mảng đánh dấu riêng trên stack (vừa L1). Đếm số nguyên
+// tố < N bằng vòng for tuần tự rồi bằng 'par for ... sum(c)' trên cùng các đoạn.
+// Chạy:  bench/par_sieve.sh                    (G_THREADS = 1, 2, 4, 8, 16)
+//        G_THREADS=4 ./gc bench/par_sieve.g -O 2 --release -r
+// Mỗi bản chạy REPS lần, lấy thời gian nhỏ nhất; hai bản phải đếm ra cùng số.
+import std
+
+const N = 100000000
+const SEG = 32768
+const REPS = 3
+
+// số nguyên tố <= limit (sàng thường, tuần tự)
+fn base_primes(limit: int, ps: *Vec[int]) {
+    let mut comp: *bool = g_alloc(bool, limit + 1)
+    for p in 2..=limit {
+        if !comp[p] {
+            (*ps).push(p)
+            for m in p * p..=limit step p {
+                comp[m] = true
+            }
+        }
+    }
+    g_free(comp)
+}
+
+// số nguyên tố trong [lo, hi), hi - lo <= SEG
+fn count_segment(lo: int, hi: int, ps: *Vec[int]) -> int {
+    let mut mark: [SEG]bool
+    for k in 0..hi - lo {
+        mark[k] = false
+    }
+    for j in 0..len(ps) {
+        let p = (*ps)[j]
+        if p * p >= hi {
+            break
+        }
+        let mut m = max(p * p, (lo + p - 1) / p * p)
+        while m < hi {
+            mark[m - lo] = true
+            m += p
+        }
+    }
+    let mut c = 0
+    for k in max(lo, 2)..hi {
+        if !mark[k - lo] {
+            c += 1
+        }
+    }
+    return c
+}
+
+fn main() -> int {
+    let mut ps: Vec[int]
+    base_primes(isqrt(N) + 1, &ps)
+    let nseg = (N + SEG - 1) / SEG
+
+    let mut seq_ns: i64 = 0
+    let mut seq_c = 0
+    for r in 0..REPS {
+        let t0 = now_ns()
+        let mut c = 0
+        for s in 0..nseg {
+            c += count_segment(s * SEG, min(N, (s + 1) * SEG), &ps)
+        }
+        let dt = now_ns() - t0
+        if r == 0 || dt < seq_ns {
+            seq_ns = dt
+        }
+        seq_c = c
+    }
+
+    // &ps trong thân par for bị chặn (con trỏ ghi được tới biến dùng chung):
+    // lấy con trỏ một lần ngoài vòng lặp, các lần lặp chỉ đọc qua nó
+    let shared = &ps
+    let mut par_ns: i64 = 0
+    let mut par_c = 0
+    for r in 0..REPS {
+        let t0 = now_ns()
+        let mut c = 0
+        par for s in 0..nseg sum(c) {
+            c += count_segment(s * SEG, min(N, (s + 1) * SEG), shared)
+        }
+        let dt = now_ns() - t0
+        if r == 0 || dt < par_ns {
+            par_ns = dt
+        }
+        par_c = c
+    }
+
+    println("số nguyên tố < {}: {} ({} đoạn x {})", N, par_c, nseg, SEG)
+    println("{s:>8} {f:10.1} ms", "for", (seq_ns as f64) / 1.0e6)
+    println("{s:>8} {f:10.1} ms  (x{f:.2})", "par for", (par_ns as f64) / 1.0e6,
+            (seq_ns as f64) / (par_ns as f64))
+    if seq_c != par_c {
+        eprintln("LỖI: tuần tự đếm {}, par for đếm {}", seq_c, par_c)
+        return 1
+    }
+    ps.free()
+    return 0
+}
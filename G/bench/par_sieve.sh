@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+# Đo bench/par_sieve.g với bể par for 1, 2, 4, 8, 16 luồng (G_THREADS). In thời
+# gian vòng for tuần tự, 'par for' và tỉ lệ tăng tốc so với chính bản tuần tự
+# cùng lần chạy. Số luồng vượt số CPU thật chỉ thêm chi phí chuyển ngữ cảnh.
+#   bench/par_sieve.sh
+#   THREADS="1 2 4" bench/par_sieve.sh
+set -u
+cd "$(dirname "$0")/.."
+
+THREADS=${THREADS:-"1 2 4 8 16"}
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+./gc bench/par_sieve.g -O 2 --release -o "$TMP/par_sieve" >/dev/null 2>&1 || { echo "par_sieve: lỗi biên dịch"; exit 1; }
+echo "CPU: $(getconf _NPROCESSORS_ONLN)"
+printf "%-8s %12s %12s %9s\n" "luồng" "for (ms)" "par (ms)" "tăng tốc"
+for t in $THREADS; do
+    out=$(G_THREADS=$t "$TMP/par_sieve") || { echo "$t: lỗi khi chạy"; continue; }
+    seq=$(echo "$out" | awk '$1 == "for" { print $2 }')
+    par=$(echo "$out" | awk '$1 == "par" { print $3 }')
+    printf "%-8s %12s %12s %9s\n" "$t" "$seq" "$par" "$(echo "$out" | sed -n 's/.*(x\(.*\))/\1/p')"
+done
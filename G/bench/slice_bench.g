@@ -0,0 +1,146 @@
+// slice_bench.g - kernel dãy (sum/dot/min/max, a += b, a *= k) so với vòng for
+// Chạy:  ./gc bench/slice_bench.g -O 2 -r
+//        G_SIMD=scalar ./gc bench/slice_bench.g -O 2 -r   (ép nhánh vô hướng)
+//        G_SIMD=sse2 / G_SIMD=avx2                         (ép độ rộng vector)
+// N = 1e7 phần tử; mỗi phép đo in ns/phần tử và một checksum (hai cột "for" và
+// "kernel" phải cho cùng checksum). Các phép rút gọn chạy trên N - r phần tử
+// để gcc không kéo lời gọi hàm thuần ra khỏi vòng REPS.
+import std
+
+const N = 10000000
+const REPS = 10
+
+// Bản sum_slice cũ (trước khi std.g chuyển sang sum(a, n)): vòng for vô hướng
+fn sum_slice_loop(a: *int, n: int) -> i64 {
+    let mut s: i64 = 0
+    for i in 0..n {
+        s = s + (a[i] as i64)
+    }
+    return s
+}
+
+fn dot_loop(a: *int, b: *int, n: int) -> i64 {
+    let mut s: i64 = 0
+    for i in 0..n {
+        s += (a[i] as i64) * (b[i] as i64)
+    }
+    return s
+}
+
+fn max_loop(a: *int, n: int) -> int {
+    let mut m = a[0]
+    for i in 1..n {
+        if a[i] > m {
+            m = a[i]
+        }
+    }
+    return m
+}
+
+fn add_loop(d: *int, s: *int, n: int) {
+    for i in 0..n {
+        d[i] = d[i] + s[i]
+    }
+}
+
+fn scale_loop(d: *f64, k: f64, n: int) {
+    for i in 0..n {
+        d[i] = d[i] * k
+    }
+}
+
+fn report(name: str, t_loop: i64, t_kern: i64, c_loop: i64, c_kern: i64) {
+    let per = (N * REPS) as f64
+    println("{s:>10} {f:10.3} {f:10.3} {f:8.2}x {:>18} {:>18}", name,
+        (t_loop as f64) / per, (t_kern as f64) / per,
+        (t_loop as f64) / (t_kern as f64), c_loop, c_kern)
+}
+
+fn main() -> int {
+    // c, h là bản sao của a, f cho các vòng for ghi vào dãy
+    let mut a: Vec[int]
+    let mut b: Vec[int]
+    let mut c: Vec[int]
+    let mut f: Vec[f64]
+    let mut h: Vec[f64]
+    for i in 0..N {
+        a.push((i * 13 + 5) & 1023)
+        b.push((i * 7) & 511)
+        f.push(((i & 255) as f64) * 0.5)
+        c.push(a[i])
+        h.push(f[i])
+    }
+    let pa = &a[0]
+    let pb = &b[0]
+
+    println("{s:>10} {s:>10} {s:>10} {s:>9} {s:>18} {s:>18}", "phép", "for ns/pt", "kern ns/pt",
+        "tăng tốc", "checksum for", "checksum kernel")
+
+    let mut t0 = now_ns()
+    let mut c1: i64 = 0
+    for r in 0..REPS {
+        c1 += sum_slice_loop(pa, N - r)
+    }
+    let t1 = now_ns() - t0
+    t0 = now_ns()
+    let mut c2: i64 = 0
+    for r in 0..REPS {
+        c2 += sum_slice(pa, N - r)
+    }
+    report("sum_slice", t1, now_ns() - t0, c1, c2)
+
+    t0 = now_ns()
+    c1 = 0
+    for r in 0..REPS {
+        c1 += dot_loop(pa, pb, N - r)
+    }
+    let t3 = now_ns() - t0
+    t0 = now_ns()
+    c2 = 0
+    for r in 0..REPS {
+        c2 += dot(pa, pb, N - r)
+    }
+    report("dot", t3, now_ns() - t0, c1, c2)
+
+    t0 = now_ns()
+    c1 = 0
+    for r in 0..REPS {
+        c1 += max_loop(pa, N - r) as i64
+    }
+    let t5 = now_ns() - t0
+    t0 = now_ns()
+    c2 = 0
+    for r in 0..REPS {
+        c2 += max(pa, N - r) as i64
+    }
+    report("max", t5, now_ns() - t0, c1, c2)
+
+    t0 = now_ns()
+    for r in 0..REPS {
+        add_loop(&c[0], pb, N)
+    }
+    let t7 = now_ns() - t0
+    t0 = now_ns()
+    for r in 0..REPS {
+        a += b
+    }
+    report("a += b", t7, now_ns() - t0, sum(c), sum(a))
+
+    t0 = now_ns()
+    for r in 0..REPS {
+        scale_loop(&h[0], 1.0001, N)
+    }
+    let t9 = now_ns() - t0
+    t0 = now_ns()
+    for r in 0..REPS {
+        f *= 1.0001
+    }
+    report("f *= k", t9, now_ns() - t0, sum(h) as i64, sum(f) as i64)
+
+    a.free()
+    b.free()
+    c.free()
+    f.free()
+    h.free()
+    return 0
+}
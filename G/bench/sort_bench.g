@@ -0,0 +1,79 @@
+// sort_bench.g - sort (pdqsort), sort_by (hàm so sánh) và radix_sort_int
+// Chạy:  ./gc bench/sort_bench.g -O 3 --release -r
+// Mỗi dạng đầu vào (ngẫu nhiên / đã sắp / đảo ngược / nhiều trùng lặp) dựng
+// lại cùng một dãy n phần tử cho từng cách sắp xếp; in ns/phần tử và kiểm
+// tra kết quả đã tăng dần (cũng để C không bỏ đi phép sắp xếp "vô dụng").
+import std
+
+fn xorshift(s: *u64) -> u64 {
+    let mut x = *s
+    x ^= x << 13
+    x ^= x >> 7
+    x ^= x << 17
+    *s = x
+    return x
+}
+
+fn less_int(a: int, b: int) -> bool {
+    return a < b
+}
+
+// Dạng 0: ngẫu nhiên, 1: đã sắp, 2: đảo ngược, 3: chỉ 16 giá trị khác nhau.
+fn fill(v: *Vec[int], n: int, kind: int) {
+    v.clear()
+    let mut seed: u64 = 88172645463325252
+    for i in 0..n {
+        let r = (xorshift(&seed) >> 33) as int
+        if kind == 0 {
+            v.push(r)
+        } else if kind == 1 {
+            v.push(i)
+        } else if kind == 2 {
+            v.push(n - i)
+        } else {
+            v.push(r % 16)
+        }
+    }
+}
+
+fn is_sorted(v: *Vec[int]) -> bool {
+    for i in 1..len(v) as int {
+        if (*v)[i - 1] > (*v)[i] {
+            return false
+        }
+    }
+    return true
+}
+
+// Cách 0: sort, 1: sort_by(less_int), 2: radix_sort_int. Trả ns/phần tử.
+fn run(v: *Vec[int], n: int, kind: int, how: int) -> f64 {
+    fill(v, n, kind)
+    let t0 = now_ns()
+    if how == 0 {
+        sort(v)
+    } else if how == 1 {
+        sort_by(v, less_int)
+    } else {
+        radix_sort_int(&(*v)[0], n)
+    }
+    let dt = now_ns() - t0
+    if !is_sorted(v) {
+        panic("sort_bench: kết quả chưa tăng dần")
+    }
+    return (dt as f64) / (n as f64)
+}
+
+fn main() -> int {
+    let kinds = ["ngẫu nhiên", "đã sắp", "đảo ngược", "trùng lặp"]
+    let mut v: Vec[int]
+    let n = 10000000
+    v.reserve(n as usize)
+    println("n = {}, ns/phần tử", n)
+    println("{s:>12} {s:>10} {s:>10} {s:>10}", "đầu vào", "sort", "sort_by", "radix")
+    for k in 0..4 {
+        println("{s:>12} {f:10.2} {f:10.2} {f:10.2}", kinds[k],
+                run(&v, n, k, 0), run(&v, n, k, 1), run(&v, n, k, 2))
+    }
+    v.free()
+    return 0
+}
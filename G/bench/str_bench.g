@@ -0,0 +1,148 @@
+// str_bench.g - hàm chuỗi của runtime so với libc, theo cỡ haystack
+// Chạy:  ./gc bench/str_bench.g -O 2 --release -r
+//        G_SIMD=scalar|sse2|avx2 ./bench/str_bench   # ép một nhánh để so sánh
+// Với mỗi cỡ n: độ dài (str_len / strlen), so sánh hai bản sao bằng nhau (streq /
+// strcmp), tìm kim 16 byte nằm ở cuối (str_index / strstr) và tìm khi đã biết
+// độ dài (sb_index, đi thẳng nhân SIMD). In ns/lần gọi; mỗi ô lặp đủ để quét
+// ~256 MB.
+// str_len/streq/str_index đi thẳng strlen/strcmp/strstr (nhân SIMD riêng cho độ
+// dài/so sánh chậm hơn libc nên đã bỏ) nên từng cặp cột giống nhau; chỉ sb_index
+// dùng nhân SIMD của G (G_SIMD chọn bản).
+import std
+
+// kiểu trả về khớp khai báo của libc (char*, không phải const char*)
+extern fn getenv(name: str) -> *char
+extern fn strcmp(a: str, b: str) -> int
+extern fn strstr(hay: str, needle: str) -> *char
+
+fn xorshift(s: *u64) -> u64 {
+    let mut x = *s
+    x ^= x << 13
+    x ^= x >> 7
+    x ^= x << 17
+    *s = x
+    return x
+}
+
+// n-16 chữ 'a'..'y' rồi kim: 15 chữ ngẫu nhiên + 'z' -> kim chỉ có ở cuối.
+fn make_haystack(b: *strbuf, needle: *strbuf, n: int, seed: *u64) {
+    sb_clear(needle)
+    for i in 0..15 {
+        sb_push_char(needle, (97 + (xorshift(seed) % 25) as int) as char)
+    }
+    sb_push_char(needle, 'z')
+    sb_clear(b)
+    for i in 0..n - 16 {
+        sb_push_char(b, (97 + (xorshift(seed) % 25) as int) as char)
+    }
+    sb_push(b, sb_str(needle))
+}
+
+// Ghi byte đầu của cả hai bản sao (vẫn bằng nhau, kim vẫn chỉ ở cuối): nếu
+// không, C compiler coi strlen/strcmp/strstr là hàm thuần và đưa lời gọi ra
+// khỏi vòng lặp.
+fn touch(a: *u8, b: *u8, r: int) {
+    a[0] = (97 + (r & 1)) as u8
+    b[0] = a[0]
+}
+
+fn per_call(t0: i64, reps: int) -> f64 {
+    return ((now_ns() - t0) as f64) / (reps as f64)
+}
+
+fn main() -> int {
+    let simd = getenv("G_SIMD")
+    if simd == null {
+        println("G_SIMD: (mặc định)")
+    } else {
+        println("G_SIMD: {s}", simd as str)
+    }
+    println("{s:>8} | {s:>9} {s:>9} | {s:>9} {s:>9} | {s:>9} {s:>9} | {s:>9}   ns/lần",
+            "n", "str_len", "strlen", "streq", "strcmp", "str_index", "strstr",
+            "sb_index")
+
+    let sizes = [32, 64, 256, 4096, 65536, 1048576, 16777216]
+    let mut seed: u64 = 88172645463325252
+    let mut h: strbuf
+    let mut copy: strbuf
+    let mut needle: strbuf
+    let mut check: i64 = 0
+    for k in 0..7 {
+        let n = sizes[k]
+        make_haystack(&h, &needle, n, &seed)
+        sb_clear(&copy)
+        sb_push(&copy, sb_str(&h))
+        let hs = sb_str(&h)
+        let cs = sb_str(&copy)
+        let ns = sb_str(&needle)
+        let hm = hs as *u8
+        let cm = cs as *u8
+        let mut reps = 268435456 / n
+        if reps > 4000000 {
+            reps = 4000000
+        }
+
+        let mut t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            check += str_len(hs) as i64
+        }
+        let t_len = per_call(t0, reps)
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            check += strlen(hs) as i64
+        }
+        let t_strlen = per_call(t0, reps)
+
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            if streq(hs, cs) {
+                check += 1
+            }
+        }
+        let t_eq = per_call(t0, reps)
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            if strcmp(hs, cs) == 0 {
+                check += 1
+            }
+        }
+        let t_strcmp = per_call(t0, reps)
+
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            check += str_index(hs, ns) as i64
+        }
+        let t_index = per_call(t0, reps)
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            if strstr(hs, ns) != null {
+                check += 1
+            }
+        }
+        let t_strstr = per_call(t0, reps)
+
+        t0 = now_ns()
+        for r in 0..reps {
+            touch(hm, cm, r)
+            check += sb_index(&h, ns) as i64
+        }
+        let t_sb = per_call(t0, reps)
+
+        if str_index(hs, ns) != (n - 16) as isize || sb_index(&h, ns) != (n - 16) as isize {
+            panic("str_bench: tìm sai vị trí")
+        }
+        println("{:>8} | {f:9.1} {f:9.1} | {f:9.1} {f:9.1} | {f:9.1} {f:9.1} | {f:9.1}",
+                n, t_len, t_strlen, t_eq, t_strcmp, t_index, t_strstr, t_sb)
+    }
+    println("(tổng kiểm tra {ld})", check)
+    sb_free(&h)
+    sb_free(&copy)
+    sb_free(&needle)
+    return 0
+}
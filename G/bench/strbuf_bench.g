@@ -0,0 +1,57 @@
+// strbuf_bench.g - dựng chuỗi bằng `s = str_concat(s, x)` và bằng sb_push
+// Chạy:  ./gc bench/strbuf_bench.g -O 2 --release -r
+// Cùng số lần append n cho cả hai cách; in tổng ms và ns/lần append.
+// str_concat chép lại cả chuỗi mỗi lần (O(n²)) nên chỉ đo tới n = 1e5 —
+// ở 1e6 nó mất cỡ vài chục giây; sb_push đo đến 1e6.
+import std
+
+fn by_concat(n: int) -> i64 {
+    let t0 = now_ns()
+    let mut s = str_concat("", "")
+    for i in 0..n {
+        let t = str_concat(s, "x")
+        g_free(s)
+        s = t
+    }
+    let dt = now_ns() - t0
+    if str_len(s) != n as usize {
+        panic("strbuf_bench: str_concat sai độ dài")
+    }
+    g_free(s)
+    return dt
+}
+
+fn by_strbuf(n: int) -> i64 {
+    let t0 = now_ns()
+    let mut b = sb_new()
+    for i in 0..n {
+        sb_push(&b, "x")
+    }
+    let s = sb_finish(&b)
+    let dt = now_ns() - t0
+    if str_len(s) != n as usize {
+        panic("strbuf_bench: sb_push sai độ dài")
+    }
+    g_free(s)
+    return dt
+}
+
+fn main() -> int {
+    println("{s:>9} {s:>14} {s:>14} {s:>12} {s:>12}", "n", "concat ms", "strbuf ms",
+            "concat ns/op", "strbuf ns/op")
+    let mut n = 10000
+    while n <= 1000000 {
+        let sb = by_strbuf(n)
+        if n <= 100000 {
+            let cc = by_concat(n)
+            println("{:>9} {f:14.3} {f:14.3} {f:12.1} {f:12.1}", n,
+                    (cc as f64) / 1e6, (sb as f64) / 1e6,
+                    (cc as f64) / (n as f64), (sb as f64) / (n as f64))
+        } else {
+            println("{:>9} {s:>14} {f:14.3} {s:>12} {f:12.1}", n, "-",
+                    (sb as f64) / 1e6, "-", (sb as f64) / (n as f64))
+        }
+        n *= 10
+    }
+    return 0
+}
@@ -14,6 +14,7 @@ class Type:
     ptr: int = 0                   # số mức con trỏ (*)
     array: Optional[object] = None # mảng 1 chiều: số phần tử (int) / "dyn" cho []T
     dims: Optional[list] = None    # mảng nhiều chiều: [d0, d1, ...] (mỗi d là int/"dyn")
+    args: Optional[list] = None    # tham số kiểu generic: Vec[T] -> [Type(T)]
     line: int = 0
     col: int = 0
 
@@ -40,6 +41,7 @@ class Function:
     is_comptime: bool = False
     is_extern: bool = False
     recv: Optional[str] = None     # tên struct nếu là method (impl)
+    is_async: bool = False         # 'async fn': sinh thành máy trạng thái
     line: int = 0
     col: int = 0
 
@@ -129,6 +131,9 @@ class For:                  # for i in a..b { } | a..=b | step N
     inclusive: bool = False
     step: object = None
     c_name: str = ""
+    par: bool = False        # 'par for': các lần lặp chạy song song
+    chunk: object = None     # par: số lần lặp tối thiểu mỗi phần việc
+    reduce: list = field(default_factory=list)   # par: [(sum|min|max, Ident)]
     line: int = 0
     col: int = 0
 
@@ -179,6 +184,13 @@ class Block:                # khối lệnh trần { ... } (tạo scope mới)
     col: int = 0
 
 
+@dataclass
+class Region:               # region { ... } : khối mà g_alloc/chuỗi cấp phát từ arena
+    body: list
+    line: int = 0
+    col: int = 0
+
+
 @dataclass
 class Break:
     line: int = 0
@@ -344,6 +356,21 @@ class SizeOfExpr:          # sizeof(biểu_thức) — lấy kích thước theo
     col: int = 0
 
 
+@dataclass
+class Const:               # hằng đã gập bởi optimize (giá trị Python + kiểu C để in)
+    value: object
+    ctype: object           # GType quyết định cách in literal (INT64_C, 'f'...)
+    line: int = 0
+    col: int = 0
+
+
+@dataclass
+class Await:               # await f(x): chờ hàm async / thao tác I/O xong (chỉ trong async fn)
+    expr: object
+    line: int = 0
+    col: int = 0
+
+
 @dataclass
 class StructLit:
     name: str
@@ -22,7 +22,48 @@ class CheckError(Exception):
 
 BUILTINS = {"print", "println", "eprint", "eprintln", "printf",
             "len", "assert", "panic", "min", "max", "abs", "clamp",
-            "g_alloc", "g_free", "g_realloc", "unreachable", "todo"}
+            "g_alloc", "g_free", "g_realloc", "unreachable", "todo",
+            "sort", "sort_by", "flush", "spawn", "wait_readable",
+            "wait_writable", "sleep_ms", "yield_now"}
+
+# Thao tác chờ dựng sẵn của executor async: chỉ dùng dạng 'await x(...)'.
+# Tên -> số tham số.
+ASYNC_BUILTINS = {"wait_readable": 1, "wait_writable": 1, "sleep_ms": 1, "yield_now": 0}
+
+# Method dựng sẵn của Vec[T] / Map[K, V]: tên -> (kiểu tham số, kiểu trả về).
+# "elem" = T (Map: V), "key" = K, "usize" = số lượng, "*elem" = con trỏ tới V.
+VEC_METHODS = {"push": (("elem",), "void"), "pop": ((), "elem"),
+               "reserve": (("usize",), "void"), "clear": ((), "void"),
+               "free": ((), "void")}
+MAP_METHODS = {"set": (("key", "elem"), "void"), "get": (("key",), "elem"),
+               "get_or": (("key", "elem"), "elem"), "has": (("key",), "bool"),
+               "find": (("key",), "*elem"), "entry": (("key",), "*elem"),
+               "remove": (("key",), "bool"), "reserve": (("usize",), "void"),
+               "clear": ((), "void"), "free": ((), "void")}
+MAP_READONLY = {"get", "get_or", "has", "find"}
+# Mat[T]: "self" = chính kiểu Mat đó. matmul ghi a·b vào recv (cấp phát lại khi
+# khác cỡ); transpose trả ma trận mới; row(i) là con trỏ tới đầu hàng i.
+MAT_METHODS = {"init": (("usize", "usize"), "void"), "rows": ((), "usize"),
+               "cols": ((), "usize"), "row": (("usize",), "*elem"),
+               "fill": (("elem",), "void"), "transpose": ((), "self"),
+               "matmul": (("self", "self"), "void"), "free": ((), "void")}
+MAT_READONLY = {"rows", "cols", "row", "transpose"}
+# Kiểu phần tử Mat có nhân GEMM trong runtime.
+MAT_ELEMS = {"int", "f32", "f64"}
+
+# Phép trên dãy số (nhân SIMD g_slice_* của runtime). sum/dot chỉ là builtin
+# khi chương trình không tự định nghĩa hàm cùng tên; min/max một đối số (hoặc
+# (con_trỏ, n)) là bản rút gọn trên dãy của min/max hai đối số.
+SLICE_BUILTINS = {"sum", "dot"}
+# Gán gộp trên cả dãy ('xs += ys', 'xs *= 2'): toán tử -> tên nhân runtime.
+SLICE_OPS = {"+=": "add", "-=": "sub", "*=": "mul", "/=": "div",
+             "&=": "and", "|=": "or", "^=": "xor"}
+CONTAINER_METHODS = {"vec": VEC_METHODS, "map": MAP_METHODS, "mat": MAT_METHODS}
+CONTAINER_READONLY = {"map": MAP_READONLY, "mat": MAT_READONLY}
+
+# Builtin dùng trạng thái toàn cục không khoá của runtime (bộ đệm stdout):
+# cấm trong thân 'par for'.
+PAR_UNSAFE_BUILTINS = {"print", "println", "eprint", "eprintln", "printf", "flush"}
 
 
 def extract_placeholders(fmt: str):
@@ -108,6 +149,15 @@ class Checker:
         self.cur_file = None       # file đang kiểm tra (chẩn đoán đa module)
         self.loop_depth = 0        # độ sâu vòng lặp (kiểm tra break/continue)
         self.fn_cnames = set()     # mọi tên C đã dùng trong hàm hiện tại (chống shadow)
+        self.local_ints = {}       # tên C -> giá trị của 'let' bất biến cục bộ fold được
+        self.generic_types = []    # mọi Vec/Map đã gặp, kiểu trong trước (codegen đơn hình hoá)
+        self.sort_insts = []       # (tên C, kiểu phần tử, hàm so sánh) của sort/sort_by
+        self.slice_insts = {}      # hậu tố C -> (kiểu phần tử, {tên phép: toán tử}) của g_slice_*
+        self.par = []              # ngữ cảnh các 'par for' đang kiểm tra (trong ra ngoài = cuối về đầu)
+        self.cur_async = None      # Function đang kiểm tra nếu là 'async fn'
+        self.await_top = None      # Await được phép ở câu lệnh hiện tại (đứng đầu vế phải)
+        self.no_await = []         # cấu trúc đang mở mà thân không được chứa 'await'
+        self.async_edges = {}      # async fn -> các async fn nó await (chống đệ quy)
 
     # ---------- tiện ích lỗi ----------
     def err(self, msg, node=None):
@@ -129,6 +179,10 @@ class Checker:
                 for m in it.methods:
                     if m.body is not None:
                         self.check_function(m)
+        self.prog.async_fns = self.async_order()
+        self.prog.generic_types = self.generic_types
+        self.prog.sort_insts = self.sort_insts
+        self.prog.slice_insts = self.slice_insts
         return self.prog
 
     # ---------- thu thập hằng nguyên (cho cỡ mảng tượng trưng) ----------
@@ -154,8 +208,9 @@ class Checker:
             if not changed:
                 break
 
-    def _fold_const_int(self, e):
-        """Tính giá trị nguyên của biểu thức hằng (hoặc None nếu không thể)."""
+    def _fold_const_int(self, e, local=None):
+        """Tính giá trị nguyên của biểu thức hằng (hoặc None nếu không thể).
+        local: thêm các 'let' bất biến cục bộ (self.local_ints) đã fold được."""
         if isinstance(e, A.IntLit):
             try:
                 return int(e.value, 0)
@@ -164,15 +219,21 @@ class Checker:
         if isinstance(e, A.CharLit):
             return ord(e.value) if len(e.value) == 1 else None
         if isinstance(e, A.Ident):
+            if local is not None:
+                cname = getattr(e, "c_name", "") or e.name
+                if cname in local:
+                    return local[cname]
+                if self.scope_index(e.name) >= 0:
+                    return None     # biến cục bộ che hằng global cùng tên
             return self.const_ints.get(e.name)
         if isinstance(e, A.Unary):
-            v = self._fold_const_int(e.operand)
+            v = self._fold_const_int(e.operand, local)
             if v is None:
                 return None
             return {"-": -v, "~": ~v, "+": v}.get(e.op)
         if isinstance(e, A.Binary):
-            a = self._fold_const_int(e.left)
-            b = self._fold_const_int(e.right)
+            a = self._fold_const_int(e.left, local)
+            b = self._fold_const_int(e.right, local)
             if a is None or b is None:
                 return None
             try:
@@ -185,7 +246,7 @@ class Checker:
             except (ValueError, ZeroDivisionError):
                 return None
         if isinstance(e, A.Cast):
-            return self._fold_const_int(e.expr)
+            return self._fold_const_int(e.expr, local)
         return None
 
     # ---------- thu thập khai báo ----------
@@ -197,7 +258,8 @@ class Checker:
                 self.struct_order.setdefault(it.name, [])
             elif isinstance(it, A.EnumDef):
                 self.enums.setdefault(it.name, {})
-        self.type_names = (set(T.PRIMITIVES) | set(self.structs) | set(self.enums))
+        self.type_names = (set(T.PRIMITIVES) | set(self.structs) | set(self.enums)
+                           | {"Vec", "Map", "Mat"})
         # Lượt 2: điền nội dung (giờ resolve thấy mọi tên kiểu).
         for it in self.prog.items:
             self.cur_file = getattr(it, "src_file", None)
@@ -243,6 +305,9 @@ class Checker:
                 if (prev is not None and prev.body is not None
                         and it.body is not None):
                     self.err(f"hàm '{it.name}' được định nghĩa nhiều lần", it)
+                if it.is_async and it.body is None:
+                    self.err(f"'async fn {it.name}' cần thân hàm (không khai báo "
+                             f"extern được)", it)
                 self.register_func(it)
             elif isinstance(it, A.Impl):
                 self.cur_file = getattr(it, "src_file", None)
@@ -297,7 +362,7 @@ class Checker:
         if isinstance(st, A.If):
             return (self._body_mutates_self(st.then, struct, stack)
                     or (st.els is not None and self._body_mutates_self(st.els, struct, stack)))
-        if isinstance(st, (A.While, A.Loop, A.For, A.ForEach, A.Block)):
+        if isinstance(st, (A.While, A.Loop, A.For, A.ForEach, A.Block, A.Region)):
             return self._body_mutates_self(getattr(st, "body", []), struct, stack)
         if isinstance(st, A.Match):
             return any(self._body_mutates_self(b, struct, stack) for _, _, b in st.arms)
@@ -342,6 +407,13 @@ class Checker:
             if isinstance(recv, A.Ident) and recv.name == "self":
                 if self.method_mutates_self(struct, e.func.field, stack):
                     return True
+            # self.items.push(x): method Vec/Map sửa header nằm ngay trong *self.
+            if (isinstance(recv, A.FieldAccess) and isinstance(recv.base, A.Ident)
+                    and recv.base.name == "self"):
+                ft = self.structs.get(struct, {}).get(recv.field)
+                if (ft is not None and e.func.field in CONTAINER_METHODS.get(ft.kind, ())
+                        and not (ft.kind == "map" and e.func.field in MAP_READONLY)):
+                    return True
         # quét đệ quy các nhánh con để bắt lời gọi lồng
         for child in self._expr_children(e):
             if self._call_mutates_self(child, struct, stack):
@@ -362,7 +434,7 @@ class Checker:
             return [e.base, e.index]
         if isinstance(e, A.FieldAccess):
             return [e.base]
-        if isinstance(e, A.Cast):
+        if isinstance(e, (A.Cast, A.Await)):
             return [e.expr]
         return []
 
@@ -407,6 +479,8 @@ class Checker:
             g = T.GType("struct", name=base)
         elif base in self.enums:
             g = T.GType("enum", name=base)
+        elif base in ("Vec", "Map", "Mat"):
+            g = self._resolve_generic(ty)
         else:
             sug = suggest(base, self.type_names)
             msg = f"kiểu chưa biết: '{base}'"
@@ -430,6 +504,41 @@ class Checker:
             g = T.ptr_of(g)
         return g
 
+    def _resolve_generic(self, ty: A.Type) -> T.GType:
+        """Vec[T] / Map[K, V] / Mat[T]: ghi nhận mỗi tổ hợp kiểu MỘT lần (kiểu
+        trong trước kiểu ngoài) để codegen sinh đúng một struct + bộ hàm cho nó."""
+        want = 2 if ty.name == "Map" else 1
+        if not ty.args or len(ty.args) != want:
+            form = "Map[K, V]" if want == 2 else f"{ty.name}[T]"
+            raise CheckError(f"{ty.name} cần đúng {want} tham số kiểu: '{form}'",
+                             ty.line, ty.col, self.cur_file)
+        args = [self.resolve(a) for a in ty.args]
+        val = args[-1]
+        if val.kind in ("void", "array"):
+            raise CheckError(
+                f"{ty.name} không chứa được giá trị kiểu '{val}' (mảng tĩnh không "
+                f"gán được — dùng Vec[T] hoặc struct)", ty.line, ty.col,
+                self.cur_file)
+        if ty.name == "Mat":
+            if val.name not in MAT_ELEMS:
+                raise CheckError(
+                    f"Mat chỉ chứa int, f32 hoặc f64 — không phải '{val}'",
+                    ty.line, ty.col, self.cur_file)
+            g = T.mat_of(val)
+        elif want == 1:
+            g = T.vec_of(val)
+        else:
+            key = args[0]
+            if key.kind not in ("int", "char", "bool", "enum", "ptr", "str"):
+                raise CheckError(
+                    f"khoá Map phải là số nguyên, char, bool, enum, con trỏ hoặc "
+                    f"str — không phải '{key}'", ty.line, ty.col, self.cur_file)
+            g = T.map_of(key, val)
+        if g not in self.generic_types:
+            self.generic_types.append(g)
+        ty.ginst = g         # codegen đọc lại tên struct C
+        return g
+
     def _fold_dim(self, d, ty):
         """Chuyển một chiều mảng tượng trưng (tên hằng) thành số nguyên.
         Số / 'dyn' giữ nguyên. Tên không phải hằng nguyên -> lỗi rõ ràng."""
@@ -467,6 +576,13 @@ class Checker:
         self.scopes[-1][name] = (gt, mutable, cname)
         return cname
 
+    def scope_index(self, name):
+        """Chỉ số scope cục bộ khai báo 'name' (trong cùng), -1 nếu không có."""
+        for i in range(len(self.scopes) - 1, -1, -1):
+            if name in self.scopes[i]:
+                return i
+        return -1
+
     def lookup(self, name):
         for s in reversed(self.scopes):
             if name in s:
@@ -494,7 +610,12 @@ class Checker:
         từ chối các trường hợp rõ ràng sai (chuỗi<->số, struct lệch...)."""
         if dst is None or src is None:
             return True
-        if dst.kind == "unknown" or src.kind in ("unknown", "null"):
+        if "unknown" in (dst.kind, src.kind):
+            return True
+        # Vec[A] và Vec[B] là hai struct C khác nhau: phải khớp đúng kiểu tham số.
+        if dst.kind in ("vec", "map", "mat") or src.kind in ("vec", "map", "mat"):
+            return dst == src
+        if src.kind == "null":
             return True
         if dst.kind == "void":
             return False
@@ -520,7 +641,25 @@ class Checker:
     # ---------- kiểm tra hàm ----------
     def check_function(self, fn: A.Function):
         self.cur_fn = fn.name
+        self.cur_async = fn if fn.is_async else None
+        if fn.is_async:
+            if fn.recv is not None:
+                self.err(f"method '{fn.recv}.{fn.name}' không thể là 'async' — dùng "
+                         f"hàm tự do nhận con trỏ", fn)
+            if fn.name == "main":
+                self.err("'main' không thể là 'async' — spawn(...) các tác vụ rồi "
+                         "gọi async_run()", fn)
+            if fn.is_comptime:
+                self.err(f"'comptime fn {fn.name}' không thể là 'async'", fn)
+            self.async_edges[fn.name] = {}
+        rt = self.resolve(fn.ret)
+        if self._is_static_array(rt) and not fn.is_comptime:
+            self.err(
+                f"hàm '{fn.name}' không thể trả về mảng tĩnh '{self.tyname(rt)}' "
+                f"(C không trả mảng theo giá trị) — dùng 'comptime fn' để tính "
+                f"lúc biên dịch, hoặc nhận con trỏ tới mảng đích", fn)
         self.fn_cnames = set()
+        self.local_ints = {}
         self.push()
         seen = set()
         for p in fn.params:
@@ -562,7 +701,7 @@ class Checker:
             if st.els is None:
                 return False
             return self._always_returns(st.then) and self._always_returns(st.els)
-        if isinstance(st, A.Block):
+        if isinstance(st, (A.Block, A.Region)):
             return self._always_returns(st.body)
         if isinstance(st, A.Loop):
             # loop { } vô hạn diverge TRỪ KHI có 'break' thoát ra
@@ -613,7 +752,7 @@ class Checker:
                     return True
                 if st.els and self._has_break(st.els):
                     return True
-            elif isinstance(st, A.Block):
+            elif isinstance(st, (A.Block, A.Region)):
                 if self._has_break(st.body):
                     return True
             elif isinstance(st, A.Match):
@@ -624,6 +763,7 @@ class Checker:
 
     def check_stmt(self, st):
         if isinstance(st, A.Let):
+            self.await_top = st.value
             val_t = self.infer(st.value) if st.value is not None else None
             # Gán kết quả của hàm void cho biến là vô nghĩa (C: 'declared void').
             if val_t is not None and val_t.kind == "void":
@@ -634,6 +774,18 @@ class Checker:
                     f"'{st.name}' (hàm không trả về giá trị)", st)
             if st.type is not None:
                 gt = self.resolve(st.type)
+                if gt.kind == "vec" and isinstance(st.value, A.ArrayLit):
+                    # 'let v: Vec[T] = [a, b, c]' — khởi tạo từ literal, từng phần tử.
+                    for el in st.value.elements:
+                        et = getattr(el, "gtype", None)
+                        if not self.assignable(gt.elem, et):
+                            self.err(
+                                f"phần tử kiểu '{self.tyname(et)}' không đưa được "
+                                f"vào '{st.name}: {self.tyname(gt)}'", st)
+                    val_t = None
+                if gt.kind == "mat" and isinstance(st.value, A.ArrayLit):
+                    self._check_mat_lit(st, gt)
+                    val_t = None
                 if val_t is not None and not self.assignable(gt, val_t):
                     self.err(
                         f"không thể gán giá trị kiểu '{self.tyname(val_t)}' "
@@ -644,8 +796,19 @@ class Checker:
                 gt = val_t if val_t is not None else T.INT
             st.resolved_type = gt
             st.c_name = self.declare(st.name, gt, st.mutable)
+            if not st.mutable and st.value is not None and gt.is_integer():
+                v = self._fold_const_int(st.value, self.local_ints)
+                if v is not None:
+                    self.local_ints[st.c_name] = v
+            for ctx in self.par:
+                if not st.mutable and st.value is not None and \
+                        self._par_affine(st.value, ctx):
+                    ctx["derived"].add(st.c_name)
         elif isinstance(st, A.Return):
+            if self.par:
+                self.err("'return' không dùng được trong thân 'par for'", st)
             if st.value is not None:
+                self.await_top = st.value
                 vt = self.infer(st.value)
                 if not self.assignable(self.cur_ret, vt):
                     if self.cur_ret.kind == "void":
@@ -675,22 +838,39 @@ class Checker:
         elif isinstance(st, A.For):
             self.check_for(st)
         elif isinstance(st, A.ForEach):
+            self.no_await.append("'for x in'")
             self.check_foreach(st)
+            self.no_await.pop()
         elif isinstance(st, A.Match):
+            self.no_await.append("'match'")
             self.check_match(st)
+            self.no_await.pop()
         elif isinstance(st, A.Block):
             self.check_block(st.body)
+        elif isinstance(st, A.Region):
+            if self.par:
+                self.err("'region' không dùng được trong thân 'par for' "
+                         "(arena của region không an toàn đa luồng)", st)
+            self.no_await.append("'region'")
+            self.check_block(st.body)
+            self.no_await.pop()
         elif isinstance(st, A.Defer):
+            self.no_await.append("'defer'")
             self.check_stmt(st.stmt)
+            self.no_await.pop()
         elif isinstance(st, A.Assign):
             self.check_assign(st)
         elif isinstance(st, A.Break):
             if self.loop_depth == 0:
                 self.err("'break' nằm ngoài vòng lặp", st)
+            if self.par and self.loop_depth == self.par[-1]["loop"]:
+                self.err("'break' không dùng được trong thân 'par for' (các lần "
+                         "lặp chạy song song, không theo thứ tự) — dùng 'continue'", st)
         elif isinstance(st, A.Continue):
             if self.loop_depth == 0:
                 self.err("'continue' nằm ngoài vòng lặp", st)
         elif isinstance(st, A.ExprStmt):
+            self.await_top = st.expr
             self.infer(st.expr)
         # Asm: không cần kiểm tra
 
@@ -706,13 +886,236 @@ class Checker:
         else:
             vt = T.INT
         st.var_type = vt
+        ctx = self._par_enter(st) if st.par else None
         self.loop_depth += 1
         self.push()
         st.c_name = self.declare(st.var, vt, True)
+        for c in self.par:
+            # biến lặp có khoảng phụ thuộc biến lặp của một 'par for' bao ngoài
+            # cũng phân biệt các lần lặp ngoài (chỉ số ghi hợp lệ)
+            if c is ctx or self._par_affine(st.start, c) or self._par_affine(st.end, c):
+                c["derived"].add(st.c_name)
         for s in st.body:
             self.check_stmt(s)
         self.pop()
         self.loop_depth -= 1
+        if ctx is not None:
+            self.par.pop()
+            self._check_par_writes(ctx)
+            self._check_par_reads(ctx)
+            st.captures = ctx["captures"]
+            st.by_ref = ctx["written"]
+
+    # ---------- par for: bắt biến + chặn data race hiển nhiên ----------
+    def _par_enter(self, st: A.For):
+        """Kiểm tra chunk và mệnh đề rút gọn, mở ngữ cảnh cho thân 'par for'.
+        Biến rút gọn phải là 'let mut' cục bộ kiểu số ở ngoài vòng lặp; trong
+        thân, mỗi luồng cộng dồn vào bản riêng."""
+        if st.chunk is not None:
+            ct = self.infer(st.chunk)
+            if not ct.is_integer() and ct.kind != "unknown":
+                self.err(f"'chunk' cần số nguyên, nhận '{self.tyname(ct)}'", st.chunk)
+        reduce = {}
+        st.reduce_info = []
+        for op, ident in st.reduce:
+            info = self.lookup(ident.name)
+            if info is None:
+                self.err(f"biến chưa khai báo: '{ident.name}'", ident)
+            if self.scope_index(ident.name) < 0 or not info[1]:
+                self.err(f"'{op}({ident.name})': biến rút gọn phải là biến cục bộ "
+                         f"'let mut'", ident)
+            if info[0].kind not in ("int", "float"):
+                self.err(f"'{op}({ident.name})': biến rút gọn cần kiểu số, không "
+                         f"phải '{self.tyname(info[0])}'", ident)
+            if info[2] in reduce:
+                self.err(f"'{ident.name}' xuất hiện hai lần trong mệnh đề rút gọn", ident)
+            ident.c_name = info[2]
+            reduce[info[2]] = op
+            st.reduce_info.append((op, info[2], info[0]))
+            # ghi vào biến gốc (dưới khoá) từ thân -> par bao ngoài phải bắt theo
+            # tham chiếu, trừ khi chính nó cũng rút gọn biến này
+            idx = self.scope_index(ident.name)
+            for outer in reversed(self.par):
+                if info[2] in outer["reduce"] or idx >= outer["depth"]:
+                    break
+                outer["captures"].setdefault(info[2], (info[0], info[1]))
+                outer["written"].add(info[2])
+        ctx = {"depth": len(self.scopes), "loop": self.loop_depth + 1,
+               "reduce": reduce, "var": st.var, "captures": {},
+               "written": set(), "derived": set(),
+               "elem_writes": {}, "elem_reads": [], "write_sites": {}}
+        self.par.append(ctx)
+        return ctx
+
+    def _par_affine(self, e, ctx) -> bool:
+        """e có chứa biến lặp của ctx (hoặc 'let' suy trực tiếp từ nó) ngoài mọi
+        phép chỉ mục/lời gọi? Khi đó mỗi lần lặp có một giá trị riêng — ghi vào
+        a[e] từ các lần lặp khác nhau là ghi vào các ô khác nhau. Hệ số biết là 0
+        (0 * i, k * i với 'let k = 0', 0 << i, i - i) xoá biến lặp: không tính."""
+        if isinstance(e, A.Ident):
+            return (getattr(e, "c_name", "") or e.name) in ctx["derived"]
+        if isinstance(e, A.Binary) and e.op in ("+", "-", "*", "<<"):
+            la, ra = self._par_affine(e.left, ctx), self._par_affine(e.right, ctx)
+            if e.op == "*" and la != ra:
+                return self._fold_const_int(e.right if la else e.left,
+                                            self.local_ints) != 0
+            if e.op == "<<" and not la and ra:
+                return self._fold_const_int(e.left, self.local_ints) != 0
+            if e.op == "-" and la and ra:
+                return self._par_key(e.left) != self._par_key(e.right)
+            return la or ra
+        if isinstance(e, A.Unary) and e.op in ("-", "~"):
+            return self._par_affine(e.operand, ctx)
+        if isinstance(e, A.Cast):
+            return self._par_affine(e.expr, ctx)
+        return False
+
+    def _par_key(self, e):
+        """Khoá so sánh hai biểu thức chỉ số (cùng biến, cùng phép tính); biểu
+        thức khác loại không bao giờ bằng nhau."""
+        if isinstance(e, A.Ident):
+            return ("id", getattr(e, "c_name", "") or e.name)
+        if isinstance(e, A.IntLit):
+            return ("int", e.value)
+        if isinstance(e, A.Binary):
+            return (e.op, self._par_key(e.left), self._par_key(e.right))
+        if isinstance(e, A.Unary):
+            return (e.op, self._par_key(e.operand))
+        if isinstance(e, A.Cast):
+            return self._par_key(e.expr)
+        return ("?", id(e))
+
+    def _par_form(self, e, ctx):
+        """Chỉ số ghi theo biến lặp -> (khoá phần gốc, bước k, độ lệch c) với
+        e = k * gốc + c (k, c là hằng; mặc định k = 1, c = 0); None nếu e không
+        phụ thuộc biến lặp."""
+        if not self._par_affine(e, ctx):
+            return None
+        off = 0
+        while True:
+            if isinstance(e, A.Cast):
+                e = e.expr
+            elif isinstance(e, A.Binary) and e.op in ("+", "-"):
+                r = self._fold_const_int(e.right, self.local_ints)
+                l = self._fold_const_int(e.left, self.local_ints) if e.op == "+" else None
+                if r is not None:
+                    off, e = off + (r if e.op == "+" else -r), e.left
+                elif l is not None:
+                    off, e = off + l, e.right
+                else:
+                    break
+            else:
+                break
+        if isinstance(e, A.Binary) and e.op == "*":
+            for k, base in ((e.left, e.right), (e.right, e.left)):
+                kv = self._fold_const_int(k, self.local_ints)
+                if kv:
+                    return (self._par_key(base), abs(kv), off)
+        return (self._par_key(e), 1, off)
+
+    def _check_par_writes(self, ctx):
+        """Hai lần ghi khác chỉ số vào cùng mảng: a[i] và a[i + 1] trúng cùng ô
+        ở hai lần lặp liền nhau. Chỉ hợp lệ khi ở một vị trí chỉ số, hai biểu thức
+        cùng gốc, cùng bước k và có độ lệch bằng nhau (cùng ô trong một lần lặp)
+        hoặc khác nhau theo mod k (v[2 * i] / v[2 * i + 1])."""
+        def disjoint(f, g):
+            return f is not None and g is not None and f[:2] == g[:2] and \
+                (f[2] == g[2] or (f[2] - g[2]) % f[1] != 0)
+        for sites in ctx["write_sites"].values():
+            for j in range(1, len(sites)):
+                name, keys, forms, node = sites[j]
+                for _, keys0, forms0, _ in sites[:j]:
+                    if keys == keys0 or any(disjoint(f, g) for f, g in zip(forms, forms0)):
+                        continue
+                    self.err(f"'par for': ghi vào '{name}[...]' ở hai chỉ số khác "
+                             f"nhau theo biến lặp '{ctx['var']}' — hai lần lặp song "
+                             f"song có thể ghi trùng một ô (data race)", node)
+
+    @staticmethod
+    def _par_root(e):
+        """Ô nhớ -> (biến gốc, các chỉ số trên đường đi theo thứ tự ngoài vào)."""
+        indices = []
+        while not isinstance(e, A.Ident):
+            if isinstance(e, A.Index):
+                indices.append(e.index)
+                e = e.base
+            elif isinstance(e, A.FieldAccess):
+                e = e.base
+            elif isinstance(e, A.Unary) and e.op == "*":
+                e = e.operand
+            else:
+                return None, indices
+        return e, indices[::-1]
+
+    def _note_par_read(self, e: A.Index):
+        """Đọc phần tử a[...] trong thân 'par for': ghi nhận để đối chiếu với các
+        lần ghi vào cùng mảng khi đóng vòng lặp (_check_par_reads)."""
+        root, indices = self._par_root(e)
+        if root is None:
+            return
+        info = self.lookup(root.name)
+        if info is None:
+            return
+        idx = self.scope_index(root.name)
+        keys = tuple(self._par_key(ix) for ix in indices)
+        for ctx in self.par:
+            if idx < ctx["depth"]:
+                ctx["elem_reads"].append((info[2], root.name, keys, e))
+
+    def _check_par_reads(self, ctx):
+        """Mảng bắt từ ngoài vừa bị ghi theo biến lặp vừa bị đọc: chỉ được đọc
+        đúng ô mà chính lần lặp đó ghi. a[i] = a[i + 1] đọc ô mà lần lặp i + 1
+        đang ghi song song -> data race."""
+        for cname, name, keys, node in ctx["elem_reads"]:
+            writes = ctx["elem_writes"].get(cname)
+            if not writes:
+                continue
+            if any(keys[:len(w)] == w[:len(keys)] for w in writes):
+                continue
+            self.err(f"'par for': đọc '{name}[...]' ở chỉ số khác ô mà lần lặp ghi "
+                     f"(theo biến lặp '{ctx['var']}') — lần lặp khác đang ghi ô đó "
+                     f"song song (data race)", node)
+
+    def _check_par_write(self, tgt, node, op=None, method=None, addr=False):
+        """Ghi vào ô nhớ 'tgt' (op: toán tử gán; method: method tự sửa) trong thân
+        'par for'. Ô nhớ thuộc biến bắt từ ngoài (hoặc global) chỉ được ghi khi một
+        chỉ số trên đường tới nó phụ thuộc trực tiếp vào biến lặp — các lần lặp
+        song song khi đó chạm các ô khác nhau; còn lại là data race. addr: '&tgt'
+        — con trỏ cho phép ghi nên xét như một lần ghi."""
+        e, indices = self._par_root(tgt)
+        if e is None:
+            return              # rvalue (kết quả hàm...): không truy được biến gốc
+        info = self.lookup(e.name)
+        if info is None:
+            return
+        cname, idx = info[2], self.scope_index(e.name)
+        for ctx in reversed(self.par):
+            if cname in ctx["reduce"]:
+                red = ctx["reduce"][cname]
+                want = ("+=", "-=") if red == "sum" else ("=",)
+                if e is tgt and op is not None and op not in want:
+                    self.err(f"'par for': biến rút gọn '{e.name}' ({red}) chỉ được "
+                             f"cập nhật bằng {' / '.join(want)}", node)
+                return
+            if idx >= ctx["depth"]:
+                return          # khai báo trong thân: riêng mỗi lần lặp
+            if idx >= 0:
+                ctx["written"].add(cname)
+            if any(self._par_affine(ix, ctx) for ix in indices):
+                keys = tuple(self._par_key(ix) for ix in indices)
+                ctx["elem_writes"].setdefault(cname, []).append(keys)
+                forms = tuple(self._par_form(ix, ctx) for ix in indices)
+                ctx["write_sites"].setdefault(cname, []).append((e.name, keys, forms, node))
+                continue
+            what = (f"gọi method '{method}' sửa" if method
+                    else "lấy địa chỉ (&) của" if addr else "ghi vào")
+            if indices:
+                self.err(f"'par for': {what} '{e.name}[...]' với chỉ số không phụ "
+                         f"thuộc trực tiếp vào biến lặp '{ctx['var']}' (data race "
+                         f"giữa các lần lặp song song)", node)
+            self.err(f"'par for': {what} '{e.name}' dùng chung giữa các lần lặp "
+                     f"song song (data race) — dùng mệnh đề sum/min/max hoặc biến "
+                     f"khai báo trong thân vòng lặp", node)
 
     def check_foreach(self, st: A.ForEach):
         it_t = self.infer(st.iterable)
@@ -725,9 +1128,21 @@ class Checker:
         elif it_t.kind == "ptr" and it_t.elem is not None and it_t.elem.kind == "char":
             elem = T.CHAR
             st.iter_kind = "str"
+        elif it_t.kind == "vec" or (it_t.kind == "ptr" and it_t.elem is not None
+                                    and it_t.elem.kind == "vec"):
+            elem = it_t.elem if it_t.kind == "vec" else it_t.elem.elem
+            st.iter_kind = "vec"
+        elif it_t.kind == "bytes" or (it_t.kind == "ptr" and it_t.elem is not None
+                                      and it_t.elem.kind == "bytes"):
+            elem = T.U8                  # cùng dạng data/len với Vec
+            st.iter_kind = "vec"
+        elif it_t.kind == "map" or (it_t.kind == "ptr" and it_t.elem is not None
+                                    and it_t.elem.kind == "map"):
+            elem = it_t.key if it_t.kind == "map" else it_t.elem.key   # duyệt khoá
+            st.iter_kind = "map"
         else:
             self.err(
-                "chỉ có thể 'for x in ...' trên mảng tĩnh hoặc chuỗi "
+                "chỉ có thể 'for x in ...' trên mảng tĩnh, Vec, Map, bytes hoặc chuỗi "
                 "(con trỏ/[]T thiếu độ dài — hãy dùng vòng lặp theo chỉ số)", st)
             return
         if st.iter_kind == "array" and not isinstance(
@@ -803,10 +1218,16 @@ class Checker:
         st.has_default = has_default
 
     def check_assign(self, st: A.Assign):
+        self.await_top = st.value
         vt = self.infer(st.value)
         tgt = st.target
         tt = self.infer(tgt)
         self._check_lvalue_mutable(tgt, st)
+        if self.par:
+            self._check_par_write(tgt, st, op=st.op)
+        if st.op != "=" and (self._is_static_array(tt) or tt.kind == "vec"):
+            self._check_slice_assign(st, tt, vt)
+            return
         # C cấm gán cả mảng tĩnh bằng '=' (kiểu mảng không phải lvalue gán được).
         # Bắt sớm để báo lỗi rõ ràng thay vì rò lỗi C khó hiểu.
         if self._is_static_array(tt):
@@ -847,6 +1268,14 @@ class Checker:
                 continue
             if isinstance(e, A.Index):
                 bt = getattr(e.base, "gtype", None)
+                if bt is not None and bt.kind == "bytes":
+                    self.err("không thể ghi vào 'bytes' (lát cắt chỉ đọc — vùng "
+                             "map_file là PROT_READ)", stmt)
+                # m[i][j]: hàng m[i] là con trỏ nhưng ô nhớ thuộc Mat m -> xét m
+                if isinstance(e.base, A.Index) and getattr(
+                        e.base.base, "gtype", T.UNKNOWN).kind == "mat":
+                    e = e.base
+                    continue
                 # index qua con trỏ / chuỗi / mảng động (đều là con trỏ heap) -> cho phép
                 if bt is not None and (bt.kind in ("ptr", "str")
                                        or self._is_dyn_array(bt)):
@@ -967,18 +1396,28 @@ class Checker:
             return T.array_of(elem, len(e.elements))
         if isinstance(e, A.StructLit):
             return self.infer_struct_lit(e)
+        if isinstance(e, A.Await):
+            return self.infer_await(e)
         return T.UNKNOWN
 
     def infer_ident(self, e: A.Ident):
         info = self.lookup(e.name)
         if info is not None:
             e.c_name = info[2]
+            # biến cục bộ (kể cả tham số) hay global — comptime cần phân biệt
+            e.is_local = any(e.name in s for s in self.scopes)
+            if self.par and e.is_local:
+                # biến khai báo ngoài thân một 'par for' -> thân bắt (capture) nó
+                idx = self.scope_index(e.name)
+                for ctx in self.par:
+                    if idx < ctx["depth"]:
+                        ctx["captures"].setdefault(info[2], (info[0], info[1]))
             return info[0]
         if e.name in self.enum_of_variant:
             return T.GType("enum", name=self.enum_of_variant[e.name])
         if e.name in self.funcs:
             return self.funcs[e.name]
-        if e.name in BUILTINS:
+        if e.name in BUILTINS or e.name in SLICE_BUILTINS:
             return T.UNKNOWN
         if e.name in T.PRIMITIVES or e.name in self.structs or e.name in self.enums:
             return T.UNKNOWN  # tên kiểu dùng làm giá trị (vd trong g_alloc)
@@ -1057,6 +1496,10 @@ class Checker:
         if e.op == "!":
             return T.BOOL
         if e.op == "&":
+            if self.par:
+                # &x của biến bắt: thân phải thấy đúng biến gốc, không phải bản sao;
+                # con trỏ ghi được nên chỉ hợp lệ khi trỏ vào ô riêng của lần lặp
+                self._check_par_write(e.operand, e, addr=True)
             return T.ptr_of(ot)
         if e.op == "*":
             if ot.kind == "ptr":
@@ -1069,22 +1512,37 @@ class Checker:
         return ot  # - , ~
 
     def infer_index(self, e: A.Index):
+        if self.par and isinstance(e.base, A.Index):
+            e.base.par_inner = True     # a[i][j]: chỉ ghi nhận lần đọc ngoài cùng
         bt = self.infer(e.base)
         it = self.infer(e.index)
+        if self.par and not getattr(e, "par_inner", False):
+            self._note_par_read(e)
         if not it.is_integer() and it.kind != "unknown":
             self.err(f"chỉ số mảng phải là số nguyên, nhận '{self.tyname(it)}'", e)
-        if bt.kind in ("array", "ptr"):
+        if bt.kind in ("array", "ptr", "vec"):
             return bt.elem
+        if bt.kind == "bytes":
+            return T.U8
+        if bt.kind == "mat":
+            return T.ptr_of(bt.elem)     # m[i] là hàng i; m[i][j] là phần tử
         if bt.kind == "str":
             return T.CHAR
         if bt.kind == "unknown":
             return T.UNKNOWN
         self.err(f"không thể lập chỉ số trên '{self.tyname(bt)}' "
-                 f"(chỉ mảng, con trỏ hoặc chuỗi)", e)
+                 f"(chỉ mảng, Vec, con trỏ hoặc chuỗi)", e)
 
     def infer_field(self, e: A.FieldAccess):
         bt = self.infer(e.base)
         e.auto_deref = (bt.kind == "ptr")
+        ct = self._container(bt)
+        if ct is not None:
+            how = {"vec": "len(v), v[i]", "map": "len(m)",
+                   "mat": "m.rows(), m[i][j]"}[ct.kind]
+            self.err(f"'{self.tyname(ct)}' không có trường '{e.field}' — dùng "
+                     f"{how} hoặc các method "
+                     f"{', '.join(CONTAINER_METHODS[ct.kind])}", e)
         sname = None
         if bt.kind == "struct":
             sname = bt.name
@@ -1127,17 +1585,18 @@ class Checker:
             seen.add(fname)
         return T.GType("struct", name=e.name)
 
-    def _require_mutable_receiver(self, recv, sname, mname, node):
+    def _require_mutable_receiver(self, recv, sname, mname, node, what=None):
         """Đối tượng nhận của một method-tự-sửa phải khả biến. Lần ngược về biến
         gốc; chỉ chặn khi chắc chắn bất biến (biến 'let'). Qua con trỏ -> bỏ qua."""
+        what = what or f"method '{sname}.{mname}' (sửa đổi đối tượng)"
         e = recv
         while True:
             if isinstance(e, A.Ident):
                 info = self.lookup(e.name)
                 if info is not None and not info[1]:
                     self.err(
-                        f"không thể gọi method '{sname}.{mname}' (sửa đổi đối "
-                        f"tượng) trên '{e.name}' bất biến — dùng 'let mut'", node)
+                        f"không thể gọi {what} trên '{e.name}' bất biến — "
+                        f"dùng 'let mut'", node)
                 return
             if isinstance(e, A.FieldAccess):
                 bt = getattr(e.base, "gtype", None)
@@ -1164,6 +1623,8 @@ class Checker:
             bt = self.infer(recv)
             sname = bt.name if bt.kind == "struct" else (
                 bt.elem.name if bt.kind == "ptr" and bt.elem and bt.elem.kind == "struct" else None)
+            if self._container(bt) is not None:
+                return self._infer_container_method(e, recv, mname, bt)
             if sname and sname in self.methods and mname in self.methods[sname]:
                 e.is_method = True
                 e.recv = recv
@@ -1175,6 +1636,8 @@ class Checker:
                 # con trỏ). Qua con trỏ thì luôn cho phép (đã chủ ý mượn để ghi).
                 if not e.recv_is_ptr and self.method_mutates_self(sname, mname):
                     self._require_mutable_receiver(recv, sname, mname, e)
+                if self.par and self.method_mutates_self(sname, mname):
+                    self._check_par_write(recv, e, method=f"{sname}.{mname}")
                 arg_types = [self.infer(a) for a in e.args]
                 m = self.methods[sname][mname]
                 want = max(0, len(m.params) - 1)  # trừ 'self'
@@ -1191,7 +1654,14 @@ class Checker:
                 return self.resolve(m.ret)
         # ----- builtin -----
         if isinstance(e.func, A.Ident) and e.func.name in BUILTINS:
+            if self.par and e.func.name in PAR_UNSAFE_BUILTINS:
+                self.err(f"'{e.func.name}' không dùng được trong thân 'par for' "
+                         f"(bộ đệm stdout dùng chung) — gom kết quả rồi in sau "
+                         f"vòng lặp", e)
             return self.infer_builtin(e)
+        if isinstance(e.func, A.Ident) and e.func.name in SLICE_BUILTINS \
+                and not self._slice_shadowed(e.func.name):
+            return self._infer_slice(e, e.func.name)
         # ----- gọi định danh không phải hàm? (biến thường) -----
         if isinstance(e.func, A.Ident):
             nm = e.func.name
@@ -1205,6 +1675,11 @@ class Checker:
         ft = self.infer(e.func)
         arg_types = [self.infer(a) for a in e.args]
         if isinstance(e.func, A.Ident) and e.func.name in self.funcs:
+            fn = self.func_defs[e.func.name]
+            if fn.is_async and not (getattr(e, "await_kind", None)
+                                    or getattr(e, "spawned", False)):
+                self.err(f"hàm async '{fn.name}' chỉ gọi được qua 'await {fn.name}(...)' "
+                         f"(trong async fn) hoặc spawn({fn.name}(...))", e)
             fdef = self.funcs[e.func.name]
             if len(e.args) != len(fdef.params):
                 self.err(
@@ -1220,10 +1695,292 @@ class Checker:
             return ft.ret
         return T.UNKNOWN
 
+    # ---------- async / await ----------
+    def infer_await(self, e: A.Await):
+        """'await f(x)' chỉ đứng đầu vế phải của let/gán/return hoặc làm cả câu
+        lệnh: điểm dừng của máy trạng thái khi đó nằm giữa hai câu lệnh, không có
+        giá trị tạm nào của biểu thức phải cất qua lúc dừng."""
+        top, self.await_top = self.await_top, None
+        if self.cur_async is None:
+            self.err("'await' chỉ dùng được trong 'async fn'", e)
+        if e is not top:
+            self.err("'await' phải đứng đầu vế phải của let/gán/return hoặc là cả "
+                     "câu lệnh — tách ra: 'let x = await f(...)'", e)
+        if self.par:
+            self.err("'await' không dùng được trong thân 'par for'", e)
+        if self.no_await:
+            self.err(f"'await' không dùng được trong {self.no_await[-1]} của hàm async "
+                     f"(chỉ trong if/while/loop/for theo khoảng)", e)
+        call = e.expr
+        name = (call.func.name if isinstance(call, A.Call)
+                and isinstance(call.func, A.Ident) else None)
+        fdef = self.func_defs.get(name)
+        if name in ASYNC_BUILTINS:
+            call.await_kind = "builtin"
+        elif fdef is not None and fdef.is_async:
+            call.await_kind = "fn"
+            self.async_edges[self.cur_async.name].setdefault(name, e)
+        else:
+            self.err("'await' cần lời gọi hàm async hoặc wait_readable/"
+                     "wait_writable/sleep_ms/yield_now", e)
+        return self.infer(call)
+
+    def async_order(self):
+        """Các async fn, hàm được await đứng trước hàm await nó: khung trạng thái
+        của hàm con nằm ngay trong khung của hàm cha. Await đệ quy (trực tiếp
+        hoặc vòng qua hàm khác) cho khung lớn vô hạn -> lỗi."""
+        order, state = [], {}
+
+        def visit(name, path):
+            if state.get(name) == 2:
+                return
+            if state.get(name) == 1:
+                cyc = path[path.index(name):] + [name]
+                self.cur_file = getattr(self.func_defs[path[-1]], "src_file", None)
+                self.err(f"hàm async '{name}' await chính nó ({' -> '.join(cyc)}): "
+                         f"khung trạng thái sẽ lớn vô hạn — tách lời gọi đệ quy "
+                         f"thành spawn(...)", self.async_edges[path[-1]][name])
+            state[name] = 1
+            for callee in self.async_edges[name]:
+                visit(callee, path + [name])
+            state[name] = 2
+            order.append(name)
+
+        for name in self.async_edges:
+            visit(name, [])
+        return order
+
+    @staticmethod
+    def _container(t: T.GType):
+        """Vec/Map/Mat (trực tiếp hoặc qua một con trỏ) -> kiểu đó; khác -> None."""
+        if t.kind == "ptr" and t.elem is not None:
+            t = t.elem
+        return t if t.kind in ("vec", "map", "mat") else None
+
+    def _infer_container_method(self, e: A.Call, recv, mname, bt: T.GType):
+        ct = self._container(bt)
+        table = CONTAINER_METHODS[ct.kind]
+        if mname not in table:
+            sug = suggest(mname, table)
+            msg = f"'{self.tyname(ct)}' không có method '{mname}'"
+            if sug:
+                msg += f" — có phải '{sug}'?"
+            self.err(msg, e)
+        e.builtin_method = mname
+        e.builtin_type = ct
+        e.recv = recv
+        e.recv_is_ptr = (bt.kind == "ptr")
+        # Method sửa header (len/cap/dữ liệu) -> cần 'let mut'; tra cứu thì không.
+        if not e.recv_is_ptr and mname not in CONTAINER_READONLY.get(ct.kind, ()):
+            self._require_mutable_receiver(recv, self.tyname(ct), mname, e)
+        if self.par and mname not in CONTAINER_READONLY.get(ct.kind, ()):
+            self._check_par_write(recv, e, method=mname)
+        arg_types = [self.infer(a) for a in e.args]
+        want, ret = table[mname]
+        if len(e.args) != len(want):
+            self.err(f"method '{mname}' của {ct.kind.capitalize()} cần {len(want)} "
+                     f"tham số nhưng nhận {len(e.args)}", e)
+        kinds = {"elem": ct.elem, "key": ct.key, "usize": T.USIZE, "self": ct}
+        for i, (at, pk) in enumerate(zip(arg_types, want)):
+            pt = kinds[pk]
+            if not self.assignable(pt, at) or (pk == "usize" and not at.is_integer()
+                                               and at.kind != "unknown"):
+                self.err(f"tham số {i + 1} của '{mname}' cần '{self.tyname(pt)}' "
+                         f"nhưng nhận '{self.tyname(at)}'", e)
+        return {"void": T.VOID, "elem": ct.elem, "bool": T.BOOL, "usize": T.USIZE,
+                "*elem": T.ptr_of(ct.elem), "self": ct}[ret]
+
+    def _infer_sort(self, e: A.Call, name):
+        """sort(xs) / sort(p, n), sort_by(xs, less) / sort_by(p, n, less).
+        xs: Vec[T], *Vec[T] hoặc [N]T; p: *T hoặc []T. Mỗi tổ hợp (T, less)
+        thành một bản pdqsort riêng (phép so sánh nội tuyến, không qua con trỏ hàm)."""
+        args = list(e.args)
+        less = None
+        if name == "sort_by":
+            if not args or not (isinstance(args[-1], A.Ident)
+                                and args[-1].name in self.funcs):
+                self.err("sort_by(xs, less): tham số cuối phải là tên hàm "
+                         "'fn(a: T, b: T) -> bool'", e)
+            less = args.pop().name
+        if len(args) not in (1, 2):
+            self.err(f"{name}() cần (xs) hoặc (con_trỏ, n)", e)
+        xt = self.infer(args[0])
+        ct = self._container(xt)
+        if len(args) == 2:
+            nt = self.infer(args[1])
+            if not nt.is_integer() and nt.kind != "unknown":
+                self.err(f"{name}(p, n): n phải là số nguyên, nhận '{self.tyname(nt)}'", e)
+            if not (xt.kind == "ptr" or self._is_dyn_array(xt)) or xt.elem is None \
+                    or ct is not None:
+                self.err(f"{name}(p, n) cần con trỏ *T hoặc []T, nhận "
+                         f"'{self.tyname(xt)}'", e)
+            elem, form = xt.elem, "ptr"
+        elif ct is not None and ct.kind == "vec":
+            elem, form = ct.elem, ("vecp" if xt.kind == "ptr" else "vec")
+        elif self._is_static_array(xt):
+            elem, form = xt.elem, "array"
+        else:
+            self.err(f"{name}() cần Vec, *Vec hoặc mảng tĩnh (hoặc {name}(p, n) "
+                     f"cho con trỏ), nhận '{self.tyname(xt)}'", e)
+        if form in ("vec", "array"):
+            self._require_mutable_receiver(args[0], None, None, e,
+                                           f"{name}() (sắp xếp tại chỗ)")
+        if less is not None:
+            f = self.funcs[less]
+            if (len(f.params) != 2 or f.ret.kind != "bool"
+                    or any(p != elem for p in f.params)):
+                self.err(f"hàm so sánh '{less}' phải có dạng 'fn(a: {self.tyname(elem)}, "
+                         f"b: {self.tyname(elem)}) -> bool' (a đứng trước b?)", e)
+            cname = f"g_sort_{T.mangle(elem)}__by_{less}"
+        else:
+            if elem.kind not in ("int", "char", "float", "bool", "enum", "ptr", "str"):
+                self.err(f"'{self.tyname(elem)}' không có thứ tự tự nhiên — dùng "
+                         f"sort_by(xs, less)", e)
+            cname = f"g_sort_{T.mangle(elem)}"
+        e.sort_fn = cname
+        e.sort_form = form
+        if all(cname != c for c, _, _ in self.sort_insts):
+            self.sort_insts.append((cname, elem, less))
+        return T.VOID
+
+    def _slice_shadowed(self, name) -> bool:
+        """Hàm 'sum'/'dot' tự định nghĩa che builtin trong file của nó và các file
+        nạp sau (module import được nạp trước file import nó) — std.g hay module
+        thư viện khác vẫn thấy builtin dù chương trình chính có 'fn sum' riêng."""
+        fn = self.func_defs.get(name)
+        if fn is None:
+            return False
+        order = getattr(self, "_file_order", None)
+        if order is None:
+            order = self._file_order = {}
+            for it in self.prog.items:
+                order.setdefault(getattr(it, "src_file", None), len(order))
+        return order.get(getattr(fn, "src_file", None), 0) <= order.get(self.cur_file, 0)
+
+    def _seq_form(self, xt: T.GType):
+        """Dạng một đối số dãy số -> (dạng, kiểu phần tử): "vec" (Vec[T]), "vecp"
+        (*Vec[T]), "array" ([N]T), "ptr" (*T / []T, độ dài truyền riêng); khác
+        -> (None, None)."""
+        ct = self._container(xt)
+        if ct is not None and ct.kind == "vec":
+            return ("vecp" if xt.kind == "ptr" else "vec"), ct.elem
+        if self._is_static_array(xt):
+            return "array", xt.elem
+        if (xt.kind == "ptr" or self._is_dyn_array(xt)) and xt.elem is not None \
+                and ct is None:
+            return "ptr", xt.elem
+        return None, None
+
+    def _slice_inst(self, elem: T.GType, op=None, c_op=None):
+        cname = T.mangle(elem)
+        _, ops = self.slice_insts.setdefault(cname, (elem, {}))
+        if op is not None:
+            ops[op] = c_op
+        return cname
+
+    def _infer_slice(self, e: A.Call, name):
+        """sum(xs), dot(xs, ys), min(xs), max(xs) — hoặc dạng con trỏ sum(p, n),
+        dot(p, q, n)... cho *T / []T. xs: [N]T, Vec[T], *Vec[T]; T là số nguyên
+        hoặc số thực. sum/dot trả tổng rộng 64 bit (T.slice_acc), min/max trả T."""
+        nseq = 2 if name == "dot" else 1
+        shape = "(xs, ys)" if nseq == 2 else "(xs)"
+        pshape = "(p, q, n)" if nseq == 2 else "(p, n)"
+        if len(e.args) not in (nseq, nseq + 1):
+            self.err(f"{name}{shape} hoặc {name}{pshape} — nhận {len(e.args)} "
+                     f"tham số", e)
+        ptr_form = len(e.args) == nseq + 1
+        forms, elem, sizes = [], None, []
+        for a in e.args[:nseq]:
+            xt = self.infer(a)
+            form, et = self._seq_form(xt)
+            if form is None or (form == "ptr") != ptr_form:
+                want = ("con trỏ *T hoặc []T" if ptr_form else
+                        "mảng tĩnh, Vec hoặc *Vec")
+                self.err(f"{name}{pshape if ptr_form else shape} cần {want}, nhận "
+                         f"'{self.tyname(xt)}'", a)
+            if et.kind not in ("int", "float"):
+                self.err(f"{name}() chỉ dùng cho dãy số nguyên/số thực, nhận phần tử "
+                         f"'{self.tyname(et)}'", a)
+            if elem is not None and et != elem:
+                self.err(f"{name}(): hai dãy khác kiểu phần tử ('{self.tyname(elem)}' "
+                         f"và '{self.tyname(et)}')", e)
+            elem = et
+            forms.append(form)
+            sizes.append(xt.n if form == "array" else None)
+        if sizes.count(None) == 0 and len(set(sizes)) > 1:
+            self.err(f"{name}(): hai mảng khác độ dài ({sizes[0]} và {sizes[1]})", e)
+        if ptr_form:
+            nt = self.infer(e.args[-1])
+            if not nt.is_integer() and nt.kind != "unknown":
+                self.err(f"{name}{pshape}: n phải là số nguyên, nhận "
+                         f"'{self.tyname(nt)}'", e)
+        e.slice_op = name
+        e.slice_forms = forms
+        e.slice_fn = f"g_slice_{name}_{self._slice_inst(elem)}"
+        return T.slice_acc(elem) if name in ("sum", "dot") else elem
+
+    def _check_mat_lit(self, st: A.Let, gt: T.GType):
+        """'let m: Mat[T] = [[a, b], [c, d]]' — mọi hàng là literal cùng độ dài,
+        phần tử gán được cho T. Ghi cỡ (hàng, cột) cho codegen."""
+        rows = st.value.elements
+        if not rows or not all(isinstance(r, A.ArrayLit) for r in rows):
+            self.err(f"'{st.name}: {self.tyname(gt)}' cần literal các hàng "
+                     f"'[[...], [...]]'", st)
+        cols = len(rows[0].elements)
+        for r in rows:
+            if len(r.elements) != cols:
+                self.err(f"các hàng của '{st.name}' phải cùng độ dài ({cols} và "
+                         f"{len(r.elements)})", st)
+            for el in r.elements:
+                et = getattr(el, "gtype", None)
+                if not self.assignable(gt.elem, et) or (
+                        gt.elem.kind == "int" and et is not None and et.kind == "float"):
+                    self.err(f"phần tử kiểu '{self.tyname(et)}' không đưa được "
+                             f"vào '{st.name}: {self.tyname(gt)}'", st)
+        st.value.mat_shape = (len(rows), cols)
+
+    def _check_slice_assign(self, st: A.Assign, tt: T.GType, vt: T.GType):
+        """xs op= ys (từng phần tử, cùng độ dài) hoặc xs op= k (k cho mọi phần
+        tử); xs là [N]T hoặc Vec[T]. '/=' chỉ cho số thực; '&=' '|=' '^=' chỉ
+        cho số nguyên ('%=', dịch bit: viết vòng for)."""
+        elem = tt.elem
+        if elem is None or elem.kind not in ("int", "float"):
+            self.err(f"'{st.op}' trên cả dãy chỉ dùng cho phần tử số nguyên/số thực, "
+                     f"nhận '{self.tyname(tt)}'", st)
+        op = SLICE_OPS.get(st.op)
+        if op is None or (op == "div" and elem.kind != "float") or (
+                op in ("and", "or", "xor") and elem.kind != "int"):
+            self.err(f"'{st.op}' không dùng được trên cả dãy '{self.tyname(tt)}' — "
+                     f"viết vòng for", st)
+        src_form, src_elem = self._seq_form(vt)
+        if src_form == "ptr":
+            self.err(f"vế phải của '{st.op}' trên dãy là con trỏ (không có độ dài) — "
+                     f"dùng mảng tĩnh/Vec", st)
+        if src_form is not None:
+            if src_elem != elem:
+                self.err(f"'{st.op}': hai dãy khác kiểu phần tử ('{self.tyname(elem)}' "
+                         f"và '{self.tyname(src_elem)}')", st)
+            if self._is_static_array(tt) and src_form == "array" and vt.n != tt.n:
+                self.err(f"'{st.op}': hai mảng khác độ dài ({tt.n} và {vt.n})", st)
+        elif (not vt.is_numeric() and vt.kind != "unknown") or (
+                elem.kind == "int" and vt.kind == "float"):
+            self.err(f"'{st.op}' trên dãy '{self.tyname(tt)}' cần dãy cùng kiểu hoặc "
+                     f"một số '{self.tyname(elem)}', nhận '{self.tyname(vt)}'", st)
+        c_op = st.op[:-1]
+        st.slice_fn = (f"g_slice_{op}{'' if src_form else 'k'}_"
+                       f"{self._slice_inst(elem, op, c_op)}")
+        st.slice_forms = ["vec" if tt.kind == "vec" else "array", src_form]
+
     def _check_fmt_spec(self, key, at: T.GType, node):
         """Kiểm tra một specifier tường minh có khớp kiểu đối số không.
         '{}'/'{v}' tự suy luận nên luôn hợp lệ; bool dùng '{}' hoặc '{b}'.
         Bỏ phần ':flags' (width/precision) trước khi kiểm tra kiểu."""
+        if at.kind == "bytes":
+            # in theo độ dài (không có '\0' kết thúc): chỉ '{}' / '{s}', không flags
+            if key not in ("", "v", "s"):
+                self.err(f"placeholder '{{{key}}}' không dùng được cho 'bytes' — "
+                         f"dùng '{{}}' hoặc '{{s}}'", node)
+            return
         key = key.split(":", 1)[0]
         if at.kind == "unknown":
             return
@@ -1292,6 +2049,9 @@ class Checker:
                 self.infer(a)
             return self.infer(e.args[0]) if e.args else T.ptr_of(T.VOID)
         if name in ("min", "max"):
+            if len(e.args) == 1 or (len(e.args) == 2 and self._seq_form(
+                    self.infer(e.args[0]))[0] == "ptr"):
+                return self._infer_slice(e, name)
             if len(e.args) != 2:
                 self.err(f"{name}(a, b) cần đúng 2 tham số", e)
             a = self.infer(e.args[0]) if e.args else T.INT
@@ -1311,19 +2071,28 @@ class Checker:
                 self.err("len(x) cần đúng 1 tham số", e)
             if e.args:
                 at = self.infer(e.args[0])
+                # strbuf/bytes (kể cả qua con trỏ) lưu sẵn độ dài -> O(1), không strlen.
+                if at.kind in ("strbuf", "bytes", "vec", "map") or (
+                        at.kind == "ptr" and at.elem is not None
+                        and at.elem.kind in ("strbuf", "bytes", "vec", "map")):
+                    return T.USIZE
                 if self._is_dyn_array(at) or at.kind == "ptr":
                     self.err(
                         "len() không dùng được cho con trỏ/[]T (không lưu độ dài) — "
                         "hãy theo dõi độ dài riêng", e)
                 elif at.kind not in ("array", "str") and at.kind != "unknown":
                     self.err(
-                        f"len() cần mảng tĩnh hoặc chuỗi, nhận '{self.tyname(at)}'", e)
+                        f"len() cần mảng tĩnh, Vec, Map, chuỗi, strbuf hoặc bytes, nhận "
+                        f"'{self.tyname(at)}'", e)
             return T.USIZE
         if name in ("print", "println", "eprint", "eprintln"):
             arg_ts = [self.infer(a) for a in e.args]
             value_ts = arg_ts[1:] if (e.args and isinstance(e.args[0], A.StrLit)) else arg_ts
             for at in value_ts:
-                if at.kind in ("struct", "void") or self._is_static_array(at):
+                if at.kind == "strbuf":
+                    self.err("không thể in trực tiếp 'strbuf' — dùng sb_str(&b)", e)
+                if at.kind in ("struct", "vec", "map", "mat", "reader", "void") or \
+                        self._is_static_array(at):
                     self.err(
                         f"không thể in trực tiếp giá trị kiểu '{self.tyname(at)}' "
                         f"(in từng trường/phần tử)", e)
@@ -1339,6 +2108,36 @@ class Checker:
                 for key, at in zip(keys, value_ts):
                     self._check_fmt_spec(key, at, e)
             return T.VOID
+        if name in ("sort", "sort_by"):
+            return self._infer_sort(e, name)
+        if name == "spawn":
+            if self.par:
+                self.err("'spawn' không dùng được trong thân 'par for' (executor "
+                         "async chạy trên một luồng)", e)
+            arg = e.args[0] if len(e.args) == 1 else None
+            fdef = (self.func_defs.get(arg.func.name) if isinstance(arg, A.Call)
+                    and isinstance(arg.func, A.Ident) else None)
+            if fdef is None or not fdef.is_async:
+                self.err("spawn(f(...)) cần đúng một lời gọi hàm async", e)
+            arg.spawned = True
+            self.infer(arg)
+            return T.VOID
+        if name in ASYNC_BUILTINS:
+            if not getattr(e, "await_kind", None):
+                self.err(f"'{name}' chỉ dùng được dạng 'await {name}(...)' trong "
+                         f"async fn", e)
+            want = ASYNC_BUILTINS[name]
+            if len(e.args) != want:
+                self.err(f"{name}() cần {want} tham số, nhận {len(e.args)}", e)
+            for a in e.args:
+                at = self.infer(a)
+                if not at.is_integer() and at.kind != "unknown":
+                    self.err(f"{name}() cần số nguyên, nhận '{self.tyname(at)}'", a)
+            return T.VOID
+        if name == "flush":
+            if e.args:
+                self.err("flush() không nhận tham số", e)
+            return T.VOID
         if name == "assert":
             if not e.args:
                 self.err("assert(cond[, msg]) cần ít nhất 1 tham số", e)
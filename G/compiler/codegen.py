@@ -8,8 +8,11 @@ Nơi 5 ngôn ngữ hội tụ:
 Tận dụng thông tin kiểu để: print tự chọn định dạng, auto-deref con trỏ, gọi method.
 """
 
+import math
+
 from . import ast_nodes as A
 from . import types as T
+from .comptime import returns_array, Comptime
 
 
 # Ánh xạ tên kiểu G -> C (cho khai báo theo cú pháp)
@@ -19,6 +22,7 @@ TYPE_MAP = {
     "usize": "size_t", "isize": "ptrdiff_t",
     "f32": "float", "f64": "double", "float": "float", "double": "double",
     "bool": "bool", "char": "char", "void": "void", "str": "const char*",
+    "strbuf": "g_string", "bytes": "g_bytes", "reader": "g_reader",
 }
 
 
@@ -36,7 +40,14 @@ class Codegen:
         self.enum_variants = set()   # mọi tên variant (là hằng số C hợp lệ)
         self.global_inits = []       # (tên, biểu_thức) cho global khởi tạo lúc chạy
         self.scope_stack = []   # ngăn xếp scope cho defer (LIFO, theo block)
+        self.fn_defs = {}       # tên hàm -> A.Function (nhận diện wrapper nối chuỗi)
         self._tmp = 0
+        self.cur_ret = None     # A.Type trả về của hàm đang sinh (cho return + defer)
+        self.par_defs = []      # thân 'par for' đã tách thành hàm, chèn trước hàm chứa nó
+        self.subst = {}         # tên C -> biểu thức thay thế: biến bắt của par for ('(*_gc->x)'),
+                                # biến trong khung của async fn ('_gf->x')
+        self.frame_vars = set() # async fn đang sinh: tên C các biến sống trong khung
+        self.cur_async = None   # A.Function async đang sinh (None = hàm thường)
 
     # ---------- tiện ích ----------
     def w(self, line=""):
@@ -48,7 +59,8 @@ class Codegen:
 
     def c_type(self, t: A.Type) -> str:
         """Kiểu cơ sở (gồm các mức con trỏ tường minh), KHÔNG gồm phần mảng."""
-        base = TYPE_MAP.get(t.name, t.name)
+        inst = getattr(t, "ginst", None)    # Vec/Map đã phân giải trong checker
+        base = T.c_type(inst) if inst is not None else TYPE_MAP.get(t.name, t.name)
         base += "*" * t.ptr
         return base
 
@@ -108,7 +120,8 @@ class Codegen:
         """Biểu thức có chứa lời gọi hàm/method (tác dụng phụ)? — quyết định
         có cần dùng statement-expression để tránh đánh giá hai lần hay không."""
         if isinstance(e, A.Call):
-            return True
+            # lời gọi comptime đã tính sẵn là literal: không có tác dụng phụ
+            return not hasattr(e, "const_value")
         if isinstance(e, A.Binary):
             return self._has_call(e.left) or self._has_call(e.right)
         if isinstance(e, A.Unary):
@@ -135,7 +148,7 @@ class Codegen:
         '&' của biến toàn cục... là hằng. Tham chiếu biến/global khác hoặc lời
         gọi hàm thì KHÔNG (C cấm 'initializer element is not constant')."""
         if isinstance(e, (A.IntLit, A.FloatLit, A.StrLit, A.CharLit, A.BoolLit,
-                          A.NullLit, A.SizeOf)):
+                          A.NullLit, A.SizeOf, A.Const)):
             return True
         if isinstance(e, A.Ident):
             # chỉ enum variant là hằng; biến/global khác thì không
@@ -154,8 +167,16 @@ class Codegen:
             return all(self._is_const_init(v) for _, v in e.fields)
         if isinstance(e, A.SizeOfExpr):
             return True
+        if isinstance(e, A.Call):
+            return hasattr(e, "const_value")    # comptime đã gập thành literal
         return False
 
+    @staticmethod
+    def _folded_array(e) -> bool:
+        """Lời gọi 'comptime fn' trả về mảng đã tính sẵn — chỉ in được dưới dạng
+        initializer { ... } (khai báo) hoặc compound literal (biểu thức)."""
+        return isinstance(e, A.Call) and isinstance(getattr(e, "const_value", None), list)
+
     def gtype_of(self, e) -> T.GType:
         return getattr(e, "gtype", T.UNKNOWN)
 
@@ -170,7 +191,9 @@ class Codegen:
 
         struct_defs = {}
         for it in self.prog.items:
-            if isinstance(it, A.StructDef):
+            if isinstance(it, A.Function):
+                self.fn_defs[it.name] = it
+            elif isinstance(it, A.StructDef):
                 self.struct_names.add(it.name)
                 struct_defs[it.name] = it
             elif isinstance(it, A.EnumDef):
@@ -191,30 +214,81 @@ class Codegen:
                     self.w(f"typedef struct {it.name} {it.name};")
             self.w("")
 
-        # 1c) Định nghĩa struct theo thứ tự topo: struct nhúng struct khác THEO
+        # 1c) Header của mỗi Vec/Map đơn hình hoá: chỉ chứa con trỏ nên đứng được
+        #     ngay sau khai báo tiến, trước mọi struct có thể nhúng nó theo giá trị.
+        #     checker liệt kê kiểu trong trước (Vec[Vec[int]] sau Vec[int]).
+        generic_types = getattr(self.prog, "generic_types", [])
+        for gt in generic_types:
+            self.w(self._generic_macro("TYPEDEF", gt))
+        if generic_types:
+            self.w("")
+
+        # 1d) Định nghĩa struct theo thứ tự topo: struct nhúng struct khác THEO
         #     GIÁ TRỊ phải đứng sau struct đó (trường con trỏ không tạo ràng buộc).
         for name in self._topo_sort_structs(struct_defs):
             self.gen_struct(struct_defs[name])
 
+        # 1e) Hàm của Vec/Map cần sizeof phần tử -> sau khi mọi struct đã đầy đủ.
+        for gt in generic_types:
+            self.w(self._generic_macro("IMPL", gt))
+        if generic_types:
+            self.w("")
+
+        # 1f) Khung trạng thái của mỗi async fn (hàm con đứng trước — checker đã
+        #     sắp): tác vụ không có stack riêng, mọi biến sống qua 'await' nằm ở đây.
+        for name in getattr(self.prog, "async_fns", []):
+            self.gen_async_frame(self.fn_defs[name])
+
         # 2) biến toàn cục
         for it in self.prog.items:
             if isinstance(it, A.GlobalVar):
                 self.gen_global(it)
         self.w("")
 
-        # 3) nguyên mẫu hàm + method
+        # 3) nguyên mẫu hàm + method ('comptime fn' trả mảng chỉ sống lúc biên
+        #    dịch: mọi lời gọi đã gập thành initializer, không có bản C)
         for it in self.prog.items:
             if isinstance(it, A.Function):
-                self.w(self.fn_signature(it) + ";")
+                if it.is_async:
+                    self.w(f"static inline bool _gaf_{it.name}_poll(void* _gv);")
+                elif not (it.is_comptime and returns_array(it)):
+                    self.w(self.fn_signature(it) + ";")
             elif isinstance(it, A.Impl):
                 for m in it.methods:
                     self.w(self.fn_signature(m) + ";")
         self.w("")
 
+        # 3b) pdqsort đơn hình hoá cho mỗi (kiểu phần tử, hàm so sánh) của
+        #     sort/sort_by — sau nguyên mẫu vì 'less' có thể là hàm người dùng.
+        sort_insts = getattr(self.prog, "sort_insts", [])
+        for cname, elem, less in sort_insts:
+            if less is None:
+                less = ("g_less_str" if elem.kind == "str" else
+                        ("g_less_f32" if T.c_type(elem) == "float" else "g_less_f64")
+                        if elem.kind == "float" else "g_less")
+            self.w(f"G_SORT_DEFINE({cname}, {T.c_type(elem)}, {less})")
+        if sort_insts:
+            self.w("")
+
+        # 3c) nhân dãy số (sum/dot/min/max + phép từng phần tử đã dùng) cho mỗi
+        #     kiểu phần tử — SIMD chọn lúc chạy trong runtime.
+        slice_insts = getattr(self.prog, "slice_insts", {})
+        for cname, (elem, ops) in slice_insts.items():
+            ct = T.c_type(elem)
+            self.w(f"G_SLICE_DEFINE({cname}, {ct}, {T.c_type(T.slice_acc(elem))}, "
+                   f"{T.slice_mask_c(elem)})")
+            for op, c_op in ops.items():
+                self.w(f"G_SLICE_OP({cname}, {ct}, {op}, {c_op})")
+        if slice_insts:
+            self.w("")
+
         # 4) định nghĩa hàm + method
         for it in self.prog.items:
             if isinstance(it, A.Function):
-                if it.body is not None:
+                if it.is_async:
+                    self.gen_async_fn(it)
+                    self.w("")
+                elif it.body is not None and not (it.is_comptime and returns_array(it)):
                     self.gen_fn(it)
                     self.w("")
             elif isinstance(it, A.Impl):
@@ -230,6 +304,23 @@ class Codegen:
 
         return "\n".join(self.out)
 
+    @staticmethod
+    def _generic_macro(what, gt: T.GType) -> str:
+        """G_VEC_TYPEDEF(g_vec_int, int) / G_MAP_IMPL(g_map_str__int, const char*,
+        int, g_hash_str, g_key_eq_str)... — một bản cho mỗi tổ hợp kiểu."""
+        args = [T.c_type(gt)]
+        if gt.kind == "map":
+            args.append(T.c_type(gt.key))
+        args.append(T.c_type(gt.elem))
+        if gt.kind == "map" and what == "IMPL":
+            if gt.key.kind == "str":
+                args += ["g_hash_str", "g_key_eq_str"]
+            elif gt.key.kind == "ptr":
+                args += ["g_hash_ptr", "g_key_eq"]
+            else:
+                args += ["g_hash_int", "g_key_eq"]
+        return f"G_{gt.kind.upper()}_{what}({', '.join(args)})"
+
     def emit_global_init_ctor(self):
         if not self.global_inits:
             return
@@ -310,6 +401,8 @@ class Codegen:
         if const_init:
             if isinstance(g.value, A.ArrayLit):
                 init = self.gen_array_init(g.value)
+            elif self._folded_array(g.value):
+                init = self.gen_const(g.value.const_value, self.gtype_of(g.value))
             else:
                 init = self.gen_expr(g.value) if g.value is not None else None
             self.w("static " + self.c_decl(g.name, decl_type, init,
@@ -349,8 +442,10 @@ class Codegen:
         return f"{qual}{ret} {self.mangle(fn)}({params})"
 
     def gen_fn(self, fn: A.Function):
+        start = len(self.out)
         self.w(self.fn_signature(fn) + " {")
         self.scope_stack = []
+        self.cur_ret = fn.ret
         self.gen_scoped_body(fn.body, is_loop=False)
         # Hàm non-void mà checker đã chứng minh luôn-trả-về nhưng câu lệnh cuối
         # không phải 'return' tường minh (vd match enum vét cạn / if-else-diverge):
@@ -362,12 +457,174 @@ class Codegen:
             self.w("__builtin_unreachable();")
             self.indent -= 1
         self.w("}")
+        if self.par_defs:
+            self.out[start:start] = self.par_defs
+            self.par_defs = []
+
+    # ---------- async fn: máy trạng thái không stack ----------
+    _AIO_WAIT = {"wait_readable": "g_aio_wait_fd({}, G_AIO_IN)",
+                 "wait_writable": "g_aio_wait_fd({}, G_AIO_OUT)",
+                 "sleep_ms": "g_aio_sleep((int64_t)({}))",
+                 "yield_now": "g_aio_yield()"}
+
+    @staticmethod
+    def _await_of(st):
+        """'await' ở đầu câu lệnh (checker chỉ cho phép ở đó), hoặc None."""
+        v = (st.value if isinstance(st, (A.Let, A.Assign, A.Return))
+             else st.expr if isinstance(st, A.ExprStmt) else None)
+        return v if isinstance(v, A.Await) else None
+
+    def _let_field(self, st: A.Let, name) -> str:
+        """Trường khung cho một 'let' — cùng kiểu gen_let sẽ khai báo."""
+        ty = self._let_type(st)
+        if ty is not None:
+            return self.c_decl(name, ty)
+        gt = getattr(st, "resolved_type", None) or self.gtype_of(st.value)
+        if st.value is None or gt.kind == "unknown":
+            return f"int {name}"
+        if gt.kind == "array":       # __auto_type x = arr: phân rã thành con trỏ
+            return self.c_decl(name, self._gtype_to_ctype_decl(gt), decay_first=True)
+        return f"{T.c_type(gt)} {name}"
+
+    def _let_type(self, st: A.Let):
+        gt = getattr(st, "resolved_type", None)
+        if isinstance(st.value, A.ArrayLit) and not (
+                gt is not None and gt.kind in ("vec", "map", "mat")):
+            if st.type is not None:
+                return self._array_type_with_inferred_dims(st.type, st.value)
+            return self._gtype_to_ctype_decl(self.gtype_of(st.value))
+        if st.type is None and self._folded_array(st.value):
+            return self._gtype_to_ctype_decl(self.gtype_of(st.value))
+        return st.type
+
+    def _async_layout(self, fn: A.Function):
+        """Duyệt thân async fn: tham số, biến của let/for và biến tạm giữ cận của
+        for thành trường khung; mỗi 'await' nhận một số trạng thái. Thân của
+        match/for-in/region/defer/par for không chứa 'await' nên biến trong đó
+        vẫn là biến C thường (không sống qua điểm dừng)."""
+        fields = [self.c_decl(p.name, p.type, decay_first=True) for p in fn.params]
+        names = {p.name for p in fn.params}
+        subs = []
+        n = 0
+
+        def walk(body):
+            nonlocal n
+            for st in body:
+                aw = self._await_of(st)
+                if aw is not None:
+                    n += 1
+                    aw.state = n
+                    if aw.expr.await_kind == "fn":
+                        subs.append(f"struct _gaf_{aw.expr.func.name} a{n};")
+                if isinstance(st, A.Let):
+                    name = getattr(st, "c_name", "") or st.name
+                    fields.append(self._let_field(st, name))
+                    names.add(name)
+                elif isinstance(st, A.For) and not st.par:
+                    v = getattr(st, "c_name", "") or st.var
+                    vt = getattr(st, "var_type", None)
+                    ctype = T.c_type(vt) if vt is not None else "long"
+                    st.frame_tmps = (self.tmp("_gend"), self.tmp("_gstep"))
+                    fields.append(f"{ctype} {v}, {st.frame_tmps[0]}, {st.frame_tmps[1]}")
+                    names.add(v)
+                    walk(st.body)
+                elif isinstance(st, A.If):
+                    walk(st.then)
+                    walk(st.els or [])
+                elif isinstance(st, (A.While, A.Loop, A.Block)):
+                    walk(st.body)
+
+        walk(fn.body)
+        fn.async_fields, fn.async_subs, fn.async_vars, fn.async_states = fields, subs, names, n
+
+    def gen_async_frame(self, fn: A.Function):
+        """struct _gaf_f { trạng thái, kết quả, tham số, biến cục bộ, khung hàm con
+        đang await (union: mỗi lúc chỉ chờ một) } + _gaf_f_start(khung, tham số)."""
+        self._async_layout(fn)
+        name = fn.name
+        self.w(f"struct _gaf_{name} {{")
+        self.indent += 1
+        self.w("int _gst;")
+        if fn.ret.name != "void" or fn.ret.ptr:
+            self.w(self.c_decl("_gret", fn.ret) + ";")
+        for d in fn.async_fields:
+            self.w(d + ";")
+        if fn.async_subs:
+            self.w("union {")
+            self.indent += 1
+            for d in fn.async_subs:
+                self.w(d)
+            self.indent -= 1
+            self.w("} _gsub;")
+        self.indent -= 1
+        self.w("};")
+        params = [f"struct _gaf_{name}* _gf"] + [
+            self.c_decl(p.name, p.type, decay_first=True) for p in fn.params]
+        self.w(f"static inline struct _gaf_{name}* _gaf_{name}_start({', '.join(params)}) {{")
+        self.indent += 1
+        self.w("_gf->_gst = 0;")
+        for p in fn.params:
+            self.w(f"_gf->{p.name} = {p.name};")
+        self.w("return _gf;")
+        self.indent -= 1
+        self.w("}")
+        self.w("")
+
+    def gen_async_fn(self, fn: A.Function):
+        """Hàm poll: chạy tiếp từ điểm dừng lưu trong khung; trả true khi xong
+        (kết quả ở _gf->_gret), false khi đang chờ (executor sẽ poll lại)."""
+        start = len(self.out)
+        name = fn.name
+        self.w(f"static inline bool _gaf_{name}_poll(void* _gv) {{")
+        self.indent += 1
+        self.w(f"struct _gaf_{name}* _gf = (struct _gaf_{name}*)_gv;")
+        if fn.async_states:
+            self.w("switch (_gf->_gst) {")
+            for k in range(1, fn.async_states + 1):
+                self.w(f"case {k}: goto _gaw{k};")
+            self.w("}")
+        self.indent -= 1
+        self.scope_stack = []
+        self.cur_ret = fn.ret
+        self.cur_async = fn
+        self.frame_vars = fn.async_vars
+        self.subst = {c: f"_gf->{c}" for c in fn.async_vars}
+        self.gen_scoped_body(fn.body, is_loop=False)
+        if not (fn.body and isinstance(fn.body[-1], A.Return)):
+            self.indent += 1
+            self.w("return true;")
+            self.indent -= 1
+        self.w("}")
+        self.cur_async, self.frame_vars, self.subst = None, set(), {}
+        if self.par_defs:
+            self.out[start:start] = self.par_defs
+            self.par_defs = []
+
+    def gen_await(self, aw: A.Await):
+        """Điểm dừng N: khởi động hàm con trong _gsub (hoặc đăng ký chờ fd/giờ/
+        lượt sau với executor), lưu N rồi trả quyền; lần poll sau nhảy về _gawN."""
+        call, k = aw.expr, aw.state
+        name = call.func.name
+        args = [self.gen_expr(a) for a in call.args]
+        if call.await_kind == "fn":
+            sub = f"_gf->_gsub.a{k}"
+            self.w(f"_gaf_{name}_start({', '.join([f'&{sub}'] + args)});")
+            self.w(f"_gf->_gst = {k};")
+            self.w(f"_gaw{k}:")
+            self.w(f"if (!_gaf_{name}_poll(&{sub})) return false;")
+            aw.result_c = f"{sub}._gret"
+        else:
+            self.w(self._AIO_WAIT[name].format(*args) + ";")
+            self.w(f"_gf->_gst = {k};")
+            self.w("return false;")
+            self.w(f"_gaw{k}: ;")
 
     # ---------- quản lý scope & defer (kiểu Zig, theo block, LIFO) ----------
-    def gen_scoped_body(self, body, is_loop=False, prologue=None):
+    def gen_scoped_body(self, body, is_loop=False, prologue=None, defers=None):
         """Sinh thân một block: mở scope defer, (tuỳ chọn) prologue, các lệnh,
-        rồi xả defer của scope này (nếu block không kết thúc bằng return/break/continue)."""
-        frame = {"defers": [], "is_loop": is_loop}
+        rồi xả defer của scope này (nếu block không kết thúc bằng return/break/continue).
+        'defers': dòng C dọn dẹp đăng ký sẵn cho scope (chạy sau mọi defer của người dùng)."""
+        frame = {"defers": list(defers or []), "is_loop": is_loop}
         self.scope_stack.append(frame)
         self.indent += 1
         if prologue:
@@ -382,7 +639,10 @@ class Codegen:
 
     def _flush_frame(self, frame):
         for d in reversed(frame["defers"]):
-            self.gen_stmt(d)
+            if isinstance(d, str):
+                self.w(d)           # dòng C do trình sinh mã tự đăng ký
+            else:
+                self.gen_stmt(d)
 
     def _emit_exit_defers(self, kind):
         """Xả defer khi rời hàm/vòng lặp: return xả mọi scope; break/continue
@@ -394,13 +654,32 @@ class Codegen:
 
     # ---------- câu lệnh ----------
     def gen_stmt(self, st):
+        if self.cur_async is not None:
+            aw = self._await_of(st)
+            if aw is not None:
+                self.gen_await(aw)     # câu lệnh sau đó đọc kết quả từ khung
+                if isinstance(st, A.ExprStmt):
+                    return
         if isinstance(st, A.Let):
             self.gen_let(st)
-        elif isinstance(st, A.Return):
-            self._emit_exit_defers("return")
+        elif isinstance(st, A.Return) and self.cur_async is not None:
             if st.value is not None:
+                self.w(f"_gf->_gret = {self.gen_expr(st.value)};")
+            self._emit_exit_defers("return")
+            self.w("return true;")
+        elif isinstance(st, A.Return):
+            pending = any(f["defers"] for f in self.scope_stack)
+            if st.value is not None and pending:
+                # Giá trị trả về được tính TRƯỚC khi chạy defer (như Zig): defer
+                # hay rời region có thể giải phóng thứ mà biểu thức còn đọc.
+                ret = self.tmp("_gret")
+                self.w(self.c_decl(ret, self.cur_ret, self.gen_expr(st.value)) + ";")
+                self._emit_exit_defers("return")
+                self.w(f"return {ret};")
+            elif st.value is not None:
                 self.w(f"return {self.gen_expr(st.value)};")
             else:
+                self._emit_exit_defers("return")
                 self.w("return;")
         elif isinstance(st, A.If):
             self.gen_if(st)
@@ -422,6 +701,15 @@ class Codegen:
             self.w("{")
             self.gen_scoped_body(st.body, is_loop=False)
             self.w("}")
+        elif isinstance(st, A.Region):
+            # Lưu mốc arena khi vào; trả về mốc qua defer để mọi lối ra
+            # (cuối khối, return, break, continue) đều giải phóng region.
+            mark = self.tmp("_greg")
+            self.w("{")
+            self.gen_scoped_body(st.body, is_loop=False,
+                                 prologue=[f"g_arena_mark {mark} = g_region_enter();"],
+                                 defers=[f"g_region_leave({mark});"])
+            self.w("}")
         elif isinstance(st, A.Defer):
             # ghi nhận vào scope hiện tại; sẽ xả khi rời block (LIFO)
             self.scope_stack[-1]["defers"].append(st.stmt)
@@ -441,6 +729,8 @@ class Codegen:
             raise CodegenError(f"câu lệnh chưa hỗ trợ: {st}")
 
     def gen_assign(self, st: A.Assign):
+        if getattr(st, "slice_fn", None):
+            return self.gen_slice_assign(st)
         tgt_c = self.gen_expr(st.target)
         val_c = self.gen_expr(st.value)
         # '%=' trên số thực: C cấm '%' cho double -> viết lại bằng fmod(). Lượng
@@ -463,6 +753,14 @@ class Codegen:
     def gen_let(self, st: A.Let):
         const = not st.mutable
         name = getattr(st, "c_name", st.name)
+        if name in self.frame_vars:
+            return self._frame_let(st, name)
+        gt = getattr(st, "resolved_type", None)
+        if gt is not None and gt.kind in ("vec", "map", "mat") and st.type is not None and (
+                st.value is None or isinstance(st.value, A.ArrayLit)):
+            self.w(self.c_decl(name, st.type, self._container_init(gt, st.value),
+                               const=const) + ";")
+            return
         # ----- mảng literal (kể cả nhiều chiều): T name[..][..] = { ... } -----
         if isinstance(st.value, A.ArrayLit):
             init = self.gen_array_init(st.value)
@@ -474,8 +772,18 @@ class Codegen:
                 ty = self._gtype_to_ctype_decl(gt)
                 self.w(self.c_decl(name, ty, init, const=const) + ";")
             return
+        if self._folded_array(st.value):
+            gt = self.gtype_of(st.value)
+            ty = st.type if st.type is not None else self._gtype_to_ctype_decl(gt)
+            self.w(self.c_decl(name, ty, self.gen_const(st.value.const_value, gt),
+                               const=const) + ";")
+            return
 
         init_c = self.gen_expr(st.value) if st.value is not None else None
+        # strbuf không khởi tạo: giá trị toàn 0 chính là chuỗi rỗng hợp lệ.
+        if init_c is None and st.type is not None and st.type.name == "strbuf" \
+                and not st.type.ptr and not self._dims(st.type):
+            init_c = "(g_string){0}"
         if st.type is not None:
             self.w(self.c_decl(name, st.type, init_c, const=const) + ";")
         else:
@@ -485,6 +793,43 @@ class Codegen:
                 q = "const " if const else ""
                 self.w(f"{q}__auto_type {name} = {init_c};")
 
+    def _frame_let(self, st: A.Let, name):
+        """'let' trong async fn: biến đã là trường khung -> chỉ còn phép gán."""
+        tgt = self.subst[name]
+        gt = getattr(st, "resolved_type", None)
+        if gt is not None and gt.kind in ("vec", "map", "mat") and st.type is not None and (
+                st.value is None or isinstance(st.value, A.ArrayLit)):
+            self.w(f"{tgt} = {self._container_init(gt, st.value)};")
+        elif isinstance(st.value, A.ArrayLit) or self._folded_array(st.value):
+            ty = self._let_type(st)
+            init = (self.gen_array_init(st.value) if isinstance(st.value, A.ArrayLit)
+                    else self.gen_const(st.value.const_value, self.gtype_of(st.value)))
+            cast = self.c_decl("", ty).strip()
+            self.w(f"memcpy({tgt}, ({cast}){init}, sizeof({tgt}));")
+        elif st.value is not None:
+            self.w(f"{tgt} = {self.gen_expr(st.value)};")
+        elif st.type is not None and st.type.name == "strbuf" \
+                and not st.type.ptr and not self._dims(st.type):
+            self.w(f"{tgt} = (g_string){{0}};")
+
+    def _container_init(self, vt: T.GType, lit) -> str:
+        """Vec/Map/Mat rỗng là giá trị toàn 0; '[a, b, c]' chép một lần từ compound
+        literal (Mat: các hàng nối liền theo thứ tự hàng-trước). Vec/Map ghi lại
+        region đang mở lúc khai báo: chỉ khi đó nó mới tăng trưởng trên arena."""
+        vc = T.c_type(vt)
+        if lit is None or not lit.elements:
+            if vt.kind == "mat":
+                return f"({vc}){{0}}"
+            return f"({vc}){{ .region = g_region_current() }}"
+        if vt.kind == "mat":
+            rows, cols = lit.mat_shape
+            parts = ", ".join(self.gen_expr(x) for r in lit.elements for x in r.elements)
+            return (f"{vc}__from(({T.c_type(vt.elem)}[]){{ {parts} }}, "
+                    f"{rows}, {cols})")
+        parts = ", ".join(self.gen_expr(x) for x in lit.elements)
+        return (f"{vc}__from(({T.c_type(vt.elem)}[]){{ {parts} }}, "
+                f"{len(lit.elements)})")
+
     def gen_array_init(self, lit: A.ArrayLit) -> str:
         """Sinh initializer { ... } (đệ quy cho mảng lồng nhau)."""
         parts = []
@@ -524,6 +869,8 @@ class Codegen:
             ptr += 1
             base = base.elem
         name = base.name if base.name else base.kind
+        if base.kind in ("vec", "map", "mat"):
+            name = T.c_type(base)    # tên struct đơn hình hoá; TYPE_MAP để nguyên
         return A.Type(name, ptr=ptr, dims=dims or None,
                       array=(dims[0] if dims else None))
 
@@ -548,6 +895,8 @@ class Codegen:
             except ValueError:
                 return None
             return -1 if v < 0 else 1
+        if isinstance(e, A.Const):
+            return -1 if e.value < 0 else 1
         if isinstance(e, A.FloatLit):
             try:
                 return -1 if float(e.value) < 0 else 1
@@ -559,34 +908,42 @@ class Codegen:
         # Cận trên (và bước) được tính MỘT lần trước vòng lặp — đúng ngữ nghĩa
         # Rust ('a..b' lượng giá b một lần) và tránh gọi lại hàm/đọc lại biến mỗi
         # vòng. Bọc trong block C để các biến tạm chỉ sống trong phạm vi vòng lặp.
+        if st.par:
+            return self.gen_par_for(st)
         v = getattr(st, "c_name", "") or st.var
         vt = getattr(st, "var_type", None)
         ctype = T.c_type(vt) if vt is not None else "long"
+        # async fn: biến lặp, cận và bước sống trong khung (qua được 'await')
+        held = getattr(st, "frame_tmps", None) if self.cur_async is not None else None
+        if held is not None:
+            v = self.subst[v]
+        decl = f"{ctype} " if held is None else ""
+        auto = "__auto_type " if held is None else ""
         self.w("{")
         self.indent += 1
-        end = self.tmp("_gend")
+        end = self.tmp("_gend") if held is None else f"_gf->{held[0]}"
         start = self.gen_expr(st.start)
-        self.w(f"__auto_type {end} = ({self.gen_expr(st.end)});")
+        self.w(f"{auto}{end} = ({self.gen_expr(st.end)});")
         if st.step is None:
             cmp = "<=" if st.inclusive else "<"
-            self.w(f"for ({ctype} {v} = {start}; {v} {cmp} {end}; {v}++) {{")
+            self.w(f"for ({decl}{v} = {start}; {v} {cmp} {end}; {v}++) {{")
         else:
-            s = self.tmp("_gstep")
-            self.w(f"__auto_type {s} = ({self.gen_expr(st.step)});")
+            s = self.tmp("_gstep") if held is None else f"_gf->{held[1]}"
+            self.w(f"{auto}{s} = ({self.gen_expr(st.step)});")
             sign = self._static_sign(st.step)
             if sign == -1:
                 cmp = ">=" if st.inclusive else ">"
-                self.w(f"for ({ctype} {v} = {start}; {v} {cmp} {end}; "
+                self.w(f"for ({decl}{v} = {start}; {v} {cmp} {end}; "
                        f"{v} += {s}) {{")
             elif sign == 1:
                 cmp = "<=" if st.inclusive else "<"
-                self.w(f"for ({ctype} {v} = {start}; {v} {cmp} {end}; "
+                self.w(f"for ({decl}{v} = {start}; {v} {cmp} {end}; "
                        f"{v} += {s}) {{")
             else:
                 # Bước không rõ dấu lúc biên dịch: chọn chiều so sánh lúc chạy để
                 # vòng lặp đúng cho cả bước âm lẫn dương.
                 eq = "=" if st.inclusive else ""
-                self.w(f"for ({ctype} {v} = {start}; "
+                self.w(f"for ({decl}{v} = {start}; "
                        f"{s} >= 0 ? {v} <{eq} {end} : {v} >{eq} {end}; "
                        f"{v} += {s}) {{")
         self.gen_scoped_body(st.body, is_loop=True)
@@ -594,6 +951,108 @@ class Codegen:
         self.indent -= 1
         self.w("}")
 
+    # Giá trị khởi đầu của biến rút gọn riêng mỗi phần việc.
+    _PAR_IDENTITY = {
+        "min": {"i8": "G_I8_MAX", "i16": "G_I16_MAX", "i32": "G_I32_MAX",
+                "int": "G_I32_MAX", "i64": "G_I64_MAX", "isize": "G_I64_MAX",
+                "u8": "G_U8_MAX", "u16": "G_U16_MAX", "u32": "G_U32_MAX",
+                "u64": "G_U64_MAX", "usize": "SIZE_MAX"},
+        "max": {"i8": "G_I8_MIN", "i16": "G_I16_MIN", "i32": "G_I32_MIN",
+                "int": "G_I32_MIN", "i64": "G_I64_MIN", "isize": "G_I64_MIN"},
+    }
+
+    def _par_identity(self, op, gt: T.GType) -> str:
+        if op == "sum":
+            return "0"
+        if gt.kind == "float":
+            return "INFINITY" if op == "min" else "-INFINITY"
+        return self._PAR_IDENTITY[op].get(gt.name, "0")
+
+    def _par_field(self, name, gt: T.GType, by_ref) -> str:
+        """Trường của struct ngữ cảnh cho một biến bắt. Mảng đi bằng con trỏ đã
+        phân rã (ghi phần tử vẫn tới mảng gốc); biến bị ghi/lấy địa chỉ trong
+        thân đi bằng con trỏ; còn lại chép giá trị."""
+        if gt.kind == "array":
+            return self.c_decl(name, self._gtype_to_ctype_decl(gt), decay_first=True)
+        return f"{T.c_type(gt)}{'*' if by_ref else ''} {name}"
+
+    def gen_par_for(self, st: A.For):
+        """par for: thân vòng lặp tách thành hàm tĩnh fn(ctx, lo, hi) chạy các lần
+        lặp [lo, hi); biến bắt đi qua một struct ngữ cảnh trên stack của hàm gọi.
+        Runtime (g_par_for) chia [0, n) cho bể luồng rồi chờ tất cả xong."""
+        fn = self.tmp("_gpar")
+        v = getattr(st, "c_name", "") or st.var
+        ctype = T.c_type(st.var_type)
+        red = st.reduce_info
+        red_names = {c for _, c, _ in red}
+        caps = [(c, gt, c in st.by_ref and gt.kind != "array")
+                for c, (gt, _mut) in st.captures.items() if c not in red_names]
+
+        # --- hàm tách ra (sinh vào bộ đệm riêng, chèn trước hàm chứa nó) ---
+        saved = (self.out, self.indent, self.scope_stack, self.subst)
+        self.out, self.indent, self.scope_stack = [], 0, []
+        self.subst = {c: f"(*_gc->{c})" for c, _, ref in caps if ref}
+        self.w(f"struct {fn} {{")
+        self.indent += 1
+        self.w("int64_t _gstart, _gstep;")
+        for c, gt, ref in caps:
+            self.w(self._par_field(c, gt, ref) + ";")
+        for _, c, gt in red:
+            self.w(f"{T.c_type(gt)}* {c};")
+        self.indent -= 1
+        self.w("};")
+        self.w("")
+        self.w(f"static void {fn}(void* _gv, size_t _glo, size_t _ghi) {{")
+        self.indent += 1
+        self.w(f"struct {fn}* _gc = (struct {fn}*)_gv;")
+        for c, gt, ref in caps:
+            if gt.kind == "array":
+                self.w(self.c_decl(c, self._gtype_to_ctype_decl(gt), f"_gc->{c}",
+                                   decay_first=True) + ";")
+            elif not ref:
+                self.w(f"{T.c_type(gt)} const {c} = _gc->{c};")
+        for op, c, gt in red:
+            self.w(f"{T.c_type(gt)} {c} = {self._par_identity(op, gt)};")
+        self.w("for (size_t _gk = _glo; _gk < _ghi; _gk++) {")
+        self.gen_scoped_body(st.body, is_loop=True, prologue=[
+            f"{ctype} {v} = ({ctype})(_gc->_gstart + (int64_t)_gk * _gc->_gstep);"])
+        self.w("}")
+        if red:
+            self.w("g_par_lock();")
+            for op, c, gt in red:
+                if op == "sum":
+                    self.w(f"*_gc->{c} += {c};")
+                else:
+                    cmp = "<" if op == "min" else ">"
+                    self.w(f"if ({c} {cmp} *_gc->{c}) *_gc->{c} = {c};")
+            self.w("g_par_unlock();")
+        self.indent -= 1
+        self.w("}")
+        self.w("")
+        self.par_defs.extend(self.out)
+        self.out, self.indent, self.scope_stack, self.subst = saved
+
+        # --- nơi gọi: tính khoảng một lần, điền ngữ cảnh, chạy song song ---
+        self.w("{")
+        self.indent += 1
+        a, b, k, ctx = self.tmp("_gs"), self.tmp("_ge"), self.tmp("_gst"), self.tmp("_gc")
+        self.w(f"int64_t {a} = (int64_t)({self.gen_expr(st.start)});")
+        self.w(f"int64_t {b} = (int64_t)({self.gen_expr(st.end)});")
+        step = "1" if st.step is None else self.gen_expr(st.step)
+        self.w(f"int64_t {k} = (int64_t)({step});")
+        inits = [f"._gstart = {a}", f"._gstep = {k}"]
+        for c, gt, ref in caps:
+            cur = self.subst.get(c, c)
+            inits.append(f".{c} = &{cur}" if ref else f".{c} = {cur}")
+        for _, c, _ in red:
+            inits.append(f".{c} = &{self.subst.get(c, c)}")
+        self.w(f"struct {fn} {ctx} = {{ {', '.join(inits)} }};")
+        chunk = "0" if st.chunk is None else f"(size_t)({self.gen_expr(st.chunk)})"
+        incl = "true" if st.inclusive else "false"
+        self.w(f"g_par_for(g_par_count({a}, {b}, {k}, {incl}), {chunk}, {fn}, &{ctx});")
+        self.indent -= 1
+        self.w("}")
+
     def _elem_decl(self, name, elem_type, init_c):
         """Khai báo C cho biến phần tử của foreach. Khi phần tử LẠI là mảng
         (duyệt hàng của mảng nhiều chiều), phải giữ chiều trong: 'int (*row)[3]'
@@ -614,7 +1073,32 @@ class Codegen:
         elem_type = getattr(st, "elem_type", T.INT)
         elem_c = T.c_type(elem_type)
         kind = getattr(st, "iter_kind", "array")
-        if kind == "str":
+        if kind in ("vec", "map"):
+            # Đọc len/data qua con trỏ tới header MỖI vòng: push trong thân
+            # (có thể realloc data) vẫn an toàn, và phần tử không cần kiểm biên.
+            # Map: quét mảng ô theo thứ tự bảng, bỏ ô có byte điều khiển âm.
+            v, i = self.tmp("_gv"), self.tmp("_gi")
+            src = self.gen_expr(st.iterable)
+            if self.gtype_of(st.iterable).kind == "ptr":
+                self.w(f"{{ __auto_type {v} = ({src});")
+            elif self._is_addressable(st.iterable):
+                self.w(f"{{ __auto_type {v} = &({src});")
+            else:
+                hold = self.tmp("_gvv")
+                self.w(f"{{ __auto_type {hold} = ({src}); __auto_type {v} = &{hold};")
+            self.indent += 1
+            if kind == "vec":
+                self.w(f"for (size_t {i} = 0; {i} < {v}->len; ++{i}) {{")
+                prologue = [f"{elem_c} {var} = {v}->data[{i}];"]
+            else:
+                self.w(f"for (size_t {i} = 0; {i} < {v}->cap; ++{i}) {{")
+                prologue = [f"if ({v}->ctrl[{i}] < 0) continue;",
+                            f"{elem_c} {var} = {v}->slots[{i}].key;"]
+            self.gen_scoped_body(st.body, is_loop=True, prologue=prologue)
+            self.w("}")
+            self.indent -= 1
+            self.w("}")
+        elif kind == "str":
             p = self.tmp("_gs")
             src = self.gen_expr(st.iterable)
             self.w(f"for (const char* {p} = ({src}); *{p}; ++{p}) {{")
@@ -675,7 +1159,7 @@ class Codegen:
                     continue
                 pc = self.gen_expr(p)
                 if is_str:
-                    tests.append(f"strcmp({tmp}, {pc}) == 0")
+                    tests.append(f"g_str_eq({tmp}, {pc})")
                 else:
                     tests.append(f"{tmp} == {pc}")
             return " || ".join(tests)
@@ -752,7 +1236,8 @@ class Codegen:
         if isinstance(e, A.NullLit):
             return "NULL"
         if isinstance(e, A.Ident):
-            return getattr(e, "c_name", "") or e.name
+            c = getattr(e, "c_name", "") or e.name
+            return self.subst.get(c, c)
         if isinstance(e, A.Binary):
             lc = self.gen_expr(e.left)
             rc = self.gen_expr(e.right)
@@ -769,7 +1254,15 @@ class Codegen:
             return f"({self.gen_expr(e.cond)} ? {self.gen_expr(e.then)} : {self.gen_expr(e.els)})"
         if isinstance(e, A.Call):
             return self.gen_call(e)
+        if isinstance(e, A.Await):
+            return e.result_c          # gen_await đã chạy ở đầu câu lệnh
         if isinstance(e, A.Index):
+            bk = self.gtype_of(e.base).kind
+            if bk in ("vec", "bytes"):
+                return self.gen_vec_index(e)
+            if bk == "mat" or (isinstance(e.base, A.Index)
+                               and self.gtype_of(e.base.base).kind == "mat"):
+                return self.gen_mat_index(e)
             return f"{self.gen_expr(e.base)}[{self.gen_expr(e.index)}]"
         if isinstance(e, A.FieldAccess):
             arrow = getattr(e, "auto_deref", False)
@@ -787,8 +1280,43 @@ class Codegen:
             return "{ " + ", ".join(self.gen_expr(x) for x in e.elements) + " }"
         if isinstance(e, A.StructLit):
             return self.gen_struct_lit(e)
+        if isinstance(e, A.Const):
+            return self.gen_const(e.value, e.ctype)
         raise CodegenError(f"biểu thức chưa hỗ trợ: {e}")
 
+    def gen_vec_index(self, e: A.Index) -> str:
+        """v[i] -> v.data[g_bounds(i, v.len)] (vẫn là lvalue). g_bounds là
+        hàm nên i chỉ được tính một lần; base có lời gọi thì vật hoá vào biến
+        tạm (khi đó kết quả là rvalue — không thể gán vào Vec tạm thời)."""
+        bc = self.gen_expr(e.base)
+        ic = self.gen_expr(e.index)
+        if getattr(e, "no_bounds", False):
+            # optimize đã chứng minh 0 <= i < len (for i in 0..len(v), v không đổi)
+            return f"({bc}).data[{ic}]"
+        if self._has_call(e.base):
+            t = self.tmp("_gv")
+            return (f"({{ __auto_type {t} = ({bc}); "
+                    f"{t}.data[g_bounds({ic}, {t}.len)]; }})")
+        return f"({bc}).data[g_bounds({ic}, ({bc}).len)]"
+
+    def gen_mat_index(self, e: A.Index) -> str:
+        """m[i][j] -> m.data[g_bounds(i, m.rows) * m.cols + g_bounds(j, m.cols)]
+        (lvalue); m[i] đứng riêng là con trỏ tới đầu hàng i."""
+        row = e if self.gtype_of(e.base).kind == "mat" else e.base
+        bc = self.gen_expr(row.base)
+        ic = self.gen_expr(row.index)
+        if self._has_call(row.base):
+            t = self.tmp("_gm")
+            pre, bc = f"__auto_type {t} = ({bc}); ", t
+        else:
+            pre, bc = "", f"({bc})"
+        at = f"g_bounds({ic}, {bc}.rows) * {bc}.cols"
+        if row is e:
+            out = f"({bc}.data + {at})"
+        else:
+            out = f"{bc}.data[{at} + g_bounds({self.gen_expr(e.index)}, {bc}.cols)]"
+        return f"({{ {pre}{out}; }})" if pre else out
+
     @staticmethod
     def _is_addressable(e) -> bool:
         """Biểu thức có phải ô nhớ lấy địa chỉ được (lvalue) trong C không?
@@ -799,6 +1327,28 @@ class Codegen:
         return isinstance(e, A.Unary) and e.op == "*"
 
     def gen_call(self, e: A.Call):
+        # lời gọi 'comptime fn' đã tính lúc biên dịch -> literal
+        if hasattr(e, "const_value"):
+            gt = self.gtype_of(e)
+            if isinstance(e.const_value, list):
+                ty = self.c_decl("", self._gtype_to_ctype_decl(gt)).strip()
+                return f"(({ty}){self.gen_const(e.const_value, gt)})"
+            return self.gen_const(e.const_value, gt)
+        # method dựng sẵn của Vec/Map: V__push(&v, x), M__get(&m, k)...
+        if getattr(e, "builtin_method", None):
+            vc = T.c_type(e.builtin_type)
+            meth = e.builtin_method
+            recv_c = self.gen_expr(e.recv)
+            arg_c = [self.gen_expr(a) for a in e.args]
+            if e.recv_is_ptr:
+                ptr_c = recv_c
+            elif self._is_addressable(e.recv):
+                ptr_c = f"&({recv_c})"
+            else:
+                tmp = self.tmp("_grecv")
+                return (f"({{ {vc} {tmp} = ({recv_c}); "
+                        f"{vc}__{meth}({', '.join(['&' + tmp] + arg_c)}); }})")
+            return f"{vc}__{meth}({', '.join([ptr_c] + arg_c)})"
         # method call (đã phân giải trong checker)
         if getattr(e, "is_method", False):
             recv_c = self.gen_expr(e.recv)
@@ -819,6 +1369,8 @@ class Codegen:
             return (f"({{ {e.struct} {tmp} = ({recv_c}); "
                     f"{call_with('&' + tmp)}; }})")
         # builtin
+        if getattr(e, "slice_fn", None):
+            return self.gen_slice(e)
         if isinstance(e.func, A.Ident):
             name = e.func.name
             if name in ("print", "println", "eprint", "eprintln"):
@@ -827,6 +1379,22 @@ class Codegen:
                 return self.gen_len(e)
             if name == "assert":
                 return self.gen_assert(e)
+            if name == "flush":
+                return "g_out_flush()"
+            if name == "spawn":
+                # tác vụ mới: khung cấp trên heap, executor poll lần đầu ở lượt sau
+                call = e.args[0]
+                f = call.func.name
+                frame = (f"(struct _gaf_{f}*)g_aio_spawn(_gaf_{f}_poll, "
+                         f"sizeof(struct _gaf_{f}))")
+                args = [frame] + [self.gen_expr(a) for a in call.args]
+                return f"(void)_gaf_{f}_start({', '.join(args)})"
+            if name == "printf":
+                # printf của C đi thẳng vào stdio: đổ bộ đệm print trước.
+                args = ", ".join(self.gen_expr(a) for a in e.args)
+                return f"(g_out_flush(), printf({args}))"
+            if name in ("sort", "sort_by"):
+                return self.gen_sort(e)
             if name == "panic":
                 msg = self.gen_expr(e.args[0]) if e.args else '"panic"'
                 return f"g_panic({msg})"
@@ -871,10 +1439,66 @@ class Codegen:
                     else:
                         parts.append(self.gen_expr(a))
                 return f"{name}({', '.join(parts)})"
+            if self._is_concat_fn(name):
+                leaves = self._concat_leaves(e)
+                if len(leaves) > 2:
+                    parts = ", ".join(self.gen_expr(x) for x in leaves)
+                    return (f"g_str_concat_n({len(leaves)}, "
+                            f"(const char*[]){{ {parts} }})")
+            if e.args:
+                last = self.gtype_of(e.args[-1])
+                if last.kind == "float" and last.bits == 32:
+                    for target, variant in self.F32_VARIANTS.items():
+                        if self._forwards_to(name, target):
+                            args = ", ".join(self.gen_expr(a) for a in e.args)
+                            return f"{variant}({args})"
         fn = self.gen_expr(e.func)
         args = ", ".join(self.gen_expr(a) for a in e.args)
         return f"{fn}({args})"
 
+    # In số thực của runtime -> bản f32 (chữ số ngắn nhất theo f32): float_to_str
+    # / sb_push_float của std.g nhận f64, f32 nới ra sẽ in 0.1 thành 0.10000000149011612.
+    F32_VARIANTS = {
+        "g_float_to_str": "g_f32_to_str",
+        "g_string_push_float": "g_string_push_f32",
+    }
+
+    def _forwards_to(self, name, target, _depth=0) -> bool:
+        """'name' có phải chính extern 'target', hoặc wrapper một dòng chuyển
+        nguyên tham số sang nó ('return target(a, b)' / 'target(a, b)') như các
+        hàm trong std.g không. Hàm người dùng tự viết thì không đụng tới."""
+        fn = self.fn_defs.get(name)
+        if fn is None or _depth > 4:
+            return False
+        if fn.body is None:
+            return name == target
+        if len(fn.body) != 1:
+            return False
+        st = fn.body[0]
+        call = (st.value if isinstance(st, A.Return)
+                else st.expr if isinstance(st, A.ExprStmt) else None)
+        if not (isinstance(call, A.Call) and isinstance(call.func, A.Ident)):
+            return False
+        return ([getattr(a, "name", None) for a in call.args]
+                == [p.name for p in fn.params]
+                and self._forwards_to(call.func.name, target, _depth + 1))
+
+    def _is_concat_fn(self, name) -> bool:
+        """'name' có phải phép nối hai chuỗi của runtime không: chính
+        g_str_concat hoặc wrapper như str_concat trong std.g."""
+        fn = self.fn_defs.get(name)
+        return (fn is not None and len(fn.params) == 2
+                and self._forwards_to(name, "g_str_concat"))
+
+    def _concat_leaves(self, e) -> list:
+        """Làm phẳng cây str_concat(str_concat(a, b), c) -> [a, b, c]. Các kết quả
+        trung gian không ai giữ được, nên gộp thành một lần nối là an toàn."""
+        if (isinstance(e, A.Call) and not getattr(e, "is_method", False)
+                and isinstance(e.func, A.Ident) and len(e.args) == 2
+                and self._is_concat_fn(e.func.name)):
+            return self._concat_leaves(e.args[0]) + self._concat_leaves(e.args[1])
+        return [e]
+
     def _type_expr_to_c(self, arg) -> str:
         """Render đối-số-là-kiểu (cho g_alloc/g_realloc) thành tên kiểu C.
         Tên trần -> ánh xạ C; '*T' (Unary '*') -> 'T*'. Fallback: gen_expr."""
@@ -894,9 +1518,105 @@ class Codegen:
             return str(gt.n)
         c = self.gen_expr(arg)
         if gt.kind == "str":
-            return f"strlen({c})"
+            return f"g_str_len({c})"
+        if gt.kind in ("strbuf", "bytes", "vec", "map"):
+            return f"({c}).len"
+        if gt.kind == "ptr" and gt.elem is not None and gt.elem.kind in (
+                "strbuf", "bytes", "vec", "map"):
+            return f"({c})->len"
         return f"(sizeof({c}) / sizeof(({c})[0]))"
 
+    def gen_sort(self, e: A.Call):
+        """g_sort_T(con trỏ dữ liệu, số phần tử) theo dạng đối số checker đã ghi."""
+        x = self.gen_expr(e.args[0])
+        if e.sort_form == "ptr":
+            n = f"(size_t)({self.gen_expr(e.args[1])})"
+        elif e.sort_form == "array":
+            n = str(self.gtype_of(e.args[0]).n)
+        else:
+            # Vec: cần cả data lẫn len -> đối số có lời gọi phải đánh giá đúng MỘT lần.
+            arg = e.args[0]
+            if e.sort_form == "vec":
+                if not self._is_addressable(arg):
+                    tmp = self.tmp("_gsv")
+                    return (f"({{ __auto_type {tmp} = ({x}); "
+                            f"{e.sort_fn}({tmp}.data, {tmp}.len); }})")
+                x = f"&({x})"
+            if self._has_call(arg):
+                tmp = self.tmp("_gsv")
+                return (f"({{ __auto_type {tmp} = {x}; "
+                        f"{e.sort_fn}({tmp}->data, {tmp}->len); }})")
+            x, n = f"({x})->data", f"({x})->len"
+        return f"{e.sort_fn}({x}, {n})"
+
+    def _seq_ref(self, arg, form, pre):
+        """(con trỏ dữ liệu, số phần tử) của một dãy cho nhân g_slice_*. Đối số
+        có lời gọi hàm được tính đúng MỘT lần vào biến tạm (thêm vào 'pre')."""
+        x = self.gen_expr(arg)
+        if form == "array":
+            return x, str(self.gtype_of(arg).n)
+        if form == "ptr":
+            if self._has_call(arg):
+                tmp = self.tmp("_gsp")
+                pre.append(f"__auto_type {tmp} = ({x});")
+                x = tmp
+            return x, None
+        if form == "vec":
+            if not self._is_addressable(arg):
+                tmp = self.tmp("_gsv")
+                pre.append(f"__auto_type {tmp} = ({x});")
+                return f"{tmp}.data", f"{tmp}.len"
+            if not self._has_call(arg):
+                return f"({x}).data", f"({x}).len"
+            x = f"&({x})"
+        if self._has_call(arg):
+            tmp = self.tmp("_gsv")
+            pre.append(f"__auto_type {tmp} = {x};")
+            x = tmp
+        return f"({x})->data", f"({x})->len"
+
+    def gen_slice(self, e: A.Call):
+        """sum/dot/min/max trên dãy -> g_slice_<phép>_<T>(dữ liệu..., n). Hai dãy
+        có độ dài lúc chạy (Vec) được so khớp bởi g_slice_len2 (panic nếu lệch)."""
+        pre = []
+        refs = [self._seq_ref(a, f, pre) for a, f in zip(e.args, e.slice_forms)]
+        datas = [d for d, _ in refs]
+        if e.slice_forms[0] == "ptr":
+            n = f"(size_t)({self.gen_expr(e.args[-1])})"
+        elif len(refs) == 1 or e.slice_forms == ["array", "array"]:
+            n = refs[0][1]     # hai mảng tĩnh: checker đã khớp độ dài
+        else:
+            n = f"g_slice_len2({refs[0][1]}, {refs[1][1]})"
+        call = f"{e.slice_fn}({', '.join(datas + [n])})"
+        if pre:
+            return f"({{ {' '.join(pre)} {call}; }})"
+        return call
+
+    def gen_slice_assign(self, st: A.Assign):
+        """xs op= ys / xs op= k -> nhân từng phần tử của runtime (restrict, căn lề,
+        SIMD). Vec vế phải phải cùng độ dài với vế trái (g_slice_len2)."""
+        pre = []
+        dst_form, src_form = st.slice_forms
+        if src_form is None:
+            # k tính trước khi đọc data/len của đích (k có thể push vào chính xs)
+            et = self.gtype_of(st.target).elem
+            arg = f"({T.c_type(et)})({self.gen_expr(st.value)})"
+            if self._has_call(st.value):
+                tmp = self.tmp("_gk")
+                pre.append(f"{T.c_type(et)} {tmp} = {arg};")
+                arg = tmp
+        d, dn = self._seq_ref(st.target, dst_form, pre)
+        if src_form is None:
+            n = dn
+        else:
+            arg, sn = self._seq_ref(st.value, src_form, pre)
+            n = dn if dst_form == src_form == "array" else f"g_slice_len2({dn}, {sn})"
+        call = f"{st.slice_fn}({d}, {arg}, {n});"
+        if pre:
+            self.w(f"{{ {' '.join(pre)} {call} }}")
+        else:
+            self.w(call)
+
     def gen_assert(self, e: A.Call):
         cond = self.gen_expr(e.args[0])
         if len(e.args) > 1:
@@ -906,21 +1626,73 @@ class Codegen:
         return f"(({cond}) ? (void)0 : g_panic({msg}))"
 
     def gen_print(self, e: A.Call, name):
-        stream = "stderr" if name.startswith("e") else "stdout"
         newline = name.endswith("ln")
-        if not e.args:
-            return f"fprintf({stream}, {self.c_string(chr(10) if newline else '')})"
-        first = e.args[0]
-        if isinstance(first, A.StrLit):
-            template = first.value
+        if e.args and isinstance(e.args[0], A.StrLit):
+            template = e.args[0].value
             value_args = e.args[1:]
         else:
-            template = "{}"
+            template = "{}" if e.args else ""
             value_args = e.args
-        fmt, c_args = self.build_format(template, value_args, newline)
-        if c_args:
-            return f"fprintf({stream}, {fmt}, {', '.join(c_args)})"
-        return f"fprintf({stream}, {fmt})"
+        if name.startswith("e"):
+            # stderr không đệm: đổ bộ đệm stdout trước để giữ thứ tự hai luồng.
+            fmt, c_args = self.build_format(template, value_args, newline)
+            return f"(g_out_flush(), fprintf({', '.join(['stderr', fmt] + c_args)}))"
+        return self.build_writes(template, value_args, newline)
+
+    # specifier (đã ép kiểu sẵn) -> hàm ghi chuyên biệt của bộ đệm stdout.
+    OUT_WRITERS = {
+        "%s": "g_out_str", "%c": "g_out_char", "%r": "g_out_f64", "%R": "g_out_f32",
+        "%.*s": "g_out_bytes",
+        "%d": "g_out_i64", "%lld": "g_out_i64",
+        "%u": "g_out_u64", "%llu": "g_out_u64",
+    }
+
+    def build_writes(self, raw, value_args, newline=False):
+        """print/println -> chuỗi lệnh ghi vào bộ đệm stdout của runtime: đoạn
+        chữ thành g_out_lit với độ dài tính sẵn, mỗi đối số thành một hàm ghi
+        theo kiểu; specifier có width/precision mới cần g_out_fmt."""
+        pieces = list(self._format_pieces(raw, value_args))
+        if newline:
+            pieces.append(("text", "\n"))
+        # Đối số có lời gọi hàm: tính hết TRƯỚC khi ghi, như printf — hàm đó có
+        # thể tự in, và phần chữ phía trước không được chen vào giữa.
+        pre = []
+        if any(p[0] == "arg" and p[2] is not None and self._has_call(p[2])
+               for p in pieces):
+            for k, p in enumerate(pieces):
+                if p[0] == "arg" and p[2] is not None:
+                    tmp = self.tmp("_gp")
+                    pre.append(f"__auto_type {tmp} = ({self.gen_expr(p[2])});")
+                    pieces[k] = ("arg", p[1], p[2], tmp)
+        stmts = []
+        text = []
+
+        def flush_text():
+            if text:
+                t = "".join(text)
+                stmts.append(f"g_out_lit({self.c_string(t)}, "
+                             f"{len(t.encode('utf-8'))});")
+                text.clear()
+
+        for p in pieces:
+            if p[0] == "text":
+                text.append(p[1])
+                continue
+            flush_text()
+            spec, carg = self._fmt_placeholder(p[1], p[2], p[3] if len(p) > 3 else None)
+            if carg is None:
+                continue
+            writer = self.OUT_WRITERS.get(spec)
+            if writer:
+                stmts.append(f"{writer}({carg});")
+            else:
+                stmts.append(f"g_out_fmt({self.c_string(spec)}, {carg});")
+        flush_text()
+        if not stmts:
+            return "((void)0)"
+        if len(stmts) == 1 and not pre:
+            return stmts[0][:-1]
+        return "({ " + " ".join(pre + stmts) + " })"
 
     # key tường minh -> (specifier, kiểu_ép). Ép kiểu để specifier luôn KHỚP
     # đối số trên mọi nền tảng (int64_t có thể là 'long' hoặc 'long long').
@@ -976,15 +1748,33 @@ class Codegen:
             rest = rest[:-1] + "f"
         return "%" + align + zero + width + prec + rest
 
-    def _fmt_placeholder(self, key, arg):
+    # Số thực qua '{}'/'{f}' không flags: chữ số ngắn nhất đọc lại đúng giá trị
+    # (g_fmt_f64 của runtime), không phải 6 chữ số của %g. Không phải specifier
+    # printf — build_writes/build_format tự thay bằng hàm ghi tương ứng. f32 có
+    # bản riêng: nới ra f64 rồi in sẽ lộ 17 chữ số (0.1 -> 0.10000000149011612).
+    SHORTEST_F64 = "%r"
+    SHORTEST_F32 = "%R"
+
+    def _fmt_placeholder(self, key, arg, ce=None):
         """Trả về (specifier, c_arg | None) cho một placeholder, kèm ép kiểu
         để printf luôn nhận đúng kiểu (an toàn đa nền tảng).
         Hỗ trợ '{key:flags}' với flags width/precision/căn lề."""
         key, sep, flags = key.partition(":")
+        spec, carg = self._fmt_spec_arg(key, arg, ce)
         if sep:
-            spec, carg = self._fmt_placeholder(key, arg)
             return self._apply_fmt_flags(spec, flags), carg
-        ce = self.gen_expr(arg) if arg is not None else None
+        if spec == "%g" and key not in ("g", "lg"):
+            gt = self.gtype_of(arg) if arg is not None else T.UNKNOWN
+            single = gt.kind == "float" and gt.bits == 32
+            spec = self.SHORTEST_F32 if single else self.SHORTEST_F64
+        return spec, carg
+
+    def _fmt_spec_arg(self, key, arg, ce=None):
+        if ce is None and arg is not None:
+            ce = self.gen_expr(arg)
+        # bytes: không có '\0' kết thúc -> in theo độ dài (checker chỉ cho {} / {s})
+        if arg is not None and self.gtype_of(arg).kind == "bytes":
+            return "%.*s", ce
         # bool tường minh -> in true/false
         if key == "b":
             if ce is not None:
@@ -1025,36 +1815,49 @@ class Codegen:
             "%g": "double", "%c": "int", "%p": "void*",
         }.get(spec)   # %s -> None (không ép)
 
-    def build_format(self, raw, value_args, newline=False):
-        """Sinh chuỗi định dạng C + danh sách biểu thức C tương ứng.
-        Placeholder rỗng {} => tự suy ra theo kiểu của tham số."""
-        result = []
-        c_args = []
+    def _format_pieces(self, raw, value_args):
+        """Tách chuỗi định dạng: ("text", chữ) và ("arg", key, biểu thức G).
+        '{{'/'}}' là ngoặc thật; '{' không đóng được giữ nguyên."""
         ai = 0
         i = 0
         n = len(raw)
         while i < n:
             ch = raw[i]
             if ch == "{" and i + 1 < n and raw[i + 1] == "{":
-                result.append("{"); i += 2; continue
+                yield ("text", "{"); i += 2; continue
             if ch == "}" and i + 1 < n and raw[i + 1] == "}":
-                result.append("}"); i += 2; continue
+                yield ("text", "}"); i += 2; continue
             if ch == "{":
                 j = raw.find("}", i)
                 if j == -1:
-                    result.append("{"); i += 1; continue
-                key = raw[i + 1:j]
+                    yield ("text", "{"); i += 1; continue
                 arg = value_args[ai] if ai < len(value_args) else None
                 ai += 1
-                spec, carg = self._fmt_placeholder(key, arg)
-                result.append(spec)
-                if carg is not None:
-                    c_args.append(carg)
+                yield ("arg", raw[i + 1:j], arg)
                 i = j + 1
-            elif ch == "%":
-                result.append("%%"); i += 1
             else:
-                result.append(ch); i += 1
+                yield ("text", ch); i += 1
+
+    def build_format(self, raw, value_args, newline=False):
+        """Sinh chuỗi định dạng C + danh sách biểu thức C tương ứng (eprint).
+        Placeholder rỗng {} => tự suy ra theo kiểu của tham số."""
+        result = []
+        c_args = []
+        for p in self._format_pieces(raw, value_args):
+            if p[0] == "text":
+                result.append("%%" if p[1] == "%" else p[1])
+                continue
+            spec, carg = self._fmt_placeholder(p[1], p[2])
+            if spec == "%.*s" and carg is not None:
+                carg = f"(int)({carg}).len, (const char*)({carg}).data"
+            if spec in (self.SHORTEST_F64, self.SHORTEST_F32):
+                fn = "g_f32_cstr" if spec == self.SHORTEST_F32 else "g_f64_cstr"
+                spec = "%s"
+                if carg is not None:
+                    carg = f"{fn}((char[G_FMT_F64_MAX]){{0}}, {carg})"
+            result.append(spec)
+            if carg is not None:
+                c_args.append(carg)
         if newline:
             result.append("\n")
         return self.c_string("".join(result)), c_args
@@ -1075,6 +1878,51 @@ class Codegen:
         ord("\b"): "\\b", ord("\f"): "\\f", ord("\v"): "\\v",
     }
 
+    def gen_const(self, v, gt: T.GType) -> str:
+        """Giá trị Python do comptime tính -> literal C đúng kiểu."""
+        if isinstance(v, list):
+            return "{ " + ", ".join(self.gen_const(x, gt.elem) for x in v) + " }"
+        k = gt.kind
+        if k == "bool":
+            return "true" if v else "false"
+        if k == "str":
+            return self.c_string(v)
+        if k == "float":
+            if math.isnan(v):
+                return "NAN"
+            if math.isinf(v):
+                return "INFINITY" if v > 0 else "(-INFINITY)"
+            if gt.bits == 32:
+                # số chữ số ngắn nhất khôi phục đúng giá trị float
+                for p in range(1, 10):
+                    txt = f"{v:.{p}g}"
+                    if Comptime.to_f32(float(txt)) == v:
+                        break
+                if not any(c in txt for c in ".en"):
+                    txt += ".0"
+                txt += "f"
+            else:
+                txt = repr(v)
+            return f"({txt})" if txt.startswith("-") else txt
+        if k == "char":
+            return self.c_char(chr(v)) if 0 <= v < 128 else f"((char){v})"
+        if k == "enum":
+            return f"(({gt.name}){v})"
+        v = int(v)
+        name = gt.name if k == "int" else "int"
+        if name in ("int", "i32"):
+            txt = "(-2147483647 - 1)" if v == -(1 << 31) else str(v)
+        elif name in ("i64", "isize"):
+            txt = ("(-INT64_C(9223372036854775807) - 1)" if v == -(1 << 63)
+                   else f"INT64_C({v})")
+        elif name in ("u64", "usize"):
+            txt = f"UINT64_C({v})"
+        elif name == "u32":
+            txt = f"{v}u"
+        else:
+            txt = f"(({T.c_type(gt)}){v})"
+        return f"({txt})" if txt.startswith("-") else txt
+
     def c_string(self, s: str) -> str:
         out = ['"']
         data = s.encode("utf-8")          # Unicode -> byte UTF-8 (C string là byte)
@@ -0,0 +1,774 @@
+"""
+G Language - Comptime: tính lời gọi 'comptime fn' ngay lúc biên dịch.
+
+Chạy sau Checker (cần node.gtype, c_name...). Là một trình thông dịch AST nhỏ
+bám đúng ngữ nghĩa C mà codegen sinh ra: nguyên không dấu tràn thì quấn theo
+độ rộng kiểu (có dấu tràn là UB -> bỏ cuộc), chia/dịch bit kiểu C, chuyển đổi số học thông thường (int < unsigned...),
+f32 làm tròn về float. Mọi thứ không chắc chắn (con trỏ, struct, Vec/Map, I/O,
+chia cho 0, UB của C, đọc ô chưa khởi tạo, vượt ngân sách bước...) -> bỏ cuộc
+và để lời gọi chạy lúc chạy như cũ (static inline).
+
+Lời gọi tính được được gắn 'call.const_value' (giá trị Python; kiểu = gtype
+của lời gọi) để codegen in thẳng literal / initializer { ... }.
+'comptime fn' trả về mảng tĩnh là hàm CHỈ-biên-dịch (C không trả mảng theo
+giá trị): mọi lời gọi phải tính được, nếu không là lỗi.
+"""
+
+import math
+import struct
+
+from . import ast_nodes as A
+from . import types as T
+from .checker import CheckError
+
+MAX_STEPS = 300_000        # số lệnh/vòng lặp tối đa cho một lần tính (~1-2 giây)
+MAX_DEPTH = 200            # độ sâu gọi hàm lồng nhau tối đa
+
+
+class NoFold(Exception):
+    """Không tính được lúc biên dịch (kèm lý do để báo lỗi khi bắt buộc)."""
+
+
+class _Budget(NoFold):
+    """Hết ngân sách bước/độ sâu — phụ thuộc nơi gọi nên không ghi nhớ."""
+
+
+class _Return(Exception):
+    def __init__(self, value):
+        self.value = value
+
+
+class _Break(Exception):
+    pass
+
+
+class _Continue(Exception):
+    pass
+
+
+_UNINIT = object()         # biến/phần tử mảng chưa khởi tạo (C: giá trị rác)
+
+
+def returns_array(fn: A.Function) -> bool:
+    return fn.ret is not None and bool(fn.ret.dims or fn.ret.array is not None)
+
+
+class Comptime:
+    def __init__(self, checker):
+        self.ck = checker
+        self.prog = checker.prog
+        self.memo = {}             # (hàm, đối số vô hướng) -> giá trị | NoFold
+        self.global_vals = {}      # tên global bất biến -> giá trị đã tính
+        self.global_defs = {it.name: it for it in self.prog.items
+                            if isinstance(it, A.GlobalVar)}
+        self.folds = []            # (hàm, file, dòng) của mọi lời gọi đã gập
+        self.steps = 0
+        self.depth = 0
+        self.cur_file = None
+        self.allow_calls = True    # optimize tắt: chỉ gập biểu thức, không chạy hàm
+
+    # ---------- điểm vào ----------
+    def run(self):
+        for it in self.prog.items:
+            self.cur_file = getattr(it, "src_file", None)
+            if isinstance(it, A.GlobalVar) and it.value is not None:
+                self.visit_expr(it.value)
+            elif isinstance(it, A.Function) and it.body is not None:
+                # hàm chỉ-biên-dịch không sinh mã C -> thân không cần gập
+                if not (it.is_comptime and returns_array(it)):
+                    self.visit_body(it.body)
+            elif isinstance(it, A.Impl):
+                for m in it.methods:
+                    if m.body is not None:
+                        self.visit_body(m.body)
+        self.prog.comptime_folds = self.folds
+
+    # ---------- duyệt chương trình tìm lời gọi comptime ----------
+    def visit_body(self, body):
+        for st in body:
+            self.visit_stmt(st)
+
+    def visit_stmt(self, st):
+        if isinstance(st, A.Match):
+            self.visit_expr(st.subject)
+            for pats, guard, body in st.arms:
+                for p in pats or ():
+                    if isinstance(p, A.RangePat):
+                        self.visit_expr(p.lo)
+                        self.visit_expr(p.hi)
+                    else:
+                        self.visit_expr(p)
+                if guard is not None:
+                    self.visit_expr(guard)
+                self.visit_body(body)
+            return
+        if isinstance(st, A.Defer):
+            self.visit_stmt(st.stmt)
+            return
+        for name in ("value", "cond", "start", "end", "step", "iterable",
+                     "target", "expr"):
+            x = getattr(st, name, None)
+            if x is not None and not isinstance(x, str):
+                self.visit_expr(x)
+        for name in ("then", "els", "body"):
+            b = getattr(st, name, None)
+            if b:
+                self.visit_body(b)
+
+    def visit_expr(self, e):
+        if isinstance(e, A.Call) and self._comptime_target(e) is not None:
+            fn = self._comptime_target(e)
+            try:
+                self.steps = 0
+                self.depth = 0
+                v = self.eval_call(fn, e.args, {})
+                self._check_complete(v)
+                e.const_value = v
+                self.folds.append((fn.name, self.cur_file, getattr(e, "line", 0)))
+                return
+            except NoFold as why:
+                if returns_array(fn):
+                    raise CheckError(
+                        f"không tính được '{fn.name}(...)' lúc biên dịch: {why} "
+                        f"('comptime fn' trả về mảng chỉ tồn tại lúc biên dịch — "
+                        f"đối số phải là hằng)",
+                        getattr(e, "line", 0), getattr(e, "col", 0), self.cur_file)
+        if isinstance(e, A.ArrayLit):
+            kids = e.elements
+        elif isinstance(e, A.StructLit):
+            kids = [v for _, v in e.fields]
+        else:
+            kids = self.ck._expr_children(e)
+        for c in kids:
+            if c is not None:
+                self.visit_expr(c)
+
+    def _check_complete(self, v):
+        if v is _UNINIT:
+            raise NoFold("kết quả còn phần tử chưa khởi tạo")
+        if isinstance(v, list):
+            for x in v:
+                self._check_complete(x)
+
+    def _comptime_target(self, e):
+        if not isinstance(e.func, A.Ident) or getattr(e, "is_method", False):
+            return None
+        fn = self.ck.func_defs.get(e.func.name)
+        if fn is None or not fn.is_comptime or fn.body is None:
+            return None
+        return fn
+
+    # ---------- kiểu C của biểu thức ----------
+    @staticmethod
+    def _lit_type(e: A.IntLit) -> T.GType:
+        """Kiểu C của literal nguyên: int, long, rồi unsigned long; hex/bát
+        phân còn thử unsigned int (0xFFFFFFFF là unsigned trong C)."""
+        v = int(e.value, 0)
+        based = e.value[:2].lower() in ("0x", "0o", "0b")
+        if v <= 0x7FFFFFFF:
+            return T.INT
+        if based and v <= 0xFFFFFFFF:
+            return T.U32
+        if v <= 0x7FFFFFFFFFFFFFFF:
+            return T.I64
+        return T.U64
+
+    def ctype(self, e) -> T.GType:
+        """Kiểu C thật của biểu thức (có thể khác gtype của checker: '1 + 3e9'
+        là long trong C, so sánh là int...)."""
+        if isinstance(e, A.IntLit):
+            return self._lit_type(e)
+        if isinstance(e, A.CharLit):
+            return T.INT
+        if isinstance(e, A.Const):
+            return e.ctype
+        if isinstance(e, A.Binary):
+            if e.op in ("&&", "||", "==", "!=", "<", ">", "<=", ">="):
+                return T.INT
+            if e.op in ("<<", ">>"):
+                return self.promote(self.ctype(e.left))
+            return self.arith_type(self.ctype(e.left), self.ctype(e.right))
+        if isinstance(e, A.Unary) and e.op in ("-", "~", "+"):
+            return self.promote(self.ctype(e.operand))
+        if isinstance(e, A.Unary) and e.op == "!":
+            return T.INT
+        t = getattr(e, "gtype", None)
+        if t is None or t.kind == "unknown":
+            raise NoFold("không rõ kiểu của biểu thức")
+        return t
+
+    @staticmethod
+    def promote(t: T.GType) -> T.GType:
+        """Thăng cấp nguyên của C: mọi kiểu hẹp hơn int (và bool/char/enum) -> int."""
+        if t.kind in ("bool", "char", "enum"):
+            return T.INT
+        if t.kind == "int" and t.bits < 32:
+            return T.INT
+        return t
+
+    def arith_type(self, a: T.GType, b: T.GType) -> T.GType:
+        """Chuyển đổi số học thông thường (usual arithmetic conversions) của C."""
+        if a.kind == "float" or b.kind == "float":
+            if a.kind == "float" and b.kind == "float":
+                return a if a.bits >= b.bits else b
+            return a if a.kind == "float" else b
+        a, b = self.promote(a), self.promote(b)
+        if a.kind != "int" or b.kind != "int":
+            raise NoFold(f"phép toán trên '{a}'/'{b}'")
+        if a.signed == b.signed:
+            return a if a.bits >= b.bits else b
+        u, s = (a, b) if not a.signed else (b, a)
+        if u.bits >= s.bits:
+            return u
+        return s
+
+    # ---------- chuyển đổi giá trị theo kiểu C ----------
+    @staticmethod
+    def wrap(v: int, bits: int, signed: bool) -> int:
+        v &= (1 << bits) - 1
+        if signed and v >> (bits - 1):
+            v -= 1 << bits
+        return v
+
+    @staticmethod
+    def to_f32(x: float) -> float:
+        try:
+            return struct.unpack("f", struct.pack("f", x))[0]
+        except OverflowError:
+            return math.copysign(math.inf, x)
+
+    def convert(self, v, t: T.GType):
+        if v is _UNINIT:
+            raise NoFold("đọc biến chưa khởi tạo")
+        if t is None or t.kind == "unknown":
+            return v
+        k = t.kind
+        if k == "bool":
+            return bool(v)
+        if k in ("int", "char", "enum"):
+            if isinstance(v, str) or isinstance(v, list):
+                raise NoFold(f"không đổi được giá trị sang '{t}'")
+            if isinstance(v, float):
+                if math.isnan(v) or math.isinf(v):
+                    raise NoFold("ép NaN/vô cực sang số nguyên (UB)")
+                v = int(v)     # cắt về 0 như C
+                bits = 32 if k == "enum" else t.bits
+                lo = -(1 << (bits - 1)) if (k == "enum" or t.signed) else 0
+                if not lo <= v < lo + (1 << bits):
+                    raise NoFold("ép số thực tràn kiểu nguyên (UB)")
+            if k == "enum":
+                return self.wrap(int(v), 32, True)
+            return self.wrap(int(v), t.bits, t.signed)
+        if k == "float":
+            if isinstance(v, (str, list)):
+                raise NoFold(f"không đổi được giá trị sang '{t}'")
+            x = float(v)
+            return self.to_f32(x) if t.bits == 32 else x
+        if k == "str" and isinstance(v, str):
+            return v
+        if k == "array" and isinstance(v, list):
+            return v
+        raise NoFold(f"kiểu '{t}' không tính được lúc biên dịch")
+
+    # ---------- biểu thức ----------
+    def tick(self):
+        self.steps += 1
+        if self.steps > MAX_STEPS:
+            raise _Budget(f"vượt {MAX_STEPS} bước tính")
+
+    def eval(self, e, env):
+        if isinstance(e, A.IntLit):
+            return int(e.value, 0)
+        if isinstance(e, A.FloatLit):
+            try:
+                return float(e.value)
+            except ValueError:
+                raise NoFold(f"literal thực '{e.value}'")
+        if isinstance(e, A.CharLit):
+            b = e.value.encode("utf-8")
+            return self.wrap(b[0], 8, True) if len(b) == 1 else ord(e.value)
+        if isinstance(e, A.BoolLit):
+            return bool(e.value)
+        if isinstance(e, A.StrLit):
+            return e.value
+        if isinstance(e, A.Ident):
+            return self.eval_ident(e, env)
+        if isinstance(e, A.Binary):
+            return self.eval_binary(e, env)
+        if isinstance(e, A.Unary):
+            return self.eval_unary(e, env)
+        if isinstance(e, A.Ternary):
+            c = self.eval(e.cond, env)
+            x = self.eval(e.then if self.truthy(c) else e.els, env)
+            ta, tb = self.ctype(e.then), self.ctype(e.els)
+            if ta.kind in ("int", "float", "char", "bool", "enum") and \
+                    tb.kind in ("int", "float", "char", "bool", "enum"):
+                return self.convert(x, self.arith_type(ta, tb))
+            return x
+        if isinstance(e, A.Cast):
+            return self.convert(self.eval(e.expr, env), self.ctype(e))
+        if isinstance(e, A.Index):
+            return self.eval_index(e, env)
+        if isinstance(e, A.ArrayLit):
+            return [self.eval(x, env) for x in e.elements]
+        if isinstance(e, A.Call):
+            if hasattr(e, "const_value"):
+                return e.const_value
+            return self.eval_call_expr(e, env)
+        if isinstance(e, A.Const):
+            return e.value
+        raise NoFold(f"biểu thức '{type(e).__name__}' chưa hỗ trợ lúc biên dịch")
+
+    def truthy(self, v):
+        if v is _UNINIT:
+            raise NoFold("đọc biến chưa khởi tạo")
+        if isinstance(v, (str, list)):
+            raise NoFold("dùng chuỗi/mảng làm điều kiện")
+        return v != 0
+
+    def eval_ident(self, e: A.Ident, env):
+        if getattr(e, "is_local", False):
+            name = getattr(e, "c_name", "") or e.name
+            if name not in env:
+                raise NoFold(f"'{e.name}' là biến lúc chạy")
+            v = env[name]
+            if v is _UNINIT:
+                raise NoFold(f"đọc '{e.name}' chưa khởi tạo")
+            return v
+        if e.name in self.ck.enum_of_variant:
+            return self.ck.enums[self.ck.enum_of_variant[e.name]][e.name]
+        if e.name in self.global_defs:
+            return self.global_value(e.name)
+        raise NoFold(f"'{e.name}' không phải hằng")
+
+    def global_value(self, name):
+        if name in self.global_vals:
+            v = self.global_vals[name]
+            if v is None:
+                raise NoFold(f"global '{name}' tham chiếu vòng")
+            return v
+        g = self.global_defs[name]
+        if (g.mutable and not g.is_const) or g.value is None:
+            raise NoFold(f"global '{name}' có thể đổi lúc chạy")
+        self.global_vals[name] = None          # chặn vòng tham chiếu
+        try:
+            v = self.convert(self.eval(g.value, {}),
+                             getattr(g, "resolved_type", None))
+        except NoFold:
+            del self.global_vals[name]
+            raise
+        self.global_vals[name] = v
+        return v
+
+    def eval_index(self, e: A.Index, env):
+        base = self.eval(e.base, env)
+        i = self.eval(e.index, env)
+        if isinstance(base, str):
+            data = base.encode("utf-8") + b"\0"
+            if not 0 <= i < len(data):
+                raise NoFold("chỉ số chuỗi ngoài phạm vi")
+            return self.wrap(data[i], 8, True)
+        if not isinstance(base, list):
+            raise NoFold("chỉ mục trên giá trị không phải mảng")
+        if not 0 <= i < len(base):
+            raise NoFold(f"chỉ số {i} ngoài mảng {len(base)} phần tử")
+        v = base[i]
+        if v is _UNINIT:
+            raise NoFold(f"đọc phần tử [{i}] chưa khởi tạo")
+        return v
+
+    def eval_unary(self, e: A.Unary, env):
+        v = self.eval(e.operand, env)
+        if e.op == "!":
+            return not self.truthy(v)
+        t = self.promote(self.ctype(e.operand))
+        if e.op == "+":
+            return self.convert(v, t)
+        if e.op == "-":
+            if t.kind == "float":
+                return self.convert(-float(v), t)
+            if t.kind == "int":
+                return self.convert(self.check_signed(-int(v), t, "-"), t)
+        if e.op == "~" and t.kind == "int":
+            return self.convert(~int(v), t)
+        raise NoFold(f"toán tử '{e.op}' lúc biên dịch")
+
+    def eval_binary(self, e: A.Binary, env):
+        op = e.op
+        if op in ("&&", "||"):
+            a = self.truthy(self.eval(e.left, env))
+            if (op == "&&") != a:
+                return a
+            return self.truthy(self.eval(e.right, env))
+        a = self.eval(e.left, env)
+        b = self.eval(e.right, env)
+        return self.binop(op, a, self.ctype(e.left), b, self.ctype(e.right))
+
+    def binop(self, op, a, ta: T.GType, b, tb: T.GType):
+        if isinstance(a, (str, list)) or isinstance(b, (str, list)):
+            raise NoFold(f"'{op}' trên chuỗi/mảng (địa chỉ lúc chạy)")
+        if op in ("<<", ">>"):
+            t = self.promote(ta)
+            if t.kind != "int":
+                raise NoFold(f"'{op}' trên '{ta}'")
+            a, n = self.convert(a, t), int(b)
+            if not 0 <= n < t.bits:
+                raise NoFold(f"dịch {n} bit trên kiểu {t.bits} bit (UB)")
+            if op == "<<" and t.signed and (a < 0 or a << n >= 1 << (t.bits - 1)):
+                raise NoFold("dịch trái số có dấu âm hoặc tràn (UB)")
+            return self.convert(a << n if op == "<<" else a >> n, t)
+        t = self.arith_type(ta, tb)
+        a, b = self.convert(a, t), self.convert(b, t)
+        if op in ("==", "!=", "<", ">", "<=", ">="):
+            return {"==": a == b, "!=": a != b, "<": a < b, ">": a > b,
+                    "<=": a <= b, ">=": a >= b}[op]
+        if t.kind == "float":
+            return self.convert(self._float_op(op, a, b), t)
+        if op in ("/", "%"):
+            if b == 0:
+                raise NoFold("chia cho 0")
+            if t.signed and a == -(1 << (t.bits - 1)) and b == -1:
+                raise NoFold("tràn khi chia (UB)")
+            q = abs(a) // abs(b)
+            if (a < 0) != (b < 0):
+                q = -q
+            return self.convert(q if op == "/" else a - b * q, t)
+        r = {"+": lambda: a + b, "-": lambda: a - b, "*": lambda: a * b,
+             "&": lambda: a & b, "|": lambda: a | b, "^": lambda: a ^ b}.get(op)
+        if r is None:
+            raise NoFold(f"toán tử '{op}' lúc biên dịch")
+        return self.convert(self.check_signed(r(), t, op), t)
+
+    @staticmethod
+    def check_signed(v: int, t: T.GType, op):
+        """Kết quả số học có dấu ra ngoài miền của kiểu là UB trong C (gc không
+        dịch với -fwrapv): không gấp, để chạy lúc chạy như mã C viết tay."""
+        if t.signed and not -(1 << (t.bits - 1)) <= v < 1 << (t.bits - 1):
+            raise NoFold(f"tràn số có dấu khi '{op}' trên '{t}' (UB)")
+        return v
+
+    @staticmethod
+    def _float_op(op, a, b):
+        if op == "+":
+            return a + b
+        if op == "-":
+            return a - b
+        if op == "*":
+            return a * b
+        if op == "/":
+            if b == 0:
+                if a == 0 or math.isnan(a):
+                    return math.nan
+                return math.copysign(math.inf, a) * math.copysign(1.0, b)
+            return a / b
+        if op == "%":
+            if b == 0 or math.isinf(a):
+                return math.nan
+            return math.fmod(a, b)
+        raise NoFold(f"toán tử '{op}' trên số thực")
+
+    # ---------- lời gọi ----------
+    def eval_call_expr(self, e: A.Call, env):
+        if not isinstance(e.func, A.Ident) or getattr(e, "is_method", False) \
+                or getattr(e, "builtin_method", None):
+            raise NoFold("gọi method lúc biên dịch")
+        name = e.func.name
+        if getattr(e, "slice_op", None):
+            return self.eval_slice(e, name, env)
+        if name in ("min", "max", "abs", "clamp", "len", "assert"):
+            return self.eval_builtin(e, name, env)
+        fn = self.ck.func_defs.get(name)
+        if not self.allow_calls:
+            raise NoFold(f"gọi '{name}' ngoài comptime")
+        if fn is None or fn.body is None or fn.is_extern:
+            raise NoFold(f"'{name}' không có thân G để tính lúc biên dịch")
+        return self.eval_call(fn, e.args, env)
+
+    def eval_builtin(self, e: A.Call, name, env):
+        vals = [self.eval(a, env) for a in e.args]
+        tys = [self.ctype(a) for a in e.args]
+        if name == "len":
+            v = vals[0]
+            if isinstance(v, str):
+                return len(v.encode("utf-8"))
+            if isinstance(v, list):
+                return len(v)
+            raise NoFold("len() trên giá trị lúc chạy")
+        if name == "assert":
+            if not self.truthy(vals[0]):
+                raise NoFold("assert thất bại")
+            return None
+        if name in ("min", "max"):
+            # macro C: (a < b ? a : b) theo kiểu chung của hai vế
+            t = self.arith_type(tys[0], tys[1])
+            a, b = self.convert(vals[0], t), self.convert(vals[1], t)
+            pick = a if (a < b if name == "min" else a > b) else b
+            return pick
+        if name == "abs":
+            t = self.promote(tys[0])
+            v = self.convert(vals[0], t)
+            return self.convert(-v if v < 0 else v, t)
+        # clamp(x, lo, hi): x < lo ? lo : (x > hi ? hi : x)
+        t = self.arith_type(self.arith_type(tys[0], tys[1]), tys[2])
+        x, lo, hi = (self.convert(v, t) for v in vals)
+        return lo if x < lo else (hi if x > hi else x)
+
+    def eval_slice(self, e: A.Call, name, env):
+        """sum/dot/min/max trên mảng tĩnh. Tổng số nguyên quấn theo 2^64 nên
+        khớp nhân SIMD ở mọi thứ tự; tổng số thực phụ thuộc thứ tự cộng của
+        nhân lúc chạy -> không gập."""
+        if e.slice_forms[0] != "array":
+            raise NoFold(f"{name}() trên Vec/con trỏ")
+        seqs = [self.eval(a, env) for a in e.args]
+        if not all(isinstance(x, list) for x in seqs):
+            raise NoFold(f"{name}() trên giá trị lúc chạy")
+        elem = self.ctype(e.args[0]).elem
+        if any(v is _UNINIT for x in seqs for v in x):
+            raise NoFold("đọc phần tử mảng chưa khởi tạo")
+        if name in ("min", "max"):
+            xs = seqs[0]
+            if not xs:
+                raise NoFold(f"{name}() trên dãy rỗng")
+            r = xs[0]
+            for x in xs[1:]:
+                if (x < r if name == "min" else x > r) or r != r:
+                    r = x
+            return r
+        if elem.kind == "float":
+            raise NoFold(f"{name}() số thực: thứ tự cộng do nhân lúc chạy quyết định")
+        acc = T.slice_acc(elem)
+        if name == "sum":
+            return self.convert(sum(seqs[0]), acc)
+        return self.convert(sum(x * y for x, y in zip(seqs[0], seqs[1])), acc)
+
+    def eval_call(self, fn: A.Function, args, env):
+        params = [self.ck.resolve(p.type) for p in fn.params]
+        vals = [self.convert(self.eval(a, env), pt) for a, pt in zip(args, params)]
+        key = None
+        if all(isinstance(v, (int, float, bool, str)) for v in vals):
+            key = (fn.name, tuple((type(v).__name__, repr(v)) for v in vals))
+            hit = self.memo.get(key)
+            if isinstance(hit, NoFold):
+                raise hit
+            if hit is not None:
+                return hit
+        self.depth += 1
+        if self.depth > MAX_DEPTH:
+            self.depth -= 1
+            raise _Budget(f"đệ quy sâu quá {MAX_DEPTH} mức")
+        try:
+            local = {p.name: v for p, v in zip(fn.params, vals)}
+            result = None
+            try:
+                self.exec_body(fn.body, local)
+            except _Return as r:
+                result = r.value
+            ret = self.ck.resolve(fn.ret)
+            if ret.kind != "void":
+                result = self.convert(result, ret)
+        except _Budget as why:
+            # ngân sách luôn bắt đầu từ 0 ở lời gọi ngoài cùng -> nhớ được
+            if key is not None and self.depth == 1:
+                self.memo[key] = why
+            raise
+        except NoFold as why:
+            if key is not None:
+                self.memo[key] = why
+            raise
+        except RecursionError:
+            raise _Budget("đệ quy quá sâu")
+        finally:
+            self.depth -= 1
+        if key is not None and not isinstance(result, list):
+            self.memo[key] = result
+        return result
+
+    # ---------- câu lệnh ----------
+    def exec_body(self, body, env):
+        for st in body:
+            self.exec_stmt(st, env)
+
+    def new_array(self, t: T.GType):
+        if t.n in (None, "dyn") or not isinstance(t.n, int):
+            raise NoFold("mảng không có kích thước tĩnh")
+        if t.elem.kind == "array":
+            return [self.new_array(t.elem) for _ in range(t.n)]
+        return [_UNINIT] * t.n
+
+    def exec_stmt(self, st, env):
+        self.tick()
+        if isinstance(st, A.Let):
+            gt = getattr(st, "resolved_type", None)
+            name = getattr(st, "c_name", "") or st.name
+            if st.value is None:
+                if gt is not None and gt.kind == "array":
+                    env[name] = self.new_array(gt)
+                elif gt is not None and gt.kind in ("int", "float", "char", "bool", "enum"):
+                    env[name] = _UNINIT
+                else:
+                    raise NoFold(f"biến '{st.name}' kiểu '{gt}' lúc biên dịch")
+                return
+            v = self.eval(st.value, env)
+            if gt is not None and gt.kind == "array":
+                if not isinstance(v, list):
+                    raise NoFold("khởi tạo mảng từ giá trị lúc chạy")
+                if isinstance(st.value, A.ArrayLit) and isinstance(gt.n, int):
+                    v += [0] * (gt.n - len(v))     # C: phần còn lại là 0
+            env[name] = self.convert(v, gt)
+        elif isinstance(st, A.Assign):
+            self.exec_assign(st, env)
+        elif isinstance(st, A.ExprStmt):
+            self.eval(st.expr, env)
+        elif isinstance(st, A.Return):
+            raise _Return(None if st.value is None else self.eval(st.value, env))
+        elif isinstance(st, A.If):
+            if self.truthy(self.eval(st.cond, env)):
+                self.exec_body(st.then, env)
+            elif st.els is not None:
+                self.exec_body(st.els, env)
+        elif isinstance(st, A.While):
+            while self.truthy(self.eval(st.cond, env)):
+                if self.exec_loop_body(st.body, env):
+                    break
+        elif isinstance(st, A.Loop):
+            while True:
+                if self.exec_loop_body(st.body, env):
+                    break
+        elif isinstance(st, A.For):
+            self.exec_for(st, env)
+        elif isinstance(st, A.ForEach):
+            self.exec_foreach(st, env)
+        elif isinstance(st, A.Match):
+            self.exec_match(st, env)
+        elif isinstance(st, A.Block):
+            self.exec_body(st.body, env)
+        elif isinstance(st, A.Break):
+            raise _Break()
+        elif isinstance(st, A.Continue):
+            raise _Continue()
+        else:
+            raise NoFold(f"câu lệnh '{type(st).__name__}' lúc biên dịch")
+
+    def exec_loop_body(self, body, env) -> bool:
+        """Chạy một vòng; True nếu gặp 'break'."""
+        self.tick()
+        try:
+            self.exec_body(body, env)
+        except _Break:
+            return True
+        except _Continue:
+            pass
+        return False
+
+    def exec_assign(self, st: A.Assign, env):
+        tgt = st.target
+        tt = self.ctype(tgt)
+        v = self.eval(st.value, env)
+        if getattr(st, "slice_fn", None):
+            # xs op= ys / xs op= k: từng phần tử, theo đúng phép C của kiểu phần tử
+            cur = self.eval(tgt, env)
+            if not isinstance(cur, list):
+                raise NoFold("phép trên dãy lúc chạy")
+            et, op = tt.elem, st.op[:-1]
+            src = v if isinstance(v, list) else [self.convert(v, et)] * len(cur)
+            if len(src) != len(cur) or any(x is _UNINIT for x in cur + src):
+                raise NoFold("dãy chưa khởi tạo / khác độ dài")
+            cur[:] = [self.convert(self.binop(op, x, et, y, et), et)
+                      for x, y in zip(cur, src)]
+            return
+        if st.op != "=":
+            cur = self.eval(tgt, env)
+            v = self.binop(st.op[:-1], cur, tt, v, self.ctype(st.value))
+        v = self.convert(v, tt)
+        if isinstance(tgt, A.Ident):
+            name = getattr(tgt, "c_name", "") or tgt.name
+            if not getattr(tgt, "is_local", False) or name not in env:
+                raise NoFold(f"gán '{tgt.name}' ngoài hàm comptime")
+            env[name] = v
+            return
+        if isinstance(tgt, A.Index):
+            base = self.eval(tgt.base, env)
+            i = self.eval(tgt.index, env)
+            if not isinstance(base, list):
+                raise NoFold("gán qua chỉ mục trên giá trị không phải mảng")
+            if not 0 <= i < len(base):
+                raise NoFold(f"chỉ số {i} ngoài mảng {len(base)} phần tử")
+            base[i] = v
+            return
+        raise NoFold("gán vào ô nhớ lúc chạy")
+
+    def exec_for(self, st: A.For, env):
+        vt = getattr(st, "var_type", None) or T.INT
+        name = getattr(st, "c_name", "") or st.var
+        i = self.convert(self.eval(st.start, env), vt)
+        end = self.eval(st.end, env)
+        et = self.ctype(st.end)
+        step = 1 if st.step is None else self.eval(st.step, env)
+        st_t = T.INT if st.step is None else self.ctype(st.step)
+        if step == 0:
+            raise NoFold("vòng for bước 0 không dừng")
+        if step > 0:
+            cmp = "<=" if st.inclusive else "<"
+        else:
+            cmp = ">=" if st.inclusive else ">"
+        while self.binop(cmp, i, vt, end, et):
+            env[name] = i
+            if self.exec_loop_body(st.body, env):
+                break
+            i = self.convert(self.binop("+", env[name], vt, step, st_t), vt)
+
+    def exec_foreach(self, st: A.ForEach, env):
+        seq = self.eval(st.iterable, env)
+        name = getattr(st, "c_name", "") or st.var
+        if isinstance(seq, str):
+            items = [self.wrap(b, 8, True) for b in seq.encode("utf-8")]
+        elif isinstance(seq, list) and getattr(st, "iter_kind", "") == "array":
+            items = seq
+        else:
+            raise NoFold("for-in trên giá trị lúc chạy")
+        for x in items:
+            if x is _UNINIT:
+                raise NoFold("duyệt phần tử chưa khởi tạo")
+            env[name] = x
+            if self.exec_loop_body(st.body, env):
+                break
+
+    def exec_match(self, st: A.Match, env):
+        subj = self.eval(st.subject, env)
+        bindings = getattr(st, "bindings", [None] * len(st.arms))
+        default = None
+        for (pats, guard, body), bname in zip(st.arms, bindings):
+            if (pats is None or bname is not None) and guard is None:
+                default = (body, bname)    # codegen luôn xét nhánh mặc định cuối
+                continue
+            if bname is not None:
+                env[bname] = subj
+                hit = True
+            elif pats is None:
+                hit = True
+            else:
+                hit = any(self._pat_matches(p, subj, st, env) for p in pats)
+            if hit and guard is not None:
+                hit = self.truthy(self.eval(guard, env))
+            if hit:
+                self.exec_body(body, env)
+                return
+        if default is not None:
+            body, bname = default
+            if bname is not None:
+                env[bname] = subj
+            self.exec_body(body, env)
+
+    def _pat_matches(self, p, subj, st, env) -> bool:
+        if isinstance(subj, str):
+            pv = self.eval(p, env)
+            if not isinstance(pv, str):
+                raise NoFold("pattern chuỗi lúc chạy")
+            return pv == subj
+        ts = self.ctype(st.subject)
+        if isinstance(p, A.RangePat):
+            lo, hi = self.eval(p.lo, env), self.eval(p.hi, env)
+            up = "<=" if p.inclusive else "<"
+            return (self.binop(">=", subj, ts, lo, self.ctype(p.lo))
+                    and self.binop(up, subj, ts, hi, self.ctype(p.hi)))
+        return self.binop("==", subj, ts, self.eval(p, env), self.ctype(p))
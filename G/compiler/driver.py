@@ -1,6 +1,7 @@
 """
 G Language - Driver: điều phối toàn bộ pipeline biên dịch.
-  nguồn .g  ->  Lexer  ->  Parser  ->  (gộp module)  ->  Checker  ->  Codegen  ->  cc
+  nguồn .g  ->  Lexer  ->  Parser  ->  (gộp module)  ->  Checker  ->  Comptime
+           ->  Optimize  ->  Codegen  ->  cc
 """
 
 import os
@@ -12,6 +13,8 @@ import tempfile
 from .lexer import Lexer, LexError
 from .parser import Parser, ParseError
 from .checker import Checker, CheckError
+from .comptime import Comptime
+from .optimize import Optimizer
 from .codegen import Codegen, CodegenError
 from . import ast_nodes as A
 
@@ -112,22 +115,49 @@ def has_main(prog):
                for it in prog.items)
 
 
-def compile_to_c(main_path):
-    """Trả về dict {c, has_main}. Báo lỗi đúng file nguồn (kể cả module import)."""
+def compile_to_c(main_path, optimize=True):
+    """Trả về dict {c, has_main, report}. Báo lỗi đúng file nguồn (kể cả module
+    import). 'report': danh sách (pass, file, dòng, mô tả) của các pass tối ưu."""
     sources = {}
     main_ap = os.path.abspath(main_path)
     prog = build_program(main_path, sources)
     main_src = sources[main_ap][1]
     try:
-        Checker(prog).check()
+        checker = Checker(prog)
+        checker.check()
+        comptime = Comptime(checker)
+        comptime.run()
     except CheckError as e:
         fpath, fsrc = sources.get(e.file or main_ap, (main_path, main_src))
         raise GError(fpath, fsrc, e.line, e.col, e.msg, "kiểu/ngữ nghĩa")
+    report = [("comptime", f, line, f"{name}(...) tính lúc biên dịch")
+              for name, f, line in prog.comptime_folds]
+    if optimize:
+        report += Optimizer(checker, comptime).run()
     try:
         c_code = Codegen(prog).generate()
     except CodegenError as e:
         raise GError(main_path, main_src, 0, 0, str(e), "sinh mã")
-    return {"c": c_code, "has_main": has_main(prog)}
+    return {"c": c_code, "has_main": has_main(prog), "report": report}
+
+
+OPT_PASSES = ("comptime", "fold", "propagate", "dead-branch", "inline",
+              "hoist-len", "bounds")
+
+
+def print_opt_report(main_path, report):
+    """--opt-report: liệt kê thay đổi của từng pass (stderr, để không lẫn với
+    mã C của --emit-c hay output của chương trình)."""
+    err = sys.stderr
+    print(f"gc: báo cáo tối ưu cho {main_path}", file=err)
+    main_ap = os.path.abspath(main_path)
+    for what in OPT_PASSES:
+        items = [r for r in report if r[0] == what]
+        print(f"  {what:<12} {len(items):>4} thay đổi", file=err)
+        for _, f, line, msg in items:
+            where = os.path.basename(f) if f and f != main_ap else ""
+            loc = f"{where}:{line}" if where else f"dòng {line}"
+            print(f"      {loc}: {msg}", file=err)
 
 
 def dump_tokens(main_path):
@@ -212,8 +242,10 @@ def build_executable(args, extra, result):
         c_path = tf.name
         keep = False
 
+    if args.release:
+        extra = ["-DG_NO_BOUNDS_CHECK"] + extra
     cmd = [cc, c_path, "-o", out_path, f"-O{args.O}", "-I", RUNTIME_DIR,
-           "-std=gnu11", "-lm", "-w"] + extra
+           "-std=gnu11", "-lm", "-pthread", "-w"] + extra
     try:
         proc = subprocess.run(cmd, capture_output=True, text=True)
     finally:
@@ -251,6 +283,12 @@ def main(argv):
     ap.add_argument("--ast", action="store_true", help="in cây cú pháp AST")
     ap.add_argument("--cc", default=None, help="trình biên dịch C (mặc định tự dò)")
     ap.add_argument("-O", default="2", help="mức tối ưu (0,1,2,3,s,g), mặc định 2")
+    ap.add_argument("--no-opt", action="store_true",
+                    help="tắt các pass tối ưu AST (fold, inline, bounds...)")
+    ap.add_argument("--opt-report", action="store_true",
+                    help="in những gì mỗi pass tối ưu đã thay đổi")
+    ap.add_argument("--release", action="store_true",
+                    help="bản phát hành: bỏ kiểm tra chỉ số Vec (G_NO_BOUNDS_CHECK)")
     ap.add_argument("--debug", action="store_true",
                     help="in traceback đầy đủ khi gặp lỗi nội bộ")
     ap.add_argument("--version", action="version", version=f"gc (ngôn ngữ G) {VERSION}")
@@ -275,7 +313,7 @@ def main(argv):
             compile_to_c(args.input)  # chạy tới hết checker
             print(f"gc: \033[32mOK\033[0m — không phát hiện lỗi kiểu trong {args.input}")
             return 0
-        result = compile_to_c(args.input)
+        result = compile_to_c(args.input, optimize=not args.no_opt)
     except GError as e:
         print(render_diag(e.filename, e.source, e.line, e.col, e.msg, e.phase),
               file=sys.stderr)
@@ -293,6 +331,9 @@ def main(argv):
               "vui lòng báo cáo)", file=sys.stderr)
         return 2
 
+    if args.opt_report:
+        print_opt_report(args.input, result["report"])
+
     if args.emit_c:
         if args.output:
             with open(args.output, "w") as f:
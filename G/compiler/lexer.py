@@ -10,7 +10,8 @@ KEYWORDS = {
     "fn", "let", "mut", "struct", "enum", "if", "else", "while", "for",
     "return", "match", "defer", "asm", "import", "true", "false",
     "comptime", "break", "continue", "as", "null", "sizeof", "in",
-    "loop", "impl", "const", "extern", "step",
+    "loop", "impl", "const", "extern", "step", "region", "par", "async",
+    "await",
 }
 
 # Toán tử 3 ký tự (kiểm tra trước 2 ký tự)
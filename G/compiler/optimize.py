@@ -0,0 +1,551 @@
+"""
+G Language - Optimize: các pass tối ưu trên AST đã kiểm tra, trước khi sinh C.
+
+Chạy sau Checker + Comptime, sửa AST tại chỗ (giữ nguyên gtype/c_name mà
+codegen cần). Mỗi pass chỉ làm việc khi CHỨNG MINH được là an toàn; không
+chắc thì để nguyên cho trình biên dịch C.
+  - fold       : gập biểu thức hằng (cùng bộ tính ngữ nghĩa C của comptime)
+  - propagate  : thay 'let' bất biến / global bất biến có giá trị hằng bằng literal
+  - dead-branch: bỏ nhánh if/while/?: có điều kiện hằng
+  - inline     : nội tuyến method nhỏ ('return <biểu thức>' không gọi hàm)
+  - hoist-len  : đưa len(chuỗi) (strlen) ra khỏi điều kiện while bất biến
+  - bounds     : bỏ kiểm tra chỉ số v[i] trong 'for i in 0..len(v)' khi v không đổi
+Mỗi thay đổi được ghi vào báo cáo (gc --opt-report).
+"""
+
+import copy
+import dataclasses
+
+from . import ast_nodes as A
+from . import types as T
+from .comptime import Comptime, NoFold, returns_array
+
+INLINE_MAX_NODES = 16      # cỡ tối đa (số nút) của biểu thức method được nội tuyến
+
+# builtin không ghi vào bộ nhớ người dùng (an toàn khi xét vòng lặp "thuần")
+PURE_BUILTINS = {"len", "min", "max", "abs", "clamp", "assert", "print",
+                 "println", "eprint", "eprintln", "flush", "panic",
+                 "unreachable", "todo"}
+
+
+
+def _pure_call(n: A.Call) -> bool:
+    """builtin thuần, hoặc sum/dot/min/max trên dãy (chỉ đọc)."""
+    return bool(getattr(n, "slice_op", None)) or (
+        isinstance(n.func, A.Ident) and n.func.name in PURE_BUILTINS)
+
+
+_LITERALS = (A.IntLit, A.FloatLit, A.CharLit, A.BoolLit, A.Const)
+
+
+def iter_nodes(x):
+    """Duyệt mọi nút AST con (kể cả trong list/tuple như nhánh match)."""
+    if isinstance(x, (list, tuple)):
+        for y in x:
+            yield from iter_nodes(y)
+    elif dataclasses.is_dataclass(x) and not isinstance(x, (A.Type, T.GType)):
+        yield x
+        for f in dataclasses.fields(x):
+            yield from iter_nodes(getattr(x, f.name))
+
+
+def _root_ident(e):
+    """Biến gốc của một ô nhớ: v, v[i], v.f, (*v)... -> Ident v (hoặc None)."""
+    while True:
+        if isinstance(e, A.Ident):
+            return e
+        if isinstance(e, (A.Index, A.FieldAccess)):
+            e = e.base
+        elif isinstance(e, A.Unary) and e.op == "*":
+            e = e.operand
+        else:
+            return None
+
+
+def _cname(e: A.Ident) -> str:
+    return getattr(e, "c_name", "") or e.name
+
+
+class Optimizer:
+    def __init__(self, checker, comptime: Comptime = None):
+        self.ck = checker
+        self.prog = checker.prog
+        self.ct = comptime or Comptime(checker)
+        self.report = []           # (pass, file, dòng, mô tả)
+        self.cur_file = None
+        self.consts = {}           # c_name 'let' bất biến -> giá trị hằng
+        self.addr_taken = set()    # c_name bị gán lại hoặc lấy địa chỉ trong hàm
+        self.ntmp = 0
+
+    def note(self, what, node, msg):
+        line = getattr(node, "line", 0)
+        if not line:       # If/While không mang vị trí: lấy dòng của điều kiện
+            line = next((n.line for n in iter_nodes(node)
+                         if getattr(n, "line", 0)), 0)
+        entry = (what, self.cur_file, line, msg)
+        self.report.append(entry)
+        return entry
+
+    # ---------- điểm vào ----------
+    def run(self):
+        self.ct.allow_calls = False
+        for it in self.prog.items:
+            self.cur_file = getattr(it, "src_file", None)
+            if isinstance(it, A.GlobalVar) and it.value is not None:
+                self.consts = {}
+                it.value = self.expr(it.value)
+            elif isinstance(it, A.Function) and it.body is not None:
+                if not (it.is_comptime and returns_array(it)):
+                    self.function(it)
+            elif isinstance(it, A.Impl):
+                for m in it.methods:
+                    if m.body is not None:
+                        self.function(m)
+        self.prog.opt_report = self.report
+        return self.report
+
+    def function(self, fn: A.Function):
+        self.consts = {}
+        self.addr_taken = set()
+        for n in iter_nodes(fn.body):
+            if isinstance(n, A.Assign):
+                root = n.target if isinstance(n.target, A.Ident) else None
+                if root is not None:
+                    self.addr_taken.add(_cname(root))
+            elif isinstance(n, A.Unary) and n.op == "&":
+                root = _root_ident(n.operand)
+                if root is not None:
+                    self.addr_taken.add(_cname(root))
+        fn.body = self.block(fn.body)
+
+    # ---------- câu lệnh ----------
+    def block(self, body):
+        out = []
+        for st in body:
+            out.extend(self.stmt(st))
+        return out
+
+    def _const_of(self, e):
+        """(True, giá trị) nếu e là literal/hằng đã gập, ngược lại (False, None)."""
+        if isinstance(e, _LITERALS):
+            try:
+                return True, self.ct.eval(e, {})
+            except NoFold:
+                pass
+        return False, None
+
+    def stmt(self, st):
+        if isinstance(st, A.Let):
+            if st.value is not None:
+                st.value = self.expr(st.value)
+                gt = getattr(st, "resolved_type", None)
+                ok, v = self._const_of(st.value)
+                if ok and not st.mutable and gt is not None and gt.kind in (
+                        "int", "float", "char", "bool", "enum"):
+                    try:
+                        self.consts[_cname(st)] = (self.ct.convert(v, gt), gt)
+                    except NoFold:
+                        pass
+            return [st]
+        if isinstance(st, A.Assign):
+            st.value = self.expr(st.value)
+            st.target = self.lvalue(st.target)
+            return [st]
+        if isinstance(st, A.Return):
+            if st.value is not None:
+                st.value = self.expr(st.value)
+            return [st]
+        if isinstance(st, A.ExprStmt):
+            st.expr = self.expr(st.expr)
+            return [st]
+        if isinstance(st, A.If):
+            st.cond = self.expr(st.cond)
+            ok, v = self._const_of(st.cond)
+            if ok and not isinstance(v, (str, list)):
+                taken = st.then if v else st.els
+                self.note("dead-branch", st,
+                          f"if luôn {'đúng' if v else 'sai'}: bỏ nhánh "
+                          f"{'else' if v else 'then'}")
+                if not taken:
+                    return []
+                return [A.Block(self.block(taken), st.line, st.col)]
+            st.then = self.block(st.then)
+            if st.els is not None:
+                st.els = self.block(st.els)
+            return [st]
+        if isinstance(st, A.While):
+            st.cond = self.expr(st.cond)
+            ok, v = self._const_of(st.cond)
+            if ok and not isinstance(v, (str, list)) and not v:
+                self.note("dead-branch", st, "while luôn sai: bỏ cả vòng lặp")
+                return []
+            st.body = self.block(st.body)
+            return self.hoist_len(st)
+        if isinstance(st, A.For):
+            st.start = self.expr(st.start)
+            st.end = self.expr(st.end)
+            if st.step is not None:
+                st.step = self.expr(st.step)
+            if st.chunk is not None:
+                st.chunk = self.expr(st.chunk)
+            st.body = self.block(st.body)
+            self.drop_bounds(st)
+            return [st]
+        if isinstance(st, A.ForEach):
+            st.iterable = self.expr(st.iterable)
+            st.body = self.block(st.body)
+            return [st]
+        if isinstance(st, A.Match):
+            st.subject = self.expr(st.subject)
+            st.arms = [(pats, None if g is None else self.expr(g), self.block(b))
+                       for pats, g, b in st.arms]
+            return [st]
+        if isinstance(st, (A.Loop, A.Block, A.Region)):
+            st.body = self.block(st.body)
+            return [st]
+        if isinstance(st, A.Defer):
+            res = self.stmt(st.stmt)
+            if len(res) == 1:
+                st.stmt = res[0]
+            return [st]
+        return [st]
+
+    # ---------- biểu thức ----------
+    def lvalue(self, e):
+        """Ô nhớ đích: giữ nguyên biến gốc, chỉ tối ưu chỉ số/biểu thức con."""
+        if isinstance(e, A.Index):
+            e.base = self.lvalue(e.base)
+            e.index = self.expr(e.index)
+        elif isinstance(e, A.FieldAccess):
+            e.base = self.lvalue(e.base)
+        elif isinstance(e, A.Unary) and e.op == "*":
+            e.operand = self.expr(e.operand)
+        return e
+
+    def expr(self, e):
+        if e is None or isinstance(e, (A.IntLit, A.FloatLit, A.StrLit, A.CharLit,
+                                       A.BoolLit, A.NullLit, A.Const, A.SizeOf,
+                                       A.SizeOfExpr)):
+            return e       # sizeof(x) phụ thuộc KIỂU của x: không thay x bằng literal
+        if isinstance(e, A.Ident):
+            return self.propagate(e)
+        if isinstance(e, A.Unary):
+            if e.op == "&":
+                e.operand = self.lvalue(e.operand)
+                return e
+            e.operand = self.expr(e.operand)
+        elif isinstance(e, A.Binary):
+            e.left = self.expr(e.left)
+            e.right = self.expr(e.right)
+        elif isinstance(e, A.Ternary):
+            e.cond = self.expr(e.cond)
+            e.then = self.expr(e.then)
+            e.els = self.expr(e.els)
+            ok, v = self._const_of(e.cond)
+            if ok and not isinstance(v, (str, list)) and \
+                    getattr(e.then, "gtype", None) == getattr(e.els, "gtype", None):
+                self.note("dead-branch", e, "?: có điều kiện hằng: giữ một vế")
+                return e.then if v else e.els
+        elif isinstance(e, A.Cast):
+            e.expr = self.expr(e.expr)
+            if not isinstance(e.expr, A.Const):
+                return e       # ép kiểu literal trần: C đã là hằng, không lợi gì
+        elif isinstance(e, A.Index):
+            e.base = self.expr(e.base)
+            e.index = self.expr(e.index)
+        elif isinstance(e, A.FieldAccess):
+            e.base = self.expr(e.base)
+            return e
+        elif isinstance(e, A.Call):
+            if hasattr(e, "const_value"):
+                return e
+            if getattr(e, "is_method", False) or getattr(e, "builtin_method", None):
+                e.recv = self.lvalue(e.recv)
+            e.args = [self.expr(a) for a in e.args]
+            if getattr(e, "is_method", False):
+                inl = self.inline(e)
+                if inl is not e:
+                    return self.expr(inl)
+            if getattr(e, "slice_op", None):
+                return self.fold(e)     # sum/min... trên mảng hằng
+            return e
+        elif isinstance(e, A.ArrayLit):
+            e.elements = [self.expr(x) for x in e.elements]
+            return e
+        elif isinstance(e, A.StructLit):
+            e.fields = [(n, self.expr(v)) for n, v in e.fields]
+            return e
+        elif isinstance(e, A.Await):
+            e.expr = self.expr(e.expr)
+            return e
+        else:
+            return e
+        return self.fold(e)
+
+    def fold(self, e):
+        if isinstance(e, A.Unary) and not isinstance(e.operand, A.Const):
+            # '-5' đã là literal trong C; chỉ gập khi toán hạng là hằng đã gập
+            if isinstance(e.operand, _LITERALS) or e.op in ("&", "*"):
+                return e
+        try:
+            self.ct.steps = 0
+            v = self.ct.eval(e, {})
+            ct = self.ct.ctype(e)
+            if not isinstance(v, (int, float, bool)):
+                return e
+            v = self.ct.convert(v, ct)
+        except NoFold:
+            return e
+        c = A.Const(v, ct, getattr(e, "line", 0), getattr(e, "col", 0))
+        c.gtype = getattr(e, "gtype", ct)
+        if isinstance(e, A.Index):
+            self.note("propagate", e, f"phần tử hằng của mảng bất biến -> {v}")
+        else:
+            # (1 << 10) - 1: chỉ báo kết quả cuối, bỏ các bước gập con
+            for f in dataclasses.fields(e):
+                sub = getattr(e, f.name)
+                if isinstance(sub, A.Const) and getattr(sub, "folded", None) in self.report:
+                    self.report.remove(sub.folded)
+            c.folded = self.note("fold", e, f"biểu thức hằng -> {v}")
+        return c
+
+    def propagate(self, e: A.Ident):
+        if getattr(e, "is_local", False):
+            hit = self.consts.get(_cname(e))
+            if hit is None:
+                return e
+            v, gt = hit
+            what = f"'{e.name}' (let bất biến) -> {v}"
+        elif e.name in self.ct.global_defs:
+            gt = getattr(e, "gtype", None)
+            if gt is None or gt.kind not in ("int", "float", "char", "bool"):
+                return e
+            try:
+                self.ct.steps = 0
+                v = self.ct.convert(self.ct.global_value(e.name), gt)
+            except NoFold:
+                return e
+            what = f"'{e.name}' (global bất biến) -> {v}"
+        else:
+            return e
+        c = A.Const(v, gt, e.line, e.col)
+        c.gtype = getattr(e, "gtype", gt)
+        self.note("propagate", e, what)
+        return c
+
+    # ---------- nội tuyến method nhỏ ----------
+    @staticmethod
+    def _simple(e) -> bool:
+        """Biểu thức đọc-thuần, rẻ: được phép chép vào nhiều chỗ."""
+        if isinstance(e, _LITERALS + (A.Ident,)):
+            return True
+        if isinstance(e, A.FieldAccess):
+            return Optimizer._simple(e.base)
+        return False
+
+    def inline(self, e: A.Call):
+        m = self.ck.methods.get(getattr(e, "struct", ""), {}).get(getattr(e, "method", ""))
+        if m is None or m.body is None or len(m.body) != 1 or not m.params:
+            return e
+        ret = m.body[0]
+        if not isinstance(ret, A.Return) or ret.value is None:
+            return e
+        nodes = list(iter_nodes(ret.value))
+        if len(nodes) > INLINE_MAX_NODES or any(
+                isinstance(n, (A.Call, A.StructLit, A.ArrayLit)) for n in nodes):
+            return e
+        if not self._simple(e.recv) or not all(self._simple(a) for a in e.args):
+            return e
+        self_name = m.params[0].name
+        args = {}
+        for p, a in zip(m.params[1:], e.args):
+            pt = self.ck.resolve(p.type)
+            if getattr(a, "gtype", None) != pt:
+                a = A.Cast(a, p.type, e.line, e.col)   # C đổi đối số theo kiểu tham số
+                a.gtype = pt
+            args[p.name] = a
+        body = self._subst(copy.deepcopy(ret.value), self_name, e, args)
+        res = A.Cast(body, m.ret, e.line, e.col)
+        res.gtype = self.ck.resolve(m.ret)
+        self.note("inline", e, f"nội tuyến {e.struct}.{e.method}()")
+        return res
+
+    def _subst(self, node, self_name, call, args):
+        """Thay 'self'/tham số trong bản sao thân method bằng receiver/đối số."""
+        def is_param(x, name):
+            return (isinstance(x, A.Ident) and getattr(x, "is_local", False)
+                    and _cname(x) == name)
+
+        if is_param(node, self_name):
+            recv = copy.deepcopy(call.recv)
+            if call.recv_is_ptr:
+                return recv
+            ref = A.Unary("&", recv, node.line, node.col)
+            ref.gtype = node.gtype
+            return ref
+        if isinstance(node, A.Ident) and getattr(node, "is_local", False) \
+                and _cname(node) in args:
+            return copy.deepcopy(args[_cname(node)])
+        if isinstance(node, A.FieldAccess) and is_param(node.base, self_name) \
+                and not call.recv_is_ptr:
+            # self.f với receiver theo giá trị: r.f thay vì (&r)->f
+            node.base = copy.deepcopy(call.recv)
+            node.auto_deref = False
+            return node
+        if dataclasses.is_dataclass(node):
+            for f in dataclasses.fields(node):
+                val = getattr(node, f.name)
+                if isinstance(val, list):
+                    setattr(node, f.name, [self._subst(x, self_name, call, args)
+                                           for x in val])
+                elif dataclasses.is_dataclass(val) and not isinstance(val, A.Type):
+                    setattr(node, f.name, self._subst(val, self_name, call, args))
+        return node
+
+    # ---------- vòng lặp ----------
+    def _loop_pure(self, body) -> bool:
+        """Thân vòng lặp không ghi qua con trỏ, không ghi vào mảng mà chuỗi có
+        thể trỏ vào và không gọi hàm người dùng — đủ để khẳng định nội dung
+        chuỗi không đổi giữa các vòng."""
+        for n in iter_nodes(body):
+            if isinstance(n, A.Asm):
+                return False
+            if isinstance(n, A.Assign):
+                t = n.target
+                if isinstance(t, A.Unary) or getattr(t, "auto_deref", False) \
+                        or getattr(n, "slice_fn", None):
+                    return False
+                if isinstance(t, A.Index):
+                    bt = getattr(t.base, "gtype", None)
+                    if bt is None or bt.kind in ("ptr", "str") or bt.n == "dyn":
+                        return False
+                    # mảng global / bị lấy địa chỉ / mảng byte (tự rã thành
+                    # str: let s: str = buf): chuỗi có thể trỏ vào nó
+                    root = _root_ident(t.base)
+                    et = bt.elem
+                    if root is None or not getattr(root, "is_local", False) \
+                            or _cname(root) in self.addr_taken \
+                            or et is None or et.kind == "char" \
+                            or (et.kind == "int" and et.bits == 8):
+                        return False
+            if isinstance(n, A.Call) and not hasattr(n, "const_value") \
+                    and not getattr(n, "builtin_method", None):
+                if getattr(n, "is_method", False) or not _pure_call(n):
+                    return False
+        return True
+
+    def _is_str_len(self, e) -> bool:
+        return (isinstance(e, A.Call) and isinstance(e.func, A.Ident)
+                and e.func.name == "len" and len(e.args) == 1
+                and isinstance(e.args[0], A.Ident)
+                and getattr(e.args[0], "is_local", False)
+                and getattr(e.args[0], "gtype", T.UNKNOWN).kind == "str"
+                and _cname(e.args[0]) not in self.addr_taken)
+
+    def hoist_len(self, st: A.While):
+        """while i < len(s) { ... }: strlen mỗi vòng -> tính một lần trước vòng."""
+        if not any(self._is_str_len(n) for n in iter_nodes(st.cond)):
+            return [st]
+        if not self._loop_pure(st.body):
+            return [st]
+        # s = ... trong thân vòng lặp: len(s) đổi giữa các vòng, giữ nguyên
+        assigned = {_cname(n.target) for n in iter_nodes(st.body)
+                    if isinstance(n, A.Assign) and isinstance(n.target, A.Ident)}
+        lets, temps = [], {}
+
+        def repl(x):
+            if self._is_str_len(x) and _cname(x.args[0]) not in assigned:
+                key = _cname(x.args[0])
+                if key not in temps:
+                    self.ntmp += 1
+                    name = f"_glen{self.ntmp}"
+                    let = A.Let(name, None, x, False, name, st.line, st.col)
+                    let.resolved_type = T.USIZE
+                    lets.append(let)
+                    temps[key] = name
+                    self.note("hoist-len", st,
+                              f"len({x.args[0].name}) tính một lần trước vòng while")
+                ident = A.Ident(temps[key], temps[key], x.line, x.col)
+                ident.gtype = T.USIZE
+                ident.is_local = True
+                return ident
+            if dataclasses.is_dataclass(x):
+                for f in dataclasses.fields(x):
+                    val = getattr(x, f.name)
+                    if dataclasses.is_dataclass(val) and not isinstance(val, A.Type):
+                        setattr(x, f.name, repl(val))
+                    elif isinstance(val, list):
+                        setattr(x, f.name, [repl(y) for y in val])
+            return x
+
+        st.cond = repl(st.cond)
+        if not lets:
+            return [st]
+        return [A.Block(lets + [st], st.line, st.col)]
+
+    def _vec_key(self, e):
+        """Khoá nhận diện Vec/bytes được lặp: Ident v hoặc *p (p: *Vec)."""
+        if isinstance(e, A.Ident) and \
+                getattr(e, "gtype", T.UNKNOWN).kind in ("vec", "bytes"):
+            return ("val", _cname(e))
+        if isinstance(e, A.Unary) and e.op == "*" and isinstance(e.operand, A.Ident):
+            return ("ptr", _cname(e.operand))
+        if isinstance(e, A.Ident):
+            t = getattr(e, "gtype", T.UNKNOWN)
+            if t.kind == "ptr" and t.elem is not None and t.elem.kind in ("vec", "bytes"):
+                return ("ptr", _cname(e))
+        return None
+
+    def drop_bounds(self, st: A.For):
+        """for i in 0..len(v) { ... v[i] ... }: 0 <= i < len(v) nên g_bounds thừa,
+        miễn là v không đổi độ dài và i không bị gán trong thân vòng lặp."""
+        if st.inclusive or st.step is not None:
+            return
+        ok, lo = self._const_of(st.start)
+        if not ok or isinstance(lo, (str, list)) or lo < 0:
+            return
+        end = st.end
+        if isinstance(end, A.Cast) and getattr(end, "gtype", T.UNKNOWN).is_integer():
+            end = end.expr     # len(v) as int: ép kiểu nguyên không làm giá trị lớn hơn
+        if not (isinstance(end, A.Call) and isinstance(end.func, A.Ident)
+                and end.func.name == "len" and len(end.args) == 1):
+            return
+        key = self._vec_key(end.args[0])
+        if key is None:
+            return
+        # &v ở chỗ khác trong hàm, hay v là global: hàm được gọi có thể sửa v,
+        # nên đối xử như trường hợp con trỏ (thân chỉ gọi builtin thuần)
+        aliased = key[0] == "ptr" or key[1] in self.addr_taken \
+            or not getattr(end.args[0], "is_local", False)
+        var = getattr(st, "c_name", "") or st.var
+        if var in self.addr_taken:
+            return
+        for n in iter_nodes(st.body):
+            if isinstance(n, A.Assign) and isinstance(n.target, A.Ident) \
+                    and _cname(n.target) in (var, key[1]):
+                return
+            if isinstance(n, A.Unary) and n.op == "&":
+                root = _root_ident(n.operand)
+                if root is not None and _cname(root) in (var, key[1]):
+                    return
+            if isinstance(n, A.Call) and not hasattr(n, "const_value"):
+                if getattr(n, "builtin_method", None) and \
+                        self._vec_key(n.recv) is not None and \
+                        self._vec_key(n.recv)[1] == key[1]:
+                    return          # push/pop/clear... đổi len/data
+                if aliased:
+                    # qua con trỏ: hàm khác có thể sửa cùng Vec (bí danh)
+                    if getattr(n, "is_method", False) or not _pure_call(n):
+                        return
+        hits = 0
+        for n in iter_nodes(st.body):
+            if isinstance(n, A.Index) and isinstance(n.index, A.Ident) \
+                    and _cname(n.index) == var \
+                    and getattr(n.base, "gtype", T.UNKNOWN).kind in ("vec", "bytes") \
+                    and self._vec_key(n.base) == key:
+                n.no_bounds = True
+                hits += 1
+        if hits:
+            self.note("bounds", st,
+                      f"bỏ {hits} kiểm tra chỉ số trong 'for {st.var} in "
+                      f"..len(...)'")
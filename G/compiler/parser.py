@@ -27,6 +27,12 @@ BIN_PREC = {
 
 ASSIGN_OPS = {"=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>="}
 
+# Kiểu generic dựng sẵn: tên -> số tham số kiểu ('Vec[T]', 'Map[K, V]', 'Mat[T]').
+GENERIC_TYPES = {"Vec": 1, "Map": 2, "Mat": 1}
+
+# Mệnh đề sau khoảng của 'par for': cỡ phần việc và các phép rút gọn.
+PAR_CLAUSES = {"chunk", "sum", "min", "max"}
+
 
 class Parser:
     def __init__(self, tokens, filename="<input>"):
@@ -111,7 +117,8 @@ class Parser:
                 else:
                     prog.imports.append(self.expect("id").value)
                 self.skip_semis()
-            elif self.is_kw("fn") or self.is_kw("comptime") or self.is_kw("extern"):
+            elif (self.is_kw("fn") or self.is_kw("comptime") or self.is_kw("extern")
+                  or self.is_kw("async")):
                 prog.items.append(self.parse_fn())
             elif self.is_kw("struct"):
                 prog.items.append(self.parse_struct())
@@ -129,6 +136,7 @@ class Parser:
         t = self.cur()
         is_comptime = bool(self.accept("kw", "comptime"))
         is_extern = bool(self.accept("kw", "extern"))
+        is_async = bool(self.accept("kw", "async"))
         self.expect("kw", "fn")
         name = self.expect("id").value
         self.expect("op", "(")
@@ -153,7 +161,7 @@ class Parser:
         else:
             body = self.parse_block()
         return A.Function(name, params, ret, body, is_comptime, is_extern,
-                          recv=recv, **self.pos_of(t))
+                          recv=recv, is_async=is_async, **self.pos_of(t))
 
     def parse_struct(self) -> A.StructDef:
         t = self.cur()
@@ -239,6 +247,12 @@ class Parser:
             self.expect("op", "]")
         name = self.expect("id").value
         ty = A.Type(name, ptr=ptr, **self.pos_of(t))
+        if name in GENERIC_TYPES and self.is_op("["):
+            self.advance()
+            ty.args = [self.parse_type()]
+            while self.accept("op", ","):
+                ty.args.append(self.parse_type())
+            self.expect("op", "]")
         if dims:
             ty.dims = dims
             ty.array = dims[0]            # chiều ngoài cùng (giữ tương thích)
@@ -278,6 +292,9 @@ class Parser:
             return A.Loop(self.parse_block())
         if self.is_kw("for"):
             return self.parse_for()
+        if self.is_kw("par"):
+            self.advance()
+            return self.parse_for(par=True)
         if self.is_kw("match"):
             return self.parse_match()
         if self.is_kw("defer"):
@@ -291,6 +308,9 @@ class Parser:
         if self.is_kw("continue"):
             tk = self.advance(); self.skip_semis()
             return A.Continue(**self.pos_of(tk))
+        if self.is_kw("region"):
+            self.advance()
+            return A.Region(self.parse_block(), **self.pos_of(t))
         if self.is_op("{"):
             # khối lệnh trần { ... } — tạo scope riêng (block-scoped defer)
             return A.Block(self.parse_block(), **self.pos_of(t))
@@ -332,7 +352,7 @@ class Parser:
                 els = self.parse_block()
         return A.If(cond, then, els)
 
-    def parse_for(self):
+    def parse_for(self, par=False):
         t = self.cur()
         self.expect("kw", "for")
         mutable = bool(self.accept("kw", "mut"))
@@ -346,10 +366,29 @@ class Parser:
         if inclusive or self.accept("op", ".."):
             end = self.parse_expr()
             step = self.parse_expr() if self.accept("kw", "step") else None
+            # par for ... [chunk N] [sum(a, b)] [min(c)] [max(d)]: các từ mệnh đề
+            # chỉ mang nghĩa ở đây, ngoài ra vẫn là định danh thường.
+            chunk, reduce = None, []
+            while par and self.check("id") and self.cur().value in PAR_CLAUSES:
+                kw = self.advance().value
+                if kw == "chunk":
+                    if chunk is not None:
+                        self.error("'chunk' lặp lại")
+                    chunk = self.parse_expr()
+                    continue
+                self.expect("op", "(")
+                while True:
+                    nt = self.expect("id")
+                    reduce.append((kw, A.Ident(nt.value, **self.pos_of(nt))))
+                    if not self.accept("op", ","):
+                        break
+                self.expect("op", ")")
             self.no_struct_lit = saved
             body = self.parse_block()
             return A.For(var, first, end, body, bool(inclusive), step,
-                         **self.pos_of(t))
+                         par=par, chunk=chunk, reduce=reduce, **self.pos_of(t))
+        if par:
+            self.error("'par for' chỉ dùng cho vòng lặp theo khoảng a..b")
         # for [mut] x in <iterable> { }   (duyệt mảng tĩnh hoặc chuỗi)
         self.no_struct_lit = saved
         body = self.parse_block()
@@ -439,6 +478,9 @@ class Parser:
             t = self.advance()
             operand = self.parse_unary()
             return A.Unary(t.value, operand, t.line, t.col)
+        if self.is_kw("await"):
+            t = self.advance()
+            return A.Await(self.parse_unary(), t.line, t.col)
         return self.parse_postfix()
 
     def parse_postfix(self):
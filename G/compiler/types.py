@@ -8,14 +8,15 @@ from dataclasses import dataclass, field
 
 @dataclass(frozen=True)
 class GType:
-    kind: str            # void bool int float char str ptr array struct enum func null unknown
+    kind: str            # void bool int float char str strbuf bytes reader ptr array vec map mat struct enum func null unknown
     name: str = ""       # tên int (i32...) / struct / enum
     bits: int = 0
     signed: bool = True
-    elem: object = None  # ptr/array: kiểu phần tử
+    elem: object = None  # ptr/array/vec/mat: kiểu phần tử; map: kiểu giá trị
     n: object = None     # array: số phần tử (int hoặc 'dyn')
     params: tuple = ()   # func
     ret: object = None   # func
+    key: object = None   # map: kiểu khoá
 
     # ---------- thuộc tính ----------
     def is_numeric(self):
@@ -33,6 +34,12 @@ class GType:
         if self.kind == "array":
             sz = "" if self.n == "dyn" else str(self.n)
             return f"[{sz}]{self.elem}"
+        if self.kind == "vec":
+            return f"Vec[{self.elem}]"
+        if self.kind == "map":
+            return f"Map[{self.key}, {self.elem}]"
+        if self.kind == "mat":
+            return f"Mat[{self.elem}]"
         if self.kind in ("struct", "enum"):
             return self.name
         if self.kind == "int":
@@ -45,6 +52,9 @@ VOID = GType("void")
 BOOL = GType("bool")
 CHAR = GType("char", "char", 8, True)
 STR = GType("str")
+STRBUF = GType("strbuf")    # chuỗi mang độ dài (g_string trong runtime)
+BYTES = GType("bytes")      # lát cắt byte chỉ đọc: con trỏ + độ dài (g_bytes)
+READER = GType("reader")    # bộ đọc theo dòng/bản ghi trên tệp/fd (g_reader)
 NULL = GType("null")
 UNKNOWN = GType("unknown")
 
@@ -63,7 +73,8 @@ F32 = GType("float", "f32", 32)
 F64 = GType("float", "f64", 64)
 
 PRIMITIVES = {
-    "void": VOID, "bool": BOOL, "char": CHAR, "str": STR,
+    "void": VOID, "bool": BOOL, "char": CHAR, "str": STR, "strbuf": STRBUF,
+    "bytes": BYTES, "reader": READER,
     "i8": I8, "i16": I16, "i32": I32, "i64": I64,
     "u8": U8, "u16": U16, "u32": U32, "u64": U64,
     "int": INT, "usize": USIZE, "isize": ISIZE,
@@ -79,9 +90,40 @@ def array_of(elem, n):
     return GType("array", elem=elem, n=n)
 
 
+def vec_of(elem):
+    return GType("vec", elem=elem)
+
+
+def map_of(key, val):
+    return GType("map", elem=val, key=key)
+
+
+def mat_of(elem):
+    return GType("mat", elem=elem)
+
+
+def mangle(t: GType) -> str:
+    """Tên định danh C ổn định cho một kiểu — đặt tên bản đơn hình hoá
+    (Vec[*Node] -> g_vec_p_Node, Vec[Vec[int]] -> g_vec_vec_int,
+    Map[str, int] -> g_map_str__int)."""
+    if t.kind == "ptr":
+        return "p_" + mangle(t.elem)
+    if t.kind == "vec":
+        return "vec_" + mangle(t.elem)
+    if t.kind == "map":
+        return f"map_{mangle(t.key)}__{mangle(t.elem)}"
+    if t.kind == "mat":
+        return "mat_" + mangle(t.elem)
+
+    if t.kind in ("struct", "enum", "int", "float"):
+        return t.name
+    return t.kind
+
+
 # ---------- ánh xạ sang C ----------
 _C_NAME = {
     "void": "void", "bool": "bool", "char": "char", "str": "const char*",
+    "strbuf": "g_string", "bytes": "g_bytes", "reader": "g_reader",
     "i8": "int8_t", "i16": "int16_t", "i32": "int32_t", "i64": "int64_t",
     "u8": "uint8_t", "u16": "uint16_t", "u32": "uint32_t", "u64": "uint64_t",
     "int": "int", "usize": "size_t", "isize": "ptrdiff_t",
@@ -94,6 +136,8 @@ def c_type(t: GType) -> str:
         return c_type(t.elem) + "*"
     if t.kind == "array":
         return c_type(t.elem) + "*"   # mảng động truyền như con trỏ
+    if t.kind in ("vec", "map", "mat"):
+        return "g_" + mangle(t)
     if t.kind in ("struct", "enum"):
         return t.name
     if t.kind == "null":
@@ -132,6 +176,19 @@ def printf_spec(t: GType):
     return "%d", False
 
 
+def slice_acc(t: GType) -> GType:
+    """Kiểu kết quả của sum/dot trên dãy phần tử t: cộng dồn rộng 64 bit
+    (số thực -> f64, kể cả dãy f32)."""
+    if t.kind == "float":
+        return F64
+    return I64 if t.signed else U64
+
+
+def slice_mask_c(t: GType) -> str:
+    """Số nguyên C có dấu cùng cỡ t — mặt nạ so sánh của nhân vector min/max."""
+    return f"int{t.bits}_t"
+
+
 def common_numeric(a: GType, b: GType) -> GType:
     """Kiểu kết quả của phép toán số học giữa a và b."""
     if a.kind == "float" or b.kind == "float":
@@ -1,15 +1,27 @@
-// fib.g - dãy Fibonacci bằng đệ quy
-fn fib(n: int) -> int {
+// fib.g - dãy Fibonacci bằng đệ quy, tính sẵn lúc biên dịch (comptime)
+comptime fn fib(n: int) -> int {
     if n < 2 {
         return n
     }
     return fib(n - 1) + fib(n - 2)
 }
 
+// Bảng 15 số đầu dựng lúc biên dịch: mã C chỉ còn một mảng hằng, chương trình
+// không phải tính gì khi chạy.
+comptime fn fib_table() -> [15]int {
+    let mut t: [15]int
+    for i in 0..15 {
+        t[i] = fib(i)
+    }
+    return t
+}
+
+let FIBS = fib_table()
+
 fn main() -> int {
     println("Dãy Fibonacci:")
-    for i in 0..15 {
-        print("{} ", fib(i))
+    for x in FIBS {
+        print("{} ", x)
     }
     println("")
     return 0
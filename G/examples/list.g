@@ -1,5 +1,5 @@
 // list.g - danh sách liên kết đơn (struct tự tham chiếu qua con trỏ)
-// Trình diễn: struct đệ quy, cấp phát động, method, duyệt con trỏ.
+// Trình diễn: struct đệ quy, cấp phát động (trong region), method, duyệt con trỏ.
 import std
 
 struct Node {
@@ -60,15 +60,19 @@ impl List {
 fn main() -> int {
     let mut list = List { head: null, len: 0 }
 
-    for i in 1..=8 {
-        list.push_front(i * i)
-    }
+    // Các node cấp phát từ arena của region: mỗi g_alloc chỉ là cộng con trỏ,
+    // và toàn bộ được thu hồi một lần khi rời khối.
+    region {
+        for i in 1..=8 {
+            list.push_front(i * i)
+        }
 
-    print("Danh sách ({} phần tử): ", list.len)
-    list.print_all()
-    println("Tổng = {ld}", list.sum())
+        print("Danh sách ({} phần tử): ", list.len)
+        list.print_all()
+        println("Tổng = {ld}", list.sum())
 
-    list.free_all()
+        list.free_all()        // g_free trong region là no-op — vẫn an toàn
+    }
     println("Sau khi giải phóng: len = {}", list.len)
     return 0
 }
@@ -1,5 +1,6 @@
 // matrix.g - mảng nhiều chiều + thuật toán ma trận
-// Trình diễn: [N][M]T, lặp lồng nhau, mảng literal lồng.
+// Trình diễn: [N][M]T, lặp lồng nhau, mảng literal lồng; Mat[T] (ma trận cấp
+// phát động) với transpose và matmul của runtime.
 
 fn main() -> int {
     // Ma trận 3x3 (mảng 2 chiều, khởi tạo bằng literal lồng)
@@ -44,5 +45,21 @@ fn main() -> int {
     }
     println("Tổng mọi phần tử = {}", total)
 
+    // Cùng ma trận dưới dạng Mat[int]: một khối liền, cỡ quyết định lúc chạy
+    let m: Mat[int] = [[1, 2, 3], [4, 5, 6], [7, 8, 9]]
+    let mut mt = m.transpose()
+    let mut p: Mat[int]
+    p.matmul(m, mt)
+    println("A·Aᵀ ({}x{}):", p.rows(), p.cols())
+    for i in 0..p.rows() {
+        print("  ")
+        for j in 0..p.cols() {
+            print("{} ", p[i][j])
+        }
+        println("")
+    }
+    mt.free()
+    p.free()
+
     return 0
 }
@@ -16,7 +16,7 @@ enum Color {
     Blue,
 }
 
-// --- Zig: comptime (sinh thành static inline) ---
+// --- Zig: comptime (đối số hằng -> tính lúc biên dịch, square(5) thành 25) ---
 comptime fn square(n: int) -> int {
     return n * n
 }
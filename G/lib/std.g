@@ -101,27 +101,28 @@ fn fib(n: int) -> i64 {
     return a
 }
 
-// Tổng các phần tử của một mảng động (truyền kèm độ dài)
+// Tổng các phần tử của một mảng động (truyền kèm độ dài) — builtin sum(p, n):
+// nhân SIMD của runtime, cộng dồn trên i64
 fn sum_slice(a: *int, n: int) -> i64 {
-    let mut s: i64 = 0
-    for i in 0..n {
-        s = s + (a[i] as i64)
+    if n <= 0 {
+        return 0
     }
-    return s
+    return sum(a, n)
 }
 
 // ---- Chuỗi: tái dùng thư viện C qua 'extern' ----
 extern fn strcmp(a: str, b: str) -> int
 extern fn strlen(s: str) -> usize
+extern fn g_str_len(s: str) -> usize
 
-// Hai chuỗi bằng nhau?
+// Hai chuỗi bằng nhau? (nhân SIMD của runtime)
 fn streq(a: str, b: str) -> bool {
-    return strcmp(a, b) == 0
+    return g_str_eq(a, b)
 }
 
-// Độ dài chuỗi (số byte)
+// Độ dài chuỗi (số byte; nhân SIMD của runtime)
 fn str_len(s: str) -> usize {
-    return strlen(s)
+    return g_str_len(s)
 }
 
 // ---- Chuỗi nâng cao (runtime g_runtime.h; bản cấp phát heap -> nhớ g_free) ----
@@ -135,7 +136,10 @@ extern fn g_str_starts_with(s: str, pre: str) -> bool
 extern fn g_str_ends_with(s: str, suf: str) -> bool
 extern fn g_parse_int(s: str) -> i64
 extern fn g_parse_float(s: str) -> f64
+extern fn g_try_parse_int(s: str, out: *i64) -> bool
+extern fn g_try_parse_float(s: str, out: *f64) -> bool
 extern fn g_int_to_str(v: i64) -> str
+extern fn g_float_to_str(v: f64) -> str
 
 // Nối hai chuỗi -> chuỗi mới trên heap (nhớ g_free)
 fn str_concat(a: str, b: str) -> str { return g_str_concat(a, b) }
@@ -148,16 +152,74 @@ fn substr(s: str, start: int, len: int) -> str {
 // Chuỗi a có chứa b không?
 fn str_contains(hay: str, needle: str) -> bool { return g_str_contains(hay, needle) }
 
+// Vị trí xuất hiện đầu tiên của needle trong hay, hoặc -1
+fn str_index(hay: str, needle: str) -> isize { return g_str_index(hay, needle) }
+
 // Chuỗi bắt đầu/kết thúc bằng tiền tố/hậu tố?
 fn starts_with(s: str, pre: str) -> bool { return g_str_starts_with(s, pre) }
 fn ends_with(s: str, suf: str) -> bool { return g_str_ends_with(s, suf) }
 
-// Phân tích số nguyên/thực từ chuỗi (lỗi -> 0)
+// Phân tích số nguyên/thực từ chuỗi (lỗi -> 0). Cả chuỗi phải là số, chỉ bỏ
+// qua khoảng trắng hai đầu: "12abc" hay số nguyên tràn i64 đều là lỗi.
 fn parse_int(s: str) -> i64 { return g_parse_int(s) }
 fn parse_float(s: str) -> f64 { return g_parse_float(s) }
 
-// Chuyển số nguyên thành chuỗi mới (heap; nhớ g_free)
+// Như trên nhưng báo lỗi: trả false (và không ghi *out) nếu s không phải số
+fn try_parse_int(s: str, out: *i64) -> bool { return g_try_parse_int(s, out) }
+fn try_parse_float(s: str, out: *f64) -> bool { return g_try_parse_float(s, out) }
+
+// Chuyển số thành chuỗi mới (heap; nhớ g_free). Số thực: ngắn nhất mà đọc lại
+// đúng giá trị, giống print "{}".
 fn int_to_str(v: i64) -> str { return g_int_to_str(v) }
+fn float_to_str(v: f64) -> str { return g_float_to_str(v) }
+
+// ---- Bộ dựng chuỗi 'strbuf' (runtime g_string: con trỏ + độ dài + dung lượng) ----
+// Dùng thay cho 's = str_concat(s, x)' trong vòng lặp (mỗi lần nối sao chép lại
+// toàn bộ -> O(n^2)). len(b) là O(1). Kết thúc bằng sb_finish (lấy chuỗi heap,
+// nhớ g_free) hoặc sb_free.
+extern fn g_string_new() -> strbuf
+extern fn g_string_push(b: *strbuf, s: str)
+extern fn g_string_push_char(b: *strbuf, c: char)
+extern fn g_string_push_int(b: *strbuf, v: i64)
+extern fn g_string_push_float(b: *strbuf, v: f64)
+extern fn g_string_cstr(b: *strbuf) -> str
+extern fn g_string_find(b: *strbuf, needle: str) -> isize
+extern fn g_string_clear(b: *strbuf)
+extern fn g_string_free(b: *strbuf)
+extern fn g_string_finish(b: *strbuf) -> str
+
+fn sb_new() -> strbuf { return g_string_new() }
+fn sb_push(b: *strbuf, s: str) { g_string_push(b, s) }
+fn sb_push_char(b: *strbuf, c: char) { g_string_push_char(b, c) }
+fn sb_push_int(b: *strbuf, v: i64) { g_string_push_int(b, v) }
+fn sb_push_float(b: *strbuf, v: f64) { g_string_push_float(b, v) }
+
+// Nội dung hiện tại (mượn; hết hiệu lực sau lần push/clear/free kế tiếp)
+fn sb_str(b: *strbuf) -> str { return g_string_cstr(b) }
+
+// Vị trí đầu tiên của needle trong b, hoặc -1 (độ dài đã biết -> nhân SIMD)
+fn sb_index(b: *strbuf, needle: str) -> isize { return g_string_find(b, needle) }
+
+// Xoá nội dung, giữ bộ đệm để tái dùng
+fn sb_clear(b: *strbuf) { g_string_clear(b) }
+fn sb_free(b: *strbuf) { g_string_free(b) }
+
+// Lấy chuỗi kết quả (heap; nhớ g_free) và đưa b về rỗng
+fn sb_finish(b: *strbuf) -> str { return g_string_finish(b) }
+
+// ---- Region (arena) ----
+// Trong 'region { ... }' g_alloc và các hàm chuỗi lấy bộ nhớ từ arena; rời
+// khối là thu hồi tất cả một lần, g_free bên trong là no-op.
+extern fn g_region_used() -> usize
+
+// Số byte arena đang giữ cho các region còn mở
+fn region_used() -> usize { return g_region_used() }
+
+// ---- Thời gian ----
+extern fn g_now_ns() -> i64
+
+// Đồng hồ đơn điệu tính bằng nano giây (chỉ dùng để đo khoảng thời gian).
+fn now_ns() -> i64 { return g_now_ns() }
 
 // ---- Số học bổ sung ----
 
@@ -187,15 +249,11 @@ fn min3(a: int, b: int, c: int) -> int {
     return min(a, min(b, c))
 }
 
-// Đếm số bit 1 (popcount)
+// Đếm số bit 1 (popcount) — lệnh POPCNT khi CPU đích có, không thì SWAR
+extern fn g_popcount64(x: u64) -> int
+
 fn popcount(x: u64) -> int {
-    let mut n: u64 = x
-    let mut count: int = 0
-    while n != 0 {
-        count += (n & 1) as int
-        n = n >> 1
-    }
-    return count
+    return g_popcount64(x)
 }
 
 // Số Fibonacci thứ n có vượt quá đệ quy? Dùng bản lặp 'fib' ở trên.
@@ -207,19 +265,24 @@ fn swap_at(a: *int, i: int, j: int) {
     a[j] = t
 }
 
-// Sắp xếp nổi bọt mảng động tăng dần (tại chỗ)
-fn bubble_sort(a: *int, n: int) {
-    let mut i: int = 0
-    while i < n {
-        let mut j: int = 0
-        while j < n - i - 1 {
-            if a[j] > a[j + 1] {
-                swap_at(a, j, j + 1)
-            }
-            j += 1
-        }
-        i += 1
-    }
+// Sắp xếp mảng động tăng dần (tại chỗ) — builtin sort: pdqsort O(n log n)
+fn sort_int(a: *int, n: int) {
+    sort(a, n)
+}
+
+// Radix sort (LSD theo byte) cho khoá nguyên: O(n), ổn định, cấp phát tạm n
+// phần tử. Nhanh hơn sort() với mảng lớn khoá ngẫu nhiên.
+extern fn g_radix_sort_i32(a: *i32, n: usize)
+extern fn g_radix_sort_i64(a: *i64, n: usize)
+extern fn g_radix_sort_u32(a: *u32, n: usize)
+extern fn g_radix_sort_u64(a: *u64, n: usize)
+
+fn radix_sort_int(a: *int, n: int) {
+    g_radix_sort_i32(a as *i32, n as usize)
+}
+
+fn radix_sort_i64(a: *i64, n: int) {
+    g_radix_sort_i64(a, n as usize)
 }
 
 // Tìm kiếm nhị phân trên mảng đã sắp xếp; trả về chỉ số hoặc -1
@@ -252,3 +315,163 @@ fn max_subarray(a: *int, n: int) -> i64 {
     }
     return best
 }
+
+// ---- Async I/O (executor một luồng trên epoll) ----
+// spawn(f(...)) các tác vụ 'async fn' rồi async_run() chạy tất cả tới khi xong.
+// fd dùng với await phải ở chế độ không chặn (socket_pair/pipe_pair đã bật sẵn,
+// fd khác dùng set_nonblocking) và đóng bằng aclose.
+extern fn g_aio_run()
+extern fn g_aio_read(fd: int, buf: *u8, n: int) -> int
+extern fn g_aio_write(fd: int, buf: *u8, n: int) -> int
+extern fn g_aio_close(fd: int) -> int
+extern fn g_aio_nonblock(fd: int) -> int
+extern fn g_aio_socketpair(fds: *int) -> int
+extern fn g_aio_pipe(fds: *int) -> int
+extern fn g_aio_nofile(want: int) -> int
+
+fn async_run() { g_aio_run() }
+
+// Cặp socket Unix nối nhau (hai chiều) / ống một chiều (fds[0] đọc, fds[1] ghi);
+// 0 nếu được, -1 nếu hết fd
+fn socket_pair(fds: *int) -> int { return g_aio_socketpair(fds) }
+fn pipe_pair(fds: *int) -> int { return g_aio_pipe(fds) }
+
+fn set_nonblocking(fd: int) -> int { return g_aio_nonblock(fd) }
+fn aclose(fd: int) -> int { return g_aio_close(fd) }
+
+// Nâng giới hạn số fd mở lên 'want' (tối đa giới hạn cứng); trả về giới hạn mới
+fn raise_fd_limit(want: int) -> int { return g_aio_nofile(want) }
+
+// Đọc tối đa n byte, chờ nếu chưa có dữ liệu; 0 = đầu kia đã đóng, -1 = lỗi
+async fn aread(fd: int, buf: *u8, n: int) -> int {
+    loop {
+        let r = g_aio_read(fd, buf, n)
+        if r != -2 {
+            return r
+        }
+        await wait_readable(fd)
+    }
+}
+
+// Ghi đủ n byte (chờ khi bộ đệm đầy); n nếu xong, -1 nếu lỗi
+async fn awrite(fd: int, buf: *u8, n: int) -> int {
+    let mut off = 0
+    while off < n {
+        let r = g_aio_write(fd, &buf[off], n - off)
+        if r == -2 {
+            await wait_writable(fd)
+        } else if r < 0 {
+            return -1
+        } else {
+            off += r
+        }
+    }
+    return n
+}
+
+// Đọc đủ n byte; số byte đọc được (< n nếu đầu kia đóng giữa chừng), -1 nếu lỗi
+async fn aread_exact(fd: int, buf: *u8, n: int) -> int {
+    let mut off = 0
+    while off < n {
+        let r = await aread(fd, &buf[off], n - off)
+        if r < 0 {
+            return -1
+        }
+        if r == 0 {
+            return off
+        }
+        off += r
+    }
+    return n
+}
+
+// ---- Tệp: map_file và đọc theo dòng/bản ghi ----
+// 'bytes' là lát cắt byte chỉ đọc (con trỏ + độ dài, không sở hữu): len(b),
+// b[i], for c in b, println("{}", b). map_file ánh xạ cả tệp bằng mmap (không
+// chép); reader cắt tệp/fd thành dòng hoặc bản ghi trỏ thẳng vào dữ liệu,
+// không cấp phát mỗi dòng.
+extern fn g_map_file(path: str, out: *bytes) -> bool
+extern fn g_unmap(b: *bytes)
+extern fn g_map_random(b: *bytes)
+extern fn g_bytes_slice(b: bytes, start: usize, n: usize) -> bytes
+extern fn g_bytes_find(b: bytes, needle: str) -> isize
+extern fn g_bytes_eq(b: bytes, s: str) -> bool
+extern fn g_bytes_starts_with(b: bytes, s: str) -> bool
+extern fn g_bytes_count(b: bytes, c: char) -> usize
+extern fn g_bytes_to_str(b: bytes) -> str
+extern fn g_write_file(path: str, b: bytes) -> bool
+extern fn g_str_bytes(s: str) -> bytes
+extern fn g_string_bytes(b: *strbuf) -> bytes
+extern fn g_reader_open(path: str, map: bool, r: *reader) -> bool
+extern fn g_reader_fd(fd: int) -> reader
+extern fn g_reader_next(r: *reader, sep: char, out: *bytes) -> bool
+extern fn g_reader_chunk(r: *reader, sep: char, out: *bytes) -> bool
+extern fn g_reader_close(r: *reader)
+
+// Cả tệp dưới dạng bytes (rỗng nếu không mở được); giải phóng bằng unmap(&b)
+fn map_file(path: str) -> bytes {
+    let mut b: bytes
+    g_map_file(path, &b)
+    return b
+}
+
+// Như map_file nhưng báo lỗi: false nếu không mở được / không phải tệp thường
+fn try_map_file(path: str, out: *bytes) -> bool { return g_map_file(path, out) }
+fn unmap(b: *bytes) { g_unmap(b) }
+
+// Gợi ý kernel: truy cập ngẫu nhiên (tra cứu) thay vì quét tuần tự (mặc định)
+fn map_random(b: *bytes) { g_map_random(b) }
+
+// Ghi đè (tạo nếu chưa có) cả tệp; false nếu lỗi
+fn write_file(path: str, data: bytes) -> bool { return g_write_file(path, data) }
+
+// Nhìn chuỗi / nội dung strbuf như bytes (không chép; sửa strbuf thì bytes hết hạn)
+fn str_bytes(s: str) -> bytes { return g_str_bytes(s) }
+fn sb_bytes(b: *strbuf) -> bytes { return g_string_bytes(b) }
+
+// Đoạn con [start, start + n) (cắt bớt cho vừa), không chép
+fn bytes_slice(b: bytes, start: usize, n: usize) -> bytes { return g_bytes_slice(b, start, n) }
+
+// Vị trí đầu tiên của needle, hoặc -1 (nhân tìm chuỗi SIMD của runtime)
+fn bytes_find(b: bytes, needle: str) -> isize { return g_bytes_find(b, needle) }
+fn bytes_eq(b: bytes, s: str) -> bool { return g_bytes_eq(b, s) }
+fn bytes_starts_with(b: bytes, s: str) -> bool { return g_bytes_starts_with(b, s) }
+
+// Số lần ký tự c xuất hiện (vd bytes_count(b, '\n') đếm dòng)
+fn bytes_count(b: bytes, c: char) -> usize { return g_bytes_count(b, c) }
+
+// Chép ra chuỗi thường (heap; nhớ g_free)
+fn bytes_to_str(b: bytes) -> str { return g_bytes_to_str(b) }
+
+// Reader trên tệp: tệp thường được map cả (dòng sống tới close_reader), còn lại
+// đọc qua bộ đệm (dòng chỉ hợp lệ tới lần next_* kế tiếp). Không mở được ->
+// reader rỗng; try_open_reader báo lỗi.
+fn open_reader(path: str) -> reader {
+    let mut r: reader
+    g_reader_open(path, true, &r)
+    return r
+}
+
+fn try_open_reader(path: str, r: *reader) -> bool { return g_reader_open(path, true, r) }
+
+// Reader luôn đọc bằng read() qua bộ đệm, không mmap: cho tệp trên mạng hoặc
+// tệp có thể bị cắt ngắn khi đang đọc (truy cập vùng map đã mất -> SIGBUS)
+fn stream_reader(path: str) -> reader {
+    let mut r: reader
+    g_reader_open(path, false, &r)
+    return r
+}
+
+// Reader đọc qua bộ đệm trên fd đang mở (vd 0 = stdin); không đóng fd
+fn fd_reader(fd: int) -> reader { return g_reader_fd(fd) }
+
+// Dòng kế tiếp (bỏ '\n' và '\r' cuối); false khi hết
+fn next_line(r: *reader, line: *bytes) -> bool { return g_reader_next(r, '\n', line) }
+
+// Bản ghi kế tiếp theo dấu phân cách sep (không gồm sep); false khi hết
+fn next_record(r: *reader, sep: char, rec: *bytes) -> bool { return g_reader_next(r, sep, rec) }
+
+// Khối nhiều dòng liền nhau (~1 MiB, gồm cả '\n') để tự quét; false khi hết
+fn next_chunk(r: *reader, chunk: *bytes) -> bool { return g_reader_chunk(r, '\n', chunk) }
+
+fn close_reader(r: *reader) { g_reader_close(r) }
@@ -12,28 +12,830 @@
 #include <string.h>
 #include <stddef.h>
 #include <math.h>
+#include <time.h>
+#include <stdarg.h>
+#include <float.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/epoll.h>                  /* chỉ executor async chờ fd (xem async/await) */
+#endif
 
-/* ---- Cấp phát bộ nhớ (Zig/Rust style) ---- */
-#define g_alloc(T, n)        ((T*)calloc((size_t)(n), sizeof(T)))
-#define g_realloc(p, T, n)   ((T*)realloc((p), sizeof(T) * (size_t)(n)))
-#define g_free(p)            free((void*)(p))
+/* ---- Cấp phát bộ nhớ (Zig/Rust style) ----
+ * Bên trong khối 'region { }' mọi g_alloc và hàm chuỗi cấp phát từ arena của
+ * region (xem phần g_arena bên dưới); ngoài region thì là calloc/realloc/free. */
+#define g_alloc(T, n)        ((T*)g_rt_alloc_n((size_t)(n), sizeof(T), _Alignof(T)))
+#define g_realloc(p, T, n)   ((T*)g_rt_realloc((void*)(p), sizeof(T) * (size_t)(n)))
+#define g_free(p)            g_rt_free((void*)(p))
+
+/* ---- Số <-> chuỗi: nhân định dạng / phân tích không qua stdio ----
+ * Dùng chung cho print (bộ đệm stdout), int_to_str, strbuf và parse_*.
+ * Không phụ thuộc locale, không cấp phát; ghi vào bộ đệm của bên gọi và trả
+ * số byte (không thêm '\0').
+ *
+ * Số nguyên: đếm chữ số trước rồi ghi từ phải sang, mỗi lần hai chữ số tra
+ * bảng "00".."99" -> nửa số phép chia so với vòng lặp từng chữ số.
+ * Số thực: Grisu2 (Loitsch 2010, bản của Milo Yip) — dãy chữ số ngắn nhất đọc
+ * lại đúng giá trị (round-trip) trong gần như mọi trường hợp, luôn đọc lại đúng;
+ * chỉ dùng số học 64-bit và bảng 87 luỹ thừa 10 đã chuẩn hoá. */
+#define G_FMT_INT_MAX 20                /* "-9223372036854775808" */
+#define G_FMT_F64_MAX 32
+
+static const char g_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static inline int g_count_digits_u64(uint64_t v) {
+    int n = 1;
+    for (;;) {
+        if (v < 10) return n;
+        if (v < 100) return n + 1;
+        if (v < 1000) return n + 2;
+        if (v < 10000) return n + 3;
+        v /= 10000;
+        n += 4;
+    }
+}
+
+static inline size_t g_fmt_u64(char* buf, uint64_t v) {
+    int n = g_count_digits_u64(v);
+    char* p = buf + n;
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--p = g_digit_pairs[d + 1];
+        *--p = g_digit_pairs[d];
+    }
+    if (v >= 10) {
+        *--p = g_digit_pairs[v * 2 + 1];
+        *--p = g_digit_pairs[v * 2];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    return (size_t)n;
+}
+
+static inline size_t g_fmt_i64(char* buf, int64_t v) {
+    if (v < 0) {
+        *buf = '-';
+        return 1 + g_fmt_u64(buf + 1, 0ull - (uint64_t)v);
+    }
+    return g_fmt_u64(buf, (uint64_t)v);
+}
+
+/* -- Grisu2 -- số dạng f * 2^e với f 64-bit ("DIY floating point") */
+typedef struct { uint64_t f; int e; } g_diyfp;
+
+static inline g_diyfp g_diyfp_mul(g_diyfp a, g_diyfp b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128)a.f * b.f;
+    uint64_t h = (uint64_t)(p >> 64), l = (uint64_t)p;
+    if (l & (1ull << 63)) h++;                  /* làm tròn */
+#else
+    const uint64_t M32 = 0xFFFFFFFFull;
+    uint64_t a_, b_ = a.f >> 32, c = a.f & M32, d = b.f >> 32, e_ = b.f & M32;
+    a_ = b_ * d;
+    uint64_t bc = b_ * e_, ad = c * d, bd = c * e_;
+    uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32) + (1u << 31);
+    uint64_t h = a_ + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+#endif
+    return (g_diyfp){ h, a.e + b.e + 64 };
+}
+
+static inline g_diyfp g_diyfp_normalize(g_diyfp x) {
+    int s = __builtin_clzll(x.f);
+    return (g_diyfp){ x.f << s, x.e - s };
+}
+
+/* 10^k với k = -348 + 8i, chuẩn hoá (bit 63 bật), làm tròn gần nhất. */
+static const uint64_t g_pow10_f[87] = {
+    0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull,
+    0xcf42894a5dce35eaull, 0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull,
+    0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full, 0xbe5691ef416bd60cull,
+    0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+    0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull,
+    0xc21094364dfb5637ull, 0x9096ea6f3848984full, 0xd77485cb25823ac7ull,
+    0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull, 0xb23867fb2a35b28eull,
+    0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+    0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull,
+    0xb5b5ada8aaff80b8ull, 0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull,
+    0x964e858c91ba2655ull, 0xdff9772470297ebdull, 0xa6dfbd9fb8e5b88full,
+    0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+    0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull,
+    0xaa242499697392d3ull, 0xfd87b5f28300ca0eull, 0xbce5086492111aebull,
+    0x8cbccc096f5088ccull, 0xd1b71758e219652cull, 0x9c40000000000000ull,
+    0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+    0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull,
+    0x9f4f2726179a2245ull, 0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull,
+    0x83c7088e1aab65dbull, 0xc45d1df942711d9aull, 0x924d692ca61be758ull,
+    0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+    0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull,
+    0x952ab45cfa97a0b3ull, 0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull,
+    0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull, 0x88fcf317f22241e2ull,
+    0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+    0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull,
+    0x8bab8eefb6409c1aull, 0xd01fef10a657842cull, 0x9b10a4e5e9913129ull,
+    0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull, 0x80444b5e7aa7cf85ull,
+    0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+    0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+};
+static const int16_t g_pow10_e[87] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static inline void g_grisu_round(char* buf, int len, uint64_t delta, uint64_t rest,
+                                 uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/* Sinh chữ số của W trong khoảng (Mp - delta, Mp]; *k nhận số mũ thập phân. */
+static inline int g_grisu_digits(g_diyfp w, g_diyfp mp, uint64_t delta, char* buf, int* k) {
+    static const uint64_t p10[] = { 1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull,
+                                    1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+                                    10000000000ull, 100000000000ull, 1000000000000ull,
+                                    10000000000000ull, 100000000000000ull,
+                                    1000000000000000ull, 10000000000000000ull,
+                                    100000000000000000ull, 1000000000000000000ull,
+                                    10000000000000000000ull };
+    const g_diyfp one = { 1ull << -mp.e, mp.e };
+    const uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = g_count_digits_u64(p1);
+    int len = 0;
+    while (kappa > 0) {
+        uint32_t d = p1 / (uint32_t)p10[kappa - 1];
+        p1 %= (uint32_t)p10[kappa - 1];
+        if (d || len) buf[len++] = (char)('0' + d);
+        kappa--;
+        uint64_t tmp = ((uint64_t)p1 << -one.e) + p2;
+        if (tmp <= delta) {
+            *k += kappa;
+            g_grisu_round(buf, len, delta, tmp, p10[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d || len) buf[len++] = (char)('0' + d);
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int idx = -kappa;
+            g_grisu_round(buf, len, delta, p2, one.f, wp_w * (idx < 20 ? p10[idx] : 0));
+            return len;
+        }
+    }
+}
+
+/* x = v > 0 hữu hạn, mant bit phần định trị (52 cho f64, 23 cho f32) -> chữ số
+ * (không dấu chấm) vào buf, trả số chữ số; v = buf*10^k. Khoảng làm tròn tính
+ * theo độ chính xác của kiểu gốc nên f32 cho ít chữ số hơn chính nó khi nới ra f64. */
+static inline int g_grisu2_core(g_diyfp x, int mant, char* buf, int* k) {
+    const uint64_t hidden = 1ull << mant;
+    /* biên trên/dưới của khoảng làm tròn về v */
+    g_diyfp pl = { (x.f << 1) + 1, x.e - 1 };
+    while (!(pl.f & (hidden << 1))) { pl.f <<= 1; pl.e--; }
+    pl.f <<= 62 - mant;                 /* 64 - mant - 2: bit 63 bật */
+    pl.e -= 62 - mant;
+    g_diyfp mi = (x.f == hidden) ? (g_diyfp){ (x.f << 2) - 1, x.e - 2 }
+                                 : (g_diyfp){ (x.f << 1) - 1, x.e - 1 };
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+    /* luỹ thừa 10 đưa số mũ nhị phân về khoảng [-60, -32] */
+    double dk = (-61 - pl.e) * 0.30102999566398114 + 347;
+    int kk = (int)dk;
+    if (dk - kk > 0.0) kk++;
+    unsigned idx = (unsigned)((kk >> 3) + 1);
+    *k = -(-348 + (int)idx * 8);
+    g_diyfp c = { g_pow10_f[idx], g_pow10_e[idx] };
+    g_diyfp w = g_diyfp_mul(g_diyfp_normalize(x), c);
+    g_diyfp wp = g_diyfp_mul(pl, c), wm = g_diyfp_mul(mi, c);
+    wm.f++;
+    wp.f--;
+    return g_grisu_digits(w, wp, wp.f - wm.f, buf, k);
+}
+
+static inline int g_grisu2(double v, char* buf, int* k) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof bits);
+    const uint64_t hidden = 1ull << 52;
+    uint64_t frac = bits & (hidden - 1);
+    int bexp = (int)((bits >> 52) & 0x7FF);
+    g_diyfp x = bexp ? (g_diyfp){ frac + hidden, bexp - 1075 } : (g_diyfp){ frac, -1074 };
+    return g_grisu2_core(x, 52, buf, k);
+}
+
+static inline int g_grisu2_f32(float v, char* buf, int* k) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof bits);
+    const uint32_t hidden = 1u << 23;
+    uint32_t frac = bits & (hidden - 1);
+    int bexp = (int)((bits >> 23) & 0xFF);
+    g_diyfp x = bexp ? (g_diyfp){ frac + hidden, bexp - 150 } : (g_diyfp){ frac, -149 };
+    return g_grisu2_core(x, 23, buf, k);
+}
+
+/* double -> chuỗi ngắn nhất đọc lại đúng. Trình bày như JavaScript: số có
+ * phần nguyên không kèm ".0" (2, 1500), thập phân khi 1e-7 < |v| < 1e21, ngoài
+ * ra dạng mũ (1e+21, 1.5e-7). inf/nan ghi như printf. Cần G_FMT_F64_MAX byte.
+ * single: v là một f32 đã nới ra double -> chữ số ngắn nhất theo f32 (0.1f in
+ * "0.1", không phải "0.10000000149011612"). */
+static inline size_t g_fmt_fp(char* buf, double v, int single) {
+    char* p = buf;
+    if (signbit(v)) *p++ = '-';
+    if (isnan(v) || isinf(v)) {
+        memcpy(p, isnan(v) ? "nan" : "inf", 3);
+        return (size_t)(p - buf) + 3;
+    }
+    if (v == 0) {
+        *p = '0';
+        return (size_t)(p - buf) + 1;
+    }
+    char d[20];
+    int k;
+    int len = single ? g_grisu2_f32((float)fabs(v), d, &k) : g_grisu2(fabs(v), d, &k);
+    int n = len + k;                    /* vị trí dấu chấm: v = 0.d × 10^n */
+    if (n > 0 && n <= 21) {
+        if (len <= n) {
+            memcpy(p, d, (size_t)len);
+            memset(p + len, '0', (size_t)(n - len));
+            p += n;
+        } else {
+            memcpy(p, d, (size_t)n);
+            p[n] = '.';
+            memcpy(p + n + 1, d + n, (size_t)(len - n));
+            p += len + 1;
+        }
+    } else if (n > -6 && n <= 0) {
+        p[0] = '0';
+        p[1] = '.';
+        memset(p + 2, '0', (size_t)-n);
+        memcpy(p + 2 - n, d, (size_t)len);
+        p += 2 - n + len;
+    } else {
+        *p++ = d[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, d + 1, (size_t)(len - 1));
+            p += len - 1;
+        }
+        int e = n - 1;
+        *p++ = 'e';
+        *p++ = e < 0 ? '-' : '+';
+        p += g_fmt_u64(p, (uint64_t)(e < 0 ? -e : e));
+    }
+    return (size_t)(p - buf);
+}
+
+static inline size_t g_fmt_f64(char* buf, double v) { return g_fmt_fp(buf, v, 0); }
+static inline size_t g_fmt_f32(char* buf, float v) { return g_fmt_fp(buf, v, 1); }
+
+/* Bản kết thúc '\0' cho printf("%s") của eprint: buf cần G_FMT_F64_MAX byte. */
+static inline const char* g_f64_cstr(char* buf, double v) {
+    buf[g_fmt_f64(buf, v)] = '\0';
+    return buf;
+}
+
+static inline const char* g_f32_cstr(char* buf, float v) {
+    buf[g_fmt_f32(buf, v)] = '\0';
+    return buf;
+}
+
+/* -- Phân tích: cả chuỗi (bỏ khoảng trắng hai đầu) phải là một số hợp lệ;
+ * sai cú pháp hoặc tràn -> false và *out giữ nguyên. */
+static inline bool g_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/* 8 byte có phải đều là chữ số ASCII không, và giá trị của chúng (SWAR). */
+static inline bool g_is_8digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) |
+             (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4))
+            == 0x3333333333333333ull);
+}
+
+static inline uint32_t g_parse_8digits(uint64_t v) {
+    v = (v & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;
+    v = (v & 0x00FF00FF00FF00FFull) * 6553601 >> 16;
+    return (uint32_t)((v & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32);
+}
+
+/* Đọc dãy chữ số vào *acc; trả số chữ số đã đọc, *sig cộng số chữ số có
+ * nghĩa (bỏ số 0 đầu). Chỉ 19 chữ số có nghĩa đầu vào *acc (vừa u64), phần
+ * sau chỉ được đếm — bên gọi thấy *sig > 19 thì biết đã mất chính xác. */
+static inline size_t g_scan_digits(const char* p, const char* end, uint64_t* acc, int* sig) {
+    const char* s = p;
+    if (*acc == 0)
+        while (p < end && *p == '0') p++;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    /* sau số 0 đầu, chữ số đầu tiên khác 0 -> mỗi khối 8 là đủ 8 chữ số có nghĩa */
+    while (end - p >= 8 && *sig + 8 <= 19) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        if (!g_is_8digits(w)) break;
+        *acc = *acc * 100000000u + g_parse_8digits(w);
+        *sig += 8;
+        p += 8;
+    }
+#endif
+    for (; p < end && (unsigned)(*p - '0') < 10; p++) {
+        if (*sig < 19) *acc = *acc * 10 + (uint64_t)(*p - '0');
+        (*sig)++;
+    }
+    return (size_t)(p - s);
+}
+
+static inline void g_trim(const char** p, const char** end) {
+    while (*p < *end && g_is_space(**p)) (*p)++;
+    while (*end > *p && g_is_space((*end)[-1])) (*end)--;
+}
+
+static inline bool g_parse_i64(const char* s, size_t n, int64_t* out) {
+    if (!s) return false;
+    const char* p = s;
+    const char* end = s + n;
+    g_trim(&p, &end);
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    uint64_t v = 0;
+    int sig = 0;
+    size_t nd = g_scan_digits(p, end, &v, &sig);
+    if (nd == 0 || p + nd != end || sig > 19) return false;
+    if (v > (uint64_t)INT64_MAX + neg) return false;
+    *out = neg ? (int64_t)(0ull - v) : (int64_t)v;
+    return true;
+}
+
+static inline bool g_match_word(const char* p, const char* end, const char* w) {
+    size_t n = strlen(w);
+    if ((size_t)(end - p) != n) return false;
+    for (size_t i = 0; i < n; i++)
+        if ((p[i] | 0x20) != w[i]) return false;
+    return true;
+}
+
+/* Nhánh nhanh (Clinger): phần định trị <= 2^53 và |số mũ| <= 22 thì m và 10^e
+ * đều đúng tuyệt đối trong double, một phép nhân/chia làm tròn đúng. Còn lại
+ * (định trị dài, số mũ lớn, x87 làm tròn kép) -> strtod trên chuỗi đã kiểm tra.
+ * Tràn (vd "1e400") và tràn dưới về 0 trả false, không đổi *out. */
+static inline bool g_parse_f64(const char* s, size_t n, double* out) {
+    static const double p10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                  1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                  1e20, 1e21, 1e22 };
+    if (!s) return false;
+    const char* p = s;
+    const char* end = s + n;
+    g_trim(&p, &end);
+    const char* start = p;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    if (g_match_word(p, end, "inf") || g_match_word(p, end, "infinity")) {
+        *out = neg ? -INFINITY : INFINITY;
+        return true;
+    }
+    if (g_match_word(p, end, "nan")) {
+        *out = neg ? -NAN : NAN;
+        return true;
+    }
+    uint64_t m = 0;
+    int sig = 0;
+    size_t nint = g_scan_digits(p, end, &m, &sig);
+    p += nint;
+    size_t nfrac = 0;
+    if (p < end && *p == '.') {
+        p++;
+        nfrac = g_scan_digits(p, end, &m, &sig);
+        p += nfrac;
+    }
+    if (nint + nfrac == 0) return false;
+    long e10 = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool eneg = false;
+        if (p < end && (*p == '-' || *p == '+')) eneg = (*p++ == '-');
+        if (p == end) return false;
+        for (; p < end && (unsigned)(*p - '0') < 10; p++)
+            if (e10 < 100000) e10 = e10 * 10 + (*p - '0');
+        if (eneg) e10 = -e10;
+    }
+    if (p != end) return false;
+#if FLT_EVAL_METHOD == 0
+    if (sig <= 19 && m <= (1ull << 53)) {
+        long e = e10 - (long)nfrac;     /* mọi chữ số đều đã vào m */
+        if (m == 0) {
+            *out = neg ? -0.0 : 0.0;
+            return true;
+        }
+        if (e >= -22 && e <= 22) {
+            double d = (double)m;
+            d = e < 0 ? d / p10[-e] : d * p10[e];
+            *out = neg ? -d : d;
+            return true;
+        }
+    }
+#endif
+    char tmp[128];
+    size_t len = (size_t)(end - start);
+    char* buf = len < sizeof tmp ? tmp : (char*)malloc(len + 1);
+    if (!buf) return false;
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+    char* stop;
+    errno = 0;
+    double d = strtod(buf, &stop);
+    bool ok = stop == buf + len;
+    /* Tràn (±inf) hoặc tràn dưới về 0 -> lỗi như tràn số nguyên; kết quả
+     * subnormal khác 0 vẫn nhận (strtod cũng báo ERANGE cho chúng). */
+    if (ok && errno == ERANGE && (isinf(d) || d == 0)) ok = false;
+    if (buf != tmp) free(buf);
+    if (ok) *out = d;
+    return ok;
+}
+
+/* ---- Bộ đệm stdout của print/println ----
+ * print/println không gọi fprintf: trình sinh mã tách chuỗi định dạng lúc biên
+ * dịch thành các lệnh ghi chuyên biệt (g_out_lit cho đoạn chữ có sẵn độ dài,
+ * g_out_i64/u64/str/char cho đối số) vào một bộ đệm 64 KiB, nên mỗi lần in
+ * không phải phân tích định dạng hay khoá FILE của stdio. Bộ đệm được đổ ra
+ * khi đầy, khi thoát (atexit), trước eprint/printf/panic (giữ đúng thứ tự với
+ * stderr) và khi gọi flush(). Nếu stdout là terminal thì đổ theo từng dòng như
+ * stdio. Bộ đệm riêng mỗi luồng: hàm gọi từ thân 'par for' in vào bộ đệm của
+ * luồng chạy nó, được đổ (fwrite có khoá của stdio) sau mỗi phần việc, trước
+ * khi g_par_for trả về. */
+#define G_OUT_CAP (64u << 10)
+
+static __thread struct {
+    size_t len;
+    char buf[G_OUT_CAP];
+} g_out_state;
+
+static bool g_out_tty;                  /* stdout là terminal -> đổ mỗi dòng */
+
+/* Chuyển bộ đệm của luồng này sang stdio (chưa fflush). */
+static inline void g_out_drain(void) {
+    if (g_out_state.len) {
+        fwrite(g_out_state.buf, 1, g_out_state.len, stdout);
+        g_out_state.len = 0;
+    }
+}
+
+/* Đổ bộ đệm rồi fflush stdout: sau lời gọi, mọi thứ đã in đều đã ra ngoài. */
+static inline void g_out_flush(void) {
+    g_out_drain();
+    fflush(stdout);
+}
+
+__attribute__((constructor(101))) static void g_out_init(void) {
+    g_out_tty = isatty(STDOUT_FILENO);
+    atexit(g_out_flush);
+}
+
+static inline void g_out_write(const char* s, size_t n) {
+    if (__builtin_expect(n > G_OUT_CAP - g_out_state.len, 0)) {
+        g_out_flush();
+        if (n >= G_OUT_CAP) {               /* khối lớn: ghi thẳng, khỏi chép */
+            fwrite(s, 1, n, stdout);
+            return;
+        }
+    }
+    memcpy(g_out_state.buf + g_out_state.len, s, n);
+    g_out_state.len += n;
+    if (g_out_tty && memchr(s, '\n', n)) g_out_flush();
+}
+
+/* Đoạn chữ của chuỗi định dạng: độ dài tính sẵn lúc biên dịch. */
+#define g_out_lit(s, n) g_out_write((s), (n))
+
+static inline void g_out_str(const char* s) {
+    if (!s) s = "(null)";                   /* như printf("%s", NULL) của glibc */
+    g_out_write(s, strlen(s));
+}
+
+static inline void g_out_char(int c) {
+    char ch = (char)c;
+    g_out_write(&ch, 1);
+}
+
+/* G 'bytes': lát cắt byte chỉ đọc (vùng map_file, dòng của reader...) — không
+ * có '\0' kết thúc, in theo độ dài. */
+typedef struct { const uint8_t* data; size_t len; } g_bytes;
+
+static inline void g_out_bytes(g_bytes b) {
+    g_out_write((const char*)b.data, b.len);
+}
+
+/* Số ghi thẳng vào bộ đệm (chừa đủ chỗ trước) — không qua mảng tạm. */
+static inline void g_out_room(size_t n) {
+    if (__builtin_expect(n > G_OUT_CAP - g_out_state.len, 0)) g_out_flush();
+}
+
+static inline void g_out_u64(unsigned long long v) {
+    g_out_room(G_FMT_INT_MAX);
+    g_out_state.len += g_fmt_u64(g_out_state.buf + g_out_state.len, v);
+}
+
+static inline void g_out_i64(long long v) {
+    g_out_room(G_FMT_INT_MAX);
+    g_out_state.len += g_fmt_i64(g_out_state.buf + g_out_state.len, v);
+}
+
+static inline void g_out_f64(double v) {
+    g_out_room(G_FMT_F64_MAX);
+    g_out_state.len += g_fmt_f64(g_out_state.buf + g_out_state.len, v);
+}
+
+static inline void g_out_f32(float v) {
+    g_out_room(G_FMT_F64_MAX);
+    g_out_state.len += g_fmt_f32(g_out_state.buf + g_out_state.len, v);
+}
+
+/* Specifier còn lại (hex, %e, có width/precision...): vsnprintf thẳng vào
+ * bộ đệm — vẫn không khoá stdio; hiếm khi tràn thì đổ rồi thử lại. */
+__attribute__((format(printf, 1, 2)))
+static inline void g_out_fmt(const char* fmt, ...) {
+    va_list ap;
+    size_t room = G_OUT_CAP - g_out_state.len;
+    va_start(ap, fmt);
+    int n = vsnprintf(g_out_state.buf + g_out_state.len, room, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= room) {
+        g_out_flush();
+        va_start(ap, fmt);
+        if ((size_t)n < G_OUT_CAP) vsnprintf(g_out_state.buf, G_OUT_CAP, fmt, ap);
+        else vfprintf(stdout, fmt, ap);
+        va_end(ap);
+        if ((size_t)n >= G_OUT_CAP) return;
+    }
+    if (g_out_tty && memchr(g_out_state.buf + g_out_state.len, '\n', (size_t)n)) {
+        g_out_state.len += (size_t)n;
+        g_out_flush();
+        return;
+    }
+    g_out_state.len += (size_t)n;
+}
 
 /* ---- panic: dừng chương trình (giống Rust) ---- */
 _Noreturn static inline void g_panic(const char* msg) {
+    g_out_flush();
     fprintf(stderr, "\033[1;31mG panic:\033[0m %s\n", msg);
     exit(101);
 }
 
 /* ---- unreachable/todo (Rust/Zig): đánh dấu nhánh không thể tới / chưa làm ---- */
 _Noreturn static inline void g_unreachable(const char* where) {
+    g_out_flush();
     fprintf(stderr, "\033[1;31mG unreachable:\033[0m %s\n", where);
     exit(101);
 }
 _Noreturn static inline void g_todo(const char* where) {
+    g_out_flush();
     fprintf(stderr, "\033[1;33mG todo:\033[0m chưa cài đặt: %s\n", where);
     exit(101);
 }
 
+/* ---- g_arena: cấp phát kiểu region (bump pointer) ----
+ * Bộ nhớ lấy theo từng chunk lớn; mỗi lần cấp phát chỉ là căn lề + cộng con
+ * trỏ. Không giải phóng từng đối tượng: g_arena_reset() trả về một mốc đã lưu
+ * (g_arena_save), g_arena_free() trả toàn bộ. Chunk mới lớn gấp đôi chunk
+ * trước nên số chunk chỉ tăng theo log của tổng dung lượng. */
+#define G_ARENA_CHUNK_MIN  4096u
+#define G_ARENA_CHUNK_MAX  (64u << 20)
+
+typedef struct g_arena_chunk {
+    struct g_arena_chunk* prev;
+    size_t size;                        /* số byte dùng được trong data[] */
+    size_t used;
+    max_align_t data[];
+} g_arena_chunk;
+
+typedef struct g_arena {
+    g_arena_chunk* cur;
+    g_arena_chunk* spare;               /* chunk giữ lại sau reset để tái dùng */
+} g_arena;
+
+typedef struct g_arena_mark {
+    g_arena_chunk* chunk;
+    size_t used;
+} g_arena_mark;
+
+static inline void* g_arena_alloc(g_arena* a, size_t size, size_t align) {
+    g_arena_chunk* c = a->cur;
+    if (c) {
+        size_t off = (c->used + align - 1) & ~(align - 1);
+        if (off <= c->size && size <= c->size - off) {
+            c->used = off + size;
+            return (char*)c->data + off;
+        }
+    }
+    size_t need = size + align;
+    if (need < size) return NULL;       /* tràn số */
+    size_t csize = c ? c->size * 2 : G_ARENA_CHUNK_MIN;
+    if (csize > G_ARENA_CHUNK_MAX) csize = G_ARENA_CHUNK_MAX;
+    if (csize < need) csize = need;
+    g_arena_chunk* n = a->spare;
+    if (n && n->size >= csize) {
+        a->spare = NULL;
+    } else {
+        n = (g_arena_chunk*)malloc(sizeof(g_arena_chunk) + csize);
+        if (!n) return NULL;
+        n->size = csize;
+    }
+    n->prev = c;
+    n->used = size;                     /* data[] đã căn theo max_align_t */
+    a->cur = n;
+    return n->data;
+}
+
+static inline g_arena_mark g_arena_save(g_arena* a) {
+    g_arena_mark m = { a->cur, a->cur ? a->cur->used : 0 };
+    return m;
+}
+
+/* Huỷ mọi cấp phát sau mốc 'm'. Chunk lớn nhất bị bỏ được giữ làm 'spare' để
+ * vòng lặp region -> reset -> region không phải malloc/free lại mỗi lần. */
+static inline void g_arena_reset(g_arena* a, g_arena_mark m) {
+    while (a->cur != m.chunk) {
+        g_arena_chunk* c = a->cur;
+        a->cur = c->prev;
+        if (!a->spare || a->spare->size < c->size) {
+            free(a->spare);
+            a->spare = c;
+        } else {
+            free(c);
+        }
+    }
+    if (a->cur) a->cur->used = m.used;
+}
+
+static inline void g_arena_free(g_arena* a) {
+    g_arena_mark empty = { NULL, 0 };
+    g_arena_reset(a, empty);
+    free(a->spare);
+    a->spare = NULL;
+}
+
+/* Con trỏ p có nằm trong một chunk đang dùng của arena không? */
+static inline g_arena_chunk* g_arena_owner(const g_arena* a, const void* p) {
+    for (g_arena_chunk* c = a->cur; c; c = c->prev) {
+        const char* base = (const char*)c->data;
+        if ((const char*)p >= base && (const char*)p < base + c->used) return c;
+    }
+    return NULL;
+}
+
+/* Byte đang dùng (gồm phần đệm căn lề) — tiện để kiểm tra/đo đạc. */
+static inline size_t g_arena_used(const g_arena* a) {
+    size_t n = 0;
+    for (g_arena_chunk* c = a->cur; c; c = c->prev) n += c->used;
+    return n;
+}
+
+/* ---- region: arena ngầm định của chương trình ----
+ * 'region { ... }' sinh g_region_enter() khi vào và g_region_leave() qua cơ
+ * chế defer khi rời khối (kể cả return/break/continue). Region lồng nhau chỉ
+ * là các mốc lồng nhau trên cùng một arena; g_region_marks[d - 1] là mốc lúc
+ * vào region độ sâu d, để biết một khối arena thuộc region nào. */
+static g_arena g_region_arena;
+static unsigned g_region_depth;
+static g_arena_mark* g_region_marks;
+static unsigned g_region_marks_cap;
+
+static inline g_arena_mark g_region_enter(void) {
+    if (g_region_depth == g_region_marks_cap) {
+        unsigned cap = g_region_marks_cap ? g_region_marks_cap * 2 : 16;
+        g_arena_mark* m = (g_arena_mark*)realloc(g_region_marks, cap * sizeof *m);
+        if (!m) g_panic("region: hết bộ nhớ");
+        g_region_marks = m;
+        g_region_marks_cap = cap;
+    }
+    g_arena_mark m = g_arena_save(&g_region_arena);
+    g_region_marks[g_region_depth++] = m;
+    return m;
+}
+
+static inline void g_region_leave(g_arena_mark m) {
+    g_region_depth--;
+    g_arena_reset(&g_region_arena, m);
+}
+
+static inline size_t g_region_used(void) {
+    return g_arena_used(&g_region_arena);
+}
+
+/* Khối p (nằm trong chunk c của arena) có thuộc region trong cùng không, tức
+ * ở trên mốc của nó? Khối của region bên ngoài nằm dưới mốc: cấp phát lại nó
+ * trên đỉnh arena sẽ bị thu hồi ngay khi region trong cùng kết thúc. */
+static inline bool g_region_owns_top(const g_arena_chunk* c, const void* p) {
+    if (!g_region_depth) return false;
+    g_arena_mark m = g_region_marks[g_region_depth - 1];
+    for (const g_arena_chunk* k = g_region_arena.cur; k; k = k->prev) {
+        if (k == m.chunk)
+            return c == k && (const char*)p >= (const char*)k->data + m.used;
+        if (k == c) return true;
+    }
+    return false;
+}
+
+/* Luồng này đang chạy thân một 'par for' (xem g_par_for)? Arena của region
+ * không an toàn đa luồng nên khi đó cấp phát đi thẳng tới malloc. */
+static __thread bool g_par_inside;
+
+/* Region sở hữu container (Vec, Map) tạo ra lúc này: độ sâu region, 0 = heap.
+ * Container chỉ tăng trưởng trên arena khi region của nó đang là region trong
+ * cùng; container tạo ngoài (kể cả trước mọi region) rồi được push bên trong
+ * một region giữ bộ nhớ trên heap, không bị thu hồi khi region đó kết thúc. */
+static inline unsigned g_region_current(void) {
+    return g_par_inside ? 0 : g_region_depth;
+}
+
+/* Đích của g_alloc/g_realloc/g_free và mọi hàm chuỗi cấp phát. */
+static inline void* g_rt_malloc(size_t size) {
+    if (g_region_depth && !g_par_inside)
+        return g_arena_alloc(&g_region_arena, size, _Alignof(max_align_t));
+    return malloc(size);
+}
+
+static inline void* g_rt_alloc_n(size_t n, size_t size, size_t align) {
+    if (!g_region_depth || g_par_inside) return calloc(n, size);
+    if (size && n > SIZE_MAX / size) return NULL;
+    void* p = g_arena_alloc(&g_region_arena, n * size, align);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+
+/* Số byte từ p tới cuối phần đã dùng của chunk c. Kích thước cũ không được
+ * lưu, nhưng khối cũ chắc chắn nằm trong khoảng đó. Phải lấy TRƯỚC khi cấp
+ * phát khối mới: nếu không, khối mới ngay sau p trong cùng chunk cũng bị tính
+ * vào và memcpy chép sang vùng chồng lấn. */
+static inline size_t g_arena_avail(const g_arena_chunk* c, const void* p) {
+    return (size_t)((const char*)c->data + c->used - (const char*)p);
+}
+
+/* Chép tối đa min(avail, size) byte của khối arena p sang q. */
+static inline void* g_arena_move(const void* p, size_t avail, void* q, size_t size) {
+    if (q) memcpy(q, p, avail < size ? avail : size);
+    return q;
+}
+
+static inline void* g_rt_realloc(void* p, size_t size) {
+    if (!p) return g_rt_malloc(size);
+    g_arena_chunk* c = g_arena_owner(&g_region_arena, p);
+    if (!c) return realloc(p, size);
+    size_t avail = g_arena_avail(c, p);
+    /* Khối của region bên ngoài phải ở lại dưới mốc của region đó -> lên heap. */
+    void* q = !g_par_inside && g_region_owns_top(c, p)
+                  ? g_arena_alloc(&g_region_arena, size, _Alignof(max_align_t))
+                  : malloc(size);
+    return g_arena_move(p, avail, q, size);
+}
+
+/* Như g_rt_malloc/g_rt_realloc cho container thuộc region 'owner' (xem
+ * g_region_current): arena chỉ khi owner là region trong cùng, còn lại heap. */
+static inline void* g_rt_malloc_in(size_t size, unsigned owner) {
+    if (owner && owner == g_region_current())
+        return g_arena_alloc(&g_region_arena, size, _Alignof(max_align_t));
+    return malloc(size);
+}
+
+static inline void* g_rt_realloc_in(void* p, size_t size, unsigned owner) {
+    if (owner && owner == g_region_current()) return g_rt_realloc(p, size);
+    if (!p) return malloc(size);
+    g_arena_chunk* c = g_arena_owner(&g_region_arena, p);
+    if (!c) return realloc(p, size);
+    size_t avail = g_arena_avail(c, p);
+    return g_arena_move(p, avail, malloc(size), size);
+}
+
+/* Bộ nhớ của region được thu hồi cả khối khi rời region -> free là no-op. */
+static inline void g_rt_free(void* p) {
+    if (p && g_arena_owner(&g_region_arena, p)) return;
+    free(p);
+}
+
 /* ---- min/max/abs/clamp: statement-expression, đánh giá đối số đúng MỘT lần.
  *      (Trình sinh mã G nội tuyến phiên bản riêng; các macro này tiện cho asm/C.) */
 #define g_min(a, b)      ({ __auto_type _ga = (a); __auto_type _gb = (b); _ga < _gb ? _ga : _gb; })
@@ -43,13 +845,137 @@ _Noreturn static inline void g_todo(const char* where) {
                               _gc < _gl ? _gl : (_gc > _gh ? _gh : _gc); })
 #define g_swap(T, a, b)  do { T _gt = (a); (a) = (b); (b) = _gt; } while (0)
 
+/* ---- Nhân chuỗi SIMD: tìm chuỗi con khi đã biết độ dài ----
+ * Trên x86 chọn bản AVX2 hoặc SSE2 một lần lúc khởi động (__builtin_cpu_supports);
+ * nơi khác, hoặc khi định nghĩa G_NO_SIMD, dùng bản vô hướng dựa trên memchr.
+ * Biến môi trường G_SIMD=scalar|sse2|avx2 ép một nhánh (để đo/kiểm tra).
+ *
+ * Độ dài và so sánh bằng luôn đi thẳng strlen/strcmp: bản SIMD riêng chậm hơn
+ * libc (glibc chọn bản viết tay qua ifunc) ở mọi cỡ trong bench/str_bench.g.
+ * Tìm chuỗi con dùng bộ lọc byte đầu/byte cuối: so khớp song song needle[0] và
+ * needle[n-1] trên 16/32 vị trí, chỉ memcmp phần giữa ở ứng viên còn lại; mọi
+ * lần đọc nằm trong [0, hn). */
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(G_NO_SIMD)
+#define G_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+static inline ptrdiff_t g_strfind_scalar(const char* h, size_t hn, const char* n, size_t nn) {
+    const char* p = h;
+    const char* end = h + (hn - nn) + 1;
+    while (p < end && (p = (const char*)memchr(p, n[0], (size_t)(end - p)))) {
+        if (p[nn - 1] == n[nn - 1] && memcmp(p, n, nn) == 0) return p - h;
+        p++;
+    }
+    return -1;
+}
+
+#ifdef G_SIMD_X86
+/* Ứng viên tại i+k: h[i+k] == n[0] và h[i+k+nn-1] == n[nn-1]. Mỗi vòng xét
+ * hai vector liền nhau (32/64 vị trí) để giảm chi phí nhánh. */
+__attribute__((target("sse2")))
+static inline unsigned g_strfind_mask16(const char* p, size_t nn, __m128i first, __m128i last) {
+    __m128i bf = _mm_loadu_si128((const __m128i*)p);
+    __m128i bl = _mm_loadu_si128((const __m128i*)(p + nn - 1));
+    return (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last)));
+}
+
+__attribute__((target("sse2")))
+static ptrdiff_t g_strfind_sse2(const char* h, size_t hn, const char* n, size_t nn) {
+    const __m128i first = _mm_set1_epi8(n[0]);
+    const __m128i last = _mm_set1_epi8(n[nn - 1]);
+    size_t i = 0;
+    for (; i + nn - 1 + 32 <= hn; i += 32) {
+        uint32_t m = g_strfind_mask16(h + i, nn, first, last)
+                   | (uint32_t)g_strfind_mask16(h + i + 16, nn, first, last) << 16;
+        while (m) {
+            size_t k = (size_t)__builtin_ctz(m);
+            if (nn <= 2 || memcmp(h + i + k + 1, n + 1, nn - 2) == 0)
+                return (ptrdiff_t)(i + k);
+            m &= m - 1;
+        }
+    }
+    ptrdiff_t r = g_strfind_scalar(h + i, hn - i, n, nn);
+    return r < 0 ? -1 : (ptrdiff_t)i + r;
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t g_strfind_mask32(const char* p, size_t nn, __m256i first, __m256i last) {
+    __m256i bf = _mm256_loadu_si256((const __m256i*)p);
+    __m256i bl = _mm256_loadu_si256((const __m256i*)(p + nn - 1));
+    return (uint32_t)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last)));
+}
+
+__attribute__((target("avx2")))
+static ptrdiff_t g_strfind_avx2(const char* h, size_t hn, const char* n, size_t nn) {
+    const __m256i first = _mm256_set1_epi8(n[0]);
+    const __m256i last = _mm256_set1_epi8(n[nn - 1]);
+    size_t i = 0;
+    for (; i + nn - 1 + 64 <= hn; i += 64) {
+        uint64_t m = g_strfind_mask32(h + i, nn, first, last)
+                   | (uint64_t)g_strfind_mask32(h + i + 32, nn, first, last) << 32;
+        while (m) {
+            size_t k = (size_t)__builtin_ctzll(m);
+            if (nn <= 2 || memcmp(h + i + k + 1, n + 1, nn - 2) == 0)
+                return (ptrdiff_t)(i + k);
+            m &= m - 1;
+        }
+    }
+    ptrdiff_t r = g_strfind_scalar(h + i, hn - i, n, nn);
+    return r < 0 ? -1 : (ptrdiff_t)i + r;
+}
+#endif /* G_SIMD_X86 */
+
+/* Bảng nhân đang dùng; khởi tạo tĩnh bằng bản vô hướng để hàm chạy trước
+ * constructor (vd khởi tạo global) vẫn đúng. */
+static struct {
+    ptrdiff_t (*find)(const char*, size_t, const char*, size_t);
+    const char* name;
+} g_strk = { g_strfind_scalar, "scalar" };
+
+/* libc không có bản tìm chuỗi con khi đã biết độ dài tương đương (memmem dùng
+ * two-way), nên luôn dùng nhân SIMD. */
+__attribute__((constructor)) static void g_str_kernels_init(void) {
+#ifdef G_SIMD_X86
+    const char* force = getenv("G_SIMD");
+    if (force && strcmp(force, "scalar") == 0) return;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(force && strcmp(force, "sse2") == 0)) {
+        g_strk.find = g_strfind_avx2;
+        g_strk.name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        g_strk.find = g_strfind_sse2;
+        g_strk.name = "sse2";
+    }
+#endif
+}
+
+/* strlen thẳng: compiler còn gập được strlen("literal"). */
+static inline size_t g_str_len(const char* s) {
+    return s ? strlen(s) : 0;
+}
+
+/* Vị trí đầu tiên của n[0..nn) trong h[0..hn), hoặc -1. Không cần '\0'. */
+static inline ptrdiff_t g_str_find(const char* h, size_t hn, const char* n, size_t nn) {
+    if (nn == 0) return 0;
+    if (nn > hn) return -1;
+    if (nn == 1) {
+        const char* p = (const char*)memchr(h, n[0], hn);
+        return p ? p - h : -1;
+    }
+    return g_strk.find(h, hn, n, nn);
+}
+
 /* ---- Tiện ích chuỗi (cấp phát trên heap; nhớ g_free khi xong) ----
  * G coi 'str' là 'const char*'. Các hàm dưới đây trả về chuỗi mới trên heap
- * (trừ hàm chỉ đọc). Thiết kế an toàn null: chuỗi NULL coi như rỗng. */
+ * (trừ hàm chỉ đọc), hoặc trong arena nếu đang ở trong 'region'. Thiết kế an
+ * toàn null: chuỗi NULL coi như rỗng. */
 static inline const char* g_str_dup(const char* s) {
     if (!s) s = "";
-    size_t n = strlen(s);
-    char* p = (char*)malloc(n + 1);
+    size_t n = g_str_len(s);
+    char* p = (char*)g_rt_malloc(n + 1);
     if (p) memcpy(p, s, n + 1);
     return p;
 }
@@ -57,23 +983,45 @@ static inline const char* g_str_dup(const char* s) {
 static inline const char* g_str_concat(const char* a, const char* b) {
     if (!a) a = "";
     if (!b) b = "";
-    size_t na = strlen(a), nb = strlen(b);
-    char* p = (char*)malloc(na + nb + 1);
+    size_t na = g_str_len(a), nb = g_str_len(b);
+    char* p = (char*)g_rt_malloc(na + nb + 1);
     if (!p) return NULL;
     memcpy(p, a, na);
     memcpy(p + na, b, nb + 1);
     return p;
 }
 
+/* Nối n chuỗi trong MỘT lần cấp phát — trình sinh mã gộp chuỗi lời gọi
+ * str_concat lồng nhau thành lời gọi này: mỗi đầu vào chỉ đo độ dài một lần và
+ * không còn chuỗi trung gian (vốn bị rò) cho mỗi cấp lồng. */
+static inline const char* g_str_concat_n(size_t n, const char* const* parts) {
+    size_t lens[n ? n : 1];
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        lens[i] = g_str_len(parts[i]);
+        total += lens[i];
+    }
+    char* p = (char*)g_rt_malloc(total + 1);
+    if (!p) return NULL;
+    char* q = p;
+    for (size_t i = 0; i < n; i++) {
+        memcpy(q, parts[i] ? parts[i] : "", lens[i]);
+        q += lens[i];
+    }
+    *q = '\0';
+    return p;
+}
+
 /* Cắt chuỗi con [start, start+len) — chỉ số/độ dài được kẹp vào biên hợp lệ. */
 static inline const char* g_substr(const char* s, ptrdiff_t start, ptrdiff_t len) {
     if (!s) s = "";
-    ptrdiff_t n = (ptrdiff_t)strlen(s);
     if (start < 0) start = 0;
-    if (start > n) start = n;
     if (len < 0) len = 0;
+    /* chỉ quét tới cuối đoạn cần cắt, không strlen cả chuỗi nguồn */
+    ptrdiff_t n = (ptrdiff_t)strnlen(s, (size_t)start + (size_t)len);
+    if (start > n) start = n;
     if (start + len > n) len = n - start;
-    char* p = (char*)malloc((size_t)len + 1);
+    char* p = (char*)g_rt_malloc((size_t)len + 1);
     if (!p) return NULL;
     memcpy(p, s + start, (size_t)len);
     p[len] = '\0';
@@ -89,6 +1037,8 @@ static inline bool g_str_eq(const char* a, const char* b) {
 /* Vị trí xuất hiện đầu tiên của 'needle' trong 'hay', hoặc -1. */
 static inline ptrdiff_t g_str_index(const char* hay, const char* needle) {
     if (!hay || !needle) return -1;
+    /* libc strstr quét một lượt và dừng ở '\0'; nhân của G phải đo độ dài
+     * trước nên chỉ lợi khi độ dài đã biết (xem g_string_find). */
     const char* p = strstr(hay, needle);
     return p ? (ptrdiff_t)(p - hay) : -1;
 }
@@ -99,33 +1049,2026 @@ static inline bool g_str_contains(const char* hay, const char* needle) {
 
 static inline bool g_str_starts_with(const char* s, const char* pre) {
     if (!s || !pre) return false;
-    size_t np = strlen(pre);
-    return strncmp(s, pre, np) == 0;
+    while (*pre)
+        if (*s++ != *pre++) return false;
+    return true;
 }
 
 static inline bool g_str_ends_with(const char* s, const char* suf) {
     if (!s || !suf) return false;
-    size_t ns = strlen(s), nf = strlen(suf);
+    size_t ns = g_str_len(s), nf = g_str_len(suf);
     return nf <= ns && memcmp(s + ns - nf, suf, nf) == 0;
 }
 
+/* parse_int/parse_float: sai cú pháp hoặc tràn -> 0; muốn phân biệt lỗi thì
+ * dùng bản g_try_parse_* (trả bool, ghi kết quả qua con trỏ). */
+static inline bool g_try_parse_int(const char* s, int64_t* out) {
+    return s && g_parse_i64(s, g_str_len(s), out);
+}
+
+static inline bool g_try_parse_float(const char* s, double* out) {
+    return s && g_parse_f64(s, g_str_len(s), out);
+}
+
 static inline int64_t g_parse_int(const char* s) {
-    if (!s) return 0;
-    return (int64_t)strtoll(s, NULL, 10);
+    int64_t v = 0;
+    g_try_parse_int(s, &v);
+    return v;
 }
 
 static inline double g_parse_float(const char* s) {
-    if (!s) return 0.0;
-    return strtod(s, NULL);
+    double v = 0.0;
+    g_try_parse_float(s, &v);
+    return v;
 }
 
 /* Chuyển số nguyên thành chuỗi mới trên heap (cơ số 10). */
 static inline const char* g_int_to_str(int64_t v) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "%lld", (long long)v);
+    char buf[G_FMT_INT_MAX + 1];
+    buf[g_fmt_i64(buf, v)] = '\0';
     return g_str_dup(buf);
 }
 
+/* Số thực -> chuỗi mới trên heap (ngắn nhất đọc lại đúng, như print "{}"). */
+static inline const char* g_float_to_str(double v) {
+    char buf[G_FMT_F64_MAX];
+    return g_str_dup(g_f64_cstr(buf, v));
+}
+
+static inline const char* g_f32_to_str(float v) {
+    char buf[G_FMT_F64_MAX];
+    return g_str_dup(g_f32_cstr(buf, v));
+}
+
+/* ---- g_string: chuỗi mang theo độ dài (G: kiểu 'strbuf') ----
+ * Con trỏ + độ dài + dung lượng, nên len() là O(1) và append không phải
+ * strlen lại phần đã có. Chuỗi ngắn (<= G_STR_SSO_CAP byte) nằm ngay trong
+ * struct (SSO, không cấp phát); lớn hơn thì lên heap, dung lượng tăng gấp đôi
+ * -> n lần append tốn O(tổng độ dài). Dữ liệu luôn kết thúc bằng '\0' nên
+ * g_string_cstr() đưa thẳng cho hàm C. Giá trị toàn 0 là chuỗi rỗng hợp lệ. */
+#define G_STR_SSO_CAP 23
+
+typedef struct g_string {
+    size_t len;
+    size_t cap;                         /* 0 = đang dùng bộ đệm nội tuyến */
+    union {
+        char* heap;
+        char sso[G_STR_SSO_CAP + 1];
+    } u;
+} g_string;
+
+static inline g_string g_string_new(void) {
+    g_string s;
+    s.len = 0;
+    s.cap = 0;
+    s.u.sso[0] = '\0';
+    return s;
+}
+
+static inline char* g_string_data(g_string* s) {
+    return s->cap ? s->u.heap : s->u.sso;
+}
+
+static inline const char* g_string_cstr(g_string* s) {
+    return s->cap ? s->u.heap : s->u.sso;
+}
+
+static inline size_t g_string_len(g_string* s) {
+    return s->len;
+}
+
+/* Bảo đảm còn chỗ cho thêm 'extra' byte (không tính '\0'). */
+static inline void g_string_reserve(g_string* s, size_t extra) {
+    size_t need = s->len + extra;
+    size_t cap = s->cap ? s->cap : G_STR_SSO_CAP;
+    if (need <= cap) return;
+    size_t ncap = cap * 2;
+    if (ncap < need) ncap = need;
+    if (s->cap) {
+        char* p = (char*)realloc(s->u.heap, ncap + 1);
+        if (!p) g_panic("g_string: hết bộ nhớ");
+        s->u.heap = p;
+    } else {
+        char* p = (char*)malloc(ncap + 1);
+        if (!p) g_panic("g_string: hết bộ nhớ");
+        memcpy(p, s->u.sso, s->len + 1);
+        s->u.heap = p;
+    }
+    s->cap = ncap;
+}
+
+static inline void g_string_push_n(g_string* s, const char* p, size_t n) {
+    /* p có thể trỏ vào chính s (sb_push(&b, sb_str(&b))): lúc tăng dung
+     * lượng, SSO -> heap ghi đè lên bộ đệm nội tuyến và realloc giải phóng
+     * vùng cũ, nên nhớ vị trí tương đối rồi tính lại p sau reserve. Độ lệch
+     * tính trên số nguyên, trước reserve: gcc không còn nghi p dùng sau realloc. */
+    uintptr_t base = (uintptr_t)g_string_data(s);
+    size_t off = (size_t)((uintptr_t)p - base);
+    bool inside = (uintptr_t)p >= base && off <= s->len;
+    g_string_reserve(s, n);
+    char* d = g_string_data(s);
+    if (inside) p = d + off;
+    memcpy(d + s->len, p, n);
+    s->len += n;
+    d[s->len] = '\0';
+}
+
+static inline void g_string_push(g_string* s, const char* p) {
+    if (p) g_string_push_n(s, p, g_str_len(p));
+}
+
+static inline void g_string_push_char(g_string* s, char c) {
+    g_string_push_n(s, &c, 1);
+}
+
+static inline void g_string_push_int(g_string* s, int64_t v) {
+    char buf[G_FMT_INT_MAX];
+    g_string_push_n(s, buf, g_fmt_i64(buf, v));
+}
+
+static inline void g_string_push_float(g_string* s, double v) {
+    char buf[G_FMT_F64_MAX];
+    g_string_push_n(s, buf, g_fmt_f64(buf, v));
+}
+
+static inline void g_string_push_f32(g_string* s, float v) {
+    char buf[G_FMT_F64_MAX];
+    g_string_push_n(s, buf, g_fmt_f32(buf, v));
+}
+
+static inline g_string g_string_from(const char* p) {
+    g_string s = g_string_new();
+    g_string_push(&s, p);
+    return s;
+}
+
+/* Tìm needle trong nội dung — độ dài haystack đã biết nên đi thẳng vào nhân
+ * SIMD, không quét '\0'. */
+static inline ptrdiff_t g_string_find(g_string* s, const char* needle) {
+    if (!needle) return -1;
+    return g_str_find(g_string_cstr(s), s->len, needle, g_str_len(needle));
+}
+
+/* Xoá nội dung nhưng giữ dung lượng (tái dùng bộ đệm trong vòng lặp). */
+static inline void g_string_clear(g_string* s) {
+    s->len = 0;
+    g_string_data(s)[0] = '\0';
+}
+
+static inline void g_string_free(g_string* s) {
+    if (s->cap) free(s->u.heap);
+    *s = g_string_new();
+}
+
+/* Lấy ra chuỗi C trên heap (nhớ g_free) và đưa builder về rỗng. Bộ đệm heap
+ * được chuyển giao luôn, không sao chép. */
+static inline const char* g_string_finish(g_string* s) {
+    const char* out;
+    if (s->cap) {
+        out = s->u.heap;
+    } else {
+        char* p = (char*)g_rt_malloc(s->len + 1);
+        if (p) memcpy(p, s->u.sso, s->len + 1);
+        out = p;
+    }
+    *s = g_string_new();
+    return out;
+}
+
+/* ---- Vec[T]: mảng động, đơn hình hoá theo kiểu phần tử ----
+ * Trình sinh mã gọi G_VEC_TYPEDEF một lần cho mỗi T (sau khai báo tiến của
+ * struct — header chỉ cần T*), rồi G_VEC_IMPL sau định nghĩa struct (push
+ * cần sizeof(T)). Giá trị toàn 0 là Vec rỗng hợp lệ (trên heap; Vec khai báo
+ * trong region ghi .region, xem g_region_current); tăng trưởng nhân đôi nên
+ * push có chi phí khấu hao O(1). Kiểm tra chỉ số qua g_bounds(); định nghĩa
+ * G_NO_BOUNDS_CHECK (gc --release) bỏ hẳn kiểm tra -> v[i] chỉ còn data[i]. */
+#ifdef G_NO_BOUNDS_CHECK
+#define g_bounds(i, n) ((size_t)(i))
+#else
+_Noreturn static void g_bounds_fail(size_t i, size_t n) {
+    g_out_flush();
+    fprintf(stderr, "\033[1;31mG panic:\033[0m chỉ số %zu ngoài phạm vi Vec (len %zu)\n",
+            i, n);
+    exit(101);
+}
+static inline size_t g_bounds(size_t i, size_t n) {
+    if (__builtin_expect(i >= n, 0)) g_bounds_fail(i, n);
+    return i;
+}
+#endif
+
+#define G_VEC_TYPEDEF(V, T) \
+    typedef struct V { T* data; size_t len; size_t cap; unsigned region; } V;
+
+#define G_VEC_IMPL(V, T)                                                        \
+    static inline void V##__reserve(V* v, size_t extra) {                       \
+        if (extra <= v->cap - v->len) return;                                   \
+        size_t cap = v->cap ? v->cap * 2 : 8;                                   \
+        if (cap - v->len < extra) cap = v->len + extra;                         \
+        T* d = (T*)g_rt_realloc_in(v->data, cap * sizeof(T), v->region);        \
+        if (!d) g_panic("Vec: hết bộ nhớ");                                     \
+        v->data = d;                                                            \
+        v->cap = cap;                                                           \
+    }                                                                           \
+    static inline void V##__push(V* v, T x) {                                   \
+        if (__builtin_expect(v->len == v->cap, 0)) V##__reserve(v, 1);         \
+        v->data[v->len++] = x;                                                  \
+    }                                                                           \
+    static inline T V##__pop(V* v) {                                            \
+        if (!v->len) g_panic("Vec.pop() trên Vec rỗng");                        \
+        return v->data[--v->len];                                               \
+    }                                                                           \
+    static inline void V##__clear(V* v) { v->len = 0; }                         \
+    static inline void V##__free(V* v) {                                        \
+        g_rt_free(v->data);                                                     \
+        v->data = NULL;                                                         \
+        v->len = v->cap = 0;                                                    \
+    }                                                                           \
+    static inline V V##__from(T const* src, size_t n) {                         \
+        V v = { .region = g_region_current() };                                 \
+        V##__reserve(&v, n);                                                    \
+        memcpy(v.data, src, n * sizeof(T));                                     \
+        v.len = n;                                                              \
+        return v;                                                               \
+    }
+
+/* ---- Map[K, V]: bảng băm địa chỉ mở kiểu SwissTable ----
+ * Mỗi ô có một byte điều khiển: EMPTY (0x80), DELETED (0xFE) hoặc FULL
+ * (0..127 = 7 bit thấp của hash, "H2"). Dò theo NHÓM 16 byte điều khiển bắt
+ * đầu từ H1 = hash >> 7: một lần so sánh SSE2 + movemask cho ra mọi ô trong
+ * nhóm có H2 khớp, nên hầu hết lần tra chỉ đụng một dòng cache điều khiển và
+ * một ô dữ liệu. Gặp nhóm có ô EMPTY là dừng (khoá không có). 16 byte điều
+ * khiển đầu được chép lại sau ô cuối để nhóm đọc tràn qua cuối bảng vẫn đúng.
+ * Các nhóm kế tiếp cách nhau 16, 32, 48... ô (dò tam giác) — với cap là luỹ
+ * thừa 2 thì duyệt hết bảng. Tải tối đa 7/8; hết chỗ thì nhân đôi, hoặc băm
+ * lại cùng cỡ nếu phần lớn là ô DELETED.
+ *
+ * Như Vec: G_MAP_TYPEDEF sau khai báo tiến, G_MAP_IMPL sau định nghĩa struct.
+ * Giá trị toàn 0 là Map rỗng hợp lệ (trên heap, như Vec). Khoá 'str' lưu con
+ * trỏ, không chép. */
+#define G_MAP_GROUP 16
+#define G_CTRL_EMPTY   ((int8_t)-128)
+#define G_CTRL_DELETED ((int8_t)-2)
+
+/* Nhân 64x64 -> 128 rồi gập hai nửa (kiểu wyhash): một phép nhân, trộn đều
+ * cả bit thấp (H2) lẫn bit cao (H1). */
+static inline uint64_t g_hash_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else   /* 32-bit: không có __int128 -> fmix64 của MurmurHash3 */
+    uint64_t x = a ^ ((b << 32) | (b >> 32));
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+#endif
+}
+
+static inline uint64_t g_hash_u64(uint64_t x) {
+    return g_hash_mix(x ^ 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL);
+}
+
+static inline uint64_t g_load64(const char* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+static inline uint64_t g_load32(const char* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+
+/* Băm n byte: khối 16 byte trộn vào seed; phần đuôi đọc bằng hai lần nạp
+ * chồng nhau (không vòng lặp từng byte). */
+static inline uint64_t g_hash_bytes(const char* p, size_t n) {
+    uint64_t seed = 0x243f6a8885a308d3ULL ^ n;
+    while (n > 16) {
+        seed = g_hash_mix(g_load64(p) ^ 0xa0761d6478bd642fULL, g_load64(p + 8) ^ seed);
+        p += 16;
+        n -= 16;
+    }
+    uint64_t a = 0, b = 0;
+    if (n >= 8) {
+        a = g_load64(p);
+        b = g_load64(p + n - 8);
+    } else if (n >= 4) {
+        a = g_load32(p);
+        b = g_load32(p + n - 4);
+    } else if (n) {
+        a = ((uint64_t)(uint8_t)p[0] << 16) | ((uint64_t)(uint8_t)p[n >> 1] << 8)
+            | (uint8_t)p[n - 1];
+    }
+    return g_hash_mix(g_hash_mix(a ^ 0xe7037ed1a0b428dbULL, b ^ seed) ^ n,
+                      0x8ebc6af09c88c6e3ULL);
+}
+
+#define g_hash_int(k)      g_hash_u64((uint64_t)(k))
+#define g_hash_ptr(k)      g_hash_u64((uint64_t)(uintptr_t)(k))
+#define g_hash_str(k)      g_hash_bytes((k), g_str_len(k))
+#define g_key_eq(a, b)     ((a) == (b))
+#define g_key_eq_str(a, b) ((a) == (b) || strcmp((a), (b)) == 0)
+
+/* Bit j của kết quả = byte điều khiển g[j] thoả điều kiện. */
+#if defined(__SSE2__) && !defined(G_NO_SIMD)
+static inline uint32_t g_ctrl_match(const int8_t* g, int8_t h2) {
+    __m128i c = _mm_loadu_si128((const __m128i*)g);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(h2)));
+}
+/* EMPTY và DELETED đều âm, FULL không âm -> chỉ cần bit dấu. */
+static inline uint32_t g_ctrl_match_free(const int8_t* g) {
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+}
+#else
+static inline uint32_t g_ctrl_match(const int8_t* g, int8_t h2) {
+    uint32_t m = 0;
+    for (int j = 0; j < G_MAP_GROUP; j++) m |= (uint32_t)(g[j] == h2) << j;
+    return m;
+}
+static inline uint32_t g_ctrl_match_free(const int8_t* g) {
+    uint32_t m = 0;
+    for (int j = 0; j < G_MAP_GROUP; j++) m |= (uint32_t)(g[j] < 0) << j;
+    return m;
+}
+#endif
+#define g_ctrl_match_empty(g) g_ctrl_match((g), G_CTRL_EMPTY)
+
+#define G_MAP_TYPEDEF(M, K, V)                                                  \
+    typedef struct M##_slot M##_slot;                                           \
+    typedef struct M {                                                          \
+        int8_t* ctrl;                                                           \
+        M##_slot* slots;                                                        \
+        size_t len;                                                             \
+        size_t cap;                                                             \
+        size_t growth_left;                                                     \
+        unsigned region;                /* xem g_region_current */              \
+    } M;
+
+#define G_MAP_IMPL(M, K, V, HASH, EQ)                                           \
+    struct M##_slot { K key; V val; };                                          \
+    static inline M##_slot* M##__lookup(const M* m, K k, uint64_t h) {         \
+        size_t mask = m->cap - 1, pos = (size_t)(h >> 7) & mask, step = 0;      \
+        int8_t h2 = (int8_t)(h & 0x7f);                                         \
+        for (;;) {                                                              \
+            const int8_t* g = m->ctrl + pos;                                    \
+            for (uint32_t b = g_ctrl_match(g, h2); b; b &= b - 1) {             \
+                size_t i = (pos + (size_t)__builtin_ctz(b)) & mask;             \
+                if (EQ(m->slots[i].key, k)) return &m->slots[i];                \
+            }                                                                   \
+            if (__builtin_expect(g_ctrl_match_empty(g) != 0, 1)) return NULL;   \
+            step += G_MAP_GROUP;                                                \
+            pos = (pos + step) & mask;                                          \
+        }                                                                       \
+    }                                                                           \
+    static inline size_t M##__free_slot(const M* m, uint64_t h) {              \
+        size_t mask = m->cap - 1, pos = (size_t)(h >> 7) & mask, step = 0;      \
+        for (;;) {                                                              \
+            uint32_t b = g_ctrl_match_free(m->ctrl + pos);                      \
+            if (b) return (pos + (size_t)__builtin_ctz(b)) & mask;              \
+            step += G_MAP_GROUP;                                                \
+            pos = (pos + step) & mask;                                          \
+        }                                                                       \
+    }                                                                           \
+    static inline void M##__set_ctrl(M* m, size_t i, int8_t c) {               \
+        m->ctrl[i] = c;                                                         \
+        if (i < G_MAP_GROUP) m->ctrl[m->cap + i] = c;                           \
+    }                                                                           \
+    static void M##__resize(M* m, size_t cap) {                                 \
+        M old = *m;                                                             \
+        m->ctrl = (int8_t*)g_rt_malloc_in(cap + G_MAP_GROUP, m->region);        \
+        m->slots = (M##_slot*)g_rt_malloc_in(cap * sizeof(M##_slot), m->region); \
+        if (!m->ctrl || !m->slots) g_panic("Map: hết bộ nhớ");                  \
+        memset(m->ctrl, G_CTRL_EMPTY, cap + G_MAP_GROUP);                       \
+        m->cap = cap;                                                           \
+        m->growth_left = cap - cap / 8 - m->len;                                \
+        for (size_t i = 0; i < old.cap; i++) {                                  \
+            if (old.ctrl[i] < 0) continue;                                      \
+            uint64_t h = HASH(old.slots[i].key);                                \
+            size_t j = M##__free_slot(m, h);                                    \
+            M##__set_ctrl(m, j, (int8_t)(h & 0x7f));                            \
+            m->slots[j] = old.slots[i];                                         \
+        }                                                                       \
+        g_rt_free(old.ctrl);                                                    \
+        g_rt_free(old.slots);                                                   \
+    }                                                                           \
+    static inline void M##__reserve(M* m, size_t extra) {                       \
+        size_t cap = G_MAP_GROUP;                                               \
+        while (cap - cap / 8 < m->len + extra) cap *= 2;                        \
+        if (cap > m->cap) M##__resize(m, cap);                                  \
+    }                                                                           \
+    /* Con trỏ tới giá trị của k; chèn k (giá trị 0) nếu chưa có. */            \
+    static inline V* M##__entry(M* m, K k) {                                    \
+        if (!m->cap) M##__resize(m, G_MAP_GROUP);                               \
+        uint64_t h = HASH(k);                                                   \
+        M##_slot* s = M##__lookup(m, k, h);                                     \
+        if (s) return &s->val;                                                  \
+        size_t i = M##__free_slot(m, h);                                        \
+        if (!m->growth_left && m->ctrl[i] == G_CTRL_EMPTY) {                    \
+            size_t usable = m->cap - m->cap / 8;                                \
+            M##__resize(m, m->len < usable / 2 ? m->cap : m->cap * 2);          \
+            i = M##__free_slot(m, h);                                           \
+        }                                                                       \
+        if (m->ctrl[i] == G_CTRL_EMPTY) m->growth_left--;                       \
+        M##__set_ctrl(m, i, (int8_t)(h & 0x7f));                                \
+        m->len++;                                                               \
+        m->slots[i].key = k;                                                    \
+        memset(&m->slots[i].val, 0, sizeof(V));                                 \
+        return &m->slots[i].val;                                                \
+    }                                                                           \
+    static inline void M##__set(M* m, K k, V v) { *M##__entry(m, k) = v; }     \
+    static inline V* M##__find(const M* m, K k) {                               \
+        if (!m->len) return NULL;                                               \
+        M##_slot* s = M##__lookup(m, k, HASH(k));                               \
+        return s ? &s->val : NULL;                                              \
+    }                                                                           \
+    static inline bool M##__has(const M* m, K k) { return M##__find(m, k) != NULL; } \
+    static inline V M##__get(const M* m, K k) {                                 \
+        V* p = M##__find(m, k);                                                 \
+        if (!p) g_panic("Map.get(): khoá không tồn tại");                       \
+        return *p;                                                              \
+    }                                                                           \
+    static inline V M##__get_or(const M* m, K k, V d) {                         \
+        V* p = M##__find(m, k);                                                 \
+        return p ? *p : d;                                                      \
+    }                                                                           \
+    /* Ô xoá trở lại EMPTY nếu mọi cửa sổ 16 ô chứa nó đều có ô EMPTY         \
+     * (không chuỗi dò nào từng đi qua); ngược lại đánh dấu DELETED. */         \
+    static inline bool M##__remove(M* m, K k) {                                 \
+        if (!m->len) return false;                                              \
+        M##_slot* s = M##__lookup(m, k, HASH(k));                               \
+        if (!s) return false;                                                   \
+        size_t i = (size_t)(s - m->slots);                                      \
+        size_t before = (i - G_MAP_GROUP) & (m->cap - 1);                       \
+        uint32_t ea = g_ctrl_match_empty(m->ctrl + i);                          \
+        uint32_t eb = g_ctrl_match_empty(m->ctrl + before) << 16;               \
+        bool never_full = ea && eb                                              \
+            && (size_t)(__builtin_ctz(ea) + __builtin_clz(eb)) < G_MAP_GROUP;   \
+        M##__set_ctrl(m, i, never_full ? G_CTRL_EMPTY : G_CTRL_DELETED);        \
+        m->growth_left += never_full;                                           \
+        m->len--;                                                               \
+        return true;                                                            \
+    }                                                                           \
+    static inline void M##__clear(M* m) {                                       \
+        if (!m->cap) return;                                                    \
+        memset(m->ctrl, G_CTRL_EMPTY, m->cap + G_MAP_GROUP);                    \
+        m->len = 0;                                                             \
+        m->growth_left = m->cap - m->cap / 8;                                   \
+    }                                                                           \
+    static inline void M##__free(M* m) {                                        \
+        unsigned region = m->region;                                            \
+        g_rt_free(m->ctrl);                                                     \
+        g_rt_free(m->slots);                                                    \
+        memset(m, 0, sizeof *m);                                                \
+        m->region = region;                                                     \
+    }
+
+/* ---- Sắp xếp: pdqsort (so sánh) và radix sort (khoá nguyên) ----
+ * G_SORT_DEFINE(name, T, LESS) sinh 'void name(T* a, size_t n)' riêng cho T;
+ * LESS(x, y) là macro hoặc tên hàm — trình sinh mã dùng g_less/g_less_str/
+ * g_less_f32/g_less_f64 cho thứ tự tự nhiên và hàm G của 'sort_by', nên phép so
+ * sánh được nội tuyến thay vì gọi qua con trỏ hàm như qsort. Đối số của LESS
+ * không bao giờ có tác dụng phụ (++/-- tách ra trước), nên LESS là macro đánh
+ * giá đối số nhiều lần vẫn đúng.
+ *
+ * pdqsort (Orson Peters): quicksort với pivot trung vị 3 (ninther khi n > 128),
+ * đoạn < 24 phần tử dùng insertion sort. Nếu phân hoạch không phải đổi chỗ
+ * phần tử nào thì thử insertion sort có giới hạn — dãy đã (gần) sắp xếp xong
+ * trong O(n). Pivot bằng phần tử đứng trước đoạn (đã là cận dưới) -> gom mọi
+ * phần tử bằng nó sang trái một lần, nên nhiều khoá trùng cũng O(n log k).
+ * Phân hoạch lệch quá (< 1/8) thì xáo vài phần tử; lệch quá log2(n) lần thì
+ * chuyển sang heapsort -> luôn O(n log n). Không ổn định (not stable). */
+#define G_SORT_INSERTION 24
+#define G_SORT_NINTHER 128
+#define G_SORT_PARTIAL_LIMIT 8
+
+#define g_less(a, b)     ((a) < (b))
+#define g_less_str(a, b) (strcmp((a), (b)) < 0)
+/* NaN xếp cuối: '<' trần với NaN không phải thứ tự yếu chặt, pdqsort (phân
+ * hoạch không kiểm tra biên) có thể chạy vượt mảng. Hàm (không phải macro) vì
+ * mỗi đối số được dùng hai lần. */
+static inline bool g_less_f32(float a, float b) { return a < b || (b != b && a == a); }
+static inline bool g_less_f64(double a, double b) { return a < b || (b != b && a == a); }
+
+#define G_SORT_DEFINE(NAME, T, LESS)                                            \
+    static inline void NAME##_swap(T* x, T* y) { T t = *x; *x = *y; *y = t; }   \
+    static inline void NAME##_sort2(T* x, T* y) {                               \
+        if (LESS(*y, *x)) NAME##_swap(x, y);                                    \
+    }                                                                           \
+    static inline void NAME##_sort3(T* x, T* y, T* z) {                         \
+        NAME##_sort2(x, y);                                                     \
+        NAME##_sort2(y, z);                                                     \
+        NAME##_sort2(x, y);                                                     \
+    }                                                                           \
+    static void NAME##_insertion(T* begin, T* end) {                            \
+        if (begin == end) return;                                               \
+        for (T* cur = begin + 1; cur != end; ++cur) {                           \
+            T* sift = cur;                                                      \
+            if (LESS(*sift, *(sift - 1))) {                                     \
+                T tmp = *sift;                                                  \
+                do { *sift = *(sift - 1); --sift; }                             \
+                while (sift != begin && LESS(tmp, *(sift - 1)));                \
+                *sift = tmp;                                                    \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    /* Phần tử ngay trước begin <= mọi phần tử -> bỏ kiểm tra biên trái. */     \
+    static void NAME##_insertion_unguarded(T* begin, T* end) {                  \
+        if (begin == end) return;                                               \
+        for (T* cur = begin + 1; cur != end; ++cur) {                           \
+            T* sift = cur;                                                      \
+            if (LESS(*sift, *(sift - 1))) {                                     \
+                T tmp = *sift;                                                  \
+                do { *sift = *(sift - 1); --sift; } while (LESS(tmp, *(sift - 1))); \
+                *sift = tmp;                                                    \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    /* Insertion sort bỏ cuộc khi đã dời quá G_SORT_PARTIAL_LIMIT phần tử. */   \
+    static bool NAME##_insertion_partial(T* begin, T* end) {                    \
+        if (begin == end) return true;                                          \
+        size_t limit = 0;                                                       \
+        for (T* cur = begin + 1; cur != end; ++cur) {                           \
+            T* sift = cur;                                                      \
+            if (LESS(*sift, *(sift - 1))) {                                     \
+                T tmp = *sift;                                                  \
+                do { *sift = *(sift - 1); --sift; }                             \
+                while (sift != begin && LESS(tmp, *(sift - 1)));                \
+                *sift = tmp;                                                    \
+                limit += (size_t)(cur - sift);                                  \
+            }                                                                   \
+            if (limit > G_SORT_PARTIAL_LIMIT) return false;                     \
+        }                                                                       \
+        return true;                                                            \
+    }                                                                           \
+    static void NAME##_sift_down(T* a, size_t n, size_t i) {                    \
+        T x = a[i];                                                             \
+        for (size_t c; (c = 2 * i + 1) < n; i = c) {                            \
+            if (c + 1 < n && LESS(a[c], a[c + 1])) c++;                         \
+            if (!LESS(x, a[c])) break;                                          \
+            a[i] = a[c];                                                        \
+        }                                                                       \
+        a[i] = x;                                                               \
+    }                                                                           \
+    static void NAME##_heapsort(T* a, size_t n) {                               \
+        for (size_t i = n / 2; i-- > 0;) NAME##_sift_down(a, n, i);             \
+        for (size_t k = n; k-- > 1;) {                                          \
+            NAME##_swap(&a[0], &a[k]);                                          \
+            NAME##_sift_down(a, k, 0);                                          \
+        }                                                                       \
+    }                                                                           \
+    /* Pivot ở *begin; trả vị trí cuối của pivot. Phần tử == pivot sang phải. \
+     * *already = không phải đổi chỗ lần nào (đoạn có thể đã sắp xếp). */      \
+    static T* NAME##_partition_right(T* begin, T* end, bool* already) {         \
+        T pivot = *begin;                                                       \
+        T* first = begin;                                                       \
+        T* last = end;                                                          \
+        while (++first, LESS(*first, pivot)) {}                                 \
+        if (first - 1 == begin)                                                 \
+            while (first < last && (--last, !LESS(*last, pivot))) {}            \
+        else                                                                    \
+            while (--last, !LESS(*last, pivot)) {}                              \
+        *already = first >= last;                                               \
+        while (first < last) {                                                  \
+            NAME##_swap(first, last);                                           \
+            while (++first, LESS(*first, pivot)) {}                             \
+            while (--last, !LESS(*last, pivot)) {}                              \
+        }                                                                       \
+        T* pos = first - 1;                                                     \
+        *begin = *pos;                                                          \
+        *pos = pivot;                                                           \
+        return pos;                                                             \
+    }                                                                           \
+    /* Như trên nhưng phần tử == pivot sang TRÁI (dùng khi pivot trùng cận dưới). */ \
+    static T* NAME##_partition_left(T* begin, T* end) {                         \
+        T pivot = *begin;                                                       \
+        T* first = begin;                                                       \
+        T* last = end;                                                          \
+        while (--last, LESS(pivot, *last)) {}                                   \
+        if (last + 1 == end)                                                    \
+            while (first < last && (++first, !LESS(pivot, *first))) {}          \
+        else                                                                    \
+            while (++first, !LESS(pivot, *first)) {}                            \
+        while (first < last) {                                                  \
+            NAME##_swap(first, last);                                           \
+            while (--last, LESS(pivot, *last)) {}                               \
+            while (++first, !LESS(pivot, *first)) {}                            \
+        }                                                                       \
+        *begin = *last;                                                         \
+        *last = pivot;                                                          \
+        return last;                                                            \
+    }                                                                           \
+    static void NAME##_loop(T* begin, T* end, int bad_allowed, bool leftmost) { \
+        for (;;) {                                                              \
+            size_t size = (size_t)(end - begin);                                \
+            if (size < G_SORT_INSERTION) {                                      \
+                if (leftmost) NAME##_insertion(begin, end);                     \
+                else NAME##_insertion_unguarded(begin, end);                    \
+                return;                                                         \
+            }                                                                   \
+            size_t s2 = size / 2;                                               \
+            if (size > G_SORT_NINTHER) {                                        \
+                NAME##_sort3(begin, begin + s2, end - 1);                       \
+                NAME##_sort3(begin + 1, begin + (s2 - 1), end - 2);             \
+                NAME##_sort3(begin + 2, begin + (s2 + 1), end - 3);             \
+                NAME##_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));   \
+                NAME##_swap(begin, begin + s2);                                 \
+            } else {                                                            \
+                NAME##_sort3(begin + s2, begin, end - 1);                       \
+            }                                                                   \
+            if (!leftmost && !LESS(*(begin - 1), *begin)) {                     \
+                begin = NAME##_partition_left(begin, end) + 1;                  \
+                continue;                                                       \
+            }                                                                   \
+            bool already;                                                       \
+            T* pivot = NAME##_partition_right(begin, end, &already);            \
+            size_t l = (size_t)(pivot - begin), r = (size_t)(end - (pivot + 1)); \
+            if (l < size / 8 || r < size / 8) {                                 \
+                if (--bad_allowed == 0) {                                       \
+                    NAME##_heapsort(begin, size);                               \
+                    return;                                                     \
+                }                                                               \
+                if (l >= G_SORT_INSERTION) {                                    \
+                    NAME##_swap(begin, begin + l / 4);                          \
+                    NAME##_swap(pivot - 1, pivot - l / 4);                      \
+                    if (l > G_SORT_NINTHER) {                                   \
+                        NAME##_swap(begin + 1, begin + (l / 4 + 1));            \
+                        NAME##_swap(begin + 2, begin + (l / 4 + 2));            \
+                        NAME##_swap(pivot - 2, pivot - (l / 4 + 1));            \
+                        NAME##_swap(pivot - 3, pivot - (l / 4 + 2));            \
+                    }                                                           \
+                }                                                               \
+                if (r >= G_SORT_INSERTION) {                                    \
+                    NAME##_swap(pivot + 1, pivot + (1 + r / 4));                \
+                    NAME##_swap(end - 1, end - r / 4);                          \
+                    if (r > G_SORT_NINTHER) {                                   \
+                        NAME##_swap(pivot + 2, pivot + (2 + r / 4));            \
+                        NAME##_swap(pivot + 3, pivot + (3 + r / 4));            \
+                        NAME##_swap(end - 2, end - (1 + r / 4));                \
+                        NAME##_swap(end - 3, end - (2 + r / 4));                \
+                    }                                                           \
+                }                                                               \
+            } else if (already && NAME##_insertion_partial(begin, pivot)        \
+                       && NAME##_insertion_partial(pivot + 1, end)) {           \
+                return;                                                         \
+            }                                                                   \
+            /* Đệ quy nửa trái, lặp nửa phải. */                                \
+            NAME##_loop(begin, pivot, bad_allowed, leftmost);                   \
+            begin = pivot + 1;                                                  \
+            leftmost = false;                                                   \
+        }                                                                       \
+    }                                                                           \
+    static inline void NAME(T* a, size_t n) {                                   \
+        if (n < 2) return;                                                      \
+        int log2n = 0;                                                          \
+        for (size_t k = n; k > 1; k >>= 1) log2n++;                             \
+        NAME##_loop(a, a + n, log2n, true);                                     \
+    }
+
+/* Radix sort LSD theo byte cho khoá nguyên: một lượt đếm cho mọi byte, rồi
+ * mỗi byte một lượt phân phối (bỏ qua byte mà mọi khoá giống nhau — khoá nhỏ
+ * trên kiểu 64-bit chỉ tốn vài lượt). Số có dấu (SIGNED = 1): lật bit dấu để
+ * thứ tự byte khớp thứ tự số. O(n·sizeof(T)), cần thêm n phần tử bộ đệm; ổn
+ * định. SIGNED là tham số thay vì phép thử (T)-1 < 0, vốn gây -Wtype-limits
+ * với kiểu không dấu. */
+#define G_RADIX_DEFINE(NAME, T, UT, SIGNED)                                     \
+    static inline void NAME(T* a, size_t n) {                                   \
+        enum { NB = (int)sizeof(T) };                                           \
+        if (n < 2) return;                                                      \
+        const UT flip = (SIGNED) ? (UT)((UT)1 << (8 * NB - 1)) : (UT)0;         \
+        size_t cnt[NB][256];                                                    \
+        memset(cnt, 0, sizeof cnt);                                             \
+        for (size_t i = 0; i < n; i++) {                                        \
+            UT k = (UT)a[i] ^ flip;                                             \
+            for (int b = 0; b < NB; b++) cnt[b][(k >> (8 * b)) & 255]++;        \
+        }                                                                       \
+        T* buf = (T*)g_rt_malloc(n * sizeof(T));                                \
+        if (!buf) g_panic("radix sort: hết bộ nhớ");                            \
+        T* src = a;                                                             \
+        T* dst = buf;                                                           \
+        for (int b = 0; b < NB; b++) {                                          \
+            UT k0 = (UT)a[0] ^ flip;                                            \
+            if (cnt[b][(k0 >> (8 * b)) & 255] == n) continue;                   \
+            size_t off = 0;                                                     \
+            for (int d = 0; d < 256; d++) {                                     \
+                size_t c = cnt[b][d];                                           \
+                cnt[b][d] = off;                                                \
+                off += c;                                                       \
+            }                                                                   \
+            for (size_t i = 0; i < n; i++) {                                    \
+                UT k = (UT)src[i] ^ flip;                                       \
+                dst[cnt[b][(k >> (8 * b)) & 255]++] = src[i];                   \
+            }                                                                   \
+            T* t = src; src = dst; dst = t;                                     \
+        }                                                                       \
+        if (src != a) memcpy(a, src, n * sizeof(T));                            \
+        g_rt_free(buf);                                                         \
+    }
+
+G_RADIX_DEFINE(g_radix_sort_i32, int32_t, uint32_t, 1)
+G_RADIX_DEFINE(g_radix_sort_i64, int64_t, uint64_t, 1)
+G_RADIX_DEFINE(g_radix_sort_u32, uint32_t, uint32_t, 0)
+G_RADIX_DEFINE(g_radix_sort_u64, uint64_t, uint64_t, 0)
+
+/* ---- Dãy số: sum/dot/min/max và phép toán từng phần tử (SIMD) ----
+ * G_SLICE_DEFINE(S, T, A, I) sinh cho kiểu phần tử T (hậu tố tên S):
+ *   A g_slice_sum_S(const T* a, size_t n)             tổng, tích luỹ trên A
+ *   A g_slice_dot_S(const T* a, const T* b, size_t n) tích vô hướng
+ *   T g_slice_min_S / g_slice_max_S(const T* a, size_t n)   (n == 0 -> panic)
+ * A là int64_t/uint64_t cho số nguyên có/không dấu, double cho số thực (f32
+ * cũng cộng trên double); I là số nguyên có dấu cùng cỡ T (mặt nạ so sánh).
+ * G_SLICE_OP(S, T, NAME, OP) sinh d[i] = d[i] OP s[i] (g_slice_NAME_S) và
+ * d[i] = d[i] OP k (g_slice_NAMEk_S) — trình sinh mã chỉ gọi cho phép dùng tới.
+ *
+ * Mỗi nhân có ba bản: vô hướng (_w0), vector 16 byte (_w16: SSE2 trên x86,
+ * NEON... nơi khác) và 32 byte (_w32: AVX2, chỉ x86). Viết bằng vector
+ * extension của GCC/Clang nên vector hoá ở mọi mức -O (vòng for thường gcc -O2
+ * chỉ vector hoá khi biết trước số vòng). Bản dùng được chọn một lần lúc khởi
+ * động như nhân chuỗi; G_SIMD=scalar|sse2|avx2 ép một nhánh.
+ *
+ * Tổng/tích số nguyên cộng dồn trên uint64_t (g_slice_S_acc; số có dấu đổi về
+ * A ở cuối) nên quấn theo 2^64, không phải UB, và mọi thứ tự cộng cho cùng kết quả; số
+ * thực cộng theo từng làn rồi gộp, có thể lệch bit cuối so với vòng for tuần
+ * tự. min/max bỏ qua NaN (dãy toàn NaN -> NaN). Nhân từng phần tử: d và s hoặc
+ * trùng hẳn (xs += xs -> bản vô hướng), hoặc không chồng lấn; vòng chính ghi
+ * d theo khối đã căn lề W byte. */
+#if defined(G_NO_SIMD)
+static int g_slice_width = 0;
+#else
+static int g_slice_width = 16;
+#endif
+
+__attribute__((constructor)) static void g_slice_kernels_init(void) {
+#ifndef G_NO_SIMD
+    const char* force = getenv("G_SIMD");
+    if (force && strcmp(force, "scalar") == 0) {
+        g_slice_width = 0;
+        return;
+    }
+#ifdef G_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(force && strcmp(force, "sse2") == 0))
+        g_slice_width = 32;
+#endif
+#endif
+}
+
+_Noreturn static void g_slice_len_fail(size_t a, size_t b) {
+    g_out_flush();
+    fprintf(stderr, "\033[1;31mG panic:\033[0m hai dãy khác độ dài (%zu và %zu)\n", a, b);
+    exit(101);
+}
+static inline size_t g_slice_len2(size_t a, size_t b) {
+    if (__builtin_expect(a != b, 0)) g_slice_len_fail(a, b);
+    return a;
+}
+
+#define G_SLICE_TARGET_0
+#define G_SLICE_TARGET_16
+#ifdef G_SIMD_X86
+#define G_SLICE_TARGET_32 __attribute__((target("avx2")))
+#define G_SLICE_X86(...) __VA_ARGS__
+#else
+#define G_SLICE_X86(...)
+#endif
+/* SSE2 không có phép nhân làn 64 bit (pmuldq từ SSE4.1): dot số nguyên ở bản
+ * 16 byte phải giả lập và chậm hơn vòng vô hướng -> dùng _w0. */
+#if defined(G_SIMD_X86) && !defined(__SSE4_1__)
+#define G_SLICE_MUL64_SLOW 1
+#else
+#define G_SLICE_MUL64_SLOW 0
+#endif
+
+/* vu: W byte không căn lề (nạp/ghi ở địa chỉ bất kỳ); va: căn lề W; vi: mặt
+ * nạ so sánh; vk: W/8 phần tử T, nới rộng thành vs (W/8 làn acc) để cộng dồn. */
+#define G_SLICE_TYPES(S, T, A, I, W)                                            \
+    typedef T g_slice_##S##_vu##W                                               \
+        __attribute__((vector_size(W), aligned(sizeof(T)), may_alias));         \
+    typedef T g_slice_##S##_va##W __attribute__((vector_size(W), may_alias));   \
+    typedef I g_slice_##S##_vi##W __attribute__((vector_size(W)));              \
+    typedef T g_slice_##S##_vk##W                                               \
+        __attribute__((vector_size(W / 8 * sizeof(T)), aligned(sizeof(T)), may_alias)); \
+    typedef g_slice_##S##_acc g_slice_##S##_vs##W __attribute__((vector_size(W)));
+
+#define G_SLICE_WIDEN(S, W, p)                                                  \
+    __builtin_convertvector(*(const g_slice_##S##_vk##W*)(p), g_slice_##S##_vs##W)
+
+/* Bốn bộ cộng dồn độc lập để che độ trễ phép cộng (nhất là số thực). */
+#define G_SLICE_RED_W(S, T, A, I, W)                                            \
+    G_SLICE_TYPES(S, T, A, I, W)                                                \
+    G_SLICE_TARGET_##W                                                          \
+    static A g_slice_sum_##S##_w##W(const T* restrict a, size_t n) {            \
+        enum { K = W / 8 };                                                     \
+        g_slice_##S##_vs##W s0 = {0}, s1 = {0}, s2 = {0}, s3 = {0};             \
+        size_t i = 0;                                                           \
+        for (; i + 4 * K <= n; i += 4 * K) {                                    \
+            s0 += G_SLICE_WIDEN(S, W, a + i);                                   \
+            s1 += G_SLICE_WIDEN(S, W, a + i + K);                               \
+            s2 += G_SLICE_WIDEN(S, W, a + i + 2 * K);                           \
+            s3 += G_SLICE_WIDEN(S, W, a + i + 3 * K);                           \
+        }                                                                       \
+        for (; i + K <= n; i += K) s0 += G_SLICE_WIDEN(S, W, a + i);            \
+        s0 = (s0 + s1) + (s2 + s3);                                             \
+        g_slice_##S##_acc r = 0;                                                \
+        for (int k = 0; k < K; k++) r += s0[k];                                 \
+        for (; i < n; i++) r += (g_slice_##S##_acc)a[i];                        \
+        return (A)r;                                                            \
+    }                                                                           \
+    G_SLICE_TARGET_##W                                                          \
+    static A g_slice_dot_##S##_w##W(const T* restrict a, const T* restrict b,   \
+                                    size_t n) {                                 \
+        enum { K = W / 8 };                                                     \
+        g_slice_##S##_vs##W s0 = {0}, s1 = {0}, s2 = {0}, s3 = {0};             \
+        size_t i = 0;                                                           \
+        for (; i + 4 * K <= n; i += 4 * K) {                                    \
+            s0 += G_SLICE_WIDEN(S, W, a + i) * G_SLICE_WIDEN(S, W, b + i);      \
+            s1 += G_SLICE_WIDEN(S, W, a + i + K) * G_SLICE_WIDEN(S, W, b + i + K); \
+            s2 += G_SLICE_WIDEN(S, W, a + i + 2 * K)                            \
+                * G_SLICE_WIDEN(S, W, b + i + 2 * K);                           \
+            s3 += G_SLICE_WIDEN(S, W, a + i + 3 * K)                            \
+                * G_SLICE_WIDEN(S, W, b + i + 3 * K);                           \
+        }                                                                       \
+        for (; i + K <= n; i += K)                                              \
+            s0 += G_SLICE_WIDEN(S, W, a + i) * G_SLICE_WIDEN(S, W, b + i);      \
+        s0 = (s0 + s1) + (s2 + s3);                                             \
+        g_slice_##S##_acc r = 0;                                                \
+        for (int k = 0; k < K; k++) r += s0[k];                                 \
+        for (; i < n; i++) r += (g_slice_##S##_acc)a[i] * (g_slice_##S##_acc)b[i]; \
+        return (A)r;                                                            \
+    }                                                                           \
+    G_SLICE_EXT_W(S, T, W, min, <)                                              \
+    G_SLICE_EXT_W(S, T, W, max, >)
+
+/* x thay r khi x "tốt hơn" hoặc r là NaN -> NaN chỉ thắng khi toàn NaN. Vector:
+ * chọn theo mặt nạ trên bit (ép kiểu vector cùng cỡ là đổi cách nhìn bit). */
+#define G_SLICE_EXT_W(S, T, W, NAME, CMP)                                       \
+    G_SLICE_TARGET_##W                                                          \
+    static T g_slice_##NAME##_##S##_w##W(const T* restrict a, size_t n) {       \
+        enum { L = W / sizeof(T) };                                             \
+        T r = a[0];                                                             \
+        size_t i = 1;                                                           \
+        if (n >= 2 * L) {                                                       \
+            g_slice_##S##_vu##W acc = *(const g_slice_##S##_vu##W*)a;           \
+            for (i = L; i + L <= n; i += L) {                                   \
+                g_slice_##S##_vu##W x = *(const g_slice_##S##_vu##W*)(a + i);   \
+                g_slice_##S##_vi##W m = (x CMP acc) | (acc != acc);             \
+                acc = (g_slice_##S##_vu##W)(((g_slice_##S##_vi##W)x & m)        \
+                                            | ((g_slice_##S##_vi##W)acc & ~m)); \
+            }                                                                   \
+            r = acc[0];                                                         \
+            for (int k = 1; k < L; k++)                                         \
+                if (acc[k] CMP r || r != r) r = acc[k];                         \
+        }                                                                       \
+        for (; i < n; i++)                                                      \
+            if (a[i] CMP r || r != r) r = a[i];                                 \
+        return r;                                                               \
+    }
+
+/* acc: uint64_t cho A số nguyên (có hoặc không dấu), double cho số thực. */
+#define G_SLICE_DEFINE(S, T, A, I)                                              \
+    typedef __typeof__((A)0 + 0ull) g_slice_##S##_acc;                         \
+    static A g_slice_sum_##S##_w0(const T* a, size_t n) {                       \
+        g_slice_##S##_acc r = 0;                                                \
+        for (size_t i = 0; i < n; i++) r += (g_slice_##S##_acc)a[i];            \
+        return (A)r;                                                            \
+    }                                                                           \
+    static A g_slice_dot_##S##_w0(const T* a, const T* b, size_t n) {           \
+        g_slice_##S##_acc r = 0;                                                \
+        for (size_t i = 0; i < n; i++)                                          \
+            r += (g_slice_##S##_acc)a[i] * (g_slice_##S##_acc)b[i];             \
+        return (A)r;                                                            \
+    }                                                                           \
+    static T g_slice_min_##S##_w0(const T* a, size_t n) {                       \
+        T r = a[0];                                                             \
+        for (size_t i = 1; i < n; i++) if (a[i] < r || r != r) r = a[i];        \
+        return r;                                                               \
+    }                                                                           \
+    static T g_slice_max_##S##_w0(const T* a, size_t n) {                       \
+        T r = a[0];                                                             \
+        for (size_t i = 1; i < n; i++) if (a[i] > r || r != r) r = a[i];        \
+        return r;                                                               \
+    }                                                                           \
+    G_SLICE_RED_W(S, T, A, I, 16)                                               \
+    G_SLICE_X86(G_SLICE_RED_W(S, T, A, I, 32))                                  \
+    static inline A g_slice_sum_##S(const T* a, size_t n) {                     \
+        G_SLICE_X86(if (g_slice_width == 32) return g_slice_sum_##S##_w32(a, n);) \
+        if (g_slice_width) return g_slice_sum_##S##_w16(a, n);                  \
+        return g_slice_sum_##S##_w0(a, n);                                      \
+    }                                                                           \
+    static inline A g_slice_dot_##S(const T* a, const T* b, size_t n) {         \
+        G_SLICE_X86(if (g_slice_width == 32) return g_slice_dot_##S##_w32(a, b, n);) \
+        if (g_slice_width && !(G_SLICE_MUL64_SLOW && (A)0.5 == 0))              \
+            return g_slice_dot_##S##_w16(a, b, n);                              \
+        return g_slice_dot_##S##_w0(a, b, n);                                   \
+    }                                                                           \
+    static inline T g_slice_min_##S(const T* a, size_t n) {                     \
+        if (!n) g_panic("min() trên dãy rỗng");                                 \
+        G_SLICE_X86(if (g_slice_width == 32) return g_slice_min_##S##_w32(a, n);) \
+        if (g_slice_width) return g_slice_min_##S##_w16(a, n);                  \
+        return g_slice_min_##S##_w0(a, n);                                      \
+    }                                                                           \
+    static inline T g_slice_max_##S(const T* a, size_t n) {                     \
+        if (!n) g_panic("max() trên dãy rỗng");                                 \
+        G_SLICE_X86(if (g_slice_width == 32) return g_slice_max_##S##_w32(a, n);) \
+        if (g_slice_width) return g_slice_max_##S##_w16(a, n);                  \
+        return g_slice_max_##S##_w0(a, n);                                      \
+    }
+
+/* Căn lề theo d: vài phần tử đầu vô hướng tới khi d + i chia hết cho W. */
+#define G_SLICE_OP_W(S, T, NAME, OP, W)                                         \
+    G_SLICE_TARGET_##W                                                          \
+    static void g_slice_##NAME##_##S##_w##W(T* restrict d, const T* restrict s, \
+                                            size_t n) {                         \
+        enum { L = W / sizeof(T) };                                             \
+        size_t i = 0;                                                           \
+        for (; i < n && ((uintptr_t)(d + i) & (W - 1)); i++) d[i] = d[i] OP s[i]; \
+        for (; i + L <= n; i += L) {                                            \
+            g_slice_##S##_va##W* dv =                                           \
+                (g_slice_##S##_va##W*)__builtin_assume_aligned(d + i, W);       \
+            *dv = *dv OP *(const g_slice_##S##_vu##W*)(s + i);                  \
+        }                                                                       \
+        for (; i < n; i++) d[i] = d[i] OP s[i];                                 \
+    }                                                                           \
+    G_SLICE_TARGET_##W                                                          \
+    static void g_slice_##NAME##k_##S##_w##W(T* restrict d, T k, size_t n) {    \
+        enum { L = W / sizeof(T) };                                             \
+        size_t i = 0;                                                           \
+        for (; i < n && ((uintptr_t)(d + i) & (W - 1)); i++) d[i] = d[i] OP k;  \
+        for (; i + L <= n; i += L) {                                            \
+            g_slice_##S##_va##W* dv =                                           \
+                (g_slice_##S##_va##W*)__builtin_assume_aligned(d + i, W);       \
+            *dv = *dv OP k;                                                     \
+        }                                                                       \
+        for (; i < n; i++) d[i] = d[i] OP k;                                    \
+    }
+
+#define G_SLICE_OP(S, T, NAME, OP)                                              \
+    G_SLICE_OP_W(S, T, NAME, OP, 16)                                            \
+    G_SLICE_X86(G_SLICE_OP_W(S, T, NAME, OP, 32))                               \
+    static inline void g_slice_##NAME##_##S(T* d, const T* s, size_t n) {       \
+        if (d == s || !g_slice_width) {                                         \
+            for (size_t i = 0; i < n; i++) d[i] = d[i] OP s[i];                 \
+            return;                                                             \
+        }                                                                       \
+        G_SLICE_X86(if (g_slice_width == 32) { g_slice_##NAME##_##S##_w32(d, s, n); return; }) \
+        g_slice_##NAME##_##S##_w16(d, s, n);                                    \
+    }                                                                           \
+    static inline void g_slice_##NAME##k_##S(T* d, T k, size_t n) {             \
+        if (!g_slice_width) {                                                   \
+            for (size_t i = 0; i < n; i++) d[i] = d[i] OP k;                    \
+            return;                                                             \
+        }                                                                       \
+        G_SLICE_X86(if (g_slice_width == 32) { g_slice_##NAME##k_##S##_w32(d, k, n); return; }) \
+        g_slice_##NAME##k_##S##_w16(d, k, n);                                   \
+    }
+
+/* ---- par for: bể luồng, mỗi luồng một hàng đợi hai đầu + trộm việc ----
+ * 'par for i in a..b { ... }' được trình sinh mã tách thân thành hàm
+ * fn(ctx, lo, hi) chạy các lần lặp [lo, hi) rồi gọi g_par_for(n, grain, fn, ctx).
+ * Bể có G_THREADS luồng (mặc định: số CPU) tính cả luồng gọi, tạo ở lần
+ * g_par_for đầu tiên. Mỗi luồng giữ một deque Chase–Lev: chủ đẩy/lấy ở đáy
+ * (LIFO — đoạn vừa tách còn nóng trong cache), luồng rảnh trộm ở đỉnh (đoạn cũ
+ * nhất, cũng là lớn nhất). Chia đôi lười: đoạn dài hơn 'grain' bị cắt, nửa sau
+ * đẩy vào deque cho ai rảnh thì trộm, nửa đầu chạy tiếp — không ai rảnh thì
+ * chi phí chỉ là vài lần đẩy/lấy. grain = 0 nghĩa là n / (8 · số luồng).
+ *
+ * Luồng gọi cũng lấy/trộm việc cho tới khi job của nó xong, nên par for lồng
+ * nhau không chặn luồng nào. Luồng thợ quay vòng trộm khi còn job đang chạy,
+ * ngủ trên condvar khi không còn. Rút gọn (sum/min/max): mỗi đoạn cộng dồn vào
+ * biến riêng rồi gộp vào biến gốc dưới g_par_lock(). */
+#define G_PAR_MAX 256                /* số luồng tối đa của bể */
+#define G_PAR_DEQ 1024               /* sức chứa mỗi deque, lũy thừa của 2 */
+
+typedef void (*g_par_fn)(void* ctx, size_t lo, size_t hi);
+typedef struct { g_par_fn fn; void* ctx; size_t grain, pending; } g_par_job;
+typedef struct { g_par_job* job; size_t lo, hi; } g_par_task;
+typedef struct {
+    _Alignas(64) int64_t top;        /* luồng trộm tăng (CAS) */
+    _Alignas(64) int64_t bottom;     /* chỉ chủ deque ghi */
+    g_par_task buf[G_PAR_DEQ];
+} g_par_deque;
+
+static struct {
+    int n;                           /* số luồng, gồm luồng gọi (deque 0) */
+    int active;                      /* số g_par_for đang chạy */
+    g_par_deque* dq;
+    pthread_mutex_t mu;
+    pthread_cond_t cv;
+} g_par = { 1, 0, NULL, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static pthread_once_t g_par_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_par_red = PTHREAD_MUTEX_INITIALIZER;
+static __thread int g_par_self;      /* deque của luồng này */
+static __thread uint32_t g_par_seed;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define G_PAR_PAUSE() __builtin_ia32_pause()
+#else
+#define G_PAR_PAUSE() ((void)0)
+#endif
+
+static inline void g_par_lock(void) { pthread_mutex_lock(&g_par_red); }
+static inline void g_par_unlock(void) { pthread_mutex_unlock(&g_par_red); }
+
+/* Số lần lặp của a..b / a..=b với bước s (âm: đếm xuống). */
+static inline size_t g_par_count(int64_t a, int64_t b, int64_t s, bool incl) {
+    if (s == 0) g_panic("par for: bước 0 không bao giờ dừng");
+    uint64_t d, m = s > 0 ? (uint64_t)s : -(uint64_t)s;
+    if (s > 0) {
+        if (incl ? a > b : a >= b) return 0;
+        d = (uint64_t)b - (uint64_t)a;
+    } else {
+        if (incl ? a < b : a <= b) return 0;
+        d = (uint64_t)a - (uint64_t)b;
+    }
+    return (size_t)(incl ? d / m + 1 : (d - 1) / m + 1);
+}
+
+/* Chủ deque: đẩy ở đáy; false khi đầy (bên gọi tự chạy đoạn đó). */
+static inline bool g_par_push(g_par_deque* q, g_par_task t) {
+    int64_t b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&q->top, __ATOMIC_ACQUIRE);
+    if (b - top >= G_PAR_DEQ) return false;
+    q->buf[b & (G_PAR_DEQ - 1)] = t;
+    __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* Chủ deque: lấy ở đáy; phần tử cuối cùng thì tranh với luồng trộm bằng CAS. */
+static inline bool g_par_pop(g_par_deque* q, g_par_task* out) {
+    int64_t b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&q->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&q->top, __ATOMIC_RELAXED);
+    if (t > b) {
+        __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    *out = q->buf[b & (G_PAR_DEQ - 1)];
+    if (t == b) {
+        bool won = __atomic_compare_exchange_n(&q->top, &t, t + 1, false,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&q->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+/* Luồng khác: trộm ở đỉnh. */
+static inline bool g_par_steal(g_par_deque* q, g_par_task* out) {
+    int64_t t = __atomic_load_n(&q->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&q->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return false;
+    *out = q->buf[t & (G_PAR_DEQ - 1)];
+    return __atomic_compare_exchange_n(&q->top, &t, t + 1, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* Lấy việc: deque của mình trước, rồi trộm từ một luồng ngẫu nhiên trở đi. */
+static inline bool g_par_take(g_par_task* out) {
+    if (g_par_pop(&g_par.dq[g_par_self], out)) return true;
+    int n = g_par.n;
+    g_par_seed = g_par_seed * 1664525u + 1013904223u;
+    int v = (int)((g_par_seed >> 16) % (uint32_t)n);
+    for (int i = 0; i < n; i++, v = v + 1 == n ? 0 : v + 1)
+        if (v != g_par_self && g_par_steal(&g_par.dq[v], out)) return true;
+    return false;
+}
+
+static inline void g_par_run(g_par_task t) {
+    g_par_job* j = t.job;
+    while (t.hi - t.lo > j->grain) {
+        size_t mid = t.lo + (t.hi - t.lo) / 2;
+        if (!g_par_push(&g_par.dq[g_par_self], (g_par_task){ j, mid, t.hi })) break;
+        t.hi = mid;
+    }
+    j->fn(j->ctx, t.lo, t.hi);
+    g_out_drain();                      /* in từ thân: ra stdio trước khi join */
+    __atomic_sub_fetch(&j->pending, t.hi - t.lo, __ATOMIC_ACQ_REL);
+}
+
+static inline void* g_par_worker(void* arg) {
+    g_par_self = (int)(intptr_t)arg;
+    g_par_seed = (uint32_t)g_par_self * 2654435761u;
+    g_par_inside = true;
+    unsigned idle = 0;
+    for (;;) {
+        if (!__atomic_load_n(&g_par.active, __ATOMIC_ACQUIRE)) {
+            pthread_mutex_lock(&g_par.mu);
+            while (!__atomic_load_n(&g_par.active, __ATOMIC_RELAXED))
+                pthread_cond_wait(&g_par.cv, &g_par.mu);
+            pthread_mutex_unlock(&g_par.mu);
+            idle = 0;
+        }
+        g_par_task t;
+        if (g_par_take(&t)) {
+            g_par_run(t);
+            idle = 0;
+        } else if (++idle < 64) {
+            G_PAR_PAUSE();
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static inline void g_par_start(void) {
+    const char* env = getenv("G_THREADS");
+    long n = env ? strtol(env, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    n = n < 1 ? 1 : (n > G_PAR_MAX ? G_PAR_MAX : n);
+    g_par.dq = (g_par_deque*)aligned_alloc(64, (size_t)n * sizeof(g_par_deque));
+    if (!g_par.dq) g_panic("par for: hết bộ nhớ");
+    memset(g_par.dq, 0, (size_t)n * sizeof(g_par_deque));
+    int started = 1;
+    for (long i = 1; i < n; i++) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, g_par_worker, (void*)(intptr_t)i)) break;
+        pthread_detach(tid);
+        started++;
+    }
+    g_par.n = started;
+}
+
+/* Số luồng của bể (tạo bể nếu chưa có). */
+static inline int g_par_size(void) {
+    pthread_once(&g_par_once, g_par_start);
+    return g_par.n;
+}
+
+/* Chạy fn(ctx, lo, hi) phủ kín [0, n), chia cho bể luồng; trả về khi xong hết. */
+static inline void g_par_for(size_t n, size_t grain, g_par_fn fn, void* ctx) {
+    if (!n) return;
+    int nt = g_par_size();
+    if (!grain) grain = n / (8 * (size_t)nt);
+    if (!grain) grain = 1;
+    bool was = g_par_inside;
+    g_par_inside = true;
+    if (nt == 1 || n <= grain) {
+        fn(ctx, 0, n);
+        g_par_inside = was;
+        return;
+    }
+    g_par_job job = { fn, ctx, grain, n };
+    g_out_drain();                      /* giữ thứ tự với phần in trước vòng */
+    pthread_mutex_lock(&g_par.mu);
+    if (__atomic_fetch_add(&g_par.active, 1, __ATOMIC_RELEASE) == 0)
+        pthread_cond_broadcast(&g_par.cv);
+    pthread_mutex_unlock(&g_par.mu);
+    g_par_run((g_par_task){ &job, 0, n });
+    unsigned idle = 0;
+    while (__atomic_load_n(&job.pending, __ATOMIC_ACQUIRE)) {
+        g_par_task t;
+        if (g_par_take(&t)) {
+            g_par_run(t);
+            idle = 0;
+        } else if (++idle < 64) {
+            G_PAR_PAUSE();
+        } else {
+            sched_yield();
+        }
+    }
+    __atomic_fetch_sub(&g_par.active, 1, __ATOMIC_RELEASE);
+    g_par_inside = was;
+}
+
+/* ---- Mat[T]: ma trận hàng-trước (row-major) liền một khối ----
+ * G_MAT_TYPEDEF(M, T) / G_MAT_IMPL(M, T) được trình sinh mã phát một lần cho
+ * mỗi kiểu phần tử (T là int, float hoặc double). m.data[i * m.cols + j] là
+ * phần tử (i, j); Mat rỗng là giá trị toàn 0. Bộ nhớ đi qua g_rt_alloc_n nên
+ * trong 'region { }' ma trận nằm trên arena như Vec.
+ *
+ * matmul (C = A·B) chia khối theo kiểu GotoBLAS/BLIS: với mỗi khối KC hàng của
+ * B (rộng NC cột) và khối MC hàng của A, chép cả hai vào bộ đệm liền nhau theo
+ * thứ tự nhân vi mô đọc (A thành các dải MR hàng, B thành các dải NR cột, cạnh
+ * thiếu đệm 0). Nhân vi mô giữ khối MR×NR của C trong thanh ghi suốt KC bước:
+ * mỗi bước nạp NV vector của B, nhân với MR phần tử A (broadcast) -> MR·NV
+ * phép nhân-cộng trên vector cho NV + MR lần đọc. Dải B (KC×NR) nằm trong L1,
+ * khối A (MC×KC) trong L2, khối B (KC×NC) trong L3.
+ *
+ * Ba bản như nhân dãy (g_slice_width): _w0 vô hướng (MR = NR = 4), _w16 SSE2
+ * và _w32 AVX2+FMA (MR = 6, NR = 2 vector). Số thực với FMA làm tròn một lần
+ * cho mỗi phép nhân-cộng nên có thể lệch bit cuối so với vòng for. Phép nhân
+ * lớn (>= G_MAT_PAR_WORK phép nhân-cộng mỗi luồng) chia các hàng của C cho
+ * bể luồng của par for (G_THREADS). */
+#define G_MAT_KC 256
+#define G_MAT_MC 120                 /* bội của MR = 4 và 6 */
+#define G_MAT_NC 1024                /* bội của mọi NR */
+#define G_MAT_SMALL 4096             /* m·n·k nhỏ hơn: vòng i-p-j, không chép */
+#define G_MAT_PAR_WORK (1u << 21)
+
+static bool g_mat_fma;
+
+__attribute__((constructor)) static void g_mat_init(void) {
+#ifdef G_SIMD_X86
+    __builtin_cpu_init();
+    g_mat_fma = __builtin_cpu_supports("fma");
+#endif
+}
+
+_Noreturn static inline void g_mat_dim_fail(const char* op, size_t r1, size_t c1,
+                                     size_t r2, size_t c2) {
+    g_out_flush();
+    fprintf(stderr, "\033[1;31mG panic:\033[0m %s: ma trận %zux%zu và %zux%zu "
+            "không khớp cỡ\n", op, r1, c1, r2, c2);
+    exit(101);
+}
+
+/* Bộ đệm chép khối: riêng mỗi luồng, căn 64 byte, không qua arena của region. */
+static inline void* g_mat_buf(size_t bytes) {
+    void* p = aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+    if (!p) g_panic("Mat: hết bộ nhớ");
+    return p;
+}
+
+/* Chạy fn(ctx, lo, hi) phủ [0, n) trên bể luồng, khoảng ~nt phần việc; mọi
+ * đoạn bắt đầu ở bội của 'step' (số hàng của nhân vi mô). */
+typedef struct { g_par_fn fn; void* ctx; size_t n, step; } g_mat_rows;
+
+static inline void g_mat_rows_run(void* p, size_t lo, size_t hi) {
+    g_mat_rows* r = (g_mat_rows*)p;
+    size_t i1 = hi * r->step;
+    r->fn(r->ctx, lo * r->step, i1 < r->n ? i1 : r->n);
+}
+
+static inline void g_mat_parallel(g_par_fn fn, void* ctx, size_t n, size_t step, int nt) {
+    size_t units = (n + step - 1) / step;
+    if (nt <= 1 || units <= 1) {
+        fn(ctx, 0, n);
+        return;
+    }
+    g_mat_rows r = { fn, ctx, n, step };
+    g_par_for(units, (units + (size_t)nt - 1) / (size_t)nt, g_mat_rows_run, &r);
+}
+
+#define G_MAT_TARGET_0
+#define G_MAT_TARGET_16
+#define G_MAT_TARGET_32 __attribute__((target("avx2,fma")))
+
+typedef struct {
+    const void* a;
+    const void* b;
+    void* c;
+    size_t m, n, k;
+} g_mat_job;
+
+/* Nhân vi mô + chép khối + vòng khối cho một độ rộng vector W (L làn/vector). */
+#define G_MAT_GEMM_W(M, T, W, L, NV, MR)                                        \
+    G_MAT_TARGET_##W                                                            \
+    static void M##__kern_w##W(size_t kc, const T* restrict ap,                 \
+                               const T* restrict bp, T* restrict c, size_t ldc, \
+                               size_t mr, size_t nr) {                          \
+        typedef T v __attribute__((vector_size((L) * sizeof(T))));              \
+        typedef T vu __attribute__((vector_size((L) * sizeof(T)),               \
+                                    aligned(sizeof(T)), may_alias));            \
+        enum { NR = (NV) * (L) };                                               \
+        v acc[MR][NV];                                                          \
+        _Pragma("GCC unroll 8") for (int i = 0; i < MR; i++)                    \
+            _Pragma("GCC unroll 4") for (int j = 0; j < NV; j++)                \
+                acc[i][j] = (v){0};                                             \
+        const v* bv = (const v*)__builtin_assume_aligned(bp, (L) * sizeof(T));  \
+        for (size_t p = 0; p < kc; p++, ap += MR, bv += NV) {                   \
+            _Pragma("GCC unroll 8") for (int i = 0; i < MR; i++)                \
+                _Pragma("GCC unroll 4") for (int j = 0; j < NV; j++)            \
+                    acc[i][j] += ap[i] * bv[j];                                 \
+        }                                                                       \
+        if (mr == MR && nr == NR) {                                             \
+            _Pragma("GCC unroll 8") for (int i = 0; i < MR; i++)                \
+                _Pragma("GCC unroll 4") for (int j = 0; j < NV; j++)            \
+                    *(vu*)(c + i * ldc + j * (L)) += acc[i][j];                 \
+            return;                                                             \
+        }                                                                       \
+        T t[MR][NR];                                                            \
+        memcpy(t, acc, sizeof t);                                               \
+        for (size_t i = 0; i < mr; i++)                                         \
+            for (size_t j = 0; j < nr; j++) c[i * ldc + j] += t[i][j];          \
+    }                                                                           \
+    G_MAT_TARGET_##W                                                            \
+    static void M##__rows_w##W(void* ctx, size_t i0, size_t i1) {               \
+        enum { NR = (NV) * (L) };                                               \
+        const g_mat_job* jb = (const g_mat_job*)ctx;                            \
+        const T* A = (const T*)jb->a;                                           \
+        const T* B = (const T*)jb->b;                                           \
+        T* C = (T*)jb->c;                                                       \
+        size_t n = jb->n, k = jb->k;                                            \
+        T* apk = (T*)g_mat_buf(G_MAT_MC * G_MAT_KC * sizeof(T));                \
+        T* bpk = (T*)g_mat_buf(G_MAT_KC * G_MAT_NC * sizeof(T));                \
+        for (size_t jc = 0; jc < n; jc += G_MAT_NC) {                           \
+            size_t nc = n - jc < G_MAT_NC ? n - jc : G_MAT_NC;                  \
+            for (size_t pc = 0; pc < k; pc += G_MAT_KC) {                       \
+                size_t kc = k - pc < G_MAT_KC ? k - pc : G_MAT_KC;              \
+                /* B[pc.., jc..] -> dải NR cột: bpk[jr*kc + p*NR + j] */        \
+                for (size_t jr = 0; jr < nc; jr += NR) {                        \
+                    T* d = bpk + jr * kc;                                       \
+                    size_t w = nc - jr < NR ? nc - jr : NR;                     \
+                    for (size_t p = 0; p < kc; p++, d += NR) {                  \
+                        const T* s = B + (pc + p) * n + jc + jr;                \
+                        if (w == NR) memcpy(d, s, NR * sizeof(T));              \
+                        else {                                                  \
+                            for (size_t j = 0; j < w; j++) d[j] = s[j];         \
+                            for (size_t j = w; j < NR; j++) d[j] = 0;           \
+                        }                                                       \
+                    }                                                           \
+                }                                                               \
+                for (size_t ic = i0; ic < i1; ic += G_MAT_MC) {                 \
+                    size_t mc = i1 - ic < G_MAT_MC ? i1 - ic : G_MAT_MC;        \
+                    /* A[ic.., pc..] -> dải MR hàng: apk[ir*kc + p*MR + i] */   \
+                    for (size_t ir = 0; ir < mc; ir += MR) {                    \
+                        T* d = apk + ir * kc;                                   \
+                        size_t h = mc - ir < MR ? mc - ir : MR;                 \
+                        const T* s = A + (ic + ir) * k + pc;                    \
+                        for (size_t p = 0; p < kc; p++, d += MR) {              \
+                            for (size_t i = 0; i < h; i++) d[i] = s[i * k + p]; \
+                            for (size_t i = h; i < MR; i++) d[i] = 0;           \
+                        }                                                       \
+                    }                                                           \
+                    for (size_t jr = 0; jr < nc; jr += NR)                      \
+                        for (size_t ir = 0; ir < mc; ir += MR)                  \
+                            M##__kern_w##W(kc, apk + ir * kc, bpk + jr * kc,    \
+                                           C + (ic + ir) * n + jc + jr, n,      \
+                                           mc - ir < MR ? mc - ir : MR,         \
+                                           nc - jr < NR ? nc - jr : NR);        \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+        free(apk);                                                              \
+        free(bpk);                                                              \
+    }
+
+#define G_MAT_TYPEDEF(M, T) \
+    typedef struct M { T* data; size_t rows, cols; } M;
+
+#define G_MAT_IMPL(M, T)                                                        \
+    static inline void M##__free(M* m) {                                        \
+        g_rt_free(m->data);                                                     \
+        m->data = NULL;                                                         \
+        m->rows = m->cols = 0;                                                  \
+    }                                                                           \
+    static inline M M##__zeros(size_t r, size_t c) {                            \
+        M m = { NULL, r, c };                                                   \
+        if (r && c > SIZE_MAX / sizeof(T) / r) g_panic("Mat: hết bộ nhớ");     \
+        if (r && c) {                                                           \
+            m.data = (T*)g_rt_alloc_n(r * c, sizeof(T), _Alignof(max_align_t)); \
+            if (!m.data) g_panic("Mat: hết bộ nhớ");                            \
+        }                                                                       \
+        return m;                                                               \
+    }                                                                           \
+    static inline void M##__init(M* m, size_t r, size_t c) {                    \
+        M##__free(m);                                                           \
+        *m = M##__zeros(r, c);                                                  \
+    }                                                                           \
+    static inline M M##__from(T const* src, size_t r, size_t c) {               \
+        M m = M##__zeros(r, c);                                                 \
+        if (r && c) memcpy(m.data, src, r * c * sizeof(T));                    \
+        return m;                                                               \
+    }                                                                           \
+    static inline size_t M##__rows(const M* m) { return m->rows; }              \
+    static inline size_t M##__cols(const M* m) { return m->cols; }              \
+    static inline T* M##__row(const M* m, size_t i) {                           \
+        return m->data + g_bounds(i, m->rows) * m->cols;                        \
+    }                                                                           \
+    static inline void M##__fill(M* m, T x) {                                   \
+        for (size_t i = 0, n = m->rows * m->cols; i < n; i++) m->data[i] = x;   \
+    }                                                                           \
+    /* Chuyển vị theo ô 32×32: cả nguồn lẫn đích đều đọc/ghi theo dòng cache. */ \
+    static inline M M##__transpose(const M* a) {                                \
+        M t = M##__zeros(a->cols, a->rows);                                     \
+        size_t r = a->rows, c = a->cols;                                        \
+        for (size_t ib = 0; ib < r; ib += 32)                                   \
+            for (size_t jb = 0; jb < c; jb += 32) {                             \
+                size_t ie = ib + 32 < r ? ib + 32 : r;                          \
+                size_t je = jb + 32 < c ? jb + 32 : c;                          \
+                for (size_t i = ib; i < ie; i++)                                \
+                    for (size_t j = jb; j < je; j++)                            \
+                        t.data[j * r + i] = a->data[i * c + j];                 \
+            }                                                                   \
+        return t;                                                               \
+    }                                                                           \
+    G_MAT_GEMM_W(M, T, 0, 1, 4, 4)                                              \
+    G_MAT_GEMM_W(M, T, 16, 16 / sizeof(T), 2, 6)                                \
+    G_SLICE_X86(G_MAT_GEMM_W(M, T, 32, 32 / sizeof(T), 2, 6))                   \
+    /* c = a·b. c được cấp phát lại khi khác cỡ; c trùng a hoặc b thì tính vào \
+     * ma trận tạm rồi chép lại (cần cùng cỡ). */                               \
+    static inline void M##__matmul(M* c, M a, M b) {                            \
+        if (a.cols != b.rows) g_mat_dim_fail("matmul", a.rows, a.cols, b.rows, b.cols); \
+        size_t m = a.rows, n = b.cols, k = a.cols;                              \
+        bool alias = c->data && (c->data == a.data || c->data == b.data);       \
+        if (alias && (c->rows != m || c->cols != n))                            \
+            g_mat_dim_fail("matmul (đích trùng toán hạng)", c->rows, c->cols, m, n); \
+        M out = *c;                                                             \
+        if (alias) out = M##__zeros(m, n);                                      \
+        else if (c->rows != m || c->cols != n) {                                \
+            M##__init(c, m, n);                                                 \
+            out = *c;                                                           \
+        } else if (m && n) memset(out.data, 0, m * n * sizeof(T));             \
+        if (m && n && k) {                                                      \
+            double work = (double)m * n * k;                                    \
+            if (work < G_MAT_SMALL) {                                           \
+                for (size_t i = 0; i < m; i++)                                  \
+                    for (size_t p = 0; p < k; p++) {                            \
+                        T x = a.data[i * k + p];                                \
+                        for (size_t j = 0; j < n; j++)                          \
+                            out.data[i * n + j] += x * b.data[p * n + j];       \
+                    }                                                           \
+            } else {                                                            \
+                g_mat_job jb = { a.data, b.data, out.data, m, n, k };           \
+                int nt = (int)(work / G_MAT_PAR_WORK);                          \
+                if (nt > g_par_size()) nt = g_par_size();                       \
+                G_SLICE_X86(if (g_slice_width == 32 && g_mat_fma) {             \
+                    g_mat_parallel(M##__rows_w32, &jb, m, 6, nt);               \
+                } else) if (g_slice_width)                                      \
+                    g_mat_parallel(M##__rows_w16, &jb, m, 6, nt);               \
+                else                                                            \
+                    g_mat_parallel(M##__rows_w0, &jb, m, 4, nt);                \
+            }                                                                   \
+        }                                                                       \
+        if (alias) {                                                            \
+            memcpy(c->data, out.data, m * n * sizeof(T));                       \
+            M##__free(&out);                                                    \
+        }                                                                       \
+    }
+
+/* ---- popcount: lệnh POPCNT khi được bật (-mpopcnt, -march=native...), còn lại
+ *      đếm song song trong thanh ghi (SWAR) — không lặp theo từng bit. ---- */
+static inline int g_popcount64(uint64_t x) {
+#if defined(__POPCNT__) || !(defined(__x86_64__) || defined(__i386__))
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* ---- Đồng hồ đơn điệu (đo thời gian, benchmark) ---- */
+static inline int64_t g_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* ---- async/await: executor một luồng trên epoll ----
+ * 'async fn f' được trình sinh mã biến thành máy trạng thái: struct _gaf_f là
+ * khung (số trạng thái, tham số, biến sống qua 'await', khung của hàm con đang
+ * chờ) và _gaf_f_poll(khung) chạy tiếp từ điểm dừng, trả true khi xong. Không
+ * có stack riêng cho tác vụ: một tác vụ chỉ tốn đúng cỡ khung của nó.
+ *
+ * spawn(f(x)) cấp g_aio_task (khung liền sau header) và xếp vào hàng đợi sẵn
+ * sàng; g_aio_run poll lần lượt từng tác vụ theo lượt (FIFO), rồi hỏi epoll.
+ * Một tác vụ dừng bằng cách gọi một trong các hàm chờ dưới đây rồi trả false:
+ *   - g_aio_wait_fd: fd được thêm vào epoll MỘT lần (edge-triggered, cả đọc lẫn
+ *     ghi) ở lần chờ đầu; sự kiện tới khi không ai chờ được nhớ thành bit sẵn
+ *     sàng, lần chờ sau thấy bit thì chạy lại ngay, khỏi qua epoll_wait.
+ *   - g_aio_sleep: heap hẹn giờ (sớm nhất ở gốc) theo g_now_ns.
+ *   - g_aio_yield: xếp lại cuối hàng đợi, nhường lượt cho tác vụ khác.
+ * Mỗi fd tối đa một tác vụ chờ đọc và một tác vụ chờ ghi. Chỉ dùng từ luồng gọi
+ * g_aio_run (không khoá).
+ *
+ * Chỉ phần chờ fd dùng epoll (g_aio_register/g_aio_block) nên chỉ phần đó gắn
+ * với Linux; trên nền POSIX khác spawn/sleep/yield vẫn chạy (chờ hẹn giờ bằng
+ * nanosleep), còn chờ fd thì panic. */
+#define G_AIO_IN  1                  /* chờ đọc / bit sẵn sàng đọc */
+#define G_AIO_OUT 2                  /* chờ ghi / bit sẵn sàng ghi */
+#define G_AIO_REG 4                  /* fd đã nằm trong epoll */
+
+typedef bool (*g_aio_poll)(void* frame);
+typedef struct g_aio_task {
+    struct g_aio_task* next;         /* hàng đợi sẵn sàng */
+    g_aio_poll poll;
+    _Alignas(16) unsigned char frame[];
+} g_aio_task;
+typedef struct { g_aio_task* rd; g_aio_task* wr; int flags; } g_aio_fdent;
+typedef struct { int64_t at; uint64_t seq; g_aio_task* t; } g_aio_timer;
+
+static struct {
+    g_aio_task* head;
+    g_aio_task* tail;
+    g_aio_task* cur;                 /* tác vụ gốc đang được poll */
+    size_t live;                     /* tác vụ chưa xong */
+    size_t waiting;                  /* tác vụ đang chờ fd */
+    int ep;                          /* epoll fd, -1 = chưa tạo */
+    bool running;
+    g_aio_fdent* fds;                /* theo số fd */
+    size_t nfds;
+    g_aio_timer* tm;                 /* heap hẹn giờ */
+    size_t ntm, captm;
+    uint64_t seq;                    /* giữ thứ tự FIFO khi trùng giờ */
+} g_aio = { .ep = -1 };
+
+static inline void g_aio_push(g_aio_task* t) {
+    t->next = NULL;
+    if (g_aio.tail) g_aio.tail->next = t; else g_aio.head = t;
+    g_aio.tail = t;
+}
+
+static inline g_aio_task* g_aio_self(const char* what) {
+    if (!g_aio.cur) g_panic(what);
+    return g_aio.cur;
+}
+
+/* Khung (chưa khởi tạo) cho tác vụ mới; _gaf_f_start điền tham số. */
+static inline void* g_aio_spawn(g_aio_poll poll, size_t size) {
+    g_aio_task* t = (g_aio_task*)malloc(sizeof(g_aio_task) + size);
+    if (!t) g_panic("spawn: hết bộ nhớ");
+    t->poll = poll;
+    g_aio.live++;
+    g_aio_push(t);
+    return t->frame;
+}
+
+static inline g_aio_fdent* g_aio_ent(int fd) {
+    if ((size_t)fd >= g_aio.nfds) {
+        size_t n = g_aio.nfds ? g_aio.nfds : 64;
+        while (n <= (size_t)fd) n *= 2;
+        g_aio_fdent* p = (g_aio_fdent*)realloc(g_aio.fds, n * sizeof(g_aio_fdent));
+        if (!p) g_panic("async: hết bộ nhớ");
+        memset(p + g_aio.nfds, 0, (n - g_aio.nfds) * sizeof(g_aio_fdent));
+        g_aio.fds = p;
+        g_aio.nfds = n;
+    }
+    return &g_aio.fds[fd];
+}
+
+/* fd mới cấp (hoặc vừa đóng): quên trạng thái của fd cũ cùng số. */
+static inline void g_aio_forget(int fd) {
+    if (fd >= 0 && (size_t)fd < g_aio.nfds) memset(&g_aio.fds[fd], 0, sizeof(g_aio_fdent));
+}
+
+static inline void g_aio_wake(g_aio_fdent* e, int dir);
+
+#ifdef __linux__
+static inline void g_aio_register(int fd) {
+    if (g_aio.ep < 0 && (g_aio.ep = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        g_panic("async_run: không tạo được epoll");
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = fd;
+    if (epoll_ctl(g_aio.ep, EPOLL_CTL_ADD, fd, &ev) < 0 && errno != EEXIST)
+        g_panic("await: fd không chờ được bằng epoll (tệp thường?)");
+}
+
+/* Chờ sự kiện fd tối đa timeout ms (-1 = mãi) rồi đánh thức tác vụ chờ. */
+static inline void g_aio_block(int timeout) {
+    struct epoll_event ev[256];
+    if (g_aio.ep < 0 && (g_aio.ep = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        g_panic("async_run: không tạo được epoll");
+    int n = epoll_wait(g_aio.ep, ev, 256, timeout);
+    if (n < 0 && errno != EINTR) g_panic("async_run: epoll_wait lỗi");
+    for (int i = 0; i < n; i++) {
+        g_aio_fdent* e = g_aio_ent(ev[i].data.fd);
+        uint32_t m = ev[i].events;
+        if (m & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) g_aio_wake(e, G_AIO_IN);
+        if (m & (EPOLLOUT | EPOLLHUP | EPOLLERR)) g_aio_wake(e, G_AIO_OUT);
+    }
+}
+#else
+static inline void g_aio_register(int fd) {
+    (void)fd;
+    g_panic("await trên fd: executor async chỉ chờ fd được trên Linux (epoll)");
+}
+
+/* Không có fd nào được chờ: chỉ còn ngủ tới hẹn giờ sớm nhất. */
+static inline void g_aio_block(int timeout) {
+    if (timeout <= 0) return;
+    struct timespec ts = { timeout / 1000, (long)(timeout % 1000) * 1000000 };
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR) {}
+}
+#endif
+
+static inline void g_aio_wait_fd(int fd, int dir) {
+    g_aio_task* t = g_aio_self("await wait_readable/wait_writable: ngoài tác vụ của async_run()");
+    if (fd < 0) g_panic("await wait_readable/wait_writable: fd âm");
+    g_aio_fdent* e = g_aio_ent(fd);
+    if (!(e->flags & G_AIO_REG)) {
+        g_aio_register(fd);
+        e->flags |= G_AIO_REG;
+    }
+    if (e->flags & dir) {            /* đã có sự kiện chưa ai nhận */
+        e->flags &= ~dir;
+        g_aio_push(t);
+        return;
+    }
+    g_aio_task** slot = dir == G_AIO_IN ? &e->rd : &e->wr;
+    if (*slot) g_panic("await: hai tác vụ cùng chờ một fd theo cùng một chiều");
+    *slot = t;
+    g_aio.waiting++;
+}
+
+static inline void g_aio_wake(g_aio_fdent* e, int dir) {
+    g_aio_task** slot = dir == G_AIO_IN ? &e->rd : &e->wr;
+    if (*slot) {
+        g_aio_push(*slot);
+        *slot = NULL;
+        g_aio.waiting--;
+    } else {
+        e->flags |= dir;
+    }
+}
+
+static inline void g_aio_sleep(int64_t ms) {
+    g_aio_task* t = g_aio_self("await sleep_ms: ngoài tác vụ của async_run()");
+    if (g_aio.ntm == g_aio.captm) {
+        g_aio.captm = g_aio.captm ? g_aio.captm * 2 : 16;
+        g_aio.tm = (g_aio_timer*)realloc(g_aio.tm, g_aio.captm * sizeof(g_aio_timer));
+        if (!g_aio.tm) g_panic("async: hết bộ nhớ");
+    }
+    g_aio_timer x = { g_now_ns() + (ms > 0 ? ms : 0) * 1000000, g_aio.seq++, t };
+    size_t i = g_aio.ntm++;
+    while (i) {                      /* vun lên */
+        size_t p = (i - 1) / 2;
+        g_aio_timer* q = &g_aio.tm[p];
+        if (q->at < x.at || (q->at == x.at && q->seq < x.seq)) break;
+        g_aio.tm[i] = *q;
+        i = p;
+    }
+    g_aio.tm[i] = x;
+}
+
+static inline void g_aio_timer_pop(void) {
+    g_aio_timer x = g_aio.tm[--g_aio.ntm];
+    size_t n = g_aio.ntm, i = 0;
+    for (;;) {                       /* vun xuống */
+        size_t c = 2 * i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && (g_aio.tm[c + 1].at < g_aio.tm[c].at ||
+                          (g_aio.tm[c + 1].at == g_aio.tm[c].at &&
+                           g_aio.tm[c + 1].seq < g_aio.tm[c].seq))) c++;
+        if (x.at < g_aio.tm[c].at || (x.at == g_aio.tm[c].at && x.seq < g_aio.tm[c].seq)) break;
+        g_aio.tm[i] = g_aio.tm[c];
+        i = c;
+    }
+    if (n) g_aio.tm[i] = x;
+}
+
+static inline void g_aio_yield(void) {
+    g_aio_push(g_aio_self("await yield_now: ngoài tác vụ của async_run()"));
+}
+
+/* Chạy mọi tác vụ đã spawn (kể cả tác vụ chúng spawn thêm) tới khi xong hết. */
+static inline void g_aio_run(void) {
+    if (g_aio.running) g_panic("async_run: không gọi lồng trong tác vụ async");
+    g_aio.running = true;
+    while (g_aio.live) {
+        /* một lượt: tác vụ sẵn sàng lúc này; tác vụ được đánh thức trong lượt
+         * (yield, spawn) chờ lượt sau để epoll/hẹn giờ không bị bỏ đói */
+        g_aio_task* t = g_aio.head;
+        g_aio.head = g_aio.tail = NULL;
+        while (t) {
+            g_aio_task* next = t->next;
+            g_aio.cur = t;
+            if (t->poll(t->frame)) {
+                g_aio.live--;
+                free(t);
+            }
+            t = next;
+        }
+        g_aio.cur = NULL;
+        if (!g_aio.live) break;
+        int64_t now = g_now_ns();
+        while (g_aio.ntm && g_aio.tm[0].at <= now) {
+            g_aio_push(g_aio.tm[0].t);
+            g_aio_timer_pop();
+        }
+        int timeout = -1;
+        if (g_aio.head) {
+            if (!g_aio.waiting) continue;
+            timeout = 0;
+        } else if (g_aio.ntm) {
+            int64_t ms = (g_aio.tm[0].at - now + 999999) / 1000000;
+            timeout = ms > 1000000000 ? 1000000000 : (int)ms;
+        } else if (!g_aio.waiting) {
+            g_panic("async_run: mọi tác vụ còn lại đều dừng mà không chờ fd hay hẹn giờ");
+        }
+        g_aio_block(timeout);
+    }
+    g_aio.running = false;
+}
+
+/* read/write không chặn: số byte, -2 khi phải chờ (EAGAIN), -1 khi lỗi. */
+static inline int g_aio_read(int fd, uint8_t* buf, int n) {
+    for (;;) {
+        ssize_t r = read(fd, buf, (size_t)n);
+        if (r >= 0) return (int)r;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK ? -2 : -1;
+    }
+}
+
+static inline int g_aio_write(int fd, uint8_t* buf, int n) {
+    for (;;) {
+        ssize_t r = write(fd, buf, (size_t)n);
+        if (r >= 0) return (int)r;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK ? -2 : -1;
+    }
+}
+
+/* Đóng fd đã dùng với await: tác vụ còn chờ trên nó được đánh thức (lần đọc/
+ * ghi kế tiếp trả -1), số fd có thể được cấp lại an toàn. */
+static inline int g_aio_close(int fd) {
+    if (fd >= 0 && (size_t)fd < g_aio.nfds) {
+        g_aio_fdent* e = &g_aio.fds[fd];
+        g_aio_wake(e, G_AIO_IN);
+        g_aio_wake(e, G_AIO_OUT);
+        g_aio_forget(fd);
+    }
+    return close(fd);
+}
+
+static inline int g_aio_nonblock(int fd) {
+    int fl = fcntl(fd, F_GETFL);
+    return fl < 0 ? -1 : fcntl(fd, F_SETFL, fl | O_NONBLOCK);
+}
+
+/* Cặp socket Unix nối nhau / ống (pipe): fds[0] đọc, fds[1] ghi; đều không
+ * chặn. Bật cờ bằng fcntl (không dùng SOCK_NONBLOCK, chỉ có trên Linux/BSD). */
+static inline void g_aio_prepare_pair(int* fds) {
+    for (int i = 0; i < 2; i++) {
+        g_aio_nonblock(fds[i]);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        g_aio_forget(fds[i]);
+    }
+}
+
+static inline int g_aio_socketpair(int* fds) {
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return -1;
+    g_aio_prepare_pair(fds);
+    return 0;
+}
+
+static inline int g_aio_pipe(int* fds) {
+    if (pipe(fds) < 0) return -1;
+    g_aio_prepare_pair(fds);
+    return 0;
+}
+
+/* Nâng giới hạn mềm số fd mở (RLIMIT_NOFILE) lên 'want', tối đa giới hạn cứng;
+ * trả về giới hạn mềm sau cùng. */
+static inline int g_aio_nofile(int want) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) < 0) return -1;
+    if (rl.rlim_cur < (rlim_t)want) {
+        rl.rlim_cur = rl.rlim_max < (rlim_t)want ? rl.rlim_max : (rlim_t)want;
+        setrlimit(RLIMIT_NOFILE, &rl);
+        getrlimit(RLIMIT_NOFILE, &rl);
+    }
+    return rl.rlim_cur > (rlim_t)INT32_MAX ? INT32_MAX : (int)rl.rlim_cur;
+}
+
+/* ---- Tệp: map_file (mmap) và reader theo dòng/bản ghi ----
+ * g_map_file ánh xạ cả tệp chỉ đọc (MAP_PRIVATE) rồi madvise SEQUENTIAL: kernel
+ * đọc trước mạnh tay và bỏ sớm trang đã qua, dữ liệu không bị chép qua bộ đệm
+ * nào. Tệp rỗng cho bytes rỗng (data = NULL: mmap cấm độ dài 0).
+ *
+ * g_reader cắt dữ liệu thành bản ghi theo một byte phân cách bằng memchr (SIMD
+ * của libc) và trả g_bytes trỏ thẳng vào dữ liệu — không cấp phát mỗi dòng:
+ *   - map: tệp thường được map cả; bản ghi sống tới khi đóng reader. Reader
+ *     madvise WILLNEED G_READER_AHEAD byte phía trước chỗ đang đọc.
+ *   - đệm: pipe/stdin/tệp không map được, hoặc khi gọi với map = false (tệp
+ *     trên mạng, tệp có thể bị cắt ngắn khi đang đọc — mmap sẽ SIGBUS) —
+ *     read() vào bộ đệm G_READER_BUF (tự nới khi một bản ghi dài hơn); bản ghi
+ *     chỉ hợp lệ tới lần đọc kế tiếp.
+ * g_reader_chunk trả cả khối nhiều bản ghi liền nhau, kết thúc ngay sau một
+ * dấu phân cách (hoặc ở cuối dữ liệu), cho vòng lặp tự quét — khỏi trả giá
+ * một lời gọi mỗi dòng. fd của chế độ đệm phải ở chế độ chặn. */
+#define G_READER_BUF   (1u << 20)
+#define G_READER_AHEAD (8u << 20)    /* bội của cỡ trang */
+
+typedef struct {
+    g_bytes map;                     /* chế độ map: cả tệp */
+    uint8_t* buf;                    /* chế độ đệm */
+    size_t cap;
+    size_t lo, hi;                   /* phần chưa trả: map.data/buf [lo, hi) */
+    size_t ahead;                    /* map: đã madvise WILLNEED tới đây */
+    int fd;                          /* chế độ đệm: nguồn; -1 = chế độ map */
+    bool own, eof;                   /* own: reader mở fd nên reader đóng */
+} g_reader;
+
+static inline bool g_map_fd(int fd, g_bytes* out) {
+    struct stat st;
+    out->data = NULL;
+    out->len = 0;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) return false;
+    if (st.st_size == 0) return true;
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) return false;
+    posix_madvise(p, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+    out->data = (const uint8_t*)p;
+    out->len = (size_t)st.st_size;
+    return true;
+}
+
+/* false (out rỗng) nếu không mở được hoặc không phải tệp thường. */
+static inline bool g_map_file(const char* path, g_bytes* out) {
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    if (fd < 0) {
+        out->data = NULL;
+        out->len = 0;
+        return false;
+    }
+    bool ok = g_map_fd(fd, out);
+    close(fd);                       /* vùng map vẫn sống sau khi đóng fd */
+    return ok;
+}
+
+static inline void g_unmap(g_bytes* b) {
+    if (b->len) munmap((void*)b->data, b->len);
+    b->data = NULL;
+    b->len = 0;
+}
+
+/* Tra cứu ngẫu nhiên thay vì quét: tắt đọc trước. */
+static inline void g_map_random(g_bytes* b) {
+    if (b->len) posix_madvise((void*)b->data, b->len, POSIX_MADV_RANDOM);
+}
+
+/* Ghi đè (tạo nếu chưa có) cả tệp bằng b; false nếu lỗi. */
+static inline bool g_write_file(const char* path, g_bytes b) {
+    int fd = path ? open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+    if (fd < 0) return false;
+    size_t off = 0;
+    while (off < b.len) {
+        ssize_t k = write(fd, b.data + off, b.len - off);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) break;
+        off += (size_t)k;
+    }
+    return close(fd) == 0 && off == b.len;
+}
+
+/* Nhìn chuỗi / strbuf như bytes (không chép; strbuf đổi thì bytes hết hạn). */
+static inline g_bytes g_str_bytes(const char* s) {
+    g_bytes b = { (const uint8_t*)(s ? s : ""), s ? g_str_len(s) : 0 };
+    return b;
+}
+
+static inline g_bytes g_string_bytes(g_string* s) {
+    g_bytes b = { (const uint8_t*)g_string_cstr(s), s->len };
+    return b;
+}
+
+static inline g_bytes g_bytes_slice(g_bytes b, size_t start, size_t n) {
+    if (start > b.len) start = b.len;
+    if (n > b.len - start) n = b.len - start;
+    g_bytes r = { b.data + start, n };
+    return r;
+}
+
+static inline ptrdiff_t g_bytes_find(g_bytes b, const char* needle) {
+    if (!needle) return -1;
+    return g_str_find((const char*)b.data, b.len, needle, g_str_len(needle));
+}
+
+static inline bool g_bytes_eq(g_bytes b, const char* s) {
+    size_t n = s ? g_str_len(s) : 0;
+    return n == b.len && (n == 0 || memcmp(b.data, s, n) == 0);
+}
+
+static inline bool g_bytes_starts_with(g_bytes b, const char* s) {
+    size_t n = s ? g_str_len(s) : 0;
+    return n <= b.len && (n == 0 || memcmp(b.data, s, n) == 0);
+}
+
+/* Số lần byte c xuất hiện (vd đếm dòng) — memchr nhảy qua đoạn không khớp. */
+static inline size_t g_bytes_count(g_bytes b, char c) {
+    size_t k = 0;
+    const uint8_t* p = b.data;
+    const uint8_t* end = b.data + b.len;
+    while (p < end && (p = (const uint8_t*)memchr(p, (unsigned char)c, (size_t)(end - p)))) {
+        k++;
+        p++;
+    }
+    return k;
+}
+
+/* Chép ra chuỗi '\0' kết thúc (heap, hoặc arena trong region). */
+static inline const char* g_bytes_to_str(g_bytes b) {
+    char* p = (char*)g_rt_malloc(b.len + 1);
+    if (!p) return NULL;
+    if (b.len) memcpy(p, b.data, b.len);
+    p[b.len] = '\0';
+    return p;
+}
+
+static inline g_reader g_reader_fd(int fd) {
+    g_reader r;
+    memset(&r, 0, sizeof r);
+    r.fd = fd;
+    r.eof = fd < 0;
+    return r;
+}
+
+/* Tệp thường (khi map) -> chế độ map, còn lại (FIFO, thiết bị) -> chế độ đệm.
+ * false (reader rỗng) nếu không mở được. */
+static inline bool g_reader_open(const char* path, bool map, g_reader* r) {
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    *r = g_reader_fd(fd);
+    if (fd < 0) return false;
+    if (map && g_map_fd(fd, &r->map)) {
+        close(fd);
+        r->fd = -1;
+        r->hi = r->map.len;
+        return true;
+    }
+    r->own = true;
+    return true;
+}
+
+static inline void g_reader_close(g_reader* r) {
+    g_unmap(&r->map);
+    free(r->buf);
+    if (r->own) close(r->fd);
+    *r = g_reader_fd(-1);
+}
+
+static inline const uint8_t* g_reader_base(g_reader* r) {
+    return r->fd < 0 ? r->map.data : r->buf;
+}
+
+static inline void g_reader_ahead(g_reader* r) {
+    if (r->ahead >= r->hi || r->lo + G_READER_AHEAD / 2 < r->ahead) return;
+    size_t n = r->hi - r->ahead < G_READER_AHEAD ? r->hi - r->ahead : G_READER_AHEAD;
+    posix_madvise((void*)(r->map.data + r->ahead), n, POSIX_MADV_WILLNEED);
+    r->ahead += n;
+}
+
+/* Chế độ đệm: dồn phần chưa trả về đầu, nới nếu đầy, đọc thêm một lần. */
+static inline void g_reader_fill(g_reader* r) {
+    if (r->lo) {
+        memmove(r->buf, r->buf + r->lo, r->hi - r->lo);
+        r->hi -= r->lo;
+        r->lo = 0;
+    }
+    if (r->hi == r->cap) {
+        size_t cap = r->cap ? r->cap * 2 : G_READER_BUF;
+        uint8_t* p = (uint8_t*)realloc(r->buf, cap);
+        if (!p) g_panic("reader: hết bộ nhớ");
+        r->buf = p;
+        r->cap = cap;
+    }
+    for (;;) {
+        ssize_t k = read(r->fd, r->buf + r->hi, r->cap - r->hi);
+        if (k > 0) {
+            r->hi += (size_t)k;
+            return;
+        }
+        if (k < 0 && errno == EINTR) continue;
+        r->eof = true;               /* 0 = hết dữ liệu; lỗi cũng dừng ở đây */
+        return;
+    }
+}
+
+/* Bản ghi kế tiếp (không gồm dấu phân cách; dòng bỏ thêm '\r' cuối). false khi
+ * hết dữ liệu. Bản ghi cuối không có dấu phân cách vẫn được trả. */
+static inline bool g_reader_next(g_reader* r, char sep, g_bytes* out) {
+    if (r->fd < 0) g_reader_ahead(r);
+    for (;;) {
+        const uint8_t* p = g_reader_base(r) + r->lo;
+        size_t n = r->hi - r->lo;
+        const uint8_t* q = n ? (const uint8_t*)memchr(p, (unsigned char)sep, n) : NULL;
+        if (q || r->fd < 0 || r->eof) {
+            if (!q && !n) return false;
+            size_t k = q ? (size_t)(q - p) : n;
+            r->lo += q ? k + 1 : k;
+            if (sep == '\n' && k && p[k - 1] == '\r') k--;
+            out->data = p;
+            out->len = k;
+            return true;
+        }
+        g_reader_fill(r);
+    }
+}
+
+/* Khối nhiều bản ghi liền nhau (gồm cả dấu phân cách), tối đa khoảng
+ * G_READER_BUF byte trừ khi một bản ghi dài hơn. false khi hết dữ liệu. */
+static inline bool g_reader_chunk(g_reader* r, char sep, g_bytes* out) {
+    if (r->fd < 0) g_reader_ahead(r);
+    else if (r->lo == r->hi && !r->eof) g_reader_fill(r);
+    for (;;) {
+        const uint8_t* base = g_reader_base(r);
+        size_t n = r->hi - r->lo;
+        if (!n) return false;
+        size_t lim = n < G_READER_BUF ? n : G_READER_BUF;
+        size_t cut = 0;
+        for (size_t i = lim; i > 0; i--) {       /* dấu phân cách cuối trong khối */
+            if (base[r->lo + i - 1] == (uint8_t)sep) {
+                cut = i;
+                break;
+            }
+        }
+        if (!cut && lim < n) {                    /* bản ghi dài hơn một khối */
+            const uint8_t* q = (const uint8_t*)memchr(base + r->lo + lim,
+                                                      (unsigned char)sep, n - lim);
+            if (q) cut = (size_t)(q - (base + r->lo)) + 1;
+        }
+        if (cut) {
+            out->data = base + r->lo;
+            out->len = cut;
+            r->lo += cut;
+            return true;
+        }
+        if (r->fd < 0 || r->eof) {               /* đuôi không có dấu phân cách */
+            out->data = base + r->lo;
+            out->len = n;
+            r->lo = r->hi;
+            return true;
+        }
+        g_reader_fill(r);
+    }
+}
+
 /* ---- giá trị nhỏ nhất/lớn nhất theo kiểu (tiện cho comptime) ---- */
 #define G_I8_MAX   127
 #define G_I8_MIN   (-128)
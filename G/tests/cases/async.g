@@ -0,0 +1,185 @@
+// async fn / await: máy trạng thái không stack + executor một luồng trên epoll.
+// await nối chuỗi (kết quả đi ngược lên), await ở let/gán/+=/return/câu lệnh,
+// trong for/while/loop, defer khi return, spawn từ main và từ tác vụ, yield_now
+// xen kẽ, sleep_ms theo thứ tự giờ, echo qua socket_pair, chuyển > 64KB qua
+// pipe_pair (bộ đệm ống đầy -> người ghi phải chờ), biến mảng/struct/Vec/match/
+// for-in/par for sống trong khung.
+import std
+
+struct Pt {
+    x: int
+    y: int
+}
+
+async fn leaf(x: int) -> int {
+    await yield_now()
+    return x * 2
+}
+
+async fn mid(x: int) -> int {
+    let a = await leaf(x)
+    let mut b = 1
+    b += await leaf(a)
+    return await leaf(b)
+}
+
+async fn chain() {
+    let r = await mid(3)
+    println("chain: {}", r)
+    let mut t = 0
+    t = await leaf(t + 5)
+    await leaf(0)
+    println("assign: {}", t)
+}
+
+async fn ticker(name: str, n: int) {
+    let mut i = 0
+    while i < n {
+        println("{} {}", name, i)
+        i += 1
+        await yield_now()
+    }
+}
+
+async fn nap(ms: int, tag: str) {
+    defer println("  (hết {})", tag)
+    await sleep_ms(ms)
+    println("dậy: {} sau {} ms", tag, ms)
+}
+
+async fn naps() {
+    spawn(nap(30, "c"))
+    spawn(nap(10, "a"))
+    spawn(nap(20, "b"))
+}
+
+async fn frame_vars() -> int {
+    let arr = [1, 2, 3, 4]
+    let mut p = Pt { x: 1, y: 2 }
+    let mut v: Vec[int]
+    for i in 0..4 step 1 {
+        let e = await leaf(arr[i])
+        v.push(e)
+        p.x += i
+    }
+    let mut s = 0
+    for x in v {
+        s += x
+    }
+    let mut k = 0
+    loop {
+        k = await leaf(k + 1)
+        if k > 20 {
+            break
+        }
+    }
+    match s {
+        20 => println("match: 20")
+        n => println("match: {}", n)
+    }
+    let mut q = 0
+    par for j in 0..len(v) sum(q) {
+        q += v[j]
+    }
+    println("frame: s={} p=({}, {}) k={} q={}", s, p.x, p.y, k, q)
+    v.free()
+    return s + p.x
+}
+
+async fn echo_server(fd: int, rounds: int) {
+    let mut buf: [16]u8
+    for r in 0..rounds {
+        let n = await aread_exact(fd, &buf[0], 4)
+        if n != 4 {
+            println("server: ngắn {}", n)
+            return
+        }
+        buf[0] = buf[0] + 1
+        await awrite(fd, &buf[0], 4)
+    }
+    aclose(fd)
+}
+
+async fn echo_client(fd: int, rounds: int) {
+    let mut buf: [4]u8
+    let mut got = 0
+    for r in 0..rounds {
+        buf[0] = r as u8
+        buf[1] = 0
+        buf[2] = 0
+        buf[3] = 0
+        await awrite(fd, &buf[0], 4)
+        let n = await aread_exact(fd, &buf[0], 4)
+        if n == 4 && buf[0] as int == r + 1 {
+            got += 1
+        }
+    }
+    let eof = await aread(fd, &buf[0], 4)
+    println("echo: {}/{} vòng, eof={}", got, rounds, eof)
+    aclose(fd)
+}
+
+async fn pipe_writer(fd: int, total: int) {
+    let buf: *u8 = g_alloc(u8, total)
+    for i in 0..total {
+        buf[i] = (i % 251) as u8
+    }
+    let w = await awrite(fd, buf, total)
+    println("pipe: đã ghi {}", w)
+    g_free(buf)
+    aclose(fd)
+}
+
+async fn pipe_reader(fd: int) {
+    let mut buf: [4096]u8
+    let mut total = 0
+    let mut sum: i64 = 0
+    loop {
+        let n = await aread(fd, &buf[0], 4096)
+        if n <= 0 {
+            break
+        }
+        for i in 0..n {
+            sum += buf[i] as i64
+        }
+        total += n
+    }
+    println("pipe: đã đọc {} byte, tổng {}", total, sum)
+    aclose(fd)
+}
+
+fn main() {
+    spawn(chain())
+    async_run()
+
+    spawn(ticker("A", 3))
+    spawn(ticker("B", 2))
+    async_run()
+
+    spawn(naps())
+    async_run()
+
+    spawn(echo_task())
+    async_run()
+
+    let mut pp: [2]int
+    if pipe_pair(&pp[0]) != 0 {
+        println("pipe_pair lỗi")
+        return
+    }
+    spawn(pipe_reader(pp[0]))
+    spawn(pipe_writer(pp[1], 200000))
+    async_run()
+}
+
+async fn echo_task() {
+    let mut sv: [2]int
+    if socket_pair(&sv[0]) != 0 {
+        println("socket_pair lỗi")
+        return
+    }
+    spawn(echo_server(sv[0], 5))
+    spawn(echo_client(sv[1], 5))
+    let f = await frame_vars()
+    println("frame_vars: {}", f)
+}
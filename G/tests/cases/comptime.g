@@ -0,0 +1,160 @@
+// Kiểm tra comptime: lời gọi 'comptime fn' với đối số hằng được tính lúc biên
+// dịch (tests/expected/comptime.emit khoá các literal trong mã C sinh ra);
+// đối số lúc chạy thì vẫn gọi hàm static inline như thường.
+
+enum Kind {
+    Small
+    Big
+}
+
+const LIMIT = 100
+
+comptime fn fib(n: int) -> int {
+    if n < 2 {
+        return n
+    }
+    return fib(n - 1) + fib(n - 2)
+}
+
+comptime fn fact(n: i64) -> i64 {
+    let mut r: i64 = 1
+    for i in 2..=n {
+        r *= i
+    }
+    return r
+}
+
+comptime fn is_prime(n: int) -> bool {
+    if n < 2 {
+        return false
+    }
+    let mut d = 2
+    while d * d <= n {
+        if n % d == 0 {
+            return false
+        }
+        d += 1
+    }
+    return true
+}
+
+// Sàng Eratosthenes: bảng tra dựng hoàn toàn lúc biên dịch.
+comptime fn prime_table() -> [32]int {
+    let mut sieve: [200]bool
+    for i in 0..200 {
+        sieve[i] = true
+    }
+    let mut out: [32]int
+    let mut k = 0
+    for i in 2..200 {
+        if !sieve[i] {
+            continue
+        }
+        if k < 32 {
+            out[k] = i
+            k += 1
+        }
+        for j in (i * i)..200 step i {
+            sieve[j] = false
+        }
+    }
+    return out
+}
+
+comptime fn squares() -> [8]u8 {
+    let mut t: [8]u8
+    for i in 0..8 {
+        t[i] = (i * i * 9) as u8      // quấn về u8 như C
+    }
+    return t
+}
+
+comptime fn sqrt_newton(x: f64) -> f64 {
+    let mut g = x / 2.0
+    for _ in 0..30 {
+        g = (g + x / g) / 2.0
+    }
+    return g
+}
+
+comptime fn third() -> f32 {
+    return 1.0 / 3.0
+}
+
+comptime fn classify(n: int) -> Kind {
+    match n {
+        0..10 => { return Small }
+        _ => { return Big }
+    }
+}
+
+comptime fn hex_digit(n: int) -> char {
+    return "0123456789abcdef"[n & 15]
+}
+
+comptime fn mix(a: u32, b: int) -> u32 {
+    // -1 đổi sang u32 thành 4294967295 trước khi cộng: quấn như C
+    return a * 2654435761 + (b as u32)
+}
+
+comptime fn trunc_div(a: int, b: int) -> int {
+    return a / b * 1000 + a % b
+}
+
+// Tràn số có dấu / dịch trái số âm là UB trong C: chỉ gấp khi không tràn.
+comptime fn twice(a: int) -> int {
+    return a * 2
+}
+
+comptime fn shl(a: int, n: int) -> int {
+    return a << n
+}
+
+// Không tính được lúc biên dịch (có I/O) -> để lại lời gọi lúc chạy.
+comptime fn noisy(n: int) -> int {
+    println("noisy({})", n)
+    return n + 1
+}
+
+let PRIMES = prime_table()
+let SQ: [8]u8 = squares()
+let FIB30 = fib(30)
+let BIGFACT = fact(20)
+let PRIME_LIMIT = is_prime(LIMIT + 1)
+
+fn main() -> int {
+    println("fib(30) = {}, fib(40) = {}", FIB30, fib(40))
+    println("20! = {}", BIGFACT)
+    println("101 nguyên tố: {}, 91 nguyên tố: {}", PRIME_LIMIT, is_prime(91))
+    print("32 số nguyên tố đầu:")
+    for p in PRIMES {
+        print(" {}", p)
+    }
+    println("")
+    print("bình phương*9 (u8):")
+    for s in SQ {
+        print(" {}", s)
+    }
+    println("")
+    let local = prime_table()
+    println("local[31] = {}, PRIMES[31] = {}", local[31], PRIMES[31])
+    println("sqrt(2) = {f}, 1/3 (f32) = {f}", sqrt_newton(2.0), third())
+    println("classify: {} {}", classify(3) as int, classify(LIMIT) as int)
+    println("hex: {c}{c}", hex_digit(12), hex_digit(255))
+    println("mix = {}", mix(7, -1))
+    println("-7 / 2: {}, 7 / -2: {}", trunc_div(-7, 2), trunc_div(7, -2))
+
+    // đối số lúc chạy: vẫn là lời gọi bình thường
+    let mut n = 0
+    for i in 0..5 {
+        n += fib(i)
+    }
+    println("tổng fib(0..5) lúc chạy = {}", n)
+    println("twice(21) = {}, shl(3, 4) = {}", twice(21), shl(3, 4))
+    if n < 0 {
+        // không bao giờ chạy; chỉ để khoá trong .emit rằng không bị gấp
+        println("{} {} {}", twice(2000000000), shl(-1, 3), shl(1, 31))
+    }
+    println("noisy = {}", noisy(41))
+    return 0
+}
@@ -0,0 +1,135 @@
+// Kiểm tra tệp: write_file, map_file (bytes), reader theo dòng/bản ghi/khối ở
+// cả chế độ map lẫn chế độ đệm (stream_reader): CRLF, dòng cuối không có '\n',
+// bản ghi dài hơn bộ đệm, và các hàm bytes_*.
+import std
+
+extern fn unlink(path: str) -> int
+
+const PATH: str = "/tmp/g_test_fileio.txt"
+const N: int = 50000
+
+// Đếm dòng, cộng số sau dấu phẩy, dòng dài nhất, và dòng cuối.
+fn scan(r: *reader, name: str) {
+    let mut line: bytes
+    let mut n = 0
+    let mut sum: i64 = 0
+    let mut longest: usize = 0
+    let mut last = ""
+    let mut errors = 0
+    while next_line(r, &line) {
+        n += 1
+        if len(line) > longest {
+            longest = len(line)
+        }
+        if bytes_starts_with(line, "ERROR") {
+            errors += 1
+        }
+        let comma = bytes_find(line, ",")
+        if comma >= 0 {
+            let mut v: i64 = 0
+            for c in bytes_slice(line, comma as usize + 1, len(line)) {
+                if c >= '0' as u8 && c <= '9' as u8 {
+                    v = v * 10 + (c - '0' as u8) as i64
+                }
+            }
+            sum += v
+        }
+        if len(line) < 64 {
+            last = bytes_to_str(line)
+        }
+    }
+    println("{s}: {} dòng, tổng {}, {} ERROR, dài nhất {}, cuối '{s}'", name, n, sum, errors, longest, last)
+}
+
+fn main() -> int {
+    // Dựng tệp: N dòng "INFO i,i" / "ERROR i,i", một dòng CRLF, một dòng 1.5 MiB
+    // (dài hơn bộ đệm 1 MiB), rồi dòng cuối không có '\n'.
+    let mut sb = sb_new()
+    for i in 0..N {
+        if i % 10 == 0 {
+            sb_push(&sb, "ERROR ")
+        } else {
+            sb_push(&sb, "INFO ")
+        }
+        sb_push_int(&sb, i)
+        sb_push_char(&sb, ',')
+        sb_push_int(&sb, i)
+        sb_push_char(&sb, '\n')
+    }
+    sb_push(&sb, "crlf,7\r\n")
+    for i in 0..1536 * 1024 {
+        sb_push_char(&sb, 'x')
+    }
+    sb_push(&sb, "\nEND,1")
+    if !write_file(PATH, sb_bytes(&sb)) {
+        println("không ghi được {s}", PATH)
+        return 1
+    }
+    let size = len(sb)
+    sb_free(&sb)
+
+    // map_file: cả tệp là một bytes, đếm '\n' bằng memchr
+    let mut m = map_file(PATH)
+    println("map: len khớp = {}, {} dấu xuống dòng", len(m) == size, bytes_count(m, '\n'))
+    println("đầu: '{}' '{s}' b[0] = {}", bytes_slice(m, 0, 7), bytes_slice(m, 6, 1), m[0])
+    println("eq = {} {}", bytes_eq(bytes_slice(m, 0, 5), "ERROR"), bytes_eq(bytes_slice(m, 0, 5), "INFO "))
+    println("tìm: {} {}", bytes_find(m, "INFO 49999,"), bytes_find(m, "không có"))
+    let mut zeros = 0
+    for i in 0..len(m) {
+        if m[i] == '0' as u8 {
+            zeros += 1
+        }
+    }
+    println("số '0' = {}", zeros)
+    unmap(&m)
+    println("sau unmap: len = {}", len(m))
+
+    // Reader ở hai chế độ phải cho cùng kết quả
+    let mut r = open_reader(PATH)
+    scan(&r, "map")
+    close_reader(&r)
+    let mut s = stream_reader(PATH)
+    scan(&s, "đệm")
+    close_reader(&s)
+
+    // next_chunk: mỗi khối kết thúc ngay sau một '\n' (trừ phần đuôi), cộng lại
+    // đúng bằng cả tệp
+    let mut c = stream_reader(PATH)
+    let mut chunk: bytes
+    let mut total: usize = 0
+    let mut lines: usize = 0
+    let mut bad = 0
+    let mut chunks = 0
+    while next_chunk(&c, &chunk) {
+        chunks += 1
+        total += len(chunk)
+        lines += bytes_count(chunk, '\n')
+        if chunk[len(chunk) - 1] != '\n' as u8 && total != size {
+            bad += 1
+        }
+    }
+    close_reader(&c)
+    println("khối: {} khối, tổng khớp = {}, {} dòng, {} khối cắt giữa dòng", chunks > 1, total == size, lines, bad)
+
+    // next_record với dấu phân cách khác '\n' (không bỏ '\r')
+    write_file(PATH, str_bytes("a;bb;;c\r;dd"))
+    let mut rr = open_reader(PATH)
+    let mut rec: bytes
+    while next_record(&rr, ';', &rec) {
+        print("[{}:{}]", len(rec), bytes_count(rec, '\r'))
+    }
+    println("")
+    close_reader(&rr)
+
+    // Tệp rỗng / không tồn tại
+    write_file(PATH, str_bytes(""))
+    let mut e = open_reader(PATH)
+    let mut x: bytes
+    println("rỗng: {}", next_line(&e, &x))
+    close_reader(&e)
+    unlink(PATH)
+    let mut bad_map: bytes
+    let mut bad_r: reader
+    println("không tồn tại: {} {}", try_map_file(PATH, &bad_map), try_open_reader(PATH, &bad_r))
+    return 0
+}
@@ -1,4 +1,7 @@
 // Kiểm tra số thực: modulo (fmod), số học hỗn hợp, ép kiểu, định dạng.
+// f32 in theo chữ số ngắn nhất của chính f32 (tests/expected/floats.emit khoá
+// đường eprint).
+import std
 
 fn main() -> int {
     // Modulo số thực -> fmod
@@ -23,6 +26,16 @@ fn main() -> int {
     // f32
     let g: f32 = 1.5
     println("f32: {f}", g as f64)
+    let tenth: f32 = 0.1
+    let third: f32 = 1.0 / 3.0
+    println("f32: {} {f} {}, nới ra f64: {}", tenth, third, -tenth, tenth as f64)
+    let mut sb = sb_new()
+    sb_push_float(&sb, third)
+    println("float_to_str: {s}, sb_push_float: {s}", float_to_str(tenth), sb_str(&sb))
+    if len(sb_str(&sb)) == 0 {
+        eprintln("sb rỗng: {}", third)
+    }
+    sb_free(&sb)
 
     // Modulo float với toán hạng âm
     let neg: f64 = -7.5
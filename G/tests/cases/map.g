@@ -0,0 +1,101 @@
+// Kiểm tra Map[K, V]: set/get/get_or/has/find/entry/remove, len O(1),
+// khoá int/str/enum, tăng trưởng qua nhiều lần rehash, duyệt khoá.
+import std
+
+enum Color {
+    Red,
+    Green,
+    Blue,
+}
+
+struct Sym {
+    id: int
+    depth: int
+}
+
+fn count_words(words: *str, n: int, out: *Map[str, int]) {
+    for i in 0..n {
+        *out.entry(words[i]) += 1
+    }
+}
+
+fn main() -> int {
+    let mut m: Map[int, i64]
+    println("rỗng: len = {}, has(1) = {}", len(m), m.has(1))
+    for i in 0..1000 {
+        m.set(i * 7, (i * i) as i64)
+    }
+    println("len = {}, get(70) = {}, get(6993) = {}", len(m), m.get(70), m.get(6993))
+    println("has(71) = {}, get_or(71, -1) = {}", m.has(71), m.get_or(71, -1))
+
+    m.set(70, 5)
+    println("ghi đè: get(70) = {}, len = {}", m.get(70), len(m))
+
+    // xoá một nửa rồi chèn lại: ô DELETED phải được tái dùng đúng
+    let mut removed = 0
+    for i in 0..1000 {
+        if i % 2 == 0 && m.remove(i * 7) {
+            removed += 1
+        }
+    }
+    println("xoá {} khoá, len = {}, remove lại = {}", removed, len(m), m.remove(0))
+    for i in 0..500 {
+        m.set(i * 14, 1)
+    }
+    let mut total: i64 = 0
+    for k in m {
+        total += m.get(k)
+    }
+    println("len = {}, tổng giá trị = {}", len(m), total)
+
+    let p = m.find(7)
+    if p != null {
+        *p = 77
+    }
+    println("qua find: get(7) = {}", m.get(7))
+
+    // bảng ký hiệu: khoá chuỗi (so sánh nội dung, không phải con trỏ)
+    let words: [8]str = ["let", "mut", "x", "let", "y", "x", "let", "fn"]
+    let mut freq: Map[str, int]
+    count_words(&words[0], 8, &freq)
+    let key = str_concat("l", "et")
+    println("let: {}, x: {}, fn: {}, while: {}", freq.get(key), freq.get("x"),
+            freq.get("fn"), freq.get_or("while", 0))
+    g_free(key)
+    println("số từ khác nhau = {}", len(freq))
+
+    let mut syms: Map[str, Sym]
+    syms.set("main", Sym { id: 1, depth: 0 })
+    syms.set("i", Sym { id: 2, depth: 1 })
+    syms.entry("i").depth = 3
+    let s = syms.get("i")
+    println("i: id = {}, depth = {}", s.id, s.depth)
+
+    let mut names: Map[Color, str]
+    names.set(Red, "đỏ")
+    names.set(Blue, "xanh")
+    println("{s} {s} {s}", names.get(Red), names.get(Blue), names.get_or(Green, "?"))
+
+    // nhiều lần tăng trưởng
+    let mut big: Map[i64, i64]
+    big.reserve(10)
+    for i in 0..200000 {
+        big.set((i as i64) * 2654435761, i as i64)
+    }
+    let mut ok = true
+    for i in 0..200000 {
+        if big.get((i as i64) * 2654435761) != (i as i64) {
+            ok = false
+        }
+    }
+    println("big: len = {}, đúng hết = {}", len(big), ok)
+    big.clear()
+    println("sau clear: len = {}, has(0) = {}", len(big), big.has(0))
+
+    big.free()
+    m.free()
+    freq.free()
+    syms.free()
+    names.free()
+    return 0
+}
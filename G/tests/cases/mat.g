@@ -0,0 +1,120 @@
+// Mat[T]: literal, init/fill, m[i][j], row(i), transpose, matmul (GEMM chia
+// khối của runtime) so với vòng for ba tầng trên các cỡ lệch khối (cạnh thiếu,
+// k vượt một khối KC), đủ ba kiểu phần tử; matmul ghi đè lên toán hạng.
+fn naive_f64(a: *Mat[f64], b: *Mat[f64], c: *Mat[f64]) {
+    (*c).init(a.rows(), b.cols())
+    for i in 0..a.rows() {
+        for j in 0..b.cols() {
+            let mut s: f64 = 0.0
+            for p in 0..a.cols() {
+                s += (*a)[i][p] * (*b)[p][j]
+            }
+            (*c)[i][j] = s
+        }
+    }
+}
+
+fn diff_f64(x: *Mat[f64], y: *Mat[f64]) -> int {
+    let mut bad = 0
+    for i in 0..x.rows() {
+        for j in 0..x.cols() {
+            if (*x)[i][j] != (*y)[i][j] {
+                bad += 1
+            }
+        }
+    }
+    return bad
+}
+
+fn check_f64(m: usize, n: usize, k: usize) {
+    let mut a: Mat[f64]
+    let mut b: Mat[f64]
+    a.init(m, k)
+    b.init(k, n)
+    for i in 0..m {
+        for p in 0..k {
+            a[i][p] = ((i * 7 + p * 3) % 11) as f64 - 5.0
+        }
+    }
+    for p in 0..k {
+        let r = b.row(p)
+        for j in 0..n {
+            r[j] = ((p * 5 + j) % 9) as f64 * 0.5
+        }
+    }
+    let mut c: Mat[f64]
+    let mut ref: Mat[f64]
+    c.matmul(a, b)
+    naive_f64(&a, &b, &ref)
+    println("f64 {}x{}x{}: {}x{}, lệch {}, c[m-1][n-1] = {}", m, n, k, c.rows(), c.cols(),
+        diff_f64(&c, &ref), c[m - 1][n - 1])
+    a.free()
+    b.free()
+    c.free()
+    ref.free()
+}
+
+fn check_int(m: usize, n: usize, k: usize) {
+    let mut a: Mat[int]
+    let mut b: Mat[int]
+    a.init(m, k)
+    b.init(k, n)
+    for i in 0..m {
+        for p in 0..k {
+            a[i][p] = ((i * 3 + p) % 13) as int - 6
+        }
+    }
+    for p in 0..k {
+        for j in 0..n {
+            b[p][j] = ((p + j * 7) % 5) as int - 1
+        }
+    }
+    let mut c: Mat[int]
+    c.matmul(a, b)
+    let mut bad = 0
+    let mut total: i64 = 0
+    for i in 0..m {
+        for j in 0..n {
+            let mut s = 0
+            for p in 0..k {
+                s += a[i][p] * b[p][j]
+            }
+            if s != c[i][j] {
+                bad += 1
+            }
+            total += c[i][j] as i64
+        }
+    }
+    println("int {}x{}x{}: lệch {}, tổng = {}", m, n, k, bad, total)
+    a.free()
+    b.free()
+    c.free()
+}
+
+fn main() -> int {
+    let a: Mat[f32] = [[1, 2], [3, 4], [5, 6]]
+    let t = a.transpose()
+    println("a: {}x{}, t: {}x{}, t[1][2] = {}", a.rows(), a.cols(), t.rows(), t.cols(), t[1][2])
+
+    let mut g: Mat[f32]
+    g.matmul(t, a)
+    println("aᵀ·a = [{} {}; {} {}]", g[0][0], g[0][1], g[1][0], g[1][1])
+
+    // đích trùng toán hạng: tính vào ma trận tạm rồi chép lại
+    g.matmul(g, g)
+    println("(aᵀ·a)² = [{} {}; {} {}]", g[0][0], g[0][1], g[1][0], g[1][1])
+
+    g.fill(0.5)
+    println("fill: {} {}", g[0][0], g[1][1])
+    g.init(4, 1)
+    println("init: {}x{}, g[3][0] = {}", g.rows(), g.cols(), g[3][0])
+    g.free()
+    println("free: {}x{}", g.rows(), g.cols())
+
+    check_f64(5, 7, 3)
+    check_f64(37, 53, 29)
+    check_f64(130, 70, 300)
+    check_int(61, 45, 270)
+    check_int(8, 8, 8)
+    return 0
+}
@@ -0,0 +1,75 @@
+// Kiểm tra nhân số <-> chuỗi: in số nguyên biên, số thực ngắn nhất đọc lại
+// đúng (thập phân / dạng mũ / inf / nan / -0), {g} giữ kiểu printf, và
+// parse_* / try_parse_* (khoảng trắng hai đầu, sai cú pháp, tràn).
+import std
+
+fn show_int(s: str) {
+    let mut v: i64 = -1
+    if try_parse_int(s, &v) {
+        println("int  [{s}] = {}", s, v)
+    } else {
+        println("int  [{s}] lỗi", s)
+    }
+}
+
+fn show_float(s: str) {
+    let mut v: f64 = -1.0
+    if try_parse_float(s, &v) {
+        println("f64  [{s}] = {}", s, v)
+    } else {
+        println("f64  [{s}] lỗi", s)
+    }
+}
+
+fn main() -> int {
+    let lo: i64 = -9223372036854775807 - 1
+    let hi: u64 = 18446744073709551615
+    println("{} {} {} {}", lo, hi, 0, -42)
+
+    let xs = [0.1, 0.1 + 0.2, 1.0 / 3.0, 2.0, 1500.0, 123.456, 1e21, 1e20,
+              0.000001, 1e-7, 5e-324, 1.7976931348623157e308, -2.5e-12]
+    for x in xs {
+        print("{} ", x)
+    }
+    println("")
+    let zero = 0.0
+    println("{} {} {} {}", 1.0 / zero, -1.0 / zero, -zero, zero)
+    println("{g} {f:.3} {e}", 1.0 / 3.0, 1.0 / 3.0, 1500.0)
+    eprintln("stderr: {} {f}", 0.1 + 0.2, 2.0)
+
+    let s = float_to_str(0.1 + 0.2)
+    println("float_to_str = {s}, đọc lại bằng = {}", s, parse_float(s) == 0.1 + 0.2)
+    g_free(s)
+    let mut b = sb_new()
+    sb_push_int(&b, -7)
+    sb_push(&b, " ")
+    sb_push_float(&b, 6.02214076e23)
+    println("strbuf: {s}", sb_str(&b))
+    sb_free(&b)
+
+    show_int("12345")
+    show_int("  -77\n")
+    show_int("+0")
+    show_int("9223372036854775807")
+    show_int("-9223372036854775808")
+    show_int("9223372036854775808")
+    show_int("12abc")
+    show_int("")
+    show_int("-")
+    show_float("3.25")
+    show_float(" -.5 ")
+    show_float("1e3")
+    show_float("2.5E-3")
+    show_float("0.30000000000000004")
+    show_float("123456789012345678901234567890")
+    show_float("inf")
+    show_float("1e400")
+    show_float("-1e400")
+    show_float("1e-400")
+    show_float("4e-320")
+    show_float("1.5.2")
+    show_float("e5")
+    show_float("1e")
+    println("parse_int(\"x\") = {}, parse_float(\"?\") = {}", parse_int("x"), parse_float("?"))
+    return 0
+}
@@ -0,0 +1,135 @@
+// Kiểm tra các pass tối ưu trước codegen: gập hằng + lan truyền, bỏ nhánh
+// chết, nội tuyến method nhỏ, kéo len(s) ra khỏi while, bỏ g_bounds trong
+// 'for i in 0..len(v)' (tests/expected/optimize.emit khoá mã C sinh ra). Các
+// trường hợp KHÔNG được tối ưu (Vec bị push, Vec global sửa qua lời gọi, chuỗi
+// bị gán lại hay trỏ vào mảng bị ghi...) phải giữ nguyên ngữ nghĩa.
+import std
+
+const DEBUG = false
+const SCALE = 3
+let BASE: int = SCALE * 1000 + 7
+let mut G: Vec[int]
+
+struct Rect {
+    w: int
+    h: int
+}
+
+impl Rect {
+    fn area(self) -> int {
+        return self.w * self.h
+    }
+
+    fn grow(self, k: int) {
+        self.w += k
+        self.h += k
+    }
+}
+
+fn count_spaces(s: str) -> int {
+    let mut n = 0
+    let mut i: usize = 0
+    while i < len(s) {
+        if s[i] == ' ' {
+            n += 1
+        }
+        i += 1
+    }
+    return n
+}
+
+// s bị gán lại trong thân: len(s) phải tính lại mỗi vòng
+fn shrink_count(text: str) -> int {
+    let mut s = text
+    let mut steps = 0
+    while len(s) > 0 {
+        s = substr(s, 1, len(s) - 1)
+        steps += 1
+    }
+    return steps
+}
+
+// buf[6] = '\0' đổi len(p) (p trỏ vào buf): không được kéo len(p) ra ngoài
+fn cut_len() -> usize {
+    let mut buf: [8]char
+    for k in 0..7 {
+        buf[k] = 'a'
+    }
+    buf[7] = '\0'
+    let p: str = &buf[0]
+    let mut j: usize = 0
+    while j < len(p) {
+        buf[6] = '\0'
+        j += 1
+    }
+    return j
+}
+
+// G là global: hàm được gọi trong thân có thể đổi len(G) -> giữ g_bounds
+fn grow_g() {
+    if len(G) < 4 {
+        G.push(len(G) as int * 100)
+    }
+}
+
+fn sum_g() -> int {
+    let mut t = 0
+    for i in 0..len(G) {
+        grow_g()
+        t += G[i]
+    }
+    return t
+}
+
+fn sum(v: *Vec[int]) -> i64 {
+    let mut t: i64 = 0
+    for i in 0..len(v) {
+        t += (*v)[i] as i64
+    }
+    return t
+}
+
+fn main() -> int {
+    let k = SCALE * 4 - 2
+    let mask = (1 << 10) - 1
+    println("k = {}, mask = {}, BASE = {}", k, mask, BASE)
+
+    if DEBUG {
+        println("DEBUG on")
+    } else {
+        println("nhánh else giữ lại")
+    }
+    let mode = DEBUG ? "debug" : "release"
+    println("mode = {s}", mode)
+
+    let mut r = Rect { w: 3, h: 4 }
+    println("area = {}", r.area())
+    r.grow(1)
+    println("area sau grow = {}", r.area())
+
+    println("spaces = {}", count_spaces("a b c  d"))
+    println("shrink = {}", shrink_count("abcde"))
+
+    let mut v: Vec[int] = [1, 2, 3, 4, 5]
+    let mut sq = 0
+    for i in 0..len(v) {
+        sq += v[i] * v[i]
+    }
+    println("sq = {}, sum = {}", sq, sum(&v))
+
+    // push trong thân: len(v) đổi -> phải giữ kiểm tra chỉ số
+    let mut w: Vec[int] = [1, 2]
+    for i in 0..len(w) {
+        if i < 3 {
+            w.push(w[i] * 10)
+        }
+    }
+    println("len(w) = {}, w[3] = {}", len(w), w[3])
+
+    println("cut_len = {}", cut_len())
+    G.push(1)
+    G.push(2)
+    println("sum_g = {}, len(G) = {}", sum_g(), len(G))
+    G.free()
+    return 0
+}
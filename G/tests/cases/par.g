@@ -0,0 +1,111 @@
+// par for: các lần lặp chia cho bể luồng của runtime (deque riêng mỗi luồng,
+// trộm việc). Rút gọn sum/min/max, chunk, step âm, khoảng đóng, par lồng nhau,
+// ghi theo chỉ số biến lặp vào mảng/Vec/Mat bắt từ ngoài, tham số hàm, chuỗi
+// cấp phát trong region. Kết quả phải giống hệt vòng for tuần tự với mọi số
+// luồng (run_tests.sh chạy với G_THREADS=4).
+import std
+
+struct Scale {
+    mul: int
+    add: int
+}
+
+fn count_primes(n: int) -> int {
+    let mut c = 0
+    par for k in 2..n chunk 64 sum(c) {
+        if is_prime(k) {
+            c += 1
+        }
+    }
+    return c
+}
+
+fn dot_par(a: *Vec[i64], b: *Vec[i64]) -> i64 {
+    let mut t: i64 = 0
+    par for i in 0..len(a) sum(t) {
+        t += (*a)[i] * (*b)[i]
+    }
+    return t
+}
+
+fn main() -> int {
+    // sum/min/max trên nguyên và số thực (giá trị nguyên nhỏ: cộng theo thứ tự
+    // nào cũng ra cùng một số)
+    let n = 100000
+    let mut total: i64 = 0
+    let mut lo = 1 << 30
+    let mut hi = -1
+    let mut fsum: f64 = 0.0
+    let mut fmin: f64 = 1.0e9
+    par for i in 0..n sum(total, fsum) min(lo, fmin) max(hi) {
+        let h = (i * 7919) % 100003
+        total += h as i64
+        fsum += (i % 10) as f64
+        lo = min(lo, h)
+        hi = max(hi, h)
+        fmin = min(fmin, ((i % 1000) - 500) as f64)
+    }
+    println("total = {}, fsum = {f:.1}", total, fsum)
+    println("lo = {}, hi = {}, fmin = {f:.1}", lo, hi, fmin)
+
+    // ghi theo chỉ số: mảng tĩnh, Vec, Mat; struct bắt theo giá trị
+    let sc = Scale { mul: 3, add: 1 }
+    let mut sq: [1000]i64
+    let mut v: Vec[i64]
+    for i in 0..2000 {
+        v.push(0)
+    }
+    let mut m: Mat[int]
+    m.init(40, 50)
+    par for i in 0..1000 {
+        sq[i] = (i * i) as i64
+        v[2 * i] = (i * sc.mul + sc.add) as i64
+        v[2 * i + 1] = -1
+    }
+    par for r in 0..40 {
+        for c in 0..50 {
+            m[r][c] = r * 100 + c
+        }
+    }
+    println("sq[999] = {}, v[10] = {}, v[11] = {}, m[39][49] = {}", sq[999], v[10], v[11], m[39][49])
+    println("dot = {}", dot_par(&v, &v))
+
+    // step âm, khoảng đóng, continue, khoảng rỗng
+    let mut odd = 0
+    par for i in 100..=0 step -3 sum(odd) {
+        if i % 2 == 0 {
+            continue
+        }
+        odd += i
+    }
+    let mut none = 0
+    par for i in 5..5 sum(none) {
+        none += 1
+    }
+    println("odd = {}, none = {}", odd, none)
+
+    // par lồng nhau: cùng rút gọn vào một biến qua hai tầng
+    let mut grid: [32][64]int
+    let mut gs: i64 = 0
+    par for r in 0..32 sum(gs) {
+        par for c in 0..64 sum(gs) {
+            grid[r][c] = r ^ c
+            gs += (r ^ c) as i64
+        }
+    }
+    println("grid[31][0] = {}, gs = {}", grid[31][0], gs)
+
+    // chuỗi cấp phát trong thân (region: đi thẳng malloc, không đụng arena)
+    let mut names: [64]str
+    region {
+        par for i in 0..64 {
+            names[i] = str_concat("n", int_to_str(i as i64))
+        }
+    }
+    println("{s} {s}", names[0], names[63])
+
+    println("primes < 50000: {}", count_primes(50000))
+    v.free()
+    m.free()
+    return 0
+}
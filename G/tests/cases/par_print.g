@@ -0,0 +1,18 @@
+// In từ hàm được gọi trong thân par for: mỗi luồng có bộ đệm stdout riêng, đổ
+// sau mỗi phần việc. Mọi lần lặp in cùng một dòng dài (tổng > 64 KiB, tràn bộ
+// đệm) nên kết quả không phụ thuộc thứ tự — dòng vỡ/mất là lỗi.
+import std
+
+fn report(x: int) {
+    let s = "0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz"
+    println("par {} {s} {s} {s} {}", x / 1000, s, s, s, 3.25)
+}
+
+fn main() -> int {
+    println("trước")
+    par for i in 0..256 {
+        report(i % 7)
+    }
+    println("sau")
+    return 0
+}
@@ -0,0 +1,34 @@
+// Kiểm tra bộ đệm stdout của print/println: thứ tự với eprint/printf (test
+// gộp stdout + stderr), đối số là lời gọi hàm tự in, các writer theo kiểu,
+// specifier có flags, một dòng dài và flush().
+
+fn noisy(x: int) -> int {
+    println("  (tính {})", x)
+    return x * 10
+}
+
+fn main() -> int {
+    println("đầu: {} {}", noisy(1), noisy(2))
+    print("cùng dòng, ")
+    eprintln("stderr sau phần đã in")
+    println("tiếp tục")
+    printf("printf %d\n", 42)
+
+    let big: i64 = -9223372036854775807
+    let u: u64 = 18446744073709551615
+    println("{} {} {} {c} {b} {s}", big - 1, u, 0, 'G', false, "chuỗi")
+    println("{f} {f:.3} {d:05} {x} {s:>6}| 100%", 0.1, 3.14159, 42, 255, "ab")
+
+    // một dòng dài ghép từ nhiều lần print
+    let mut total = 0
+    for i in 0..20000 {
+        print("{}", i % 10)
+        total += 1
+    }
+    println("")
+    println("{} ký tự", total)
+    flush()
+    eprintln("stderr sau flush")
+    println("cuối")
+    return 0
+}
@@ -0,0 +1,140 @@
+// Kiểm tra region (arena): g_alloc/chuỗi trong region cấp phát từ arena,
+// mọi lối ra (cuối khối, return, break) đều trả bộ nhớ; region lồng nhau.
+import std
+
+struct Node {
+    val: int,
+    next: *Node,
+}
+
+fn build(n: int) -> *Node {
+    let mut head: *Node = null
+    for i in 0..n {
+        let mut nd: *Node = g_alloc(Node, 1)
+        nd.val = i
+        nd.next = head
+        head = nd
+    }
+    return head
+}
+
+fn total(head: *Node) -> i64 {
+    let mut s: i64 = 0
+    let mut cur: *Node = head
+    while cur != null {
+        s += cur.val as i64
+        cur = cur.next
+    }
+    return s
+}
+
+// return bên trong region: giá trị được tính trước khi region bị thu hồi
+fn sum_in_region(n: int) -> i64 {
+    region {
+        defer println("  rời region của sum_in_region")
+        return total(build(n))
+    }
+}
+
+fn main() -> int {
+    println("đầu: {} byte", region_used())
+
+    region {
+        let list = build(1000)
+        println("tổng = {ld}, đang dùng > 0? {}", total(list), region_used() > 0)
+
+        let s = str_concat(str_concat("arena", "-"), int_to_str(42))
+        println("{s}", s)
+        g_free(s)          // no-op trong region
+
+        let before = region_used()
+        region {
+            let tmp = build(5000)
+            println("lồng: tổng = {ld}", total(tmp))
+        }
+        println("sau region lồng: trở về mốc? {}", region_used() == before)
+
+        // g_realloc trong region giữ nguyên dữ liệu cũ
+        let mut a: *int = g_alloc(int, 4)
+        for i in 0..4 { a[i] = i + 1 }
+        a = g_realloc(a, int, 1000)
+        a[999] = 7
+        println("realloc: {} {} {} {} {}", a[0], a[1], a[2], a[3], a[999])
+
+        // khối của region ngoài được realloc trong region lồng: phải sống sót
+        // khi region lồng kết thúc (lên heap, không nằm trên mốc của nó)
+        let mut b: *int = g_alloc(int, 1)
+        b[0] = 1
+        let mut v: Vec[int]
+        v.push(1)
+        region {
+            b = g_realloc(b, int, 100)
+            for i in 0..100 {
+                b[i] = i + 1
+                v.push(i)
+            }
+        }
+        let junk = build(2000)
+        let mut sb: int = 0
+        let mut sv: int = 0
+        for i in 0..100 {
+            sb += b[i]
+        }
+        for x in v {
+            sv += x
+        }
+        println("realloc lồng: {} {} (rác {ld})", sb, sv, total(junk))
+        g_free(b)
+        v.free()
+    }
+    println("sau region: {} byte", region_used())
+
+    println("sum_in_region = {ld}", sum_in_region(100))
+    println("sau hàm: {} byte", region_used())
+
+    // break thoát vòng lặp vẫn trả region của thân vòng
+    let mut k: int = 0
+    loop {
+        region {
+            let p: *Node = build(10)
+            k += total(p) as int
+            if k > 100 {
+                break
+            }
+        }
+    }
+    println("k = {}, còn {} byte", k, region_used())
+
+    // Vec/Map khai báo ngoài region, tăng trưởng bên trong: giữ trên heap,
+    // không bị thu hồi khi region kết thúc; Vec khai báo trong region (kể cả
+    // trong hàm gọi từ region) vẫn lấy từ arena.
+    let mut outer: Vec[int]
+    let mut seen: Map[int, int]
+    region {
+        for i in 0..10 {
+            outer.push(i)
+            seen.set(i, i * i)
+        }
+        let mut inner: Vec[i64]
+        inner.push(1)
+        println("region: arena chỉ giữ Vec bên trong? {}", region_used() == 8 * 8)
+    }
+    region {
+        let junk = build(100)
+        k = total(junk) as int
+    }
+    let mut so: int = 0
+    for x in outer {
+        so += x
+    }
+    println("Vec ngoài region: tổng = {}, seen[9] = {}", so, seen.get(9))
+    outer.free()
+    seen.free()
+
+    // bộ nhớ cấp phát ngoài region vẫn free bình thường trong region
+    let outside: *int = g_alloc(int, 16)
+    region {
+        g_free(outside)
+    }
+    return 0
+}
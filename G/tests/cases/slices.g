@@ -0,0 +1,80 @@
+// Kiểm tra phép trên dãy số: sum/dot/min/max (mảng tĩnh, Vec, *Vec, con trỏ +
+// n) và gán gộp từng phần tử 'xs op= ys' / 'xs op= k' — nhân SIMD g_slice_*
+// của runtime (tests/expected/slices.emit khoá lời gọi nhân). Độ dài lẻ để đi
+// qua cả phần đầu căn lề lẫn phần đuôi vô hướng.
+import std
+
+fn total(p: []int, n: int) -> i64 {
+    return sum(p, n)
+}
+
+comptime fn ramp() -> [10]int {
+    let mut t: [10]int = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9]
+    t *= 3
+    t -= 4
+    return t
+}
+
+let RAMP = ramp()
+let RAMP_SUM = sum(RAMP)
+let RAMP_MIN = min(RAMP)
+
+fn main() -> int {
+    let mut a: [7]int = [3, -1, 4, -1, 5, -9, 2]
+    let b: [7]int = [1, 1, 1, 1, 1, 1, 1]
+    println("a: sum = {}, min = {}, max = {}, dot(a, a) = {}", sum(a), min(a), max(a), dot(a, a))
+    a += b
+    a *= 2
+    println("a*: {} {} {} {} {} {} {}", a[0], a[1], a[2], a[3], a[4], a[5], a[6])
+    println("RAMP: sum = {}, min = {}, cuối = {}", RAMP_SUM, RAMP_MIN, RAMP[9])
+
+    // Vec dài: tổng khớp công thức, tích vô hướng trên i64 không tràn
+    let mut v: Vec[int]
+    let mut w: Vec[int]
+    for i in 0..1003 {
+        v.push(i)
+        w.push(1000000 - i)
+    }
+    println("v: sum = {}, min = {}, max = {}", sum(v), min(v), max(v))
+    println("dot(v, w) = {}", dot(v, w))
+    v += w
+    println("v + w: min = {}, max = {}", min(v), max(v))
+    v -= w
+    v ^= 5
+    v &= 255
+    println("v xor/and: sum = {}, max = {}", sum(&v), max(&v))
+    v += v
+    println("v + v: sum = {}", sum(v))
+    println("total(&v[0], 10) = {}, sum_slice = {}", total(&v[0], 10), sum_slice(&v[0], 1003))
+
+    // số thực: giá trị nguyên nhỏ -> tổng chính xác ở mọi thứ tự cộng
+    let mut f: Vec[f64]
+    for i in 0..37 {
+        f.push((i - 18) as f64)
+    }
+    f.push(0.0 / 0.0)
+    println("f: sum NaN? {}, min = {}, max = {}", sum(f) != sum(f), min(f), max(f))
+    let mut g: [5]f32 = [1.5, 2.5, -3.0, 4.0, 8.0]
+    g /= 2.0
+    g *= g
+    println("g: sum = {}, dot = {}, max = {}", sum(g), dot(g, g), max(g))
+
+    // số không dấu: cộng dồn trên u64
+    let mut bytes: Vec[u8]
+    for i in 0..300 {
+        bytes.push(250 as u8)
+    }
+    println("bytes: sum = {}, max = {}", sum(bytes), max(bytes))
+    bytes += 10 as u8
+    println("bytes + 10 (quấn): max = {}", max(bytes))
+
+    // tràn i64: tổng/tích quấn theo 2^64 ở cả bản vô hướng lẫn SIMD
+    let mut big: Vec[i64]
+    for i in 0..37 {
+        big.push(9223372036854775807)
+    }
+    println("big: sum = {}, dot = {}", sum(big), dot(big, big))
+
+    println("popcount: {} {} {}", popcount(0), popcount(255), popcount(18446744073709551615))
+    return 0
+}
@@ -0,0 +1,153 @@
+// Kiểm tra sort/sort_by: Vec, *Vec, mảng tĩnh, con trỏ + n; thứ tự tự nhiên
+// (số nguyên, số thực kể cả NaN, chuỗi, enum) và hàm so sánh tự viết;
+// dãy lớn đã sắp / đảo ngược / nhiều trùng lặp; radix_sort_int của std.
+import std
+
+enum Color { Red, Green, Blue }
+
+struct Person {
+    name: str
+    age: int
+}
+
+fn by_age(a: Person, b: Person) -> bool {
+    return a.age < b.age
+}
+
+fn desc(a: int, b: int) -> bool {
+    return a > b
+}
+
+fn xorshift(s: *u64) -> u64 {
+    let mut x = *s
+    x ^= x << 13
+    x ^= x >> 7
+    x ^= x << 17
+    *s = x
+    return x
+}
+
+fn check(v: *Vec[int], what: str) {
+    let mut ok = true
+    let mut sum: i64 = 0
+    for i in 0..len(v) as int {
+        if i > 0 && (*v)[i - 1] > (*v)[i] {
+            ok = false
+        }
+        sum += (*v)[i] as i64
+    }
+    println("{s}: n = {}, tăng dần = {}, tổng = {}", what, len(v), ok, sum)
+}
+
+fn main() -> int {
+    let mut v: Vec[int] = [5, -3, 9, 1, 7, 1, 0]
+    sort(v)
+    for x in v {
+        print("{} ", x)
+    }
+    println("")
+    sort_by(&v, desc)
+    for x in v {
+        print("{} ", x)
+    }
+    println("")
+
+    let mut a = [2.5, -1.0, 0.0 / 0.0, 10.0, -7.25]
+    sort(a)
+    println("{} {} {} {} {}", a[0], a[1], a[2], a[3], a[4] != a[4])
+
+    let mut names: Vec[str] = ["minh", "an", "chi", "bình", "an"]
+    sort(names)
+    for s in names {
+        print("{s} ", s)
+    }
+    println("")
+
+    let mut cs = [Blue, Red, Green, Red]
+    sort(cs)
+    println("{} {} {} {}", cs[0] as int, cs[1] as int, cs[2] as int, cs[3] as int)
+
+    let mut ps: Vec[Person] = [Person { name: "Lan", age: 31 },
+                               Person { name: "Huy", age: 19 },
+                               Person { name: "Mai", age: 25 }]
+    sort_by(ps, by_age)
+    for p in ps {
+        print("{s}({}) ", p.name, p.age)
+    }
+    println("")
+
+    let p = g_alloc(int, 6)
+    for i in 0..6 {
+        p[i] = (i * 7) % 6 - 2
+    }
+    sort(p, 6)
+    println("{} {} {} {} {} {}", p[0], p[1], p[2], p[3], p[4], p[5])
+    g_free(p)
+
+    // Dãy lớn: đủ dài để đi qua phân hoạch, ninther và nhánh trùng lặp.
+    let n = 100000
+    let mut big: Vec[int]
+    let mut seed: u64 = 88172645463325252
+    for i in 0..n {
+        big.push((xorshift(&seed) >> 40) as int - 8000000)
+    }
+    sort(big)
+    check(&big, "ngẫu nhiên")
+    sort(big)
+    check(&big, "đã sắp")
+    sort_by(&big, desc)
+    sort(big)
+    check(&big, "đảo ngược")
+    for i in 0..n {
+        big[i] = (xorshift(&seed) % 5) as int
+    }
+    sort(big)
+    check(&big, "trùng lặp")
+    for i in 0..n {
+        big[i] = (xorshift(&seed) >> 33) as int - 1000000000
+    }
+    radix_sort_int(&big[0], n)
+    check(&big, "radix")
+
+    // Số thực nhiều trùng lặp, đủ dài cho phân hoạch (so sánh NaN-an-toàn
+    // không được đánh giá ++/-- hai lần); vài NaN phải dồn về cuối.
+    let mut fs: Vec[f64]
+    let mut gs: Vec[f32]
+    for i in 0..1000 {
+        let s = xorshift(&seed)
+        fs.push((s % 16) as f64)
+        gs.push((s % 16) as f32)
+    }
+    fs[17] = 0.0 / 0.0
+    fs[500] = 0.0 / 0.0
+    sort(fs)
+    sort(gs)
+    let mut fok = fs[998] != fs[998] && fs[999] != fs[999]
+    let mut gok = true
+    let mut fsum: f64 = 0.0
+    let mut gsum: f64 = 0.0
+    for i in 1..998 {
+        if fs[i - 1] > fs[i] {
+            fok = false
+        }
+        fsum += fs[i - 1]
+    }
+    fsum += fs[997]
+    for i in 1..1000 {
+        if gs[i - 1] > gs[i] {
+            gok = false
+        }
+        gsum += gs[i - 1] as f64
+    }
+    gsum += gs[999] as f64
+    println("f64 trùng lặp: tăng dần + NaN cuối = {}, tổng = {f}", fok, fsum)
+    println("f32 trùng lặp: tăng dần = {}, tổng = {f}", gok, gsum)
+    fs.free()
+    gs.free()
+
+    v.free()
+    names.free()
+    ps.free()
+    big.free()
+    return 0
+}
@@ -0,0 +1,66 @@
+// Kiểm tra strbuf (g_string): append tăng dần, SSO -> heap, len O(1),
+// sb_finish chuyển giao bộ đệm, và gộp chuỗi str_concat lồng nhau.
+import std
+
+fn join(words: *str, n: int, sep: char) -> str {
+    let mut b = sb_new()
+    for i in 0..n {
+        if i > 0 {
+            sb_push_char(&b, sep)
+        }
+        sb_push(&b, words[i])
+    }
+    return sb_finish(&b)
+}
+
+fn main() -> int {
+    let mut b: strbuf
+    println("rỗng: len = {}, '{s}'", len(b), sb_str(&b))
+
+    sb_push(&b, "ngắn")
+    println("'{s}' len = {}", sb_str(&b), len(b))
+
+    // vượt bộ đệm nội tuyến -> lên heap, nội dung cũ giữ nguyên
+    for i in 0..10 {
+        sb_push_char(&b, ' ')
+        sb_push_int(&b, (i * i) as i64)
+    }
+    println("'{s}' len = {}", sb_str(&b), len(b))
+
+    sb_clear(&b)
+    sb_push(&b, "sau clear")
+    println("'{s}' len = {}", sb_str(&b), len(b))
+    sb_free(&b)
+
+    // append chính nó: lần đầu SSO -> heap, các lần sau realloc nguồn
+    let mut self_b = sb_new()
+    sb_push(&self_b, "abcdefghijklmnop")
+    sb_push(&self_b, sb_str(&self_b))
+    println("'{s}' len = {}", sb_str(&self_b), len(self_b))
+    for i in 0..3 {
+        sb_push(&self_b, sb_str(&self_b))
+    }
+    println("x16: len = {}, tìm 'pa' ở {}", len(self_b), sb_index(&self_b, "pa"))
+    sb_free(&self_b)
+
+    let mut big = sb_new()
+    for i in 0..100000 {
+        sb_push_int(&big, (i % 10) as i64)
+    }
+    let pb = &big
+    println("big: len = {}, len qua con trỏ = {}", len(big), len(pb))
+    let flat = sb_finish(&big)
+    println("sau finish: len = {}, str_len = {}", len(big), str_len(flat))
+    g_free(flat)
+
+    let words: [4]str = ["alpha", "beta", "gamma", "delta"]
+    let j = join(words, 4, ',')
+    println("{s}", j)
+    g_free(j)
+
+    let name = "G"
+    let msg = str_concat(str_concat("Xin ", "chào, "), str_concat(name, str_concat("!", "")))
+    println("{s} ({} byte)", msg, str_len(msg))
+    g_free(msg)
+    return 0
+}
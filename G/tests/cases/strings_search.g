@@ -0,0 +1,40 @@
+// Kiểm tra nhân chuỗi của runtime: str_len/streq/str_index trên chuỗi ngắn và
+// dài (vượt nhiều khối vector), match chuỗi, và sb_index (độ dài đã biết).
+import std
+
+fn main() -> int {
+    let mut b = sb_new()
+    for i in 0..200 {
+        sb_push(&b, "log line ")
+        sb_push_int(&b, i as i64)
+        sb_push_char(&b, ';')
+    }
+    sb_push(&b, "ERROR disk failure at sector 42")
+    let text = sb_str(&b)
+    println("len = {}, str_len = {}", len(b), str_len(text))
+
+    println("index ERROR = {}", str_index(text, "ERROR"))
+    println("sb_index ERROR = {}", sb_index(&b, "ERROR"))
+    println("sb_index 'line 137;' = {}", sb_index(&b, "line 137;"))
+    println("sb_index thiếu = {}", sb_index(&b, "line 200;"))
+    println("sb_index rỗng = {}", sb_index(&b, ""))
+    println("index 1 ký tự = {}", str_index(text, "E"))
+    println("contains 'sector 42'? {}", str_contains(text, "sector 42"))
+    println("ends 'sector 42'? {}", ends_with(text, "sector 42"))
+
+    let copy = g_str_dup(text)
+    println("streq(copy)? {}", streq(copy, text))
+    println("streq(ngắn)? {} {}", streq("abc", "abc"), streq("abc", "abd"))
+    println("streq(tiền tố)? {}", streq("abc", "abcd"))
+
+    let cmd = "status"
+    match cmd {
+        "start" => println("bắt đầu")
+        "status" => println("trạng thái")
+        _ => println("không rõ")
+    }
+
+    g_free(copy)
+    sb_free(&b)
+    return 0
+}
@@ -0,0 +1,118 @@
+// Kiểm tra Vec[T]: push/pop/reserve/len, duyệt 'for x in v', v[i] đọc/ghi,
+// Vec của struct/chuỗi/Vec, Vec làm trường struct và truyền qua con trỏ.
+
+struct Point {
+    x: int
+    y: int
+}
+
+struct Stack {
+    items: Vec[i64]
+}
+
+impl Stack {
+    fn push(self: *Stack, v: i64) {
+        self.items.push(v)
+    }
+
+    fn top(self: *Stack) -> i64 {
+        return self.items[len(self.items) - 1]
+    }
+}
+
+fn sum(v: *Vec[int]) -> int {
+    let mut s = 0
+    for x in v {
+        s += x
+    }
+    return s
+}
+
+fn fill(v: *Vec[int], n: int) {
+    v.reserve(n as usize)
+    for i in 0..n {
+        v.push(i * i)
+    }
+}
+
+fn main() -> int {
+    let mut v: Vec[int]
+    println("rỗng: len = {}", len(v))
+    fill(&v, 10)
+    println("len = {}, tổng = {}", len(v), sum(&v))
+
+    v[0] = 100
+    v[9] += 1
+    println("v[0] = {}, v[9] = {}", v[0], v[9])
+
+    let last = v.pop()
+    println("pop = {}, len = {}", last, len(v))
+
+    // push trong lúc duyệt: vòng lặp đọc lại len/data nên vẫn an toàn
+    let mut w: Vec[int] = [1, 2, 3]
+    for x in w {
+        if x < 3 {
+            w.push(x * 10)
+        }
+    }
+    for x in w {
+        print("{} ", x)
+    }
+    println("")
+
+    let mut pts: Vec[Point]
+    for i in 0..3 {
+        pts.push(Point { x: i, y: -i })
+    }
+    pts[1].y = 42
+    for p in pts {
+        println("({}, {})", p.x, p.y)
+    }
+
+    let mut names: Vec[str] = ["an", "bình"]
+    names.push("chi")
+    for s in names {
+        print("{s} ", s)
+    }
+    println("")
+
+    let mut grid: Vec[Vec[int]]
+    for r in 0..3 {
+        let mut row: Vec[int]
+        for c in 0..r + 1 {
+            row.push(r * 10 + c)
+        }
+        grid.push(row)
+    }
+    println("grid[2][1] = {}, hàng = {}", grid[2][1], len(grid))
+
+    let mut st = Stack {}
+    st.push(7)
+    st.push(9)
+    println("đỉnh = {}", st.top())
+
+    // nhiều lần tăng trưởng: dữ liệu cũ giữ nguyên
+    let mut big: Vec[i64]
+    for i in 0..100000 {
+        big.push(i as i64)
+    }
+    let mut total: i64 = 0
+    for x in big {
+        total += x
+    }
+    println("big: len = {}, tổng = {}", len(big), total)
+
+    big.clear()
+    println("sau clear: len = {}", len(big))
+    big.free()
+    v.free()
+    w.free()
+    names.free()
+    pts.free()
+    st.items.free()
+    for mut row in grid {
+        row.free()
+    }
+    grid.free()
+    return 0
+}
@@ -0,0 +1,10 @@
+// Hàm thường không trả được mảng tĩnh (C không trả mảng theo giá trị).
+fn make() -> [4]int {
+    let t = [1, 2, 3, 4]
+    return t
+}
+
+fn main() -> int {
+    let a = make()
+    return a[0]
+}
@@ -0,0 +1,10 @@
+// Gọi thẳng hàm async như hàm thường (phải await trong async fn hoặc spawn).
+import std
+async fn twice(x: int) -> int {
+    await yield_now()
+    return x * 2
+}
+fn main() -> int {
+    let y = twice(3)
+    return y
+}
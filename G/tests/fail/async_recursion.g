@@ -0,0 +1,17 @@
+// Hàm async await chính nó qua một hàm khác: khung trạng thái lồng vô hạn.
+import std
+async fn ping(n: int) -> int {
+    if n == 0 {
+        return 0
+    }
+    let r = await pong(n - 1)
+    return r + 1
+}
+async fn pong(n: int) -> int {
+    let r = await ping(n)
+    return r
+}
+fn main() {
+    spawn(ping(3))
+    async_run()
+}
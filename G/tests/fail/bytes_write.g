@@ -0,0 +1,8 @@
+// bytes là vùng chỉ đọc (tệp map PROT_READ): không được ghi phần tử
+import std
+
+fn main() -> int {
+    let mut b = str_bytes("abc")
+    b[0] = 'x' as u8
+    return 0
+}
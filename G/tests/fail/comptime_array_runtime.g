@@ -0,0 +1,15 @@
+// 'comptime fn' trả về mảng chỉ tồn tại lúc biên dịch: đối số phải là hằng.
+comptime fn ramp(k: int) -> [4]int {
+    let mut t: [4]int
+    for i in 0..4 {
+        t[i] = i * k
+    }
+    return t
+}
+
+fn main() -> int {
+    let mut k = 3
+    k += 1
+    let t = ramp(k)
+    return t[1]
+}
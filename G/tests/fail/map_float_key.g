@@ -0,0 +1,6 @@
+// Khoá Map kiểu số thực (NaN != NaN) không được hỗ trợ.
+fn main() -> int {
+    let mut m: Map[f64, int]
+    m.set(1.5, 1)
+    return 0
+}
@@ -0,0 +1,5 @@
+// Mat chỉ có nhân GEMM cho int, f32 và f64
+fn main() -> int {
+    let mut m: Mat[u8]
+    return 0
+}
@@ -0,0 +1,13 @@
+// Truyền &c của biến bắt từ ngoài vào hàm trong thân par for: hàm ghi qua con
+// trỏ, mọi lần lặp cùng sửa một ô nhớ.
+fn bump(p: *int) {
+    *p += 1
+}
+
+fn main() -> int {
+    let mut c = 0
+    par for i in 0..1000 {
+        bump(&c)
+    }
+    return c
+}
@@ -0,0 +1,10 @@
+// Ghi mảng bắt từ ngoài với chỉ số không phụ thuộc trực tiếp vào biến lặp
+// (histogram): hai lần lặp có thể trúng cùng một ô.
+fn main() -> int {
+    let data = [3, 1, 4, 1, 5, 9, 2, 6]
+    let mut hist: [10]int
+    par for i in 0..8 {
+        hist[data[i]] += 1
+    }
+    return hist[1]
+}
@@ -0,0 +1,10 @@
+// Hai lần ghi vào cùng mảng ở a[i] và a[i + 1]: lần lặp i và i + 1 cùng ghi
+// ô a[i + 1] song song.
+fn main() -> int {
+    let mut a: [101]int
+    par for i in 0..100 {
+        a[i] = 1
+        a[i + 1] = 2
+    }
+    return a[1]
+}
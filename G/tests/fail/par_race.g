@@ -0,0 +1,11 @@
+// Gán biến 'let mut' bắt từ ngoài trong thân par for mà không có mệnh đề rút
+// gọn: các lần lặp song song cùng ghi một ô nhớ.
+fn main() -> int {
+    let mut count = 0
+    par for i in 0..1000 {
+        if i % 3 == 0 {
+            count += 1
+        }
+    }
+    return count
+}
@@ -0,0 +1,12 @@
+// Dịch mảng tại chỗ trong par for: lần lặp i đọc arr[i + 1] trong khi lần lặp
+// i + 1 ghi chính ô đó song song.
+fn main() -> int {
+    let mut arr: [101]int
+    for i in 0..101 {
+        arr[i] = i
+    }
+    par for i in 0..100 {
+        arr[i] = arr[i + 1]
+    }
+    return arr[0]
+}
@@ -0,0 +1,9 @@
+// Chỉ số có hệ số 0 trước biến lặp: mọi lần lặp cùng cập nhật a[0].
+fn main() -> int {
+    let mut a: [8]int
+    let k = 0
+    par for i in 0..8 {
+        a[k * i] += 1
+    }
+    return a[0]
+}
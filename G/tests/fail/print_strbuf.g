@@ -0,0 +1,9 @@
+// In trực tiếp một strbuf (cần sb_str để lấy chuỗi).
+import std
+
+fn main() -> int {
+    let mut b = sb_new()
+    sb_push(&b, "x")
+    println("{}", b)
+    return 0
+}
@@ -0,0 +1,6 @@
+// '/=' trên cả dãy chỉ dành cho phần tử số thực
+fn main() -> int {
+    let mut v: Vec[int] = [1, 2, 3]
+    v /= 2
+    return 0
+}
@@ -0,0 +1,10 @@
+// Struct không có thứ tự tự nhiên: phải truyền hàm so sánh qua sort_by.
+struct P {
+    x: int
+}
+
+fn main() -> int {
+    let mut v: Vec[P]
+    sort(v)
+    return 0
+}
@@ -0,0 +1,6 @@
+// Đưa phần tử sai kiểu vào Vec[T].
+fn main() -> int {
+    let mut v: Vec[int]
+    v.push("x")
+    return 0
+}
@@ -1,6 +1,7 @@
 #!/usr/bin/env bash
 # Bộ test tự động cho ngôn ngữ G.
 # Biên dịch & chạy từng ví dụ, so sánh stdout với tests/expected/<tên>.txt
+# (và mã C sinh ra với tests/expected/<tên>.emit nếu có).
 # Dùng:  ./tests/run_tests.sh            (chạy test)
 #        ./tests/run_tests.sh --bless    (cập nhật kết quả mong đợi)
 
@@ -9,6 +10,8 @@ ROOT="$(cd "$(dirname "$0")/.." && pwd)"
 GC="$ROOT/gc"
 EXPECTED="$ROOT/tests/expected"
 TMP="$(mktemp -d)"
+# par for / Mat.matmul chạy trên bể nhiều luồng kể cả khi máy ít CPU.
+export G_THREADS="${G_THREADS:-4}"
 trap 'rm -rf "$TMP"' EXIT
 
 mkdir -p "$EXPECTED"
@@ -17,6 +20,55 @@ GREEN='\033[32m'; RED='\033[1;31m'; YEL='\033[33m'; RST='\033[0m'
 pass=0; fail=0; bless=0
 [ "${1:-}" = "--bless" ] && bless=1
 
+# Kiểm tra mã C sinh ra (tuỳ chọn): tests/expected/<tên>.emit liệt kê mỗi dòng
+# một đoạn phải có trong 'gc --emit-c'; dòng bắt đầu bằng '!' là đoạn KHÔNG được
+# có (vd hằng comptime phải thành literal, không còn lời gọi hàm).
+check_emit() {
+    local src="$1"
+    local name; name="$(basename "$src" .g)"
+    local pat="$EXPECTED/$name.emit"
+    [ -f "$pat" ] || return 0
+    "$GC" "$src" --emit-c -o "$TMP/$name.c" >/dev/null 2>&1
+    local line bad=0
+    while IFS= read -r line; do
+        [ -n "$line" ] || continue
+        if [ "${line:0:1}" = "!" ]; then
+            grep -qF -- "${line:1}" "$TMP/$name.c" || continue
+            echo "  mã C không được chứa: ${line:1}"
+        else
+            grep -qF -- "$line" "$TMP/$name.c" && continue
+            echo "  mã C thiếu: $line"
+        fi
+        bad=1
+    done < "$pat"
+    if [ "$bad" = "1" ]; then
+        echo -e "${RED}FAIL${RST}         $name (mã C)"
+        fail=$((fail+1)); return 1
+    fi
+    return 0
+}
+
+# gc biên dịch với -w; ở đây biên dịch lại mã C sinh ra với -Wall -Wextra (không
+# -w) để cảnh báo của runtime và helper sinh ra (hàm static không dùng, dùng sau
+# realloc...) không lọt qua. Cảnh báo thuộc chính chương trình G (biến không
+# dùng...) bỏ qua: chỉ tính cảnh báo trong g_runtime.h và -Wunused-function.
+CC_WARN="${CC:-cc}"
+check_warnings() {
+    local src="$1"
+    local name; name="$(basename "$src" .g)"
+    command -v "$CC_WARN" >/dev/null || return 0
+    "$GC" "$src" --emit-c -o "$TMP/$name.w.c" >/dev/null 2>&1 || return 0
+    local warn
+    warn="$("$CC_WARN" "$TMP/$name.w.c" -c -o /dev/null -O2 -std=gnu11 -pthread \
+            -I "$ROOT/runtime" -Wall -Wextra 2>&1 \
+            | grep -E 'g_runtime\.h:[0-9]+:[0-9]+: warning|\[-Wunused-function\]')"
+    [ -z "$warn" ] && return 0
+    echo -e "${RED}FAIL${RST}         $name (cảnh báo C)"
+    echo "$warn" | head -5
+    fail=$((fail+1))
+    return 1
+}
+
 run_one() {
     local src="$1"
     local name; name="$(basename "$src" .g)"
@@ -41,6 +93,8 @@ run_one() {
         fail=$((fail+1)); return
     fi
     if diff -q "$exp" "$got" >/dev/null; then
+        check_emit "$src" || return
+        check_warnings "$src" || return
         echo -e "${GREEN}PASS${RST}         $name"
         pass=$((pass+1))
     else
@@ -87,6 +141,32 @@ run_fail() {
     fi
 }
 
+# Chạy lại một số test dưới AddressSanitizer + UBSan (vd region.g: g_realloc
+# trên arena từng memcpy giữa hai vùng chồng lấn; slices.g: tổng i64 tràn).
+# Bỏ qua nếu cc không hỗ trợ sanitizer.
+ASAN_CASES="region slices"
+
+run_asan() {
+    local name="$1"
+    local src="$ROOT/tests/cases/$name.g"
+    local bin="$TMP/$name.asan"
+    local exp="$EXPECTED/$name.txt"
+    if ! "$GC" "$src" -o "$bin" -fsanitize=address,undefined -fno-omit-frame-pointer \
+            >"$TMP/$name.asan.cc" 2>&1; then
+        echo -e "${YEL}BỎ QUA${RST}       $name (asan: cc không hỗ trợ)"
+        return
+    fi
+    if ASAN_OPTIONS=detect_leaks=0 "$bin" >"$TMP/$name.asan.out" 2>&1 \
+            && diff -q "$exp" "$TMP/$name.asan.out" >/dev/null; then
+        echo -e "${GREEN}PASS${RST}         $name (asan)"
+        pass=$((pass+1))
+    else
+        echo -e "${RED}FAIL${RST}         $name (asan)"
+        grep -m3 -E 'ERROR|SUMMARY|runtime error' "$TMP/$name.asan.out"
+        fail=$((fail+1))
+    fi
+}
+
 echo "=== Bộ test ngôn ngữ G ==="
 for src in "$ROOT"/examples/*.g "$ROOT"/tests/cases/*.g; do
     [ -e "$src" ] || continue
@@ -96,6 +176,9 @@ for src in "$ROOT"/tests/fail/*.g; do
     [ -e "$src" ] || continue
     run_fail "$src"
 done
+if [ "$bless" = "0" ]; then
+    for name in $ASAN_CASES; do run_asan "$name"; done
+fi
 
 echo "-------------------------"
 if [ "$bless" = "1" ]; then
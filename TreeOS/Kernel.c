@@ -5,6 +5,14 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#include "slab.h"
+#include "frame_alloc.h"
+#include "buddy.h"
+#include "mlfq.h"
+#include "timer_wheel.h"
+#include "spsc_ring.h"
+#include "deferred.h"
+
 // ========== Type Definitions ==========
 typedef uint8_t u8;
 typedef uint16_t u16;
@@ -41,8 +49,11 @@ enum vga_color {
 #define HEAP_SIZE (32 * 1024 * 1024)  // 32MB heap
 #define MAX_MEMORY_BLOCKS 16384
 #define KERNEL_STACK_SIZE 16384
+#define KERNEL_STACK_ORDER 2               // 4 frames = KERNEL_STACK_SIZE
+#define BUDDY_POOL_FRAMES 4096             // 16MB of contiguous pages
+#define SLAB_ARENA_SIZE (8 * 1024 * 1024)  // front of the heap, small objects
 
-typedef struct {
+typedef struct memory_block {
     void *address;
     size_t size;
     bool used;
@@ -51,14 +62,6 @@ typedef struct {
     struct memory_block *prev;
 } memory_block_t;
 
-typedef struct {
-    u32 *bitmap;
-    u32 total_frames;
-    u32 used_frames;
-    u32 free_frames;
-    u32 first_free;
-} page_frame_allocator_t;
-
 typedef struct {
     u32 *page_directory;
     u32 *page_tables[1024];
@@ -69,7 +72,7 @@ typedef struct {
 #define MAX_PROCESSES 256
 #define PROCESS_NAME_LEN 64
 #define MAX_FILE_DESCRIPTORS 64
-#define QUANTUM_MS 20
+#define sched_process(se) ((process_t*)((u8*)(se) - offsetof(process_t, sched)))
 
 typedef enum {
     PROC_STATE_NEW,
@@ -94,12 +97,13 @@ typedef struct process {
     u32 ppid;
     char name[PROCESS_NAME_LEN];
     process_state_t state;
-    i32 priority;
+    i32 priority;               // current MLFQ level, mirrored from sched
     i32 nice;
-    u32 quantum;
+    sched_entity_t sched;
     u64 cpu_time;
     u64 start_time;
-    u64 sleep_until;
+    u64 sleep_until;            // microseconds, see clock_now_us()
+    timer_entry_t sleep_timer;
     registers_t regs;
     void *kernel_stack;
     void *user_stack;
@@ -169,7 +173,7 @@ static u8 cursor_x = 0;
 static u8 cursor_y = 0;
 static u8 current_color = 0x0F;
 
-static u8 *heap_start = (u8*)HEAP_START;
+static u8 *heap_start = (u8*)(HEAP_START + SLAB_ARENA_SIZE);
 static memory_block_t *memory_blocks_head = NULL;
 static size_t total_allocated = 0;
 static size_t allocation_count = 0;
@@ -177,20 +181,25 @@ static size_t allocation_count = 0;
 static process_t *process_list[MAX_PROCESSES] = {NULL};
 static process_t *current_process = NULL;
 static process_t *idle_process = NULL;
-static process_t *ready_queue = NULL;
+static sched_runqueue_t run_queue;
 static u32 next_pid = 1;
 static volatile u64 system_ticks = 0;
 static volatile u64 system_time_ms = 0;
+static timer_wheel_t sleep_wheel;
 
 static idt_entry_t idt[IDT_ENTRIES];
 static idt_ptr_t idt_ptr;
 
+void schedule(void);
+void make_ready(process_t *proc);
+
 static page_frame_allocator_t frame_allocator;
+static buddy_allocator_t page_buddy;
 static virtual_memory_t kernel_vm;
 
-static u8 keyboard_buffer[256];
-static volatile int kb_read_pos = 0;
-static volatile int kb_write_pos = 0;
+// Keyboard IRQ (producer, raw scancodes) -> keyboard bottom half (consumer)
+SPSC_RING_DEFINE(kb_ring, u8, 256)
+static kb_ring_t keyboard_ring;
 static bool shift_pressed = false;
 static bool ctrl_pressed = false;
 static bool alt_pressed = false;
@@ -206,6 +215,9 @@ static struct {
     u64 memory_frees;
     u64 kernel_time;
     u64 user_time;
+    u32 buddy_free_blocks[BUDDY_ORDERS];   // per-order, watch for fragmentation
+    u32 buddy_free_frames;
+    u32 irq_max_cycles[16];                // worst interrupts-off time per IRQ line
 } kernel_stats = {0};
 
 // ========== Port I/O ==========
@@ -427,14 +439,29 @@ void init_memory(void) {
     total_allocated = 0;
     allocation_count = 0;
     
+    slab_init((void*)HEAP_START, SLAB_ARENA_SIZE);
+    
     printf("[MEM] Initializing memory manager...\n");
     printf("[MEM] Heap at 0x%x - 0x%x (%d MB)\n", 
            HEAP_START, HEAP_START + HEAP_SIZE, HEAP_SIZE / (1024*1024));
+    printf("[MEM] Slab arena: %d KB, classes %d-%d B\n",
+           SLAB_ARENA_SIZE / 1024, SLAB_MIN_SIZE, SLAB_MAX_SIZE);
 }
 
 void *kmalloc_aligned(size_t size, u32 alignment) {
     if (size == 0) return NULL;
     
+    // Small objects: O(1) size-class slabs. Falls through to the block
+    // list only when the request is too big or the arena is exhausted.
+    if (size <= SLAB_MAX_SIZE && alignment <= SLAB_MAX_SIZE) {
+        void *obj = slab_alloc(size, alignment);
+        if (obj) {
+            allocation_count++;
+            kernel_stats.memory_allocations++;
+            return obj;
+        }
+    }
+    
     size = (size + alignment - 1) & ~(alignment - 1);
     size += sizeof(memory_block_t);
     
@@ -468,7 +495,7 @@ void *kmalloc_aligned(size_t size, u32 alignment) {
         block = block->next;
     }
     
-    if (total_allocated + size > HEAP_SIZE) return NULL;
+    if (total_allocated + size > HEAP_SIZE - SLAB_ARENA_SIZE) return NULL;
     
     block = (memory_block_t*)((u8*)heap_start + total_allocated);
     block->address = (u8*)block + sizeof(memory_block_t);
@@ -502,6 +529,15 @@ void *kcalloc(size_t nmemb, size_t size) {
 void kfree(void *ptr) {
     if (!ptr) return;
     
+    if (slab_owns(ptr)) {
+        if (!slab_free(ptr)) {
+            printf("[MEM] Invalid free: bad slab page at %x\n", ptr);
+            return;
+        }
+        kernel_stats.memory_frees++;
+        return;
+    }
+    
     memory_block_t *block = (memory_block_t*)((u8*)ptr - sizeof(memory_block_t));
     if (block->magic != 0xDEADBEEF) {
         printf("[MEM] Invalid free: magic mismatch at %x\n", ptr);
@@ -528,14 +564,14 @@ void kfree(void *ptr) {
 void init_paging(void) {
     printf("[MEM] Initializing paging...\n");
     
-    frame_allocator.total_frames = (128 * 1024 * 1024) / PAGE_SIZE;
-    frame_allocator.used_frames = 0;
-    frame_allocator.free_frames = frame_allocator.total_frames;
-    frame_allocator.first_free = 0;
+    u32 total_frames = (128 * 1024 * 1024) / PAGE_SIZE;
+    u32 bitmap_size = (total_frames + 31) / 32;
+    u32 *bitmap = (u32*)kmalloc(bitmap_size * sizeof(u32));
+    frame_alloc_init(&frame_allocator, bitmap, total_frames);
     
-    u32 bitmap_size = (frame_allocator.total_frames + 31) / 32;
-    frame_allocator.bitmap = (u32*)kmalloc(bitmap_size * sizeof(u32));
-    memset(frame_allocator.bitmap, 0, bitmap_size * sizeof(u32));
+    // Low memory, the kernel image and the heap are never handed out. This
+    // also keeps frame 0 reserved, so a physical address of 0 means failure.
+    frame_reserve_range(&frame_allocator, 0, (HEAP_START + HEAP_SIZE) / PAGE_SIZE);
     
     kernel_vm.page_directory = (u32*)kmalloc_aligned(PAGE_SIZE, PAGE_SIZE);
     memset(kernel_vm.page_directory, 0, PAGE_SIZE);
@@ -545,32 +581,59 @@ void init_paging(void) {
 }
 
 u32 alloc_frame(void) {
-    for (u32 i = frame_allocator.first_free; i < frame_allocator.total_frames; i++) {
-        u32 idx = i / 32;
-        u32 bit = i % 32;
-        
-        if (!(frame_allocator.bitmap[idx] & (1 << bit))) {
-            frame_allocator.bitmap[idx] |= (1 << bit);
-            frame_allocator.used_frames++;
-            frame_allocator.free_frames--;
-            frame_allocator.first_free = i + 1;
-            return i * PAGE_SIZE;
-        }
-    }
-    return 0;
+    u32 i = frame_alloc_one(&frame_allocator);
+    return i == FRAME_NONE ? 0 : i * PAGE_SIZE;
 }
 
 void free_frame(u32 frame) {
-    u32 i = frame / PAGE_SIZE;
-    u32 idx = i / 32;
-    u32 bit = i % 32;
-    
-    if (frame_allocator.bitmap[idx] & (1 << bit)) {
-        frame_allocator.bitmap[idx] &= ~(1 << bit);
-        frame_allocator.used_frames--;
-        frame_allocator.free_frames++;
-        if (i < frame_allocator.first_free) frame_allocator.first_free = i;
+    frame_free_range(&frame_allocator, frame / PAGE_SIZE, 1);
+}
+
+// Physically contiguous frames (DMA buffers, large pages). `align` is in
+// bytes and must be a power of two (0 or anything up to PAGE_SIZE means page
+// aligned); other alignments fail rather than being silently weakened.
+u32 alloc_frames(u32 count, u32 align) {
+    if (align & (align - 1)) return 0;
+    u32 align_frames = align > PAGE_SIZE ? align / PAGE_SIZE : 1;
+    u32 i = frame_alloc_range(&frame_allocator, count, align_frames);
+    return i == FRAME_NONE ? 0 : i * PAGE_SIZE;
+}
+
+void free_frames(u32 frame, u32 count) {
+    frame_free_range(&frame_allocator, frame / PAGE_SIZE, count);
+}
+
+// ========== Buddy Pages ==========
+static void update_buddy_stats(void) {
+    for (u32 o = 0; o < BUDDY_ORDERS; o++)
+        kernel_stats.buddy_free_blocks[o] = page_buddy.free_blocks[o];
+    kernel_stats.buddy_free_frames = page_buddy.free_frames;
+}
+
+void init_page_buddy(void) {
+    if (buddy_init(&page_buddy, &frame_allocator, BUDDY_POOL_FRAMES))
+        printf("[MEM] Buddy pool: %d frames at 0x%x\n",
+               page_buddy.frames, page_buddy.base_frame * PAGE_SIZE);
+    else
+        printf("[MEM] Buddy pool unavailable\n");
+    update_buddy_stats();
+}
+
+// 2^order physically contiguous, naturally aligned frames (page tables,
+// kernel stacks). Returns the physical address or 0.
+u32 alloc_pages(u32 order) {
+    u32 frame = buddy_alloc(&page_buddy, order);
+    if (frame == FRAME_NONE) return 0;
+    update_buddy_stats();
+    return frame * PAGE_SIZE;
+}
+
+void free_pages(u32 addr, u32 order) {
+    if (!buddy_free(&page_buddy, addr / PAGE_SIZE, order)) {
+        printf("[MEM] Invalid free_pages: 0x%x order %d\n", addr, order);
+        return;
     }
+    update_buddy_stats();
 }
 
 // ========== IDT Setup ==========
@@ -589,6 +652,11 @@ extern void isr12(void), isr13(void), isr14(void), isr15(void);
 extern void isr16(void), isr17(void), isr18(void), isr19(void);
 extern void irq0(void), irq1(void), irq2(void), irq3(void);
 extern void irq4(void), irq5(void), irq6(void), irq7(void);
+extern void irq14(void);
+
+// IRQ table in driver_manager.cpp; weak so the kernel still links (and
+// just acknowledges device IRQs) when the driver manager is left out.
+extern void driver_manager_handle_irq(u32 irq) __attribute__((weak));
 
 void idt_install(void) {
     idt_ptr.limit = sizeof(idt) - 1;
@@ -605,6 +673,7 @@ void idt_install(void) {
     // Install IRQs
     idt_set_gate(32, (u32)irq0, 0x08, 0x8E);
     idt_set_gate(33, (u32)irq1, 0x08, 0x8E);
+    idt_set_gate(46, (u32)irq14, 0x08, 0x8E);   // primary ATA
     
     __asm__ volatile("lidt %0" : : "m"(idt_ptr));
     
@@ -633,38 +702,205 @@ void pic_remap(void) {
     outb(PIC2_DATA, 0x01);
     io_wait();
     
-    outb(PIC1_DATA, 0xFD);
-    outb(PIC2_DATA, 0xFF);
+    // Unmasked: keyboard, the cascade line to PIC2, and primary ATA (IRQ 14)
+    outb(PIC1_DATA, 0xF9);
+    outb(PIC2_DATA, 0xBF);
     
     printf("[PIC] Remapped to 0x20-0x2F\n");
 }
 
 // ========== Timer ==========
+// Tickless: the PIT runs in one-shot mode (mode 0) and is reprogrammed after
+// every interrupt for the nearest of: the next sleep deadline in sleep_wheel,
+// the next scheduler tick (only while something is runnable), or a kernel
+// busy-wait deadline. Time is kept by summing the programmed PIT counts.
+// The kernel owns the PIT; drivers must not reprogram it.
+#define PIT_FREQUENCY 1193182
+#define PIT_MAX_COUNT 0xFFFF
+#define PIT_MIN_US 50
+#define SCHED_TICK_US 10000                 // one scheduler tick = 10 ms
+
+static u64 pit_elapsed = 0;                 // PIT clocks before the current shot
+static u32 pit_programmed = 0;              // count loaded for the current shot
+static bool pit_irq_stale = false;          // pending IRQ0 is for a shot already counted
+static u64 last_sched_tick_us = 0;
+static u64 kernel_wakeup_us = TW_NEVER;
+
+static inline u32 irq_save(void) {
+    u32 flags;
+    __asm__ volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void irq_restore(u32 flags) {
+    if (flags & 0x200) __asm__ volatile("sti" : : : "memory");
+}
+
+// PIT clocks consumed by the current shot so far.
+static u32 pit_shot_elapsed(void) {
+    if (!pit_programmed) return 0;
+    outb(0x43, 0x00);                       // latch channel 0
+    u32 remaining = inb(0x40);
+    remaining |= (u32)inb(0x40) << 8;
+    // After terminal count the counter wraps and keeps going; until the IRQ
+    // is serviced the whole shot counts as elapsed.
+    if (remaining > pit_programmed) return pit_programmed;
+    return pit_programmed - remaining;
+}
+
+u64 clock_now_us(void) {
+    u64 clocks = pit_elapsed + pit_shot_elapsed();
+    return clocks * 1000000 / PIT_FREQUENCY;
+}
+
+// IRQ0 raised but not yet serviced (PIC IRR bit 0).
+static bool pit_irq_pending(void) {
+    outb(PIC1_COMMAND, 0x0A);               // OCW3: next read returns IRR
+    return inb(PIC1_COMMAND) & 0x01;
+}
+
+static void pit_program_us(u64 us) {
+    if (pit_programmed && pit_irq_pending()) {
+        // The shot being replaced already hit terminal count (we run with
+        // interrupts off): count it in full here and let timer_handler know
+        // that the IRQ it is about to see carries no time of its own.
+        pit_elapsed += pit_programmed;
+        pit_irq_stale = true;
+    } else {
+        pit_elapsed += pit_shot_elapsed();
+    }
+    
+    if (us < PIT_MIN_US) us = PIT_MIN_US;
+    u64 count = us * PIT_FREQUENCY / 1000000;
+    if (count > PIT_MAX_COUNT) count = PIT_MAX_COUNT;
+    if (count == 0) count = 1;
+    
+    outb(0x43, 0x30);                       // channel 0, lo/hi, mode 0
+    outb(0x40, count & 0xFF);
+    outb(0x40, (count >> 8) & 0xFF);
+    pit_programmed = (u32)count;
+}
+
+static void timer_reprogram(u64 now) {
+    u64 next = timer_wheel_next_event(&sleep_wheel);
+    if (kernel_wakeup_us < next) next = kernel_wakeup_us;
+    
+    bool busy = (current_process && current_process != idle_process) || run_queue.nr_queued;
+    if (busy && last_sched_tick_us + SCHED_TICK_US < next)
+        next = last_sched_tick_us + SCHED_TICK_US;
+    
+    // With nothing to wait for the PIT still fires at its maximum period
+    // (~55 ms) so the clock keeps counting.
+    pit_program_us(next > now ? next - now : 0);
+}
+
+static void wake_sleeper(timer_entry_t *entry, void *ctx) {
+    (void)ctx;
+    process_t *proc = (process_t*)((u8*)entry - offsetof(process_t, sleep_timer));
+    if (proc->state == PROC_STATE_BLOCKED) make_ready(proc);
+}
+
 void timer_install(void) {
-    u32 divisor = 1193180 / 100; // 100 Hz
-    outb(0x43, 0x36);
-    outb(0x40, divisor & 0xFF);
-    outb(0x40, (divisor >> 8) & 0xFF);
+    timer_wheel_init(&sleep_wheel, 0);
+    pit_elapsed = 0;
+    pit_programmed = 0;
+    pit_irq_stale = false;
+    last_sched_tick_us = 0;
+    pit_program_us(SCHED_TICK_US);
     
-    printf("[TMR] Initialized at 100 Hz\n");
+    printf("[TMR] Tickless one-shot PIT, %d us wheel resolution\n", TW_RES_US);
 }
 
 void timer_handler(interrupt_frame_t *frame) {
-    system_ticks++;
-    system_time_ms = system_ticks * 10;
+    if (pit_irq_stale) {
+        // Raised by a shot that pit_program_us() replaced and already
+        // counted; the live shot keeps running and is read from the counter.
+        pit_irq_stale = false;
+    } else {
+        pit_elapsed += pit_programmed;      // this shot ran to terminal count
+        pit_programmed = 0;
+    }
+    
+    u64 now = clock_now_us();
+    system_time_ms = now / 1000;
+    system_ticks = now / SCHED_TICK_US;
     kernel_stats.interrupts_handled++;
     
-    if (current_process) {
+    timer_wheel_advance(&sleep_wheel, now, wake_sleeper, NULL);
+    
+    bool resched = false;
+    while (now - last_sched_tick_us >= SCHED_TICK_US) {
+        last_sched_tick_us += SCHED_TICK_US;
+        if (!current_process) continue;
         current_process->cpu_time++;
-        if (--current_process->quantum == 0) {
-            // Time slice expired
-            schedule();
-        }
+        sched_entity_t *se = current_process == idle_process ? NULL : &current_process->sched;
+        if (sched_tick(&run_queue, se)) resched = true;
     }
     
+    // A woken sleeper or an expired slice: pick again.
+    if (resched || (current_process == idle_process && run_queue.nr_queued))
+        schedule();
+    
+    timer_reprogram(now);
     outb(PIC1_COMMAND, 0x20);
 }
 
+// Block the caller for `us` microseconds. Processes sleep on sleep_wheel;
+// the idle/boot context halts until its own deadline, which the PIT is
+// programmed to hit exactly.
+void sleep_us(u64 us) {
+    u32 flags = irq_save();
+    u64 deadline = clock_now_us() + us;
+    
+    if (current_process && current_process != idle_process) {
+        current_process->sleep_until = deadline;
+        current_process->state = PROC_STATE_BLOCKED;
+        timer_wheel_add(&sleep_wheel, &current_process->sleep_timer, deadline);
+        schedule();
+        timer_reprogram(clock_now_us());
+        irq_restore(flags);
+        return;
+    }
+    
+    kernel_wakeup_us = deadline;
+    timer_reprogram(clock_now_us());
+    while (clock_now_us() < deadline) {
+        __asm__ volatile("sti; hlt; cli" : : : "memory");
+    }
+    kernel_wakeup_us = TW_NEVER;
+    irq_restore(flags);
+}
+
+void sleep_ms(u32 ms) {
+    sleep_us((u64)ms * 1000);
+}
+
+// ========== Deferred Work ==========
+// Bottom halves: IRQ handlers acknowledge the device, stash what they read
+// and queue a work item; the main loop runs it later with interrupts on.
+static deferred_queue_t bottom_halves;
+
+extern u64 read_tsc(void);
+
+// Safe from any context; drivers reach it through extern "C".
+bool defer_work(deferred_work_t *work) {
+    u32 flags = irq_save();
+    bool queued = deferred_schedule(&bottom_halves, work);
+    irq_restore(flags);
+    return queued;
+}
+
+static void print_irq_latency(void) {
+    printf("\n[IRQ] Worst-case interrupts-off time per line (TSC cycles):\n");
+    for (u32 i = 0; i < 16; i++) {
+        if (kernel_stats.irq_max_cycles[i])
+            printf("[IRQ]   IRQ%d: %u\n", i, kernel_stats.irq_max_cycles[i]);
+    }
+    printf("[IRQ] Bottom halves: %u run, %u coalesced, max queue depth %u\n",
+           (u32)bottom_halves.executed, (u32)bottom_halves.coalesced,
+           bottom_halves.max_depth);
+}
+
 // ========== Keyboard ==========
 static const char scancode_to_ascii[] = {
     0, 0, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
@@ -674,18 +910,38 @@ static const char scancode_to_ascii[] = {
     0, ' '
 };
 
-void keyboard_handler(interrupt_frame_t *frame) {
-    u8 scancode = inb(0x60);
-    
-    if (scancode < 128 && scancode < sizeof(scancode_to_ascii)) {
-        char c = scancode_to_ascii[scancode];
-        if (c) {
-            keyboard_buffer[kb_write_pos] = c;
-            kb_write_pos = (kb_write_pos + 1) % 256;
-            putchar(c);
+#define SCANCODE_F12 0x58
+
+// Translation and echo run here, outside the interrupt.
+static void keyboard_bottom_half(deferred_work_t *work) {
+    static u32 dropped_seen = 0;
+    (void)work;
+    
+    u8 scancode;
+    while (kb_ring_pop(&keyboard_ring, &scancode)) {
+        if (scancode == SCANCODE_F12) {
+            print_irq_latency();
+            continue;
+        }
+        if (scancode < 128 && scancode < sizeof(scancode_to_ascii)) {
+            char c = scancode_to_ascii[scancode];
+            if (c) putchar(c);
         }
     }
     
+    u32 dropped = SPSC_LOAD_RELAXED(&keyboard_ring.overflows);
+    if (dropped != dropped_seen) {
+        printf("\n[KBD] Input buffer full, %d keys dropped\n", dropped - dropped_seen);
+        dropped_seen = dropped;
+    }
+}
+
+static deferred_work_t keyboard_bh = { keyboard_bottom_half, NULL, 0, 0 };
+
+void keyboard_handler(interrupt_frame_t *frame) {
+    kb_ring_push(&keyboard_ring, inb(0x60));
+    defer_work(&keyboard_bh);
+    
     kernel_stats.interrupts_handled++;
     outb(PIC1_COMMAND, 0x20);
 }
@@ -698,7 +954,10 @@ void init_tasking(void) {
     memset(idle_process, 0, sizeof(process_t));
     idle_process->pid = 0;
     idle_process->state = PROC_STATE_RUNNING;
+    idle_process->kernel_stack = (void*)alloc_pages(KERNEL_STACK_ORDER);
     strcpy(idle_process->name, "idle");
+    sched_entity_init(&idle_process->sched, 0);
+    sched_rq_init(&run_queue);
     
     current_process = idle_process;
     process_list[0] = idle_process;
@@ -706,28 +965,31 @@ void init_tasking(void) {
     printf("[TASK] Created idle process (PID 0)\n");
 }
 
+// Put a process on the run queue. The idle process is never queued; it runs
+// only when every level is empty.
+void make_ready(process_t *proc) {
+    proc->state = PROC_STATE_READY;
+    if (proc != idle_process) sched_enqueue(&run_queue, &proc->sched);
+}
+
 void schedule(void) {
     if (!current_process) return;
     
     kernel_stats.context_switches++;
     
-    // Simple round-robin scheduler
-    process_t *next = current_process->next;
-    if (!next) next = process_list[0];
+    // Multi-level feedback queue: the preempted process goes to the back of
+    // its (possibly demoted) level, then the highest non-empty level runs.
+    process_t *prev = current_process;
+    if (prev->state == PROC_STATE_RUNNING) make_ready(prev);
     
-    while (next && next->state != PROC_STATE_READY && next->state != PROC_STATE_RUNNING) {
-        next = next->next;
-        if (!next) next = process_list[0];
-        if (next == current_process) break;
-    }
+    sched_entity_t *se = sched_pick_next(&run_queue);
+    process_t *next = se ? sched_process(se) : idle_process;
     
-    if (next && next != current_process) {
-        process_t *prev = current_process;
-        if (prev->state == PROC_STATE_RUNNING) prev->state = PROC_STATE_READY;
-        
+    next->state = PROC_STATE_RUNNING;
+    next->priority = next->sched.level;
+    
+    if (next != prev) {
         current_process = next;
-        current_process->state = PROC_STATE_RUNNING;
-        current_process->quantum = QUANTUM_MS;
         
         // TODO: Switch page directory
         // switch_context(&prev->regs, &next->regs);
@@ -758,6 +1020,10 @@ u32 syscall_handler(u32 syscall_num, u32 arg1, u32 arg2, u32 arg3, u32 arg4) {
             }
             return -1;
             
+        case SYSCALL_SLEEP:
+            sleep_ms(arg1);
+            return 0;
+            
         case SYSCALL_YIELD:
             schedule();
             return 0;
@@ -816,15 +1082,25 @@ void isr_handler(interrupt_frame_t *frame) {
 }
 
 void irq_handler(interrupt_frame_t *frame) {
+    u64 start = read_tsc();
+    
     if (frame->int_no == 32) {
         timer_handler(frame);
     } else if (frame->int_no == 33) {
         keyboard_handler(frame);
     } else {
         kernel_stats.interrupts_handled++;
+        if (driver_manager_handle_irq)
+            driver_manager_handle_irq(frame->int_no - 32);
         outb(PIC1_COMMAND, 0x20);
         if (frame->int_no >= 40) outb(PIC2_COMMAND, 0x20);
     }
+    
+    // Interrupts stay off for the whole handler; track the worst case.
+    u32 line = frame->int_no - 32;
+    u32 cycles = (u32)(read_tsc() - start);
+    if (line < 16 && cycles > kernel_stats.irq_max_cycles[line])
+        kernel_stats.irq_max_cycles[line] = cycles;
 }
 
 // ========== Main Kernel Entry ==========
@@ -843,6 +1119,8 @@ void kernel_main(void) {
     
     init_memory();
     init_paging();
+    init_page_buddy();
+    deferred_queue_init(&bottom_halves);
     
     print("[*] Installing IDT...\n");
     idt_install();
@@ -861,18 +1139,21 @@ void kernel_main(void) {
     
     set_color(VGA_YELLOW, VGA_BLACK);
     print("\n=== System Ready ===\n");
-    print("Press any key to interact...\n\n");
+    print("Press any key to interact (F12: interrupt latency)...\n\n");
     
     set_color(VGA_WHITE, VGA_BLACK);
     
-    // Main kernel loop
+    // Main kernel loop: run bottom halves, then halt until the next IRQ.
+    // The emptiness check is done with interrupts off and "sti; hlt" is
+    // atomic, so work queued in between is never slept on.
     while (1) {
-        __asm__ volatile("hlt");
+        deferred_run(&bottom_halves, 0);
         
-        if (kb_read_pos != kb_write_pos) {
-            char c = keyboard_buffer[kb_read_pos];
-            kb_read_pos = (kb_read_pos + 1) % 256;
-        }
+        __asm__ volatile("cli");
+        if (deferred_has_work(&bottom_halves))
+            __asm__ volatile("sti" : : : "memory");
+        else
+            __asm__ volatile("sti; hlt" : : : "memory");
     }
 }
 
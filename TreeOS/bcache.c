@@ -0,0 +1,187 @@
+// bcache.c - MiniOS block buffer cache
+// Kernel:  gcc -m32 -c bcache.c -o bcache.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c bcache.c -o bcache.o -O2 -Wall -Wextra
+//
+// A fixed set of block buffers indexed by a chained hash on LBA. Every hit
+// sets the buffer's REF bit; the CLOCK hand clears REF bits as it sweeps
+// and evicts the first unpinned buffer it finds with REF already clear, so
+// recently used blocks get a second chance without any LRU list upkeep.
+// Dirty blocks stay in memory until evicted or bcache_sync() runs.
+
+#include "bcache.h"
+
+static inline uint32_t hash_lba(uint32_t lba) {
+    return (lba * 2654435761u) >> (32 - BCACHE_HASH_SHIFT);   // Fibonacci hashing
+}
+
+static void copy_block(uint8_t *dst, const uint8_t *src) {
+    for (uint32_t i = 0; i < BCACHE_BLOCK_SIZE; i++) dst[i] = src[i];
+}
+
+static uint32_t hash_find(bcache_t *c, uint32_t lba) {
+    uint32_t i = c->hash[hash_lba(lba)];
+    while (i != BCACHE_NIL && c->bufs[i].lba != lba)
+        i = c->bufs[i].hash_next;
+    return i;
+}
+
+static void hash_insert(bcache_t *c, uint32_t idx) {
+    uint16_t *head = &c->hash[hash_lba(c->bufs[idx].lba)];
+    c->bufs[idx].hash_next = *head;
+    *head = (uint16_t)idx;
+}
+
+static void hash_remove(bcache_t *c, uint32_t idx) {
+    uint16_t *link = &c->hash[hash_lba(c->bufs[idx].lba)];
+    while (*link != idx) link = &c->bufs[*link].hash_next;
+    *link = c->bufs[idx].hash_next;
+}
+
+static bool write_back(bcache_t *c, bcache_buf_t *b) {
+    if (!c->dev->write(c->dev->ctx, b->lba, 1, b->data)) {
+        c->stats.io_errors++;
+        return false;
+    }
+    b->flags &= ~BCACHE_DIRTY;
+    c->dirty--;
+    c->stats.writebacks++;
+    return true;
+}
+
+// Two sweeps suffice: the first clears every REF bit it passes.
+static uint32_t clock_victim(bcache_t *c) {
+    for (uint32_t n = 0; n < 2 * c->nbufs; n++) {
+        uint32_t idx = c->hand;
+        bcache_buf_t *b = &c->bufs[idx];
+        c->hand = (c->hand + 1) % c->nbufs;
+        
+        if (b->pins) continue;
+        if (b->flags & BCACHE_REF) {
+            b->flags &= ~BCACHE_REF;
+            continue;
+        }
+        return idx;
+    }
+    return BCACHE_NIL;
+}
+
+// Find or claim the buffer for `lba`; `fill` reads the block on a miss.
+static bcache_buf_t *lookup(bcache_t *c, uint32_t lba, bool fill) {
+    if (lba >= c->dev->blocks) return NULL;
+    
+    uint32_t idx = hash_find(c, lba);
+    if (idx != BCACHE_NIL) {
+        bcache_buf_t *b = &c->bufs[idx];
+        b->flags |= BCACHE_REF;
+        b->pins++;
+        c->stats.hits++;
+        return b;
+    }
+    
+    c->stats.misses++;
+    idx = clock_victim(c);
+    if (idx == BCACHE_NIL) return NULL;
+    
+    bcache_buf_t *b = &c->bufs[idx];
+    if (b->flags & BCACHE_VALID) {
+        if ((b->flags & BCACHE_DIRTY) && !write_back(c, b)) return NULL;
+        hash_remove(c, idx);
+        b->flags = 0;
+        c->stats.evictions++;
+    }
+    
+    if (fill && !c->dev->read(c->dev->ctx, lba, 1, b->data)) {
+        c->stats.io_errors++;
+        return NULL;
+    }
+    
+    b->lba = lba;
+    b->flags = BCACHE_VALID | BCACHE_REF;
+    b->pins = 1;
+    hash_insert(c, idx);
+    return b;
+}
+
+// ========== Public API ==========
+void bcache_init(bcache_t *c, const block_device_t *dev, uint8_t *storage, uint32_t nbufs) {
+    if (nbufs > BCACHE_MAX_BUFFERS) nbufs = BCACHE_MAX_BUFFERS;
+    c->dev = dev;
+    c->nbufs = nbufs;
+    c->hand = 0;
+    c->dirty = 0;
+    for (uint32_t i = 0; i < BCACHE_HASH_BUCKETS; i++) c->hash[i] = BCACHE_NIL;
+    for (uint32_t i = 0; i < nbufs; i++) {
+        c->bufs[i].data = storage + (size_t)i * BCACHE_BLOCK_SIZE;
+        c->bufs[i].lba = 0;
+        c->bufs[i].hash_next = BCACHE_NIL;
+        c->bufs[i].pins = 0;
+        c->bufs[i].flags = 0;
+    }
+    c->stats = (bcache_stats_t){0};
+}
+
+bcache_buf_t *bcache_get(bcache_t *c, uint32_t lba) {
+    return lookup(c, lba, true);
+}
+
+void bcache_release(bcache_t *c, bcache_buf_t *buf) {
+    (void)c;
+    if (buf->pins) buf->pins--;
+}
+
+void bcache_mark_dirty(bcache_t *c, bcache_buf_t *buf) {
+    if (!(buf->flags & BCACHE_DIRTY)) {
+        buf->flags |= BCACHE_DIRTY;
+        c->dirty++;
+    }
+}
+
+bool bcache_read(bcache_t *c, uint32_t lba, void *dst) {
+    bcache_buf_t *b = lookup(c, lba, true);
+    if (!b) return false;
+    copy_block((uint8_t*)dst, b->data);
+    bcache_release(c, b);
+    return true;
+}
+
+bool bcache_write(bcache_t *c, uint32_t lba, const void *src) {
+    bcache_buf_t *b = lookup(c, lba, false);
+    if (!b) return false;
+    copy_block(b->data, (const uint8_t*)src);
+    bcache_mark_dirty(c, b);
+    bcache_release(c, b);
+    return true;
+}
+
+bool bcache_sync(bcache_t *c) {
+    bool ok = true;
+    
+    // Repeatedly take the lowest dirty LBA above the last one written:
+    // O(nbufs) per block, without needing scratch space for a sort.
+    uint32_t prev = 0;
+    bool first = true;
+    while (c->dirty) {
+        uint32_t best = BCACHE_NIL;
+        for (uint32_t i = 0; i < c->nbufs; i++) {
+            bcache_buf_t *b = &c->bufs[i];
+            if (!(b->flags & BCACHE_DIRTY)) continue;
+            if (!first && b->lba <= prev) continue;
+            if (best == BCACHE_NIL || b->lba < c->bufs[best].lba) best = i;
+        }
+        if (best == BCACHE_NIL) break;      // only failed writes remain
+        
+        prev = c->bufs[best].lba;
+        first = false;
+        if (!write_back(c, &c->bufs[best])) ok = false;
+    }
+    
+    if (c->dev->flush && !c->dev->flush(c->dev->ctx)) {
+        c->stats.io_errors++;
+        ok = false;
+    }
+    return ok && c->dirty == 0;
+}
+
+const bcache_stats_t *bcache_get_stats(const bcache_t *c) {
+    return &c->stats;
+}
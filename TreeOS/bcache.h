@@ -0,0 +1,91 @@
+// bcache.h - MiniOS block buffer cache
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+// The cache sits above any block_device_t: the ATA driver on the kernel,
+// a file-backed device in a hosted build.
+
+#ifndef BCACHE_H
+#define BCACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define BCACHE_BLOCK_SIZE 512
+#define BCACHE_MAX_BUFFERS 256
+#define BCACHE_HASH_SHIFT 9
+#define BCACHE_HASH_BUCKETS (1u << BCACHE_HASH_SHIFT)
+#define BCACHE_NIL 0xFFFFu
+
+// ========== Block Device ==========
+// Synchronous transfers of whole blocks. `flush` may be NULL for devices
+// without a volatile write cache.
+typedef struct {
+    bool (*read)(void *ctx, uint32_t lba, uint32_t count, uint8_t *buf);
+    bool (*write)(void *ctx, uint32_t lba, uint32_t count, const uint8_t *buf);
+    bool (*flush)(void *ctx);
+    void *ctx;
+    uint32_t blocks;                                // device size
+} block_device_t;
+
+// ========== Cache ==========
+typedef struct {
+    uint8_t *data;                                  // BCACHE_BLOCK_SIZE bytes
+    uint32_t lba;
+    uint16_t hash_next;
+    uint16_t pins;
+    uint8_t flags;                                  // BCACHE_VALID | DIRTY | REF
+} bcache_buf_t;
+
+#define BCACHE_VALID 0x01u
+#define BCACHE_DIRTY 0x02u
+#define BCACHE_REF   0x04u                          // CLOCK second-chance bit
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t writebacks;                            // dirty blocks written
+    uint64_t io_errors;
+} bcache_stats_t;
+
+typedef struct {
+    const block_device_t *dev;
+    uint32_t nbufs;
+    uint32_t hand;                                  // CLOCK hand
+    uint32_t dirty;
+    uint16_t hash[BCACHE_HASH_BUCKETS];
+    bcache_buf_t bufs[BCACHE_MAX_BUFFERS];
+    bcache_stats_t stats;
+} bcache_t;
+
+// ========== API ==========
+// `storage` provides nbufs * BCACHE_BLOCK_SIZE bytes of block memory;
+// nbufs is clamped to BCACHE_MAX_BUFFERS.
+void bcache_init(bcache_t *c, const block_device_t *dev, uint8_t *storage, uint32_t nbufs);
+
+// Pinned buffer holding block `lba`, read from the device on a miss.
+// NULL on I/O error, out-of-range LBA, or when every buffer is pinned.
+bcache_buf_t *bcache_get(bcache_t *c, uint32_t lba);
+void bcache_release(bcache_t *c, bcache_buf_t *buf);
+void bcache_mark_dirty(bcache_t *c, bcache_buf_t *buf);
+
+// Copying helpers. A full-block write never reads the old contents.
+bool bcache_read(bcache_t *c, uint32_t lba, void *dst);
+bool bcache_write(bcache_t *c, uint32_t lba, const void *src);
+
+// Write every dirty block back in ascending LBA order, then flush the
+// device. Returns false if any write or the flush failed.
+bool bcache_sync(bcache_t *c);
+
+const bcache_stats_t *bcache_get_stats(const bcache_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BCACHE_H
@@ -0,0 +1,114 @@
+// buddy.c - MiniOS buddy allocator for physically contiguous pages
+// Kernel:  gcc -m32 -c buddy.c -o buddy.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c buddy.c -o buddy.o -O2 -Wall -Wextra
+//
+// The pool is one contiguous, max-order-aligned run taken from the frame
+// allocator. Blocks of order k are tracked on doubly linked free lists whose
+// links live in per-frame metadata (not in the frames themselves), so the
+// pool works before paging maps anything and in a hosted build. Splitting on
+// alloc and merging with the buddy on free are both O(BUDDY_MAX_ORDER).
+
+#include "buddy.h"
+
+// state[] of a block's first frame; every other frame reads 0.
+#define BUDDY_FREE 0x80u
+#define BUDDY_USED 0x40u
+
+static void list_push(buddy_allocator_t *b, uint32_t idx, uint32_t order) {
+    uint16_t head = b->free_head[order];
+    b->next[idx] = head;
+    b->prev[idx] = BUDDY_NIL;
+    if (head != BUDDY_NIL) b->prev[head] = (uint16_t)idx;
+    b->free_head[order] = (uint16_t)idx;
+    b->state[idx] = (uint8_t)(BUDDY_FREE | order);
+    b->free_blocks[order]++;
+    b->nonempty |= 1u << order;
+}
+
+static void list_remove(buddy_allocator_t *b, uint32_t idx, uint32_t order) {
+    uint16_t next = b->next[idx];
+    uint16_t prev = b->prev[idx];
+    if (prev != BUDDY_NIL) b->next[prev] = next;
+    else b->free_head[order] = next;
+    if (next != BUDDY_NIL) b->prev[next] = prev;
+    b->state[idx] = 0;
+    b->free_blocks[order]--;
+    if (b->free_head[order] == BUDDY_NIL) b->nonempty &= ~(1u << order);
+}
+
+// ========== Public API ==========
+bool buddy_init(buddy_allocator_t *b, page_frame_allocator_t *fa, uint32_t frames) {
+    const uint32_t block = 1u << BUDDY_MAX_ORDER;
+
+    if (frames > BUDDY_MAX_FRAMES) frames = BUDDY_MAX_FRAMES;
+    frames &= ~(block - 1);
+
+    b->frames = 0;
+    b->nonempty = 0;
+    b->free_frames = 0;
+    for (uint32_t o = 0; o < BUDDY_ORDERS; o++) {
+        b->free_head[o] = BUDDY_NIL;
+        b->free_blocks[o] = 0;
+    }
+    if (frames == 0) return false;
+
+    uint32_t base = frame_alloc_range(fa, frames, block);
+    if (base == FRAME_NONE) return false;
+
+    b->base_frame = base;
+    b->frames = frames;
+    for (uint32_t i = 0; i < frames; i++) b->state[i] = 0;
+    for (uint32_t i = frames; i > 0; i -= block) list_push(b, i - block, BUDDY_MAX_ORDER);
+    b->free_frames = frames;
+    return true;
+}
+
+uint32_t buddy_alloc(buddy_allocator_t *b, uint32_t order) {
+    if (order > BUDDY_MAX_ORDER) return FRAME_NONE;
+
+    uint32_t avail = b->nonempty >> order;
+    if (!avail) return FRAME_NONE;
+
+    uint32_t o = order + __builtin_ctz(avail);
+    uint32_t idx = b->free_head[o];
+    list_remove(b, idx, o);
+
+    // Split down, returning the upper halves to their free lists.
+    while (o > order) {
+        o--;
+        list_push(b, idx + (1u << o), o);
+    }
+
+    b->state[idx] = (uint8_t)(BUDDY_USED | order);
+    b->free_frames -= 1u << order;
+    return b->base_frame + idx;
+}
+
+bool buddy_free(buddy_allocator_t *b, uint32_t frame, uint32_t order) {
+    if (order > BUDDY_MAX_ORDER || frame < b->base_frame) return false;
+
+    uint32_t idx = frame - b->base_frame;
+    if (idx >= b->frames || (idx & ((1u << order) - 1))) return false;
+    if (b->state[idx] != (BUDDY_USED | order)) return false;  // double free / wrong order
+
+    b->state[idx] = 0;
+    b->free_frames += 1u << order;
+
+    // Merge with the buddy while it is a free block of the same order.
+    while (order < BUDDY_MAX_ORDER) {
+        uint32_t buddy = idx ^ (1u << order);
+        if (b->state[buddy] != (BUDDY_FREE | order)) break;
+        list_remove(b, buddy, order);
+        if (buddy < idx) idx = buddy;
+        order++;
+    }
+
+    list_push(b, idx, order);
+    return true;
+}
+
+uint32_t buddy_order_for(size_t bytes, size_t page_size) {
+    uint32_t order = 0;
+    while (order < BUDDY_MAX_ORDER && ((size_t)page_size << order) < bytes) order++;
+    return order;
+}
@@ -0,0 +1,56 @@
+// buddy.h - MiniOS buddy allocator for physically contiguous pages
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+
+#ifndef BUDDY_H
+#define BUDDY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "frame_alloc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define BUDDY_MAX_ORDER 10                          // 2^10 frames = 4 MiB
+#define BUDDY_ORDERS (BUDDY_MAX_ORDER + 1)
+#define BUDDY_MAX_FRAMES 8192                       // largest pool (32 MiB)
+#define BUDDY_NIL 0xFFFFu
+
+typedef struct {
+    uint32_t base_frame;                 // first frame owned by the pool
+    uint32_t frames;                     // multiple of 2^BUDDY_MAX_ORDER
+    uint32_t nonempty;                   // bit k set = free_head[k] non-empty
+    uint16_t free_head[BUDDY_ORDERS];
+    uint32_t free_blocks[BUDDY_ORDERS];  // per-order free counts
+    uint32_t free_frames;
+    // Per-frame metadata, valid only for the first frame of a block.
+    uint16_t next[BUDDY_MAX_FRAMES];
+    uint16_t prev[BUDDY_MAX_FRAMES];
+    uint8_t state[BUDDY_MAX_FRAMES];     // free/used flag | order
+} buddy_allocator_t;
+
+// ========== API ==========
+// Carve `frames` contiguous frames (rounded down to whole max-order blocks)
+// out of `fa` and hand them to the buddy pool. Returns false if the frame
+// allocator cannot supply a suitably aligned range.
+bool buddy_init(buddy_allocator_t *b, page_frame_allocator_t *fa, uint32_t frames);
+
+// First frame of a free 2^order block, or FRAME_NONE.
+uint32_t buddy_alloc(buddy_allocator_t *b, uint32_t order);
+
+// Release a block previously returned by buddy_alloc with the same order.
+// Returns false for frames outside the pool, misaligned blocks or double frees.
+bool buddy_free(buddy_allocator_t *b, uint32_t frame, uint32_t order);
+
+// Smallest order whose block holds `bytes` (given a `page_size` frame size).
+uint32_t buddy_order_for(size_t bytes, size_t page_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUDDY_H
@@ -0,0 +1,58 @@
+// deferred.c - MiniOS deferred interrupt work (bottom halves)
+// Kernel:  gcc -m32 -c deferred.c -o deferred.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c deferred.c -o deferred.o -O2 -Wall -Wextra
+
+#include "deferred.h"
+
+void deferred_work_init(deferred_work_t *work, deferred_fn fn, void *ctx) {
+    work->fn = fn;
+    work->ctx = ctx;
+    work->pending = 0;
+    work->runs = 0;
+}
+
+void deferred_queue_init(deferred_queue_t *q) {
+    q->ring.head = 0;
+    q->ring.tail = 0;
+    q->ring.overflows = 0;
+    q->scheduled = 0;
+    q->coalesced = 0;
+    q->executed = 0;
+    q->max_depth = 0;
+}
+
+bool deferred_schedule(deferred_queue_t *q, deferred_work_t *work) {
+    q->scheduled++;
+    if (SPSC_LOAD_ACQUIRE(&work->pending)) {
+        q->coalesced++;
+        return false;
+    }
+    
+    // Each item takes at most one slot, so the push only fails with more
+    // than DEFERRED_QUEUE_SIZE live items. The ring counts that in
+    // ring.overflows and the item is left schedulable.
+    SPSC_STORE_RELAXED(&work->pending, 1);
+    if (!deferred_ring_push(&q->ring, work)) {
+        SPSC_STORE_RELAXED(&work->pending, 0);
+        return false;
+    }
+    
+    uint32_t depth = deferred_ring_count(&q->ring);
+    if (depth > q->max_depth) q->max_depth = depth;
+    return true;
+}
+
+uint32_t deferred_run(deferred_queue_t *q, uint32_t budget) {
+    uint32_t ran = 0;
+    deferred_work_t *work;
+    
+    while ((budget == 0 || ran < budget) && deferred_ring_pop(&q->ring, &work)) {
+        SPSC_STORE_RELEASE(&work->pending, 0);
+        work->runs++;
+        work->fn(work);
+        ran++;
+    }
+    
+    SPSC_STORE_RELAXED(&q->executed, q->executed + ran);
+    return ran;
+}
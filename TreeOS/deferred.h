@@ -0,0 +1,68 @@
+// deferred.h - MiniOS deferred interrupt work (bottom halves)
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+//
+// An interrupt handler (top half) acknowledges the device, stashes whatever
+// it read, and calls deferred_schedule() on a work item. The kernel drains
+// the queue with deferred_run() outside interrupt context, interrupts on.
+// A work item is queued at most once: scheduling it again before it runs is
+// coalesced, so the queue never holds more entries than there are items.
+
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "spsc_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define DEFERRED_QUEUE_SIZE 64          // distinct work items in flight
+
+typedef struct deferred_work deferred_work_t;
+typedef void (*deferred_fn)(deferred_work_t *work);
+
+struct deferred_work {
+    deferred_fn fn;
+    void *ctx;                          // owner, for the callback's use
+    uint8_t pending;                    // queued and not yet started
+    uint32_t runs;
+};
+
+SPSC_RING_DEFINE(deferred_ring, deferred_work_t *, DEFERRED_QUEUE_SIZE)
+
+typedef struct {
+    deferred_ring_t ring;
+    uint64_t scheduled;
+    uint64_t coalesced;                 // already pending when scheduled
+    uint64_t executed;
+    uint32_t max_depth;
+} deferred_queue_t;
+
+// ========== API ==========
+void deferred_work_init(deferred_work_t *work, deferred_fn fn, void *ctx);
+void deferred_queue_init(deferred_queue_t *q);
+
+// Producer side. Callers must not race each other: on the kernel this means
+// interrupts off (true inside any handler). Returns true if the item was
+// newly queued, false if it was already pending or the queue was full.
+bool deferred_schedule(deferred_queue_t *q, deferred_work_t *work);
+
+// Consumer side. Runs up to `budget` items (0 = until empty) and returns how
+// many ran. Each item's pending flag is cleared before its callback, so work
+// arriving while the callback runs schedules it again.
+uint32_t deferred_run(deferred_queue_t *q, uint32_t budget);
+
+static inline bool deferred_has_work(deferred_queue_t *q) {
+    return deferred_ring_count(&q->ring) != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEFERRED_H
@@ -4,23 +4,57 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "spsc_ring.h"
+#include "deferred.h"
+#include "driver_manager.h"
+
+// ========== Kernel Services ==========
+extern "C" void sleep_ms(uint32_t ms);
+extern "C" uint64_t clock_now_us(void);
+extern "C" uint64_t read_tsc(void);
+extern "C" bool defer_work(deferred_work_t* work);
+
 // ========== Base Classes ==========
 class Driver {
+    friend class DriverManager;
+    
 protected:
     const char* name;
     bool initialized;
     uint32_t id;
     uint32_t irq;
     
+private:
+    Driver* nextOnIRQ;          // chain of drivers sharing this IRQ line
+    deferred_work_t bottomHalf;
+    
+    static void runBottomHalf(deferred_work_t* work) {
+        static_cast<Driver*>(work->ctx)->handleDeferred();
+    }
+    
+protected:
+    // Called from handleInterrupt(): runs handleDeferred() later, outside
+    // interrupt context. Repeated calls before it runs are coalesced.
+    void scheduleDeferred() {
+        defer_work(&bottomHalf);
+    }
+    
 public:
     Driver(const char* n, uint32_t driver_id, uint32_t interrupt = 0) 
-        : name(n), initialized(false), id(driver_id), irq(interrupt) {}
+        : name(n), initialized(false), id(driver_id), irq(interrupt),
+          nextOnIRQ(nullptr) {
+        deferred_work_init(&bottomHalf, runBottomHalf, this);
+    }
     
     virtual ~Driver() {}
     
     virtual bool init() = 0;
     virtual void shutdown() = 0;
+    
+    // Top half: interrupts are off. Acknowledge the device, save what was
+    // read and scheduleDeferred() for anything slower.
     virtual void handleInterrupt() {}
+    virtual void handleDeferred() {}
     
     const char* getName() const { return name; }
     bool isInitialized() const { return initialized; }
@@ -29,6 +63,10 @@ public:
 };
 
 // ========== Port I/O ==========
+// A hosted test (tests/test_ata_queue.cpp) defines DRIVER_MANAGER_HOSTED and
+// supplies its own PortIO and IrqGuard backed by a simulated device before
+// including this file.
+#ifndef DRIVER_MANAGER_HOSTED
 class PortIO {
 public:
     static inline void outb(uint16_t port, uint8_t val) {
@@ -66,13 +104,27 @@ public:
     }
 };
 
+// Disables interrupts for its lifetime and restores the previous IF state.
+class IrqGuard {
+    uint32_t flags;
+    
+public:
+    IrqGuard() {
+        asm volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    }
+    
+    ~IrqGuard() {
+        asm volatile("push %0; popf" : : "r"(flags) : "memory", "cc");
+    }
+};
+#endif // DRIVER_MANAGER_HOSTED
+
 // ========== Keyboard Driver ==========
 class KeyboardDriver : public Driver {
 private:
-    static const int BUFFER_SIZE = 256;
-    uint8_t buffer[BUFFER_SIZE];
-    volatile int readPos;
-    volatile int writePos;
+    static const uint32_t BUFFER_SIZE = 256;
+    SpscRing<uint8_t, 64> scancodes;            // IRQ produces, bottom half consumes
+    SpscRing<uint8_t, BUFFER_SIZE> buffer;      // bottom half produces, getKey consumes
     bool shiftPressed;
     bool ctrlPressed;
     bool altPressed;
@@ -83,7 +135,6 @@ private:
     
 public:
     KeyboardDriver() : Driver("PS/2 Keyboard", 1, 1), 
-                       readPos(0), writePos(0),
                        shiftPressed(false), ctrlPressed(false),
                        altPressed(false), capsLock(false) {}
     
@@ -110,8 +161,17 @@ public:
     }
     
     void handleInterrupt() override {
-        uint8_t scancode = PortIO::inb(0x60);
-        
+        scancodes.push(PortIO::inb(0x60));
+        scheduleDeferred();
+    }
+    
+    void handleDeferred() override {
+        uint8_t scancode;
+        while (scancodes.pop(scancode))
+            processScancode(scancode);
+    }
+    
+    void processScancode(uint8_t scancode) {
         // Handle special keys
         if (scancode == 0x2A || scancode == 0x36) {
             shiftPressed = true;
@@ -152,23 +212,29 @@ public:
             }
             
             if (c != 0) {
-                buffer[writePos] = c;
-                writePos = (writePos + 1) % BUFFER_SIZE;
+                buffer.push((uint8_t)c);
             }
         }
     }
     
     bool hasKey() const {
-        return readPos != writePos;
+        return !buffer.empty();
     }
     
     char getKey() {
-        if (readPos == writePos)
-            return 0;
-        
-        char c = buffer[readPos];
-        readPos = (readPos + 1) % BUFFER_SIZE;
-        return c;
+        uint8_t c = 0;
+        buffer.pop(c);
+        return (char)c;
+    }
+    
+    // Batch read; returns how many keys were copied into `dst`.
+    uint32_t getKeys(char* dst, uint32_t max) {
+        return buffer.pop_n((uint8_t*)dst, max);
+    }
+    
+    // Keys dropped because a buffer was full when they arrived.
+    uint32_t getDroppedKeys() const {
+        return scancodes.overflowCount() + buffer.overflowCount();
     }
     
     void setLEDs() {
@@ -204,13 +270,81 @@ const char KeyboardDriver::scancodeToAsciiShift[128] = {
 };
 
 // ========== ATA/IDE Disk Driver ==========
+// One queued block transfer. The submitter owns the storage and must keep it
+// alive until `done` is set; `ok` is valid from then on.
+struct BlockRequest {
+    enum Op : uint8_t { READ, WRITE, FLUSH };
+    
+    uint32_t lba;
+    uint32_t count;             // sectors; unused for FLUSH
+    uint8_t* buffer;
+    Op op;
+    volatile bool done;
+    bool ok;
+    
+    // Driver-private
+    uint32_t transferred;       // sectors moved so far
+    BlockRequest* next;
+    
+    BlockRequest(Op o, uint32_t l = 0, uint32_t n = 0, uint8_t* buf = nullptr)
+        : lba(l), count(n), buffer(buf), op(o), done(false), ok(false),
+          transferred(0), next(nullptr) {}
+};
+
 class ATADriver : public Driver {
 private:
     static const uint16_t ATA_PRIMARY_IO = 0x1F0;
     static const uint16_t ATA_PRIMARY_CONTROL = 0x3F6;
+    static const uint32_t SECTOR_SIZE = 512;
+    static const uint32_t MAX_SECTORS = 256;            // per command (count register 0)
+    static const uint32_t LOST_IRQ_SPINS = 1 << 16;
+    
+    static const uint8_t STATUS_ERR = 0x01;
+    static const uint8_t STATUS_DRQ = 0x08;
+    static const uint8_t STATUS_DF = 0x20;
+    static const uint8_t STATUS_BSY = 0x80;
+    
+    static const uint8_t CMD_READ_SECTORS = 0x20;
+    static const uint8_t CMD_WRITE_SECTORS = 0x30;
+    static const uint8_t CMD_READ_MULTIPLE = 0xC4;
+    static const uint8_t CMD_WRITE_MULTIPLE = 0xC5;
+    static const uint8_t CMD_SET_MULTIPLE = 0xC6;
+    static const uint8_t CMD_CACHE_FLUSH = 0xE7;
+    static const uint8_t CMD_IDENTIFY = 0xEC;
     
     uint32_t sectorCount;
     char model[41];
+    uint32_t blockSectors;      // sectors per DRQ block (SET MULTIPLE), 1 = plain PIO
+    
+    // Request queue: sorted by LBA between barriers. A FLUSH is a barrier for
+    // everything; a queued request is one for any later request whose sectors
+    // overlap it. The in-flight command covers queueHead..batchLast, which
+    // insertion never crosses.
+    BlockRequest* queueHead;
+    bool active;
+    BlockRequest* batchLast;
+    BlockRequest* cursor;       // request receiving/supplying the next sector
+    uint32_t batchRemaining;    // sectors left in the in-flight command
+    
+    // Set by the top half, consumed by service()
+    volatile bool irqPending;
+    volatile uint8_t irqStatus;
+    bool servicing;
+    
+public:
+    struct Stats {
+        uint32_t requests;
+        uint32_t merged;        // requests that rode along in another's command
+        uint32_t commands;
+        uint32_t sectors;
+        uint32_t flushes;
+        uint32_t interrupts;
+        uint32_t lostInterrupts;
+        uint32_t errors;
+    };
+    
+private:
+    Stats stats;
     
     void wait400ns() {
         for (int i = 0; i < 4; i++)
@@ -220,7 +354,7 @@ private:
     bool waitBusy() {
         for (int i = 0; i < 100000; i++) {
             uint8_t status = PortIO::inb(ATA_PRIMARY_IO + 7);
-            if ((status & 0x80) == 0)
+            if ((status & STATUS_BSY) == 0)
                 return true;
         }
         return false;
@@ -229,14 +363,215 @@ private:
     bool waitDRQ() {
         for (int i = 0; i < 100000; i++) {
             uint8_t status = PortIO::inb(ATA_PRIMARY_IO + 7);
-            if (status & 0x08)
+            if (status & STATUS_DRQ)
                 return true;
         }
         return false;
     }
     
+    // ---- Queue (caller holds an IrqGuard) ----
+    static bool overlaps(const BlockRequest* a, const BlockRequest* b) {
+        return a->lba < b->lba + b->count && b->lba < a->lba + a->count;
+    }
+    
+    void enqueue(BlockRequest* req) {
+        // Insert after the in-flight batch and after the last barrier, in
+        // LBA order, so contiguous requests end up adjacent and can merge.
+        // Overlapping requests stay in submission order, so a read never
+        // overtakes the write it depends on and writes land in order.
+        BlockRequest** link = active ? &batchLast->next : &queueHead;
+        for (BlockRequest** scan = link; *scan; scan = &(*scan)->next) {
+            if ((*scan)->op == BlockRequest::FLUSH ||
+                (req->op != BlockRequest::FLUSH && overlaps(*scan, req)))
+                link = &(*scan)->next;
+        }
+        if (req->op != BlockRequest::FLUSH) {
+            while (*link && (*link)->lba <= req->lba)
+                link = &(*link)->next;
+        } else {
+            while (*link)
+                link = &(*link)->next;
+        }
+        req->next = *link;
+        *link = req;
+    }
+    
+    void issue(uint32_t lba, uint32_t sectors, uint8_t cmd) {
+        PortIO::outb(ATA_PRIMARY_IO + 6, 0xE0 | ((lba >> 24) & 0x0F));
+        PortIO::outb(ATA_PRIMARY_IO + 2, sectors & 0xFF);     // 0 = 256
+        PortIO::outb(ATA_PRIMARY_IO + 3, lba & 0xFF);
+        PortIO::outb(ATA_PRIMARY_IO + 4, (lba >> 8) & 0xFF);
+        PortIO::outb(ATA_PRIMARY_IO + 5, (lba >> 16) & 0xFF);
+        PortIO::outb(ATA_PRIMARY_IO + 7, cmd);
+        stats.commands++;
+    }
+    
+    // Start the command for the head of the queue, absorbing following
+    // requests whose LBAs continue it. Caller holds an IrqGuard.
+    void startNext() {
+        BlockRequest* head = queueHead;
+        if (!head) {
+            active = false;
+            return;
+        }
+        
+        active = true;
+        cursor = head;
+        batchLast = head;
+        
+        if (head->op == BlockRequest::FLUSH) {
+            batchRemaining = 0;
+            if (!waitBusy()) {
+                finishBatch(false);
+                return;
+            }
+            issue(0, 0, CMD_CACHE_FLUSH);
+            stats.flushes++;
+            return;
+        }
+        
+        uint32_t lba = head->lba + head->transferred;
+        uint32_t sectors = head->count - head->transferred;
+        if (sectors > MAX_SECTORS)
+            sectors = MAX_SECTORS;
+        
+        for (BlockRequest* r = head->next; r && sectors < MAX_SECTORS; r = r->next) {
+            if (r->op != head->op || r->lba != lba + sectors)
+                break;
+            uint32_t take = r->count;
+            if (sectors + take > MAX_SECTORS)
+                take = MAX_SECTORS - sectors;
+            sectors += take;
+            batchLast = r;
+            stats.merged++;
+        }
+        batchRemaining = sectors;
+        
+        if (!waitBusy()) {
+            finishBatch(false);
+            return;
+        }
+        
+        bool write = head->op == BlockRequest::WRITE;
+        if (blockSectors > 1)
+            issue(lba, sectors, write ? CMD_WRITE_MULTIPLE : CMD_READ_MULTIPLE);
+        else
+            issue(lba, sectors, write ? CMD_WRITE_SECTORS : CMD_READ_SECTORS);
+        
+        // PIO-out protocol: the first block goes without an interrupt.
+        if (write) {
+            wait400ns();
+            if (!waitBusy() || !waitDRQ()) {
+                finishBatch(false);
+                return;
+            }
+            transferBlock(true);
+        }
+    }
+    
+    // Move one DRQ block between the data port and the batch's buffers.
+    void transferBlock(bool write) {
+        uint32_t n = batchRemaining < blockSectors ? batchRemaining : blockSectors;
+        for (uint32_t s = 0; s < n; s++) {
+            while (cursor->transferred == cursor->count)
+                cursor = cursor->next;
+            
+            uint16_t* buf16 = (uint16_t*)(cursor->buffer + cursor->transferred * SECTOR_SIZE);
+            if (write) {
+                for (int i = 0; i < 256; i++)
+                    PortIO::outw(ATA_PRIMARY_IO, buf16[i]);
+            } else {
+                for (int i = 0; i < 256; i++)
+                    buf16[i] = PortIO::inw(ATA_PRIMARY_IO);
+            }
+            cursor->transferred++;
+        }
+        batchRemaining -= n;
+        stats.sectors += n;
+    }
+    
+    // Retire the batch: fully transferred requests (or all of them on error)
+    // leave the queue and are marked done, then the next command starts.
+    void finishBatch(bool ok) {
+        IrqGuard guard;
+        BlockRequest* stop = batchLast->next;
+        while (queueHead != stop) {
+            BlockRequest* r = queueHead;
+            if (ok && r->op != BlockRequest::FLUSH && r->transferred < r->count)
+                break;                          // head of an oversize request
+            queueHead = r->next;
+            r->next = nullptr;
+            r->ok = ok;
+            r->done = true;
+        }
+        if (!ok)
+            stats.errors++;
+        startNext();
+    }
+    
+    // Advance the in-flight command after an interrupt. Runs as the bottom
+    // half and from wait(); `servicing` keeps the two from overlapping.
+    void service() {
+        uint8_t status;
+        {
+            IrqGuard guard;
+            if (servicing || !irqPending)
+                return;
+            servicing = true;
+            irqPending = false;
+            status = irqStatus;
+        }
+        
+        if (active) {
+            // Act on the alternate status (no side effects) so a stale event
+            // can never move a block twice; if the drive is still busy the
+            // real interrupt is on its way.
+            uint8_t now = PortIO::inb(ATA_PRIMARY_CONTROL);
+            bool write = cursor->op == BlockRequest::WRITE;
+            if ((status | now) & (STATUS_ERR | STATUS_DF)) {
+                finishBatch(false);
+            } else if (now & STATUS_BSY) {
+                // wait for the next interrupt
+            } else if (cursor->op == BlockRequest::FLUSH || batchRemaining == 0) {
+                finishBatch(true);              // flush or final write block done
+            } else if (now & STATUS_DRQ) {
+                transferBlock(write);
+                if (!write && batchRemaining == 0)
+                    finishBatch(true);          // reads get no trailing interrupt
+            }
+        }
+        
+        servicing = false;
+    }
+    
+    bool wait(BlockRequest* req) {
+        uint32_t spins = 0;
+        while (!req->done) {
+            service();
+            if (++spins < LOST_IRQ_SPINS) {
+                asm volatile("pause");
+                continue;
+            }
+            
+            // No interrupt for a long time: if the drive is idle or wants
+            // data, take its status as if IRQ 14 had fired.
+            spins = 0;
+            IrqGuard guard;
+            uint8_t alt = PortIO::inb(ATA_PRIMARY_CONTROL);
+            if (active && !irqPending && !(alt & STATUS_BSY)) {
+                irqStatus = PortIO::inb(ATA_PRIMARY_IO + 7);
+                irqPending = true;
+                stats.lostInterrupts++;
+            }
+        }
+        return req->ok;
+    }
+    
 public:
-    ATADriver() : Driver("ATA/IDE Disk", 2, 14), sectorCount(0) {
+    ATADriver() : Driver("ATA/IDE Disk", 2, 14), sectorCount(0), blockSectors(1),
+                  queueHead(nullptr), active(false), batchLast(nullptr),
+                  cursor(nullptr), batchRemaining(0), irqPending(false),
+                  irqStatus(0), servicing(false), stats() {
         for (int i = 0; i < 41; i++)
             model[i] = 0;
     }
@@ -250,7 +585,7 @@ public:
         PortIO::outb(ATA_PRIMARY_CONTROL, 0x02);
         
         // Send IDENTIFY command
-        PortIO::outb(ATA_PRIMARY_IO + 7, 0xEC);
+        PortIO::outb(ATA_PRIMARY_IO + 7, CMD_IDENTIFY);
         wait400ns();
         
         // Check if drive exists
@@ -279,97 +614,115 @@ public:
         // Get sector count
         sectorCount = (identify[61] << 16) | identify[60];
         
+        // Largest READ/WRITE MULTIPLE block the drive supports (word 47)
+        uint32_t maxMultiple = identify[47] & 0xFF;
+        blockSectors = 1;
+        if (maxMultiple > 1) {
+            PortIO::outb(ATA_PRIMARY_IO + 2, maxMultiple);
+            PortIO::outb(ATA_PRIMARY_IO + 7, CMD_SET_MULTIPLE);
+            wait400ns();
+            if (waitBusy() && !(PortIO::inb(ATA_PRIMARY_IO + 7) & STATUS_ERR))
+                blockSectors = maxMultiple;
+        }
+        
+        // Transfers complete through IRQ 14 from here on
+        PortIO::outb(ATA_PRIMARY_CONTROL, 0x00);
+        
         initialized = true;
         return true;
     }
     
     void shutdown() override {
+        PortIO::outb(ATA_PRIMARY_CONTROL, 0x02);
         initialized = false;
     }
     
-    bool readSector(uint32_t lba, uint8_t* buffer) {
-        if (!initialized || lba >= sectorCount)
+    // Top half: reading the status register acknowledges INTRQ.
+    void handleInterrupt() override {
+        irqStatus = PortIO::inb(ATA_PRIMARY_IO + 7);
+        irqPending = true;
+        stats.interrupts++;
+        scheduleDeferred();
+    }
+    
+    void handleDeferred() override {
+        service();
+    }
+    
+    // Asynchronous entry point: queue `req` and return. Poll req->done, or
+    // call wait() through read()/write()/flush() for blocking I/O.
+    bool submit(BlockRequest* req) {
+        if (!initialized)
             return false;
-        
-        // Wait for drive to be ready
-        if (!waitBusy())
+        if (req->op != BlockRequest::FLUSH &&
+            (req->count == 0 || req->lba >= sectorCount || req->count > sectorCount - req->lba))
             return false;
         
-        // Select drive and send LBA
-        PortIO::outb(ATA_PRIMARY_IO + 6, 0xE0 | ((lba >> 24) & 0x0F));
-        PortIO::outb(ATA_PRIMARY_IO + 2, 1);  // Sector count
-        PortIO::outb(ATA_PRIMARY_IO + 3, lba & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 4, (lba >> 8) & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 5, (lba >> 16) & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 7, 0x20);  // READ SECTORS
-        
-        if (!waitBusy() || !waitDRQ())
-            return false;
-        
-        // Read 512 bytes (256 words)
-        uint16_t* buf16 = (uint16_t*)buffer;
-        for (int i = 0; i < 256; i++) {
-            buf16[i] = PortIO::inw(ATA_PRIMARY_IO);
-        }
+        req->done = false;
+        req->ok = false;
+        req->transferred = 0;
         
+        IrqGuard guard;
+        enqueue(req);
+        stats.requests++;
+        if (!active)
+            startNext();
         return true;
     }
     
+    bool read(uint32_t lba, uint32_t count, uint8_t* buffer) {
+        BlockRequest req(BlockRequest::READ, lba, count, buffer);
+        return submit(&req) && wait(&req);
+    }
+    
+    // Completes when the data is in the drive's write cache; call flush()
+    // for durability.
+    bool write(uint32_t lba, uint32_t count, const uint8_t* buffer) {
+        BlockRequest req(BlockRequest::WRITE, lba, count, const_cast<uint8_t*>(buffer));
+        return submit(&req) && wait(&req);
+    }
+    
+    // Barrier: requests queued before it reach the medium before it
+    // completes, and nothing queued after it is merged or sorted ahead.
+    bool flush() {
+        BlockRequest req(BlockRequest::FLUSH);
+        return submit(&req) && wait(&req);
+    }
+    
+    bool readSector(uint32_t lba, uint8_t* buffer) {
+        return read(lba, 1, buffer);
+    }
+    
     bool writeSector(uint32_t lba, const uint8_t* buffer) {
-        if (!initialized || lba >= sectorCount)
-            return false;
-        
-        if (!waitBusy())
-            return false;
-        
-        PortIO::outb(ATA_PRIMARY_IO + 6, 0xE0 | ((lba >> 24) & 0x0F));
-        PortIO::outb(ATA_PRIMARY_IO + 2, 1);
-        PortIO::outb(ATA_PRIMARY_IO + 3, lba & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 4, (lba >> 8) & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 5, (lba >> 16) & 0xFF);
-        PortIO::outb(ATA_PRIMARY_IO + 7, 0x30);  // WRITE SECTORS
-        
-        if (!waitBusy() || !waitDRQ())
-            return false;
-        
-        const uint16_t* buf16 = (const uint16_t*)buffer;
-        for (int i = 0; i < 256; i++) {
-            PortIO::outw(ATA_PRIMARY_IO, buf16[i]);
-        }
-        
-        // Flush cache
-        PortIO::outb(ATA_PRIMARY_IO + 7, 0xE7);
-        waitBusy();
-        
-        return true;
+        return write(lba, 1, buffer);
     }
     
     uint32_t getSectorCount() const { return sectorCount; }
     const char* getModel() const { return model; }
+    uint32_t getBlockSectors() const { return blockSectors; }
+    const Stats& getStats() const { return stats; }
 };
 
 // ========== Timer Driver ==========
+// The kernel runs the PIT in one-shot mode and owns its programming, so this
+// driver never touches the hardware: ticks are derived from clock_now_us() at
+// a virtual frequency instead of counting interrupts (which the tickless
+// kernel raises only when something is due).
 class TimerDriver : public Driver {
 private:
-    volatile uint32_t ticks;
     uint32_t frequency;
+    uint64_t startUs;
     
 public:
-    TimerDriver() : Driver("PIT Timer", 3, 0), ticks(0), frequency(100) {}
+    TimerDriver() : Driver("PIT Timer", 3, 0), frequency(100), startUs(0) {}
     
     bool init() override {
         return init(frequency);
     }
     
     bool init(uint32_t freq) {
-        frequency = freq;
-        uint32_t divisor = 1193180 / frequency;
-        
-        PortIO::outb(0x43, 0x36);
-        PortIO::outb(0x40, divisor & 0xFF);
-        PortIO::outb(0x40, (divisor >> 8) & 0xFF);
-        
-        ticks = 0;
+        frequency = freq ? freq : 100;
+        startUs = clock_now_us();
         initialized = true;
         return true;
     }
@@ -378,18 +731,15 @@ public:
         initialized = false;
     }
     
-    void handleInterrupt() override {
-        ticks++;
+    uint32_t getTicks() const {
+        return (uint32_t)((clock_now_us() - startUs) * frequency / 1000000);
     }
-    
-    uint32_t getTicks() const { return ticks; }
     uint32_t getFrequency() const { return frequency; }
     
+    // Delegates to the kernel's tickless sleep: the caller blocks on the
+    // sleep timing wheel instead of halting on every periodic tick.
     void sleep(uint32_t ms) {
-        uint32_t target = ticks + (ms * frequency / 1000);
-        while (ticks < target) {
-            asm volatile("hlt");
-        }
+        sleep_ms(ms);
     }
 };
 
@@ -470,11 +820,55 @@ private:
     Driver* drivers[MAX_DRIVERS];
     int driverCount;
     
+    // Dispatch table indexed by IRQ line. Each slot heads a chain of the
+    // drivers on that line, so the interrupt path never searches drivers[].
+    struct IrqSlot {
+        Driver* head;
+        uint32_t handlers;
+        uint64_t calls;
+        uint64_t cycles;
+        uint64_t maxCycles;
+    };
+    IrqSlot irqTable[DRIVER_MAX_IRQS];
+    
     static DriverManager* instance;
     
     DriverManager() : driverCount(0) {
         for (int i = 0; i < MAX_DRIVERS; i++)
             drivers[i] = nullptr;
+        for (int i = 0; i < DRIVER_MAX_IRQS; i++)
+            irqTable[i] = IrqSlot{nullptr, 0, 0, 0, 0};
+    }
+    
+    // Appends so that drivers sharing a line run in registration order.
+    void attachIRQ(Driver* driver) {
+        uint32_t irq = driver->getIRQ();
+        if (irq >= DRIVER_MAX_IRQS)
+            return;
+        
+        driver->nextOnIRQ = nullptr;
+        IrqGuard guard;
+        Driver** link = &irqTable[irq].head;
+        while (*link)
+            link = &(*link)->nextOnIRQ;
+        *link = driver;
+        irqTable[irq].handlers++;
+    }
+    
+    void detachIRQ(Driver* driver) {
+        uint32_t irq = driver->getIRQ();
+        if (irq >= DRIVER_MAX_IRQS)
+            return;
+        
+        IrqGuard guard;
+        for (Driver** link = &irqTable[irq].head; *link; link = &(*link)->nextOnIRQ) {
+            if (*link == driver) {
+                *link = driver->nextOnIRQ;
+                driver->nextOnIRQ = nullptr;
+                irqTable[irq].handlers--;
+                break;
+            }
+        }
     }
     
 public:
@@ -490,6 +884,7 @@ public:
         
         if (driver->init()) {
             drivers[driverCount++] = driver;
+            attachIRQ(driver);
             return true;
         }
         
@@ -499,6 +894,7 @@ public:
     void unregisterDriver(uint32_t id) {
         for (int i = 0; i < driverCount; i++) {
             if (drivers[i] && drivers[i]->getId() == id) {
+                detachIRQ(drivers[i]);
                 drivers[i]->shutdown();
                 
                 // Shift remaining drivers
@@ -520,20 +916,59 @@ public:
         return nullptr;
     }
     
+    // First driver on the line; use the chain for shared IRQs.
     Driver* getDriverByIRQ(uint32_t irq) {
-        for (int i = 0; i < driverCount; i++) {
-            if (drivers[i] && drivers[i]->getIRQ() == irq)
-                return drivers[i];
+        return irq < DRIVER_MAX_IRQS ? irqTable[irq].head : nullptr;
+    }
+    
+    // Interrupt hot path: one table index, then the (usually one-long) chain.
+    void dispatchIRQ(uint32_t irq) {
+        if (irq >= DRIVER_MAX_IRQS)
+            return;
+        
+        IrqSlot& slot = irqTable[irq];
+        uint64_t start = read_tsc();
+        for (Driver* d = slot.head; d; d = d->nextOnIRQ)
+            d->handleInterrupt();
+        uint64_t elapsed = read_tsc() - start;
+        
+        slot.calls++;
+        slot.cycles += elapsed;
+        if (elapsed > slot.maxCycles)
+            slot.maxCycles = elapsed;
+    }
+    
+    bool getIRQStats(uint32_t irq, driver_irq_stats_t* out) const {
+        if (irq >= DRIVER_MAX_IRQS || !out)
+            return false;
+        
+        IrqGuard guard;
+        const IrqSlot& slot = irqTable[irq];
+        out->handlers = slot.handlers;
+        out->calls = slot.calls;
+        out->cycles = slot.cycles;
+        out->max_cycles = slot.maxCycles;
+        return true;
+    }
+    
+    void resetIRQStats() {
+        IrqGuard guard;
+        for (int i = 0; i < DRIVER_MAX_IRQS; i++) {
+            irqTable[i].calls = 0;
+            irqTable[i].cycles = 0;
+            irqTable[i].maxCycles = 0;
         }
-        return nullptr;
     }
     
     int getDriverCount() const { return driverCount; }
     
     void shutdownAll() {
         for (int i = 0; i < driverCount; i++) {
-            if (drivers[i])
+            if (drivers[i]) {
+                detachIRQ(drivers[i]);
                 drivers[i]->shutdown();
+                drivers[i] = nullptr;
+            }
         }
         driverCount = 0;
     }
@@ -576,34 +1011,87 @@ extern "C" {
     }
     
     void driver_manager_handle_irq(uint32_t irq) {
-        Driver* driver = DriverManager::getInstance()->getDriverByIRQ(irq);
-        if (driver)
-            driver->handleInterrupt();
+        DriverManager::getInstance()->dispatchIRQ(irq);
+    }
+    
+    bool driver_manager_irq_stats(uint32_t irq, driver_irq_stats_t* out) {
+        return DriverManager::getInstance()->getIRQStats(irq, out);
+    }
+    
+    void driver_manager_reset_irq_stats(void) {
+        DriverManager::getInstance()->resetIRQStats();
+    }
+    
+    static bool disk_read(void* ctx, uint32_t lba, uint32_t count, uint8_t* buf) {
+        return static_cast<ATADriver*>(ctx)->read(lba, count, buf);
+    }
+    
+    static bool disk_write(void* ctx, uint32_t lba, uint32_t count, const uint8_t* buf) {
+        return static_cast<ATADriver*>(ctx)->write(lba, count, buf);
+    }
+    
+    static bool disk_flush(void* ctx) {
+        return static_cast<ATADriver*>(ctx)->flush();
+    }
+    
+    bool driver_manager_disk_device(void* disk, block_device_t* out) {
+        ATADriver* ata = static_cast<ATADriver*>(disk);
+        if (!ata || !ata->isInitialized())
+            return false;
+        
+        out->read = disk_read;
+        out->write = disk_write;
+        out->flush = disk_flush;
+        out->ctx = ata;
+        out->blocks = ata->getSectorCount();
+        return true;
     }
 }
 
 // ========== Operator Overloads ==========
+// Hosted builds keep the C++ runtime's allocator.
+#ifndef DRIVER_MANAGER_HOSTED
 void* operator new(size_t size, void* ptr) {
     return ptr;
 }
 
-void* operator new(size_t size) {
-    // Simple bump allocator
-    static uint8_t heap[131072];
+// Freestanding: no <new>, so declare the tag type the compiler uses for
+// over-aligned allocations (SpscRing keeps head/tail on separate 64-byte
+// cache lines, so any class holding one is allocated through these).
+namespace std {
+    enum class align_val_t : size_t {};
+}
+
+// Simple bump allocator: drivers are created once at boot and never freed.
+static void* bump_alloc(size_t size, size_t align) {
+    static uint8_t heap[131072] __attribute__((aligned(64)));
     static size_t heap_pos = 0;
     
+    if (align < 16) align = 16;
+    size_t pos = (heap_pos + align - 1) & ~(align - 1);
     size = (size + 15) & ~15;
     
-    if (heap_pos + size > sizeof(heap))
+    if (align > 64 || pos + size > sizeof(heap))
         return nullptr;
     
-    void* ptr = &heap[heap_pos];
-    heap_pos += size;
-    return ptr;
+    heap_pos = pos + size;
+    return &heap[pos];
+}
+
+void* operator new(size_t size) {
+    return bump_alloc(size, 16);
 }
 
 void* operator new[](size_t size) {
-    return operator new(size);
+    return bump_alloc(size, 16);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    return bump_alloc(size, (size_t)align);
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    return bump_alloc(size, (size_t)align);
 }
 
 void operator delete(void* ptr) noexcept {
@@ -616,4 +1104,25 @@ void operator delete(void* ptr, size_t size) noexcept {
 
 void operator delete[](void* ptr) noexcept {
     // No-op for now
-}
\ No newline at end of file
+}
+
+void operator delete[](void* ptr, size_t size) noexcept {
+    // No-op for now
+}
+
+void operator delete(void* ptr, std::align_val_t align) noexcept {
+    // No-op for now
+}
+
+void operator delete(void* ptr, size_t size, std::align_val_t align) noexcept {
+    // No-op for now
+}
+
+void operator delete[](void* ptr, std::align_val_t align) noexcept {
+    // No-op for now
+}
+
+void operator delete[](void* ptr, size_t size, std::align_val_t align) noexcept {
+    // No-op for now
+}
+#endif // DRIVER_MANAGER_HOSTED
@@ -0,0 +1,47 @@
+// driver_manager.h - C interface to the MiniOS driver system
+// The drivers themselves are C++ (driver_manager.cpp); the kernel only sees
+// opaque handles and these extern "C" entry points.
+
+#ifndef DRIVER_MANAGER_H
+#define DRIVER_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bcache.h"
+
+#define DRIVER_MAX_IRQS 16              // legacy PIC lines
+
+// Per-IRQ dispatch counters. Cycles are TSC ticks spent in the handler chain.
+typedef struct {
+    uint32_t handlers;                  // drivers chained on this line
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t max_cycles;
+} driver_irq_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* driver_manager_get_instance(void);
+void* driver_manager_create_keyboard(void);
+void* driver_manager_create_disk(void);
+void* driver_manager_create_timer(void);
+void* driver_manager_create_rtc(void);
+
+// Runs every driver registered on `irq`; EOI stays with the caller.
+void driver_manager_handle_irq(uint32_t irq);
+
+bool driver_manager_irq_stats(uint32_t irq, driver_irq_stats_t* out);
+void driver_manager_reset_irq_stats(void);
+
+// Describe a disk from driver_manager_create_disk() as a block device, e.g.
+// to put a bcache_t on top of it. False if the disk did not initialize.
+bool driver_manager_disk_device(void* disk, block_device_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DRIVER_MANAGER_H
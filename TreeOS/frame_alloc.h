@@ -0,0 +1,57 @@
+// frame_alloc.h - MiniOS hierarchical bitmap physical frame allocator
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+
+#ifndef FRAME_ALLOC_H
+#define FRAME_ALLOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+// Four levels of 32-way fan-out cover 2^20 frames (4 GiB of 4 KiB pages).
+#define FRAME_MAX_FRAMES (1u << 20)
+#define FRAME_L1_WORDS (FRAME_MAX_FRAMES / 32 / 32)
+#define FRAME_L2_WORDS (FRAME_L1_WORDS / 32)
+#define FRAME_NONE 0xFFFFFFFFu
+
+// Level 0 is one bit per frame (set = used) and is supplied by the caller.
+// Each summary bit above it is set while the 32 entries below it still
+// contain a free frame, so a free frame is found with one ctz per level.
+typedef struct {
+    uint32_t *bitmap;
+    uint32_t total_frames;
+    uint32_t used_frames;
+    uint32_t free_frames;
+    uint32_t summary1[FRAME_L1_WORDS];
+    uint32_t summary2[FRAME_L2_WORDS];
+    uint32_t summary3;
+} page_frame_allocator_t;
+
+// ========== API ==========
+// `bitmap` must hold (total_frames + 31) / 32 words. All frames start free.
+void frame_alloc_init(page_frame_allocator_t *fa, uint32_t *bitmap, uint32_t total_frames);
+
+// Lowest free frame index, marked used; FRAME_NONE if memory is exhausted.
+uint32_t frame_alloc_one(page_frame_allocator_t *fa);
+
+// `count` contiguous frames whose first index is a multiple of `align`
+// (a power of two, in frames; anything else fails). Returns the first index
+// or FRAME_NONE.
+uint32_t frame_alloc_range(page_frame_allocator_t *fa, uint32_t count, uint32_t align);
+
+// Returns the number of frames whose state actually changed.
+uint32_t frame_free_range(page_frame_allocator_t *fa, uint32_t first, uint32_t count);
+uint32_t frame_reserve_range(page_frame_allocator_t *fa, uint32_t first, uint32_t count);
+
+bool frame_is_used(const page_frame_allocator_t *fa, uint32_t frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_ALLOC_H
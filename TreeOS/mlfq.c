@@ -0,0 +1,168 @@
+// mlfq.c - MiniOS O(1) multi-level feedback queue run queue
+// Kernel:  gcc -m32 -c mlfq.c -o mlfq.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c mlfq.c -o mlfq.o -O2 -Wall -Wextra
+//
+// One FIFO per priority level plus a bitmap of non-empty levels: picking the
+// next entity is a single ctz. An entity that burns SCHED_LEVEL_ALLOTMENT
+// quanta at a level is demoted one level (CPU-bound work sinks and gets
+// longer slices); every SCHED_BOOST_TICKS everything returns to its base
+// level. An entity that sat in the queue for a whole boost period without
+// running (its base is below that of busy, lower-nice entities) is lifted to
+// the highest occupied level instead, so nothing starves.
+
+#include "mlfq.h"
+
+static inline void level_push(sched_runqueue_t *rq, sched_entity_t *se) {
+    uint32_t l = se->level;
+    se->next = NULL;
+    se->prev = rq->tail[l];
+    if (rq->tail[l]) rq->tail[l]->next = se;
+    else rq->head[l] = se;
+    rq->tail[l] = se;
+    rq->bitmap |= 1u << l;
+}
+
+static inline void level_remove(sched_runqueue_t *rq, sched_entity_t *se) {
+    uint32_t l = se->level;
+    if (se->prev) se->prev->next = se->next;
+    else rq->head[l] = se->next;
+    if (se->next) se->next->prev = se->prev;
+    else rq->tail[l] = se->prev;
+    se->next = NULL;
+    se->prev = NULL;
+    if (!rq->head[l]) rq->bitmap &= ~(1u << l);
+}
+
+// Return every queued entity (and the running one) to its base level, then
+// lift the ones that waited through the whole last period to the top.
+static void boost_all(sched_runqueue_t *rq, sched_entity_t *cur) {
+    uint32_t pending = rq->bitmap;
+    while (pending) {
+        uint32_t l = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        sched_entity_t *se = rq->head[l];
+        while (se) {
+            sched_entity_t *next = se->next;
+            se->level_ticks = 0;
+            if (se->level != se->base_level) {
+                level_remove(rq, se);
+                se->level = se->base_level;
+                level_push(rq, se);
+            }
+            se = next;
+        }
+    }
+
+    if (cur) {
+        cur->level = cur->base_level;
+        cur->level_ticks = 0;
+    }
+
+    uint32_t top = rq->bitmap ? (uint32_t)__builtin_ctz(rq->bitmap) : SCHED_LEVELS - 1;
+    if (cur && cur->level < top) top = cur->level;
+
+    pending = rq->bitmap;
+    while (pending) {
+        uint32_t l = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        sched_entity_t *se = rq->head[l];
+        while (se) {
+            sched_entity_t *next = se->next;
+            if (se->boost_waiting && l > top) {
+                level_remove(rq, se);
+                se->level = (uint8_t)top;
+                level_push(rq, se);
+                rq->starved++;
+            }
+            se->boost_waiting = true;
+            se = next;
+        }
+    }
+    rq->boosts++;
+}
+
+// ========== Public API ==========
+void sched_rq_init(sched_runqueue_t *rq) {
+    for (uint32_t l = 0; l < SCHED_LEVELS; l++) {
+        rq->head[l] = NULL;
+        rq->tail[l] = NULL;
+    }
+    rq->bitmap = 0;
+    rq->nr_queued = 0;
+    rq->ticks_since_boost = 0;
+    rq->boosts = 0;
+    rq->demotions = 0;
+    rq->starved = 0;
+}
+
+void sched_entity_init(sched_entity_t *se, int32_t nice) {
+    int32_t base = SCHED_DEFAULT_LEVEL + nice / 4;
+    if (base < 0) base = 0;
+    if (base > SCHED_LEVELS - 1) base = SCHED_LEVELS - 1;
+
+    se->next = NULL;
+    se->prev = NULL;
+    se->base_level = (uint8_t)base;
+    se->level = (uint8_t)base;
+    se->queued = false;
+    se->boost_waiting = false;
+    se->slice_left = sched_quantum((uint32_t)base);
+    se->level_ticks = 0;
+}
+
+uint32_t sched_quantum(uint32_t level) {
+    // 1 tick at the top, growing to 8 ticks at the bottom.
+    return 1 + level / 4;
+}
+
+void sched_enqueue(sched_runqueue_t *rq, sched_entity_t *se) {
+    if (se->queued) return;
+    level_push(rq, se);
+    se->queued = true;
+    se->boost_waiting = false;
+    rq->nr_queued++;
+}
+
+void sched_dequeue(sched_runqueue_t *rq, sched_entity_t *se) {
+    if (!se->queued) return;
+    level_remove(rq, se);
+    se->queued = false;
+    rq->nr_queued--;
+}
+
+sched_entity_t *sched_pick_next(sched_runqueue_t *rq) {
+    if (!rq->bitmap) return NULL;
+
+    sched_entity_t *se = rq->head[__builtin_ctz(rq->bitmap)];
+    sched_dequeue(rq, se);
+    se->slice_left = sched_quantum(se->level);
+    return se;
+}
+
+bool sched_tick(sched_runqueue_t *rq, sched_entity_t *cur) {
+    if (++rq->ticks_since_boost >= SCHED_BOOST_TICKS) {
+        rq->ticks_since_boost = 0;
+        boost_all(rq, cur);
+    }
+
+    if (!cur) return rq->bitmap != 0;
+
+    cur->level_ticks++;
+    cur->boost_waiting = false;
+    if (cur->slice_left) cur->slice_left--;
+
+    if (cur->level_ticks >= SCHED_LEVEL_ALLOTMENT * sched_quantum(cur->level) &&
+        cur->level < SCHED_LEVELS - 1) {
+        cur->level++;
+        cur->level_ticks = 0;
+        rq->demotions++;
+    }
+
+    if (cur->slice_left == 0) return true;
+
+    // Anything waiting at a strictly higher priority preempts right away.
+    uint32_t higher = cur->level ? rq->bitmap & ((1u << cur->level) - 1) : 0;
+    return higher != 0;
+}
@@ -0,0 +1,70 @@
+// mlfq.h - MiniOS O(1) multi-level feedback queue run queue
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+// The kernel embeds a sched_entity_t in every process_t, so this code never
+// needs to know what a process looks like.
+
+#ifndef MLFQ_H
+#define MLFQ_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define SCHED_LEVELS 32                 // 0 = highest priority
+#define SCHED_DEFAULT_LEVEL 8           // base level for nice 0
+#define SCHED_BOOST_TICKS 100           // move everyone back to base every 1 s
+#define SCHED_LEVEL_ALLOTMENT 4         // quanta at one level before demotion
+
+typedef struct sched_entity {
+    struct sched_entity *next;
+    struct sched_entity *prev;
+    uint8_t level;              // current run-queue level
+    uint8_t base_level;         // level derived from nice, target of boosts
+    bool queued;
+    bool boost_waiting;         // queued at the last boost, not run since
+    uint32_t slice_left;        // ticks left in the current quantum
+    uint32_t level_ticks;       // CPU ticks consumed at the current level
+} sched_entity_t;
+
+typedef struct {
+    sched_entity_t *head[SCHED_LEVELS];
+    sched_entity_t *tail[SCHED_LEVELS];
+    uint32_t bitmap;            // bit k set = level k non-empty
+    uint32_t nr_queued;
+    uint32_t ticks_since_boost;
+    uint64_t boosts;
+    uint64_t demotions;
+    uint64_t starved;           // entities lifted by a boost after a whole period unrun
+} sched_runqueue_t;
+
+// ========== API ==========
+void sched_rq_init(sched_runqueue_t *rq);
+
+// `nice` follows the Unix range -20..19; lower nice = higher base level.
+void sched_entity_init(sched_entity_t *se, int32_t nice);
+
+// Quantum of a level in timer ticks; lower-priority levels run longer.
+uint32_t sched_quantum(uint32_t level);
+
+void sched_enqueue(sched_runqueue_t *rq, sched_entity_t *se);
+void sched_dequeue(sched_runqueue_t *rq, sched_entity_t *se);
+
+// Remove and return the head of the highest non-empty level, with a fresh
+// quantum; NULL if nothing is runnable. O(1).
+sched_entity_t *sched_pick_next(sched_runqueue_t *rq);
+
+// Charge one tick to the running entity `cur` (may be NULL when idle).
+// Handles demotion and the periodic boost. Returns true if `cur` should be
+// preempted: its slice ran out or a higher-priority entity is waiting.
+bool sched_tick(sched_runqueue_t *rq, sched_entity_t *cur);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MLFQ_H
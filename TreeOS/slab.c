@@ -0,0 +1,225 @@
+// slab.c - MiniOS size-class slab allocator
+// Kernel:  gcc -m32 -c slab.c -o slab.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c slab.c -o slab.o -O2 -Wall -Wextra
+//
+// Small requests (16..2048 B) are served from fixed-size slab pages, one size
+// class per page. Each class keeps a list of partially free pages and each
+// page keeps its own free list, so alloc and free never walk anything. The
+// page holding an object is found by masking the pointer, which is why the
+// arena is aligned to SLAB_PAGE_SIZE.
+
+#include "slab.h"
+
+typedef struct slab_obj {
+    struct slab_obj *next;
+} slab_obj_t;
+
+typedef struct slab_page {
+    uint32_t magic;
+    uint16_t cls;
+    uint16_t in_use;
+    uint16_t capacity;
+    uint16_t bumped;            // objects handed out at least once
+    uint32_t first_offset;      // offset of object 0 from the page start
+    slab_obj_t *free;           // recycled objects
+    struct slab_page *next;     // partial list (or page pool when released)
+    struct slab_page *prev;
+} slab_page_t;
+
+typedef struct {
+    slab_page_t *partial;
+    uint32_t object_size;
+    uint32_t pages;
+    uint32_t objects_in_use;
+    uint64_t allocs;
+    uint64_t frees;
+} slab_class_t;
+
+static slab_class_t classes[SLAB_CLASSES];
+
+static uintptr_t arena_start = 0;
+static uintptr_t arena_end = 0;
+static uintptr_t arena_bump = 0;
+static slab_page_t *page_pool = NULL;
+static uint32_t page_pool_count = 0;
+
+#define SLAB_ALIGN_UP(x, a) (((x) + ((a) - 1)) & ~((uintptr_t)(a) - 1))
+
+// ========== Page Pool ==========
+static slab_page_t *page_get(uint32_t cls) {
+    slab_page_t *page;
+
+    if (page_pool) {
+        page = page_pool;
+        page_pool = page->next;
+        page_pool_count--;
+    } else if (arena_bump + SLAB_PAGE_SIZE <= arena_end) {
+        page = (slab_page_t*)arena_bump;
+        arena_bump += SLAB_PAGE_SIZE;
+    } else {
+        return NULL;
+    }
+
+    uint32_t size = classes[cls].object_size;
+    uint32_t offset = (uint32_t)SLAB_ALIGN_UP(sizeof(slab_page_t), size);
+
+    page->magic = SLAB_MAGIC;
+    page->cls = (uint16_t)cls;
+    page->in_use = 0;
+    page->capacity = (uint16_t)((SLAB_PAGE_SIZE - offset) / size);
+    page->bumped = 0;
+    page->first_offset = offset;
+    page->free = NULL;
+    page->next = NULL;
+    page->prev = NULL;
+
+    classes[cls].pages++;
+    return page;
+}
+
+static void page_put(slab_page_t *page) {
+    classes[page->cls].pages--;
+    page->magic = 0;
+    page->next = page_pool;
+    page_pool = page;
+    page_pool_count++;
+}
+
+// ========== Partial List ==========
+static void partial_push(slab_class_t *c, slab_page_t *page) {
+    page->prev = NULL;
+    page->next = c->partial;
+    if (c->partial) c->partial->prev = page;
+    c->partial = page;
+}
+
+static void partial_remove(slab_class_t *c, slab_page_t *page) {
+    if (page->prev) page->prev->next = page->next;
+    else c->partial = page->next;
+    if (page->next) page->next->prev = page->prev;
+    page->next = NULL;
+    page->prev = NULL;
+}
+
+static inline bool page_full(const slab_page_t *page) {
+    return !page->free && page->bumped == page->capacity;
+}
+
+static inline uint32_t size_to_class(size_t size) {
+    if (size <= SLAB_MIN_SIZE) return 0;
+    uint32_t shift = 32 - __builtin_clz((uint32_t)size - 1);
+    return shift - SLAB_MIN_SHIFT;
+}
+
+// ========== Public API ==========
+void slab_init(void *base, size_t size) {
+    uintptr_t start = SLAB_ALIGN_UP((uintptr_t)base, SLAB_PAGE_SIZE);
+    uintptr_t end = ((uintptr_t)base + size) & ~((uintptr_t)SLAB_PAGE_SIZE - 1);
+    if (end < start) end = start;
+
+    arena_start = start;
+    arena_end = end;
+    arena_bump = start;
+    page_pool = NULL;
+    page_pool_count = 0;
+
+    for (uint32_t i = 0; i < SLAB_CLASSES; i++) {
+        classes[i].partial = NULL;
+        classes[i].object_size = SLAB_MIN_SIZE << i;
+        classes[i].pages = 0;
+        classes[i].objects_in_use = 0;
+        classes[i].allocs = 0;
+        classes[i].frees = 0;
+    }
+}
+
+void *slab_alloc(size_t size, size_t alignment) {
+    if (size == 0) return NULL;
+    if (alignment > size) size = alignment;
+    if (size > SLAB_MAX_SIZE) return NULL;
+
+    uint32_t cls = size_to_class(size);
+    slab_class_t *c = &classes[cls];
+
+    slab_page_t *page = c->partial;
+    if (!page) {
+        page = page_get(cls);
+        if (!page) return NULL;
+        partial_push(c, page);
+    }
+
+    slab_obj_t *obj;
+    if (page->free) {
+        obj = page->free;
+        page->free = obj->next;
+    } else {
+        obj = (slab_obj_t*)((uintptr_t)page + page->first_offset +
+                            (uintptr_t)page->bumped * c->object_size);
+        page->bumped++;
+    }
+
+    page->in_use++;
+    if (page_full(page)) partial_remove(c, page);
+
+    c->objects_in_use++;
+    c->allocs++;
+    return obj;
+}
+
+bool slab_free(void *ptr) {
+    if (!slab_owns(ptr)) return false;
+
+    slab_page_t *page = (slab_page_t*)((uintptr_t)ptr & ~((uintptr_t)SLAB_PAGE_SIZE - 1));
+    if (page->magic != SLAB_MAGIC || page->in_use == 0) return false;
+
+    slab_class_t *c = &classes[page->cls];
+    bool was_full = page_full(page);
+
+    slab_obj_t *obj = (slab_obj_t*)ptr;
+    obj->next = page->free;
+    page->free = obj;
+    page->in_use--;
+
+    c->objects_in_use--;
+    c->frees++;
+
+    if (was_full) {
+        partial_push(c, page);
+    } else if (page->in_use == 0 && (page->prev || page->next)) {
+        // Keep one empty page per class so alloc/free at a page boundary
+        // does not bounce pages through the pool.
+        partial_remove(c, page);
+        page_put(page);
+    }
+    return true;
+}
+
+bool slab_owns(const void *ptr) {
+    uintptr_t p = (uintptr_t)ptr;
+    return p >= arena_start && p < arena_bump;
+}
+
+size_t slab_usable_size(const void *ptr) {
+    if (!slab_owns(ptr)) return 0;
+    const slab_page_t *page =
+        (const slab_page_t*)((uintptr_t)ptr & ~((uintptr_t)SLAB_PAGE_SIZE - 1));
+    if (page->magic != SLAB_MAGIC) return 0;
+    return classes[page->cls].object_size;
+}
+
+void slab_get_stats(uint32_t cls, slab_class_stats_t *out) {
+    if (cls >= SLAB_CLASSES || !out) return;
+    const slab_class_t *c = &classes[cls];
+    out->object_size = c->object_size;
+    out->pages = c->pages;
+    out->objects_in_use = c->objects_in_use;
+    out->objects_free = 0;
+    for (const slab_page_t *p = c->partial; p; p = p->next)
+        out->objects_free += p->capacity - p->in_use;
+    out->allocs = c->allocs;
+    out->frees = c->frees;
+}
+
+uint32_t slab_free_pages(void) {
+    return page_pool_count + (uint32_t)((arena_end - arena_bump) / SLAB_PAGE_SIZE);
+}
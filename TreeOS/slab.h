@@ -0,0 +1,62 @@
+// slab.h - MiniOS size-class slab allocator
+// Freestanding: depends only on <stdint.h>/<stddef.h>/<stdbool.h>, so the same
+// source links into the kernel and into a hosted build (see `make hosted`).
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define SLAB_MIN_SHIFT 4                            // 16 B
+#define SLAB_MAX_SHIFT 11                           // 2048 B
+#define SLAB_MIN_SIZE (1u << SLAB_MIN_SHIFT)
+#define SLAB_MAX_SIZE (1u << SLAB_MAX_SHIFT)
+#define SLAB_CLASSES (SLAB_MAX_SHIFT - SLAB_MIN_SHIFT + 1)
+#define SLAB_PAGE_SIZE 16384                        // must be a power of two
+#define SLAB_MAGIC 0x51AB51ABu
+
+// ========== Statistics ==========
+typedef struct {
+    uint32_t object_size;
+    uint32_t pages;            // slab pages currently owned by this class
+    uint32_t objects_in_use;
+    uint32_t objects_free;     // free objects on this class's pages
+    uint64_t allocs;
+    uint64_t frees;
+} slab_class_stats_t;
+
+// ========== API ==========
+// Hand the allocator a region to carve slab pages from. `base` is rounded up
+// to SLAB_PAGE_SIZE; the usable tail is rounded down.
+void slab_init(void *base, size_t size);
+
+// O(1) allocation of `size` bytes aligned to `alignment` (power of two).
+// Returns NULL if the request is larger than SLAB_MAX_SIZE or the arena is
+// out of pages; the caller is expected to fall back to its large allocator.
+void *slab_alloc(size_t size, size_t alignment);
+
+// O(1) free. Returns false (and does nothing) if the page holding `ptr` has
+// no valid slab header, e.g. a corrupted or foreign pointer.
+bool slab_free(void *ptr);
+
+// True if `ptr` lies inside the slab arena.
+bool slab_owns(const void *ptr);
+
+// Usable size of a slab object (its size class), 0 if not owned.
+size_t slab_usable_size(const void *ptr);
+
+void slab_get_stats(uint32_t cls, slab_class_stats_t *out);
+uint32_t slab_free_pages(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SLAB_H
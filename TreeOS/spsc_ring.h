@@ -0,0 +1,135 @@
+// spsc_ring.h - MiniOS lock-free single-producer/single-consumer ring buffer
+// Header-only and freestanding (GCC __atomic builtins, no <atomic>), usable
+// from the C kernel and from the C++ drivers.
+//
+// Indices are free-running 32-bit counters masked by a power-of-two size, so
+// all N slots are usable and "full" is simply tail - head == N. The producer
+// publishes a slot with a release store of `tail` and the consumer frees it
+// with a release store of `head`; each side reads the other's index with an
+// acquire load. A push into a full ring is dropped and counted in
+// `overflows` instead of silently overwriting unread data.
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SPSC_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define SPSC_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SPSC_STORE_RELAXED(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+#ifdef __cplusplus
+#define SPSC_STATIC_ASSERT static_assert
+#else
+#define SPSC_STATIC_ASSERT _Static_assert
+#endif
+
+// ========== C Interface ==========
+// SPSC_RING_DEFINE(kb_ring, u8, 256) declares kb_ring_t and static inline
+// kb_ring_push/pop/push_n/pop_n/count helpers. T may be a pointer type.
+#define SPSC_RING_DEFINE(name, T, N)                                            \
+    SPSC_STATIC_ASSERT(((N) & ((N) - 1)) == 0 && (N) >= 2,                      \
+                       #name ": size must be a power of two");                  \
+    typedef struct {                                                            \
+        T slots[N];                                                             \
+        uint32_t head __attribute__((aligned(64)));  /* consumer */             \
+        uint32_t tail __attribute__((aligned(64)));  /* producer */             \
+        uint32_t overflows;                                                     \
+    } name##_t;                                                                 \
+                                                                                \
+    static inline uint32_t name##_count(name##_t *r) {                          \
+        return SPSC_LOAD_ACQUIRE(&r->tail) - SPSC_LOAD_ACQUIRE(&r->head);       \
+    }                                                                           \
+                                                                                \
+    static inline uint32_t name##_push_n(name##_t *r, T const *src, uint32_t n) { \
+        uint32_t tail = SPSC_LOAD_RELAXED(&r->tail);                            \
+        uint32_t room = (N) - (tail - SPSC_LOAD_ACQUIRE(&r->head));             \
+        uint32_t k = n < room ? n : room;                                       \
+        for (uint32_t i = 0; i < k; i++) r->slots[(tail + i) & ((N) - 1)] = src[i]; \
+        SPSC_STORE_RELEASE(&r->tail, tail + k);                                 \
+        if (k < n)                                                              \
+            SPSC_STORE_RELAXED(&r->overflows, SPSC_LOAD_RELAXED(&r->overflows) + (n - k)); \
+        return k;                                                               \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_push(name##_t *r, T v) {                          \
+        return name##_push_n(r, &v, 1) == 1;                                    \
+    }                                                                           \
+                                                                                \
+    static inline uint32_t name##_pop_n(name##_t *r, T *dst, uint32_t n) {      \
+        uint32_t head = SPSC_LOAD_RELAXED(&r->head);                            \
+        uint32_t avail = SPSC_LOAD_ACQUIRE(&r->tail) - head;                    \
+        uint32_t k = n < avail ? n : avail;                                     \
+        for (uint32_t i = 0; i < k; i++) dst[i] = r->slots[(head + i) & ((N) - 1)]; \
+        SPSC_STORE_RELEASE(&r->head, head + k);                                 \
+        return k;                                                               \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_pop(name##_t *r, T *out) {                        \
+        return name##_pop_n(r, out, 1) == 1;                                    \
+    }
+
+// ========== C++ Interface ==========
+#ifdef __cplusplus
+
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0 && N >= 2, "SpscRing size must be a power of two");
+    static const uint32_t MASK = N - 1;
+
+    T slots[N];
+    uint32_t head __attribute__((aligned(64)));     // written by the consumer
+    uint32_t tail __attribute__((aligned(64)));     // written by the producer
+    uint32_t overflows;
+
+public:
+    SpscRing() : head(0), tail(0), overflows(0) {}
+
+    // ---- producer side ----
+    uint32_t push_n(const T* src, uint32_t n) {
+        uint32_t t = SPSC_LOAD_RELAXED(&tail);
+        uint32_t room = N - (t - SPSC_LOAD_ACQUIRE(&head));
+        uint32_t k = n < room ? n : room;
+        for (uint32_t i = 0; i < k; i++)
+            slots[(t + i) & MASK] = src[i];
+        SPSC_STORE_RELEASE(&tail, t + k);
+        if (k < n)
+            SPSC_STORE_RELAXED(&overflows, SPSC_LOAD_RELAXED(&overflows) + (n - k));
+        return k;
+    }
+
+    bool push(const T& v) {
+        return push_n(&v, 1) == 1;
+    }
+
+    // ---- consumer side ----
+    uint32_t pop_n(T* dst, uint32_t n) {
+        uint32_t h = SPSC_LOAD_RELAXED(&head);
+        uint32_t avail = SPSC_LOAD_ACQUIRE(&tail) - h;
+        uint32_t k = n < avail ? n : avail;
+        for (uint32_t i = 0; i < k; i++)
+            dst[i] = slots[(h + i) & MASK];
+        SPSC_STORE_RELEASE(&head, h + k);
+        return k;
+    }
+
+    bool pop(T& out) {
+        return pop_n(&out, 1) == 1;
+    }
+
+    // ---- either side ----
+    uint32_t size() const {
+        return SPSC_LOAD_ACQUIRE(&tail) - SPSC_LOAD_ACQUIRE(&head);
+    }
+
+    bool empty() const { return size() == 0; }
+    static uint32_t capacity() { return N; }
+    uint32_t overflowCount() const { return SPSC_LOAD_RELAXED(&overflows); }
+};
+
+#endif // __cplusplus
+
+#endif // SPSC_RING_H
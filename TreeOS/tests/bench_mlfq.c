@@ -0,0 +1,231 @@
+// bench_mlfq.c - scheduling simulation: MLFQ run queue vs the old round robin
+// Run: make hosted-bench
+//
+// Replays synthetic workloads tick by tick (one tick = one 10 ms timer
+// interrupt) and reports, per task group, how long a runnable task waits
+// for the CPU: from waking up or being preempted until it is dispatched.
+//
+//   interactive  1-tick bursts, then sleeps 20-100 ticks (shell, editor)
+//   mixed        1-4 tick bursts, then sleeps 10-40 ticks (I/O bound)
+//   batch        never sleeps (compiler, number crunching)
+//
+// "rr" models the scheduler mlfq.c replaced: one FIFO and a fixed
+// QUANTUM_MS = 20 tick slice, nice ignored.
+
+#include <stdbool.h>
+#include <string.h>
+#include "hosted_test.h"
+#include "mlfq.h"
+
+#define SIM_TICKS 200000
+#define MAX_TASKS 128
+#define MAX_GROUPS 4
+#define RR_QUANTUM 20
+
+typedef enum { KIND_INTERACTIVE, KIND_MIXED, KIND_BATCH } task_kind_t;
+
+static const char *kind_names[] = { "interactive", "mixed", "batch" };
+
+typedef struct {
+    task_kind_t kind;
+    int32_t nice;
+    uint32_t count;
+} group_spec_t;
+
+typedef struct {
+    const char *name;
+    group_spec_t groups[MAX_GROUPS];
+    uint32_t nr_groups;
+} scenario_t;
+
+typedef struct task {
+    sched_entity_t se;          // must stay first: entity -> task cast
+    uint32_t group;
+    task_kind_t kind;
+    uint32_t burst_left;
+    uint64_t wake_at;
+    uint64_t ready_since;
+    bool sleeping;
+    uint32_t rr_slice;
+    struct task *rr_next;
+} task_t;
+
+typedef struct {
+    uint32_t *waits;
+    uint32_t n, cap;
+    uint64_t cpu_ticks;
+} group_stats_t;
+
+// ========== Policies ==========
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    void (*enqueue)(task_t *t);
+    task_t *(*pick)(void);
+    bool (*tick)(task_t *cur);      // true = preempt cur
+} policy_t;
+
+static sched_runqueue_t rq;
+
+static void mlfq_init(void) { sched_rq_init(&rq); }
+static void mlfq_enqueue(task_t *t) { sched_enqueue(&rq, &t->se); }
+static task_t *mlfq_pick(void) { return (task_t*)sched_pick_next(&rq); }
+static bool mlfq_tick(task_t *cur) { return sched_tick(&rq, cur ? &cur->se : NULL); }
+
+static task_t *rr_head, *rr_tail;
+
+static void rr_init(void) { rr_head = rr_tail = NULL; }
+
+static void rr_enqueue(task_t *t) {
+    t->rr_next = NULL;
+    if (rr_tail) rr_tail->rr_next = t;
+    else rr_head = t;
+    rr_tail = t;
+}
+
+static task_t *rr_pick(void) {
+    task_t *t = rr_head;
+    if (!t) return NULL;
+    rr_head = t->rr_next;
+    if (!rr_head) rr_tail = NULL;
+    t->rr_slice = RR_QUANTUM;
+    return t;
+}
+
+static bool rr_tick(task_t *cur) { return cur && --cur->rr_slice == 0; }
+
+static const policy_t policies[] = {
+    { "rr",   rr_init,   rr_enqueue,   rr_pick,   rr_tick },
+    { "mlfq", mlfq_init, mlfq_enqueue, mlfq_pick, mlfq_tick },
+};
+
+// ========== Simulation ==========
+static task_t tasks[MAX_TASKS];
+static group_stats_t stats[MAX_GROUPS];
+
+static void record_wait(uint32_t group, uint32_t wait) {
+    group_stats_t *g = &stats[group];
+    if (g->n == g->cap) {
+        g->cap = g->cap ? g->cap * 2 : 4096;
+        g->waits = realloc(g->waits, g->cap * sizeof(uint32_t));
+        CHECK(g->waits != NULL);
+    }
+    g->waits[g->n++] = wait;
+}
+
+static void new_burst(task_t *t, uint64_t *seed) {
+    switch (t->kind) {
+    case KIND_INTERACTIVE: t->burst_left = 1; break;
+    case KIND_MIXED:       t->burst_left = 1 + rng_below(seed, 4); break;
+    case KIND_BATCH:       t->burst_left = UINT32_MAX; break;
+    }
+}
+
+static uint32_t sleep_ticks(const task_t *t, uint64_t *seed) {
+    return t->kind == KIND_INTERACTIVE ? 20 + rng_below(seed, 81) : 10 + rng_below(seed, 31);
+}
+
+static void simulate(const scenario_t *sc, const policy_t *pol) {
+    uint64_t seed = 0x5C4ED;
+    uint32_t n = 0;
+
+    pol->init();
+    memset(tasks, 0, sizeof(tasks));
+    for (uint32_t g = 0; g < sc->nr_groups; g++) {
+        stats[g].n = 0;
+        stats[g].cpu_ticks = 0;
+        for (uint32_t i = 0; i < sc->groups[g].count; i++, n++) {
+            CHECK(n < MAX_TASKS);
+            task_t *t = &tasks[n];
+            sched_entity_init(&t->se, sc->groups[g].nice);
+            t->group = g;
+            t->kind = sc->groups[g].kind;
+            // Stagger the start so the interactive tasks are not in lockstep
+            t->sleeping = true;
+            t->wake_at = rng_below(&seed, 100);
+        }
+    }
+
+    task_t *cur = NULL;
+    for (uint64_t now = 0; now < SIM_TICKS; now++) {
+        for (uint32_t i = 0; i < n; i++) {
+            task_t *t = &tasks[i];
+            if (t->sleeping && t->wake_at <= now) {
+                t->sleeping = false;
+                t->ready_since = now;
+                new_burst(t, &seed);
+                pol->enqueue(t);
+            }
+        }
+
+        if (!cur && (cur = pol->pick()) != NULL)
+            record_wait(cur->group, (uint32_t)(now - cur->ready_since));
+
+        // The tick that ends at now + 1 is charged to cur
+        bool preempt = pol->tick(cur);
+        if (!cur) continue;
+
+        stats[cur->group].cpu_ticks++;
+        if (--cur->burst_left == 0) {
+            cur->sleeping = true;
+            cur->wake_at = now + 1 + sleep_ticks(cur, &seed);
+            cur = NULL;
+        } else if (preempt) {
+            cur->ready_since = now + 1;
+            pol->enqueue(cur);
+            cur = NULL;
+        }
+    }
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const group_stats_t *g, uint32_t pct) {
+    if (!g->n) return 0;
+    uint64_t idx = ((uint64_t)g->n * pct + 99) / 100;
+    return g->waits[idx ? idx - 1 : 0];
+}
+
+static void report(const scenario_t *sc, const policy_t *pol) {
+    for (uint32_t g = 0; g < sc->nr_groups; g++) {
+        group_stats_t *s = &stats[g];
+        qsort(s->waits, s->n, sizeof(uint32_t), cmp_u32);
+        printf("  %-5s %-11s nice %3d x%-3u %8u %6u %6u %6u %6u %7.1f%%\n",
+               pol->name, kind_names[sc->groups[g].kind], (int)sc->groups[g].nice,
+               sc->groups[g].count, s->n, percentile(s, 50), percentile(s, 90),
+               percentile(s, 99), s->n ? s->waits[s->n - 1] : 0,
+               100.0 * (double)s->cpu_ticks / SIM_TICKS);
+    }
+}
+
+int main(void) {
+    static const scenario_t scenarios[] = {
+        { "desktop: interactive tasks next to a few CPU hogs",
+          { { KIND_INTERACTIVE, 0, 16 }, { KIND_MIXED, 0, 4 }, { KIND_BATCH, 0, 4 } }, 3 },
+        { "server: many I/O-bound tasks and batch work",
+          { { KIND_INTERACTIVE, 0, 4 }, { KIND_MIXED, 0, 8 }, { KIND_BATCH, 0, 16 } }, 3 },
+        { "nice: batch at nice 0 vs nice 19, interactive at -10",
+          { { KIND_INTERACTIVE, -10, 8 }, { KIND_BATCH, 0, 4 }, { KIND_BATCH, 19, 4 } }, 3 },
+    };
+
+    printf("run-queue wait per dispatch, in ticks (10 ms); %u ticks simulated\n", SIM_TICKS);
+    for (uint32_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        printf("\n%s\n", scenarios[s].name);
+        printf("  %-5s %-11s %-10s %8s %6s %6s %6s %6s %8s\n",
+               "sched", "group", "", "runs", "p50", "p90", "p99", "max", "cpu");
+        for (uint32_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+            uint64_t t0 = now_ns();
+            simulate(&scenarios[s], &policies[p]);
+            uint64_t t1 = now_ns();
+            report(&scenarios[s], &policies[p]);
+            printf("  %-5s %.1f ns per simulated tick\n", policies[p].name,
+                   (double)(t1 - t0) / SIM_TICKS);
+        }
+    }
+
+    for (uint32_t g = 0; g < MAX_GROUPS; g++) free(stats[g].waits);
+    return 0;
+}
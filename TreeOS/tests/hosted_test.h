@@ -0,0 +1,42 @@
+// hosted_test.h - shared helpers for the hosted unit tests and benchmarks
+// Built by `make hosted-test` / `make hosted-bench` against build/hosted/
+// libminios_hosted.a; usable from both C and C++ test programs.
+
+#ifndef HOSTED_TEST_H
+#define HOSTED_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+// xorshift64*: deterministic for a given seed and cheap enough not to show
+// up in the benchmark numbers.
+static inline uint64_t rng_next(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform in [0, n)
+static inline uint32_t rng_below(uint64_t *s, uint32_t n) {
+    return (uint32_t)(((rng_next(s) >> 32) * (uint64_t)n) >> 32);
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif // HOSTED_TEST_H
@@ -0,0 +1,563 @@
+// test_ata_queue.cpp - hosted test for the ATA driver's request queue
+// Run: make hosted-test
+//
+// driver_manager.cpp is compiled in directly, with PortIO and IrqGuard
+// replaced by a simulated primary-channel drive: registers, PIO data blocks,
+// READ/WRITE MULTIPLE, CACHE FLUSH and INTRQ (delivered whenever interrupts
+// are "on", i.e. outside every IrqGuard). Bottom halves go through the real
+// deferred queue. The drive can hold a command to let the queue build up,
+// fail a sector, or drop interrupts, which the driver must recover from by
+// polling. Checked: data against a shadow disk, LBA sorting and merging of
+// queued requests, FLUSH and overlap barriers, errors, and lost IRQs.
+
+#define DRIVER_MANAGER_HOSTED
+
+#include <stdint.h>
+#include <string.h>
+#include "hosted_test.h"
+#include "deferred.h"
+#include "driver_manager.h"
+
+// ========== Simulated drive ==========
+namespace sim {
+
+const uint32_t SECTORS = 4096;
+const uint32_t MULTIPLE = 16;                   // IDENTIFY word 47
+const uint32_t MAX_LOG = 256;
+
+const uint8_t ST_ERR = 0x01, ST_DRQ = 0x08, ST_DRDY = 0x40, ST_BSY = 0x80;
+
+struct Command {
+    uint8_t cmd;
+    uint32_t lba;
+    uint32_t count;
+};
+
+uint8_t disk[SECTORS * 512];
+uint8_t regs[8];                                // task file as last written
+uint8_t ctrl;                                   // device control (bit 1 = nIEN)
+uint8_t status = ST_DRDY;
+uint32_t multiple = 1;
+
+// Command in progress
+enum Mode { IDLE, PIO_IN, PIO_OUT } mode;
+uint8_t cmd;
+uint32_t lba, left, perBlock;
+uint16_t buf[MULTIPLE * 256];
+uint32_t bufWords, bufPos;
+
+Command log[MAX_LOG];
+uint32_t logCount;
+
+bool irqLine;
+uint32_t guardDepth;
+bool inIrq;
+
+bool hold;                                      // park the next completion
+void (*held)();
+uint32_t failLba = ~0u;                         // sector that reads/writes as ERR
+uint32_t dropOneIn;                             // 0 = never drop INTRQ
+uint32_t dropped;
+uint64_t seed = 0xA7A5EED;
+
+void deliver() {
+    if (!irqLine || guardDepth || inIrq)
+        return;
+    inIrq = true;
+    driver_manager_handle_irq(14);
+    inIrq = false;
+}
+
+void raise() {
+    if (ctrl & 0x02)
+        return;
+    if (dropOneIn && rng_below(&seed, dropOneIn) == 0) {
+        dropped++;
+        return;
+    }
+    irqLine = true;
+    deliver();
+}
+
+// Where a real drive would go busy for a while: a held command waits for
+// release(), everything else completes at once.
+void complete(void (*fn)()) {
+    if (hold) {
+        CHECK(!held);
+        held = fn;
+        return;
+    }
+    fn();
+}
+
+void release() {
+    hold = false;
+    void (*fn)() = held;
+    held = nullptr;
+    if (fn)
+        fn();
+}
+
+bool failing(uint32_t first, uint32_t n) {
+    return failLba >= first && failLba < first + n;
+}
+
+void finishError() {
+    mode = IDLE;
+    status = ST_DRDY | ST_ERR;
+    raise();
+}
+
+void loadReadBlock() {
+    uint32_t n = left < perBlock ? left : perBlock;
+    if (failing(lba, n)) {
+        finishError();
+        return;
+    }
+    memcpy(buf, disk + (size_t)lba * 512, n * 512);
+    bufWords = n * 256;
+    bufPos = 0;
+    status = ST_DRDY | ST_DRQ;
+    raise();
+}
+
+void startWriteBlock() {
+    uint32_t n = left < perBlock ? left : perBlock;
+    bufWords = n * 256;
+    bufPos = 0;
+    status = ST_DRDY | ST_DRQ;
+}
+
+void writeBlockDone() {
+    if (left) {
+        startWriteBlock();
+    } else {
+        mode = IDLE;
+        status = ST_DRDY;
+    }
+    raise();
+}
+
+void flushDone() {
+    mode = IDLE;
+    status = ST_DRDY;
+    raise();
+}
+
+void identify() {
+    memset(buf, 0, 512);
+    const char* model = "SIMULATED ATA DISK";
+    for (int i = 0; model[i] && i < 40; i++)
+        buf[27 + i / 2] |= (uint16_t)((uint8_t)model[i] << (i % 2 ? 0 : 8));
+    buf[47] = 0x8000 | MULTIPLE;
+    buf[60] = SECTORS & 0xFFFF;
+    buf[61] = SECTORS >> 16;
+    mode = PIO_IN;
+    cmd = 0xEC;
+    left = 1;
+    perBlock = 1;
+    bufWords = 256;
+    bufPos = 0;
+    status = ST_DRDY | ST_DRQ;
+}
+
+void command(uint8_t c) {
+    uint32_t count = regs[2] ? regs[2] : 256;
+    uint32_t at = regs[3] | (regs[4] << 8) | (regs[5] << 16) | ((regs[6] & 0x0F) << 24);
+
+    switch (c) {
+    case 0xEC:
+        identify();
+        return;
+    case 0xC6:
+        multiple = regs[2];
+        status = ST_DRDY;
+        raise();
+        return;
+    case 0xE7:
+        break;
+    case 0x20: case 0xC4: case 0x30: case 0xC5:
+        CHECK(at + count <= SECTORS);
+        break;
+    default:
+        CHECK(!"unexpected ATA command");
+    }
+
+    CHECK(mode == IDLE && !(status & ST_BSY));
+    if (logCount < MAX_LOG)                     // only the first commands are kept
+        log[logCount] = Command{c, c == 0xE7 ? 0 : at, c == 0xE7 ? 0 : count};
+    logCount++;
+    cmd = c;
+    lba = at;
+    left = count;
+    perBlock = (c == 0xC4 || c == 0xC5) ? multiple : 1;
+
+    if (c == 0xE7) {
+        status = ST_BSY;
+        complete(flushDone);
+    } else if (c == 0x20 || c == 0xC4) {
+        mode = PIO_IN;
+        status = ST_BSY;
+        complete(loadReadBlock);
+    } else {
+        mode = PIO_OUT;
+        startWriteBlock();                      // first block needs no INTRQ
+    }
+}
+
+uint16_t readData() {
+    CHECK(mode == PIO_IN && (status & ST_DRQ) && bufPos < bufWords);
+    uint16_t w = buf[bufPos++];
+    if (bufPos == bufWords) {
+        uint32_t n = bufWords / 256;
+        lba += n;
+        left -= n;
+        if (left) {
+            status = ST_BSY;
+            loadReadBlock();
+        } else {
+            mode = IDLE;
+            status = ST_DRDY;                   // no interrupt after the last block
+        }
+    }
+    return w;
+}
+
+void writeData(uint16_t w) {
+    CHECK(mode == PIO_OUT && (status & ST_DRQ) && bufPos < bufWords);
+    buf[bufPos++] = w;
+    if (bufPos == bufWords) {
+        uint32_t n = bufWords / 256;
+        status = ST_BSY;
+        if (failing(lba, n)) {
+            complete(finishError);
+            return;
+        }
+        memcpy(disk + (size_t)lba * 512, buf, n * 512);
+        lba += n;
+        left -= n;
+        complete(writeBlockDone);
+    }
+}
+
+void reset() {
+    memset(log, 0, sizeof(log));
+    logCount = 0;
+    hold = false;
+    held = nullptr;
+    failLba = ~0u;
+    dropOneIn = 0;
+    dropped = 0;
+}
+
+} // namespace sim
+
+// ========== Hosted PortIO / IrqGuard ==========
+class PortIO {
+public:
+    static void outb(uint16_t port, uint8_t val) {
+        sim::deliver();
+        if (port >= 0x1F1 && port <= 0x1F6)
+            sim::regs[port - 0x1F0] = val;
+        else if (port == 0x1F7)
+            sim::command(val);
+        else if (port == 0x3F6)
+            sim::ctrl = val;
+    }
+
+    static uint8_t inb(uint16_t port) {
+        sim::deliver();
+        if (port == 0x1F7) {
+            sim::irqLine = false;               // reading status acknowledges INTRQ
+            return sim::status;
+        }
+        if (port == 0x3F6)
+            return sim::status;                 // alternate status: no side effects
+        return 0xFF;
+    }
+
+    static void outw(uint16_t port, uint16_t val) {
+        sim::deliver();
+        CHECK(port == 0x1F0);
+        sim::writeData(val);
+    }
+
+    static uint16_t inw(uint16_t port) {
+        sim::deliver();
+        CHECK(port == 0x1F0);
+        return sim::readData();
+    }
+
+    static void outl(uint16_t, uint32_t) { sim::deliver(); }
+    static uint32_t inl(uint16_t) { sim::deliver(); return 0xFFFFFFFF; }
+    static void io_wait() {}
+};
+
+// Interrupts are "off" while any guard is alive; a pending INTRQ is taken as
+// soon as the last one goes away, as after popf on the real CPU.
+class IrqGuard {
+public:
+    IrqGuard() { sim::guardDepth++; }
+    ~IrqGuard() {
+        if (--sim::guardDepth == 0)
+            sim::deliver();
+    }
+};
+
+#include "driver_manager.cpp"
+
+// ========== Kernel services ==========
+static deferred_queue_t bottom_halves;
+
+extern "C" void sleep_ms(uint32_t) {}
+extern "C" uint64_t clock_now_us(void) { return now_ns() / 1000; }
+extern "C" uint64_t read_tsc(void) { return now_ns(); }
+
+extern "C" bool defer_work(deferred_work_t* work) {
+    return deferred_schedule(&bottom_halves, work);
+}
+
+// ========== Helpers ==========
+static ATADriver* ata;
+static uint8_t shadow[sim::SECTORS * 512];      // what the disk must hold
+
+static void fill(uint8_t* buf, uint32_t sectors, uint64_t* seed) {
+    for (uint32_t i = 0; i < sectors * 512; i += 8) {
+        uint64_t x = rng_next(seed);
+        memcpy(buf + i, &x, 8);
+    }
+}
+
+// The kernel's main loop: run bottom halves until every request is done.
+static void drain(BlockRequest** reqs, uint32_t n) {
+    for (uint32_t spins = 0;; spins++) {
+        bool all = true;
+        for (uint32_t i = 0; i < n; i++)
+            all = all && reqs[i]->done;
+        if (all)
+            return;
+        CHECK(spins < 1000000);
+        deferred_run(&bottom_halves, 0);
+    }
+}
+
+static void check_log(const sim::Command* want, uint32_t n) {
+    CHECK(sim::logCount == n);
+    for (uint32_t i = 0; i < n; i++) {
+        CHECK(sim::log[i].cmd == want[i].cmd);
+        CHECK(sim::log[i].lba == want[i].lba);
+        CHECK(sim::log[i].count == want[i].count);
+    }
+}
+
+static void test_init(void) {
+    deferred_queue_init(&bottom_halves);
+    ata = static_cast<ATADriver*>(driver_manager_create_disk());
+    CHECK(ata && ata->isInitialized());
+    CHECK(ata->getSectorCount() == sim::SECTORS);
+    CHECK(ata->getBlockSectors() == sim::MULTIPLE);
+    CHECK(strncmp(ata->getModel(), "SIMULATED ATA DISK", 18) == 0);
+    CHECK(sim::ctrl == 0x00);                   // interrupts enabled for transfers
+
+    uint64_t seed = 1;
+    fill(sim::disk, sim::SECTORS, &seed);
+    memcpy(shadow, sim::disk, sizeof(shadow));
+}
+
+// Blocking I/O of every shape, including requests longer than one command.
+static void test_blocking(void) {
+    static uint8_t buf[600 * 512];
+    uint64_t seed = 2;
+    sim::reset();
+    ATADriver::Stats before = ata->getStats();
+
+    for (int round = 0; round < 300; round++) {
+        uint32_t n = 1 + rng_below(&seed, round % 10 == 0 ? 600 : 40);
+        uint32_t at = rng_below(&seed, sim::SECTORS - n);
+        if (rng_below(&seed, 2)) {
+            fill(buf, n, &seed);
+            CHECK(ata->write(at, n, buf));
+            memcpy(shadow + (size_t)at * 512, buf, n * 512);
+        } else {
+            CHECK(ata->read(at, n, buf));
+            CHECK(memcmp(buf, shadow + (size_t)at * 512, n * 512) == 0);
+        }
+        if (round % 50 == 0)
+            CHECK(ata->flush());
+    }
+    CHECK(memcmp(sim::disk, shadow, sizeof(shadow)) == 0);
+
+    // Every completion came through IRQ 14, none through the lost-IRQ poll.
+    const ATADriver::Stats& s = ata->getStats();
+    CHECK(s.interrupts > before.interrupts);
+    CHECK(s.lostInterrupts == before.lostInterrupts);
+    CHECK(s.errors == before.errors);
+    CHECK(!ata->read(sim::SECTORS - 1, 2, buf));             // past the end
+    CHECK(!ata->read(0, 0, buf));
+}
+
+// Requests queued behind a busy drive go out in LBA order, contiguous ones
+// share a command, and FLUSH keeps everything after it in its place.
+static void test_sort_merge_barrier(void) {
+    static uint8_t a[4 * 512], b[512], c[8 * 512], d[4 * 512], e[4 * 512], f[512], g[512];
+    sim::reset();
+    uint32_t merged = ata->getStats().merged;
+
+    sim::hold = true;
+    BlockRequest r0(BlockRequest::READ, 100, 4, a);
+    BlockRequest r1(BlockRequest::READ, 300, 1, b);
+    BlockRequest r2(BlockRequest::READ, 200, 8, c);
+    BlockRequest r3(BlockRequest::READ, 104, 4, d);
+    BlockRequest r4(BlockRequest::READ, 108, 4, e);
+    BlockRequest r5(BlockRequest::READ, 50, 1, f);
+    BlockRequest fl(BlockRequest::FLUSH);
+    BlockRequest r6(BlockRequest::READ, 10, 1, g);
+    BlockRequest* reqs[] = { &r0, &r1, &r2, &r3, &r4, &r5, &fl, &r6 };
+    for (BlockRequest* r : reqs)
+        CHECK(ata->submit(r));
+    CHECK(sim::logCount == 1 && !r0.done);
+    sim::release();
+    drain(reqs, 8);
+
+    for (BlockRequest* r : reqs)
+        CHECK(r->ok);
+    const sim::Command want[] = {
+        { 0xC4, 100, 4 }, { 0xC4, 50, 1 }, { 0xC4, 104, 8 }, { 0xC4, 200, 8 },
+        { 0xC4, 300, 1 }, { 0xE7, 0, 0 }, { 0xC4, 10, 1 },
+    };
+    check_log(want, 7);
+    CHECK(ata->getStats().merged == merged + 1);
+    CHECK(memcmp(d, shadow + 104 * 512, sizeof(d)) == 0);
+    CHECK(memcmp(e, shadow + 108 * 512, sizeof(e)) == 0);
+    CHECK(memcmp(c, shadow + 200 * 512, sizeof(c)) == 0);
+    CHECK(memcmp(g, shadow + 10 * 512, sizeof(g)) == 0);
+}
+
+// Overlapping requests keep submission order even when sorting would swap
+// them: the read sees the first write, the second write lands last.
+static void test_overlap_order(void) {
+    static uint8_t w1[4 * 512], rd[4 * 512], w2[4 * 512], pad[512];
+    uint64_t seed = 3;
+    fill(w1, 4, &seed);
+    fill(w2, 4, &seed);
+    fill(pad, 1, &seed);
+    sim::reset();
+
+    sim::hold = true;
+    BlockRequest r0(BlockRequest::WRITE, 1, 1, pad);
+    BlockRequest r1(BlockRequest::WRITE, 600, 4, w1);
+    BlockRequest r2(BlockRequest::READ, 600, 4, rd);
+    BlockRequest r3(BlockRequest::WRITE, 598, 4, w2);
+    BlockRequest* reqs[] = { &r0, &r1, &r2, &r3 };
+    for (BlockRequest* r : reqs)
+        CHECK(ata->submit(r));
+    sim::release();
+    drain(reqs, 4);
+
+    const sim::Command want[] = {
+        { 0xC5, 1, 1 }, { 0xC5, 600, 4 }, { 0xC4, 600, 4 }, { 0xC5, 598, 4 },
+    };
+    check_log(want, 4);
+    CHECK(memcmp(rd, w1, sizeof(rd)) == 0);
+    CHECK(memcmp(sim::disk + 598 * 512, w2, sizeof(w2)) == 0);
+    CHECK(memcmp(sim::disk + 602 * 512, w1 + 2 * 512, 2 * 512) == 0);
+    memcpy(shadow + 1 * 512, pad, 512);
+    memcpy(shadow + 600 * 512, w1, sizeof(w1));
+    memcpy(shadow + 598 * 512, w2, sizeof(w2));
+}
+
+// Random queued batches checked against the order they were submitted in.
+static void test_random_queue(void) {
+    enum { BATCH = 24, MAX_N = 48 };
+    static uint8_t data[BATCH][MAX_N * 512];
+    static uint8_t expect[BATCH][MAX_N * 512];
+    uint64_t seed = 4;
+    sim::reset();
+
+    for (int round = 0; round < 200; round++) {
+        BlockRequest* reqs[BATCH];
+        uint32_t n = 1 + rng_below(&seed, BATCH);
+        sim::hold = true;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t kind = rng_below(&seed, 10);
+            uint32_t count = 1 + rng_below(&seed, MAX_N);
+            // A small window makes contiguous and overlapping requests common.
+            uint32_t at = 1000 + rng_below(&seed, 256);
+            if (kind == 0) {
+                reqs[i] = new BlockRequest(BlockRequest::FLUSH);
+            } else if (kind < 5) {
+                fill(data[i], count, &seed);
+                reqs[i] = new BlockRequest(BlockRequest::WRITE, at, count, data[i]);
+                memcpy(shadow + (size_t)at * 512, data[i], count * 512);
+            } else {
+                reqs[i] = new BlockRequest(BlockRequest::READ, at, count, data[i]);
+                memcpy(expect[i], shadow + (size_t)at * 512, count * 512);
+            }
+            CHECK(ata->submit(reqs[i]));
+        }
+        sim::release();
+        drain(reqs, n);
+        for (uint32_t i = 0; i < n; i++) {
+            CHECK(reqs[i]->ok);
+            if (reqs[i]->op == BlockRequest::READ)
+                CHECK(memcmp(data[i], expect[i], reqs[i]->count * 512) == 0);
+            delete reqs[i];
+        }
+    }
+    CHECK(memcmp(sim::disk, shadow, sizeof(shadow)) == 0);
+    CHECK(ata->getStats().merged > 0);
+}
+
+// A failing sector fails its whole command and nothing else.
+static void test_errors(void) {
+    static uint8_t buf[8 * 512];
+    sim::reset();
+    uint32_t errors = ata->getStats().errors;
+
+    sim::failLba = 703;
+    CHECK(!ata->read(700, 8, buf));
+    CHECK(!ata->write(703, 1, buf));
+    CHECK(ata->read(710, 8, buf));
+    CHECK(memcmp(buf, shadow + 710 * 512, sizeof(buf)) == 0);
+    CHECK(ata->getStats().errors == errors + 2);
+    sim::failLba = ~0u;
+    CHECK(ata->read(700, 8, buf));
+}
+
+// Dropped interrupts stall a request only until the lost-IRQ poll in wait().
+static void test_lost_interrupts(void) {
+    static uint8_t buf[64 * 512];
+    uint64_t seed = 5;
+    sim::reset();
+    sim::dropOneIn = 8;
+    uint32_t lost = ata->getStats().lostInterrupts;
+
+    for (int round = 0; round < 60; round++) {
+        uint32_t n = 1 + rng_below(&seed, 64);
+        uint32_t at = rng_below(&seed, sim::SECTORS - n);
+        if (rng_below(&seed, 2)) {
+            fill(buf, n, &seed);
+            CHECK(ata->write(at, n, buf));
+            memcpy(shadow + (size_t)at * 512, buf, n * 512);
+        } else {
+            CHECK(ata->read(at, n, buf));
+            CHECK(memcmp(buf, shadow + (size_t)at * 512, n * 512) == 0);
+        }
+    }
+    CHECK(ata->flush());
+    CHECK(sim::dropped > 0);
+    CHECK(ata->getStats().lostInterrupts > lost);
+    CHECK(memcmp(sim::disk, shadow, sizeof(shadow)) == 0);
+}
+
+int main(void) {
+    test_init();
+    test_blocking();
+    test_sort_merge_barrier();
+    test_overlap_order();
+    test_random_queue();
+    test_errors();
+    test_lost_interrupts();
+    printf("test_ata_queue: ok\n");
+    return 0;
+}
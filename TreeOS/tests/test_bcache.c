@@ -0,0 +1,232 @@
+// test_bcache.c - hosted unit test for the block buffer cache (bcache.c)
+// Run: make hosted-test
+//
+// The cache runs on top of a block device backed by a temporary file, and
+// every operation is checked against a shadow copy of what the disk should
+// hold once the cache is synced.
+
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "hosted_test.h"
+#include "bcache.h"
+
+#define DEV_BLOCKS 1024
+#define CACHE_BUFS 64
+#define RANDOM_OPS 200000
+
+typedef struct {
+    int fd;
+    uint32_t reads, writes, flushes;
+    uint32_t fail_lba;                  // UINT32_MAX = no injected errors
+    uint32_t last_write;
+    bool writes_ascending;
+} file_dev_t;
+
+static bool file_read(void *ctx, uint32_t lba, uint32_t count, uint8_t *buf) {
+    file_dev_t *d = ctx;
+    d->reads++;
+    if (lba == d->fail_lba) return false;
+    size_t len = (size_t)count * BCACHE_BLOCK_SIZE;
+    return pread(d->fd, buf, len, (off_t)lba * BCACHE_BLOCK_SIZE) == (ssize_t)len;
+}
+
+static bool file_write(void *ctx, uint32_t lba, uint32_t count, const uint8_t *buf) {
+    file_dev_t *d = ctx;
+    d->writes++;
+    if (lba == d->fail_lba) return false;
+    if (d->writes > 1 && lba <= d->last_write) d->writes_ascending = false;
+    d->last_write = lba;
+    size_t len = (size_t)count * BCACHE_BLOCK_SIZE;
+    return pwrite(d->fd, buf, len, (off_t)lba * BCACHE_BLOCK_SIZE) == (ssize_t)len;
+}
+
+static bool file_flush(void *ctx) {
+    file_dev_t *d = ctx;
+    d->flushes++;
+    return fsync(d->fd) == 0;
+}
+
+static file_dev_t fdev;
+static block_device_t dev = { file_read, file_write, file_flush, &fdev, DEV_BLOCKS };
+static uint8_t storage[CACHE_BUFS * BCACHE_BLOCK_SIZE];
+static uint8_t shadow[DEV_BLOCKS][BCACHE_BLOCK_SIZE];
+static bcache_t cache;
+
+static void fill_block(uint8_t *buf, uint32_t lba, uint32_t version) {
+    for (uint32_t i = 0; i < BCACHE_BLOCK_SIZE; i++)
+        buf[i] = (uint8_t)(lba * 31 + version * 7 + i);
+}
+
+// Fresh file with a known pattern, matching shadow, and an empty cache.
+static void reset(void) {
+    CHECK(ftruncate(fdev.fd, 0) == 0);
+    for (uint32_t lba = 0; lba < DEV_BLOCKS; lba++) {
+        fill_block(shadow[lba], lba, 0);
+        CHECK(pwrite(fdev.fd, shadow[lba], BCACHE_BLOCK_SIZE,
+                     (off_t)lba * BCACHE_BLOCK_SIZE) == BCACHE_BLOCK_SIZE);
+    }
+    fdev.reads = fdev.writes = fdev.flushes = 0;
+    fdev.fail_lba = UINT32_MAX;
+    fdev.writes_ascending = true;
+    bcache_init(&cache, &dev, storage, CACHE_BUFS);
+}
+
+static void check_disk_matches_shadow(void) {
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    for (uint32_t lba = 0; lba < DEV_BLOCKS; lba++) {
+        CHECK(pread(fdev.fd, buf, BCACHE_BLOCK_SIZE,
+                    (off_t)lba * BCACHE_BLOCK_SIZE) == BCACHE_BLOCK_SIZE);
+        CHECK(memcmp(buf, shadow[lba], BCACHE_BLOCK_SIZE) == 0);
+    }
+}
+
+static void test_hits_and_writeback(void) {
+    reset();
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    const bcache_stats_t *st = bcache_get_stats(&cache);
+
+    CHECK(bcache_read(&cache, 5, buf) && memcmp(buf, shadow[5], sizeof(buf)) == 0);
+    CHECK(bcache_read(&cache, 5, buf));
+    CHECK(st->misses == 1 && st->hits == 1 && fdev.reads == 1);
+
+    // A full-block write does not read the old contents and stays cached
+    fill_block(shadow[7], 7, 1);
+    CHECK(bcache_write(&cache, 7, shadow[7]));
+    CHECK(fdev.reads == 1 && fdev.writes == 0 && cache.dirty == 1);
+    CHECK(bcache_read(&cache, 7, buf) && memcmp(buf, shadow[7], sizeof(buf)) == 0);
+
+    // Pinned buffers are modified in place
+    bcache_buf_t *b = bcache_get(&cache, 9);
+    CHECK(b && b->pins == 1 && b->lba == 9);
+    b->data[0] ^= 0xFF;
+    shadow[9][0] ^= 0xFF;
+    bcache_mark_dirty(&cache, b);
+    bcache_mark_dirty(&cache, b);
+    bcache_release(&cache, b);
+    CHECK(cache.dirty == 2);
+
+    CHECK(bcache_sync(&cache));
+    CHECK(cache.dirty == 0 && fdev.writes == 2 && fdev.flushes == 1);
+    CHECK(st->writebacks == 2);
+    check_disk_matches_shadow();
+}
+
+// Touching more blocks than there are buffers evicts, writing dirty victims
+// back; recently referenced blocks get a second chance.
+static void test_eviction(void) {
+    reset();
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    for (uint32_t lba = 0; lba < CACHE_BUFS; lba++) {
+        fill_block(shadow[lba], lba, 2);
+        CHECK(bcache_write(&cache, lba, shadow[lba]));
+    }
+    CHECK(fdev.writes == 0);
+    for (uint32_t lba = CACHE_BUFS; lba < 2 * CACHE_BUFS; lba++)
+        CHECK(bcache_read(&cache, lba, buf));
+    CHECK(bcache_get_stats(&cache)->evictions == CACHE_BUFS);
+    CHECK(fdev.writes == CACHE_BUFS && cache.dirty == 0);
+    check_disk_matches_shadow();
+
+    // Keep block 100 hot: a burst of one-off misses must not evict it
+    CHECK(bcache_read(&cache, 100, buf));
+    for (uint32_t lba = 200; lba < 200 + CACHE_BUFS / 2; lba++) {
+        CHECK(bcache_read(&cache, lba, buf));
+        CHECK(bcache_read(&cache, 100, buf));
+    }
+    uint32_t reads = fdev.reads;
+    CHECK(bcache_read(&cache, 100, buf));
+    CHECK(fdev.reads == reads);
+}
+
+static void test_limits(void) {
+    reset();
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    CHECK(bcache_get(&cache, DEV_BLOCKS) == NULL);
+    CHECK(!bcache_read(&cache, DEV_BLOCKS, buf));
+
+    // Every buffer pinned: the next miss has no victim
+    bcache_buf_t *pinned[CACHE_BUFS];
+    for (uint32_t i = 0; i < CACHE_BUFS; i++)
+        CHECK((pinned[i] = bcache_get(&cache, i)) != NULL);
+    CHECK(bcache_get(&cache, CACHE_BUFS) == NULL);
+    CHECK(bcache_get(&cache, 3) == pinned[3] && pinned[3]->pins == 2);
+    bcache_release(&cache, pinned[3]);
+    for (uint32_t i = 0; i < CACHE_BUFS; i++) bcache_release(&cache, pinned[i]);
+    CHECK(bcache_get(&cache, CACHE_BUFS) != NULL);
+}
+
+// A failed write-back leaves the block dirty; the next sync retries it.
+static void test_io_errors(void) {
+    reset();
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    fdev.fail_lba = 11;
+    CHECK(!bcache_read(&cache, 11, buf));
+
+    fill_block(shadow[11], 11, 3);
+    fill_block(shadow[12], 12, 3);
+    CHECK(bcache_write(&cache, 11, shadow[11]));
+    CHECK(bcache_write(&cache, 12, shadow[12]));
+    CHECK(!bcache_sync(&cache));
+    CHECK(cache.dirty == 1 && bcache_get_stats(&cache)->io_errors == 2);
+
+    fdev.fail_lba = UINT32_MAX;
+    CHECK(bcache_sync(&cache));
+    check_disk_matches_shadow();
+}
+
+// Random reads and writes against the shadow; sync writes ascending.
+static void test_random(void) {
+    reset();
+    uint64_t rng = 0xB10C;
+    uint8_t buf[BCACHE_BLOCK_SIZE];
+    for (uint32_t op = 0; op < RANDOM_OPS; op++) {
+        // Skewed towards low LBAs so hits, misses and evictions all happen
+        uint32_t lba = rng_below(&rng, 8) ? rng_below(&rng, CACHE_BUFS * 2)
+                                          : rng_below(&rng, DEV_BLOCKS);
+        switch (rng_below(&rng, 4)) {
+        case 0:
+            fill_block(shadow[lba], lba, op);
+            CHECK(bcache_write(&cache, lba, shadow[lba]));
+            break;
+        case 1: {
+            bcache_buf_t *b = bcache_get(&cache, lba);
+            CHECK(b);
+            uint32_t at = rng_below(&rng, BCACHE_BLOCK_SIZE);
+            b->data[at]++;
+            shadow[lba][at]++;
+            bcache_mark_dirty(&cache, b);
+            bcache_release(&cache, b);
+            break;
+        }
+        default:
+            CHECK(bcache_read(&cache, lba, buf));
+            CHECK(memcmp(buf, shadow[lba], sizeof(buf)) == 0);
+        }
+        if (op % 50000 == 49999) {
+            fdev.writes_ascending = true;
+            fdev.writes = 0;
+            CHECK(bcache_sync(&cache));
+            CHECK(fdev.writes_ascending);
+            check_disk_matches_shadow();
+        }
+    }
+    const bcache_stats_t *st = bcache_get_stats(&cache);
+    CHECK(st->hits > 0 && st->evictions > 0 && st->io_errors == 0);
+}
+
+int main(void) {
+    FILE *f = tmpfile();
+    CHECK(f);
+    fdev.fd = fileno(f);
+
+    test_hits_and_writeback();
+    test_eviction();
+    test_limits();
+    test_io_errors();
+    test_random();
+
+    fclose(f);
+    printf("test_bcache: ok\n");
+    return 0;
+}
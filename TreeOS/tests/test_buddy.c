@@ -0,0 +1,189 @@
+// test_buddy.c - hosted unit test for the buddy page allocator
+// Run: make hosted-test
+//
+// The pool is carved out of a real frame allocator and checked against a
+// per-frame shadow map: every block is naturally aligned for its order and
+// inside the pool, no two live blocks overlap, the per-order free counts
+// always add up to free_frames, bad frees are refused without touching the
+// pool, and freeing everything coalesces back to max-order blocks.
+
+#include <stdbool.h>
+#include <string.h>
+#include "hosted_test.h"
+#include "buddy.h"
+
+#define TOTAL_FRAMES 6000
+#define POOL_FRAMES 4096
+#define MAX_LIVE 4096
+#define STEPS 1000000
+
+static uint32_t fa_bitmap[(TOTAL_FRAMES + 31) / 32];
+static page_frame_allocator_t fa;
+static buddy_allocator_t pool;
+
+static bool shadow[POOL_FRAMES];            // frame handed out by the pool
+static uint32_t live_frame[MAX_LIVE];
+static uint32_t live_order[MAX_LIVE];
+static uint32_t n_live;
+static uint32_t used_frames;
+
+static void setup(void) {
+    frame_alloc_init(&fa, fa_bitmap, TOTAL_FRAMES);
+    // A few frames in use up front, so the pool has to be aligned past them.
+    CHECK(frame_reserve_range(&fa, 0, 3) == 3);
+    CHECK(buddy_init(&pool, &fa, POOL_FRAMES));
+    CHECK(pool.frames == POOL_FRAMES);
+    CHECK(pool.base_frame % (1u << BUDDY_MAX_ORDER) == 0);
+    CHECK(pool.base_frame >= 3);
+    for (uint32_t i = 0; i < POOL_FRAMES; i++)
+        CHECK(frame_is_used(&fa, pool.base_frame + i));
+    memset(shadow, 0, sizeof(shadow));
+    n_live = 0;
+    used_frames = 0;
+}
+
+static void check_counts(void) {
+    uint32_t sum = 0;
+    for (uint32_t o = 0; o < BUDDY_ORDERS; o++) {
+        sum += pool.free_blocks[o] << o;
+        CHECK(((pool.nonempty >> o) & 1) == (pool.free_blocks[o] != 0));
+    }
+    CHECK(sum == pool.free_frames);
+    CHECK(pool.free_frames + used_frames == pool.frames);
+}
+
+static bool take(uint32_t order) {
+    uint32_t f = buddy_alloc(&pool, order);
+    if (f == FRAME_NONE) return false;
+    uint32_t size = 1u << order;
+    CHECK(f % size == 0);
+    CHECK(f >= pool.base_frame && f - pool.base_frame + size <= pool.frames);
+    uint32_t idx = f - pool.base_frame;
+    for (uint32_t i = 0; i < size; i++) {
+        CHECK(!shadow[idx + i]);
+        shadow[idx + i] = true;
+    }
+    CHECK(n_live < MAX_LIVE);
+    live_frame[n_live] = f;
+    live_order[n_live] = order;
+    n_live++;
+    used_frames += size;
+    return true;
+}
+
+static void give_back(uint32_t slot) {
+    uint32_t f = live_frame[slot], order = live_order[slot];
+    CHECK(buddy_free(&pool, f, order));
+    uint32_t idx = f - pool.base_frame;
+    for (uint32_t i = 0; i < (1u << order); i++) shadow[idx + i] = false;
+    used_frames -= 1u << order;
+    live_frame[slot] = live_frame[--n_live];
+    live_order[slot] = live_order[n_live];
+}
+
+static void check_coalesced(void) {
+    CHECK(n_live == 0);
+    for (uint32_t o = 0; o < BUDDY_MAX_ORDER; o++) CHECK(pool.free_blocks[o] == 0);
+    CHECK(pool.free_blocks[BUDDY_MAX_ORDER] == pool.frames >> BUDDY_MAX_ORDER);
+    CHECK(pool.free_frames == pool.frames);
+}
+
+static void test_init(void) {
+    static buddy_allocator_t b;
+    frame_alloc_init(&fa, fa_bitmap, TOTAL_FRAMES);
+    // Rounded down to whole max-order blocks; a pool that rounds to 0 fails.
+    CHECK(buddy_init(&b, &fa, 3000));
+    CHECK(b.frames == 2048);
+    CHECK(b.free_frames == 2048);
+    CHECK(!buddy_init(&b, &fa, 1000));
+    CHECK(b.frames == 0 && b.free_frames == 0);
+    // Not enough aligned frames left in the frame allocator.
+    CHECK(!buddy_init(&b, &fa, 4096));
+}
+
+static void test_orders(void) {
+    setup();
+    CHECK(buddy_alloc(&pool, BUDDY_MAX_ORDER + 1) == FRAME_NONE);
+    // One block of every order splits a single max-order block exactly.
+    for (uint32_t o = 0; o < BUDDY_MAX_ORDER; o++) CHECK(take(o));
+    CHECK(take(0));
+    check_counts();
+    CHECK(pool.free_blocks[BUDDY_MAX_ORDER] == (POOL_FRAMES >> BUDDY_MAX_ORDER) - 1);
+    for (uint32_t o = 0; o < BUDDY_MAX_ORDER; o++) CHECK(pool.free_blocks[o] == 0);
+    while (n_live) give_back(n_live - 1);
+    check_counts();
+    check_coalesced();
+
+    // Exhaustion in single frames, then one more fails.
+    while (take(0)) {}
+    CHECK(used_frames == POOL_FRAMES);
+    CHECK(pool.free_frames == 0 && pool.nonempty == 0);
+    check_counts();
+    uint64_t seed = 0x5EED;
+    while (n_live) give_back(rng_below(&seed, n_live));
+    check_coalesced();
+
+    CHECK(buddy_order_for(1, 4096) == 0);
+    CHECK(buddy_order_for(4096, 4096) == 0);
+    CHECK(buddy_order_for(4097, 4096) == 1);
+    CHECK(buddy_order_for(64 * 1024, 4096) == 4);
+    CHECK(buddy_order_for((size_t)1 << 30, 4096) == BUDDY_MAX_ORDER);
+}
+
+static void test_bad_frees(void) {
+    setup();
+    CHECK(take(3));
+    uint32_t f = live_frame[0];
+    uint32_t before = pool.free_frames;
+
+    CHECK(!buddy_free(&pool, f + 1, 3));                 // misaligned
+    CHECK(!buddy_free(&pool, f + 8, 3));                 // free, not allocated
+    CHECK(!buddy_free(&pool, f, 2));                     // wrong order
+    CHECK(!buddy_free(&pool, f, BUDDY_MAX_ORDER + 1));
+    CHECK(!buddy_free(&pool, pool.base_frame - 1, 0));   // below the pool
+    CHECK(!buddy_free(&pool, pool.base_frame + pool.frames, 0));
+    CHECK(pool.free_frames == before);
+    check_counts();
+
+    give_back(0);
+    CHECK(!buddy_free(&pool, f, 3));                     // double free
+    check_counts();
+    check_coalesced();
+}
+
+static void test_random(void) {
+    setup();
+    uint64_t seed = 0xB0DD1E5;
+    uint32_t failed = 0;
+    for (uint32_t step = 0; step < STEPS; step++) {
+        // Mostly small blocks, occasionally large ones, about as many frees.
+        bool alloc = n_live == 0 || (n_live < MAX_LIVE && rng_below(&seed, 2));
+        if (alloc) {
+            uint32_t order = rng_below(&seed, rng_below(&seed, BUDDY_ORDERS) + 1);
+            uint32_t free_before = pool.free_frames;
+            if (!take(order)) {
+                failed++;
+                // Only a real shortage of a large enough block may fail.
+                CHECK((pool.nonempty >> order) == 0);
+                CHECK(pool.free_frames == free_before);
+            }
+        } else {
+            give_back(rng_below(&seed, n_live));
+        }
+        if ((step & 1023) == 0) check_counts();
+    }
+    CHECK(failed > 0);                      // the pool did run dry at times
+    check_counts();
+    while (n_live) give_back(rng_below(&seed, n_live));
+    check_counts();
+    check_coalesced();
+}
+
+int main(void) {
+    test_init();
+    test_orders();
+    test_bad_frees();
+    test_random();
+    printf("test_buddy: ok\n");
+    return 0;
+}
@@ -0,0 +1,77 @@
+// test_mlfq.c - hosted unit test for the MLFQ run queue (mlfq.c)
+// Run: make hosted-test
+
+#include "hosted_test.h"
+#include "mlfq.h"
+
+static sched_runqueue_t rq;
+
+// Highest level first, FIFO within a level.
+static void test_pick_order(void) {
+    sched_entity_t a, b, c;
+    sched_rq_init(&rq);
+    sched_entity_init(&a, 0);
+    sched_entity_init(&b, -20);
+    sched_entity_init(&c, 0);
+    CHECK(b.level < a.level && a.level == SCHED_DEFAULT_LEVEL);
+
+    sched_enqueue(&rq, &a);
+    sched_enqueue(&rq, &c);
+    sched_enqueue(&rq, &b);
+    sched_enqueue(&rq, &b);             // already queued: ignored
+    CHECK(rq.nr_queued == 3);
+    CHECK(sched_pick_next(&rq) == &b);
+    CHECK(sched_pick_next(&rq) == &a);
+    CHECK(sched_pick_next(&rq) == &c);
+    CHECK(sched_pick_next(&rq) == NULL && rq.bitmap == 0);
+}
+
+// A CPU-bound entity sinks one level per SCHED_LEVEL_ALLOTMENT quanta and a
+// waiting higher-priority entity preempts it at once.
+static void test_demotion_and_preempt(void) {
+    sched_entity_t hog, other;
+    sched_rq_init(&rq);
+    sched_entity_init(&hog, 0);
+    sched_entity_init(&other, 0);
+
+    uint32_t q = sched_quantum(hog.level);
+    for (uint32_t t = 1; t < SCHED_LEVEL_ALLOTMENT * q; t++) sched_tick(&rq, &hog);
+    CHECK(hog.level == SCHED_DEFAULT_LEVEL);
+    sched_tick(&rq, &hog);
+    CHECK(hog.level == SCHED_DEFAULT_LEVEL + 1 && rq.demotions == 1);
+
+    hog.slice_left = sched_quantum(hog.level);
+    sched_enqueue(&rq, &other);
+    CHECK(sched_tick(&rq, &hog));        // other waits one level higher
+}
+
+// Boosts return demoted entities to base; one that waited through a whole
+// period behind lower-nice work is lifted to the top occupied level.
+static void test_boost_and_starvation(void) {
+    sched_entity_t busy, low;
+    sched_rq_init(&rq);
+    sched_entity_init(&busy, 0);
+    sched_entity_init(&low, 19);
+    CHECK(low.base_level > busy.base_level);
+
+    sched_enqueue(&rq, &low);
+    // busy runs for two full periods; low never gets picked
+    for (uint32_t t = 0; t < 2 * SCHED_BOOST_TICKS; t++) sched_tick(&rq, &busy);
+    CHECK(rq.boosts == 2 && busy.level == busy.base_level);
+    CHECK(low.level == busy.base_level && rq.starved == 1);
+
+    // Once it has run it is no longer considered starved
+    CHECK(sched_pick_next(&rq) == &low);
+    sched_tick(&rq, &low);
+    sched_enqueue(&rq, &low);
+    for (uint32_t t = 0; t < SCHED_BOOST_TICKS; t++) sched_tick(&rq, &busy);
+    CHECK(low.level == low.base_level && rq.starved == 1);
+}
+
+int main(void) {
+    test_pick_order();
+    test_demotion_and_preempt();
+    test_boost_and_starvation();
+    printf("test_mlfq: ok\n");
+    return 0;
+}
@@ -0,0 +1,140 @@
+// test_slab.c - hosted unit test for the size-class slab allocator (slab.c)
+// Run: make hosted-test
+
+#include <stdbool.h>
+#include <string.h>
+#include "hosted_test.h"
+#include "slab.h"
+
+#define ARENA_SIZE (4u * 1024 * 1024)
+#define CHURN_SLOTS 4096
+#define CHURN_OPS 400000
+
+static uint8_t *arena;
+
+static void reset(size_t size) {
+    memset(arena, 0xCC, ARENA_SIZE + SLAB_PAGE_SIZE);
+    slab_init(arena, size);
+}
+
+// Every class hands out distinct, class-aligned objects that do not overlap.
+static void test_classes(void) {
+    reset(ARENA_SIZE);
+    for (uint32_t cls = 0; cls < SLAB_CLASSES; cls++) {
+        size_t size = (size_t)SLAB_MIN_SIZE << cls;
+        uint8_t *a = slab_alloc(size, 1);
+        uint8_t *b = slab_alloc(size - 1, 1);
+        CHECK(a && b && a != b);
+        CHECK(((uintptr_t)a & (size - 1)) == 0);
+        CHECK(slab_usable_size(a) == size && slab_usable_size(b) == size);
+        CHECK(slab_owns(a) && slab_owns(b));
+        memset(a, 0xAA, size);
+        memset(b, 0xBB, size);
+        CHECK(a[size - 1] == 0xAA && b[0] == 0xBB);
+
+        slab_class_stats_t st;
+        slab_get_stats(cls, &st);
+        CHECK(st.object_size == size && st.objects_in_use == 2 && st.allocs == 2);
+
+        CHECK(slab_free(a) && slab_free(b));
+        slab_get_stats(cls, &st);
+        CHECK(st.objects_in_use == 0 && st.frees == 2);
+    }
+    // Sizes below the smallest class round up to it
+    CHECK(slab_usable_size(slab_alloc(1, 1)) == SLAB_MIN_SIZE);
+}
+
+static void test_limits(void) {
+    reset(ARENA_SIZE);
+    CHECK(slab_alloc(0, 16) == NULL);
+    CHECK(slab_alloc(SLAB_MAX_SIZE + 1, 16) == NULL);
+    CHECK(slab_alloc(16, SLAB_MAX_SIZE * 2) == NULL);
+
+    // The alignment picks the class when it exceeds the size
+    void *p = slab_alloc(24, 256);
+    CHECK(p && ((uintptr_t)p & 255) == 0 && slab_usable_size(p) == 256);
+
+    // Foreign pointers, and a double free on an emptied page, are refused
+    int local = 0;
+    CHECK(!slab_free(&local) && !slab_owns(&local) && slab_usable_size(&local) == 0);
+    CHECK(slab_free(p));
+    void *q = slab_alloc(16, 16);
+    void *r = slab_alloc(16, 16);
+    CHECK(slab_free(q) && slab_free(r));
+    CHECK(!slab_free(r));
+}
+
+// A tiny arena runs out, returns NULL, and recovers once objects are freed.
+static void test_exhaustion(void) {
+    reset(4 * SLAB_PAGE_SIZE);
+    void *objs[64];
+    uint32_t n = 0;
+    while (n < 64 && (objs[n] = slab_alloc(SLAB_MAX_SIZE, 16)) != NULL) n++;
+    CHECK(n > 0 && n < 64);
+    CHECK(slab_free_pages() == 0);
+    CHECK(slab_alloc(SLAB_MAX_SIZE, 16) == NULL);
+
+    // Pages emptied by one class go back to the pool for another
+    for (uint32_t i = 0; i < n; i++) CHECK(slab_free(objs[i]));
+    CHECK(slab_free_pages() > 0);
+    CHECK(slab_alloc(64, 16) != NULL);
+    CHECK(slab_alloc(SLAB_MAX_SIZE, 16) != NULL);
+}
+
+// Random alloc/free across all classes; each live object carries a pattern
+// derived from its slot, so any overlap or reuse of a live object shows up.
+static void test_churn(void) {
+    reset(ARENA_SIZE);
+    static uint8_t *live[CHURN_SLOTS];
+    static uint32_t sizes[CHURN_SLOTS];
+    memset(live, 0, sizeof(live));
+    uint64_t seed = 0x51AB;
+    uint32_t in_use = 0;
+
+    for (uint32_t op = 0; op < CHURN_OPS; op++) {
+        uint32_t i = rng_below(&seed, CHURN_SLOTS);
+        if (live[i]) {
+            for (uint32_t k = 0; k < sizes[i]; k++) CHECK(live[i][k] == (uint8_t)(i * 7 + k));
+            CHECK(slab_free(live[i]));
+            live[i] = NULL;
+            in_use--;
+        } else {
+            uint32_t size = 1 + rng_below(&seed, SLAB_MAX_SIZE / (1u << rng_below(&seed, 8)));
+            live[i] = slab_alloc(size, 1u << rng_below(&seed, 5));
+            CHECK(live[i] != NULL);
+            CHECK(slab_usable_size(live[i]) >= size);
+            sizes[i] = size;
+            for (uint32_t k = 0; k < size; k++) live[i][k] = (uint8_t)(i * 7 + k);
+            in_use++;
+        }
+    }
+
+    uint32_t counted = 0;
+    for (uint32_t cls = 0; cls < SLAB_CLASSES; cls++) {
+        slab_class_stats_t st;
+        slab_get_stats(cls, &st);
+        CHECK(st.allocs - st.frees == st.objects_in_use);
+        counted += st.objects_in_use;
+    }
+    CHECK(counted == in_use);
+
+    for (uint32_t i = 0; i < CHURN_SLOTS; i++)
+        if (live[i]) CHECK(slab_free(live[i]));
+    for (uint32_t cls = 0; cls < SLAB_CLASSES; cls++) {
+        slab_class_stats_t st;
+        slab_get_stats(cls, &st);
+        CHECK(st.objects_in_use == 0 && st.pages <= 1);
+    }
+}
+
+int main(void) {
+    arena = malloc(ARENA_SIZE + SLAB_PAGE_SIZE);
+    CHECK(arena != NULL);
+    test_classes();
+    test_limits();
+    test_exhaustion();
+    test_churn();
+    free(arena);
+    printf("test_slab: ok\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+// test_timer_wheel.c - hosted unit test for the sleep timing wheel
+// Run: make hosted-test
+//
+// The wheel takes time from its caller, so the test drives it with a
+// simulated microsecond clock and checks it against a brute-force list of
+// deadlines: nothing fires early, nothing due is left behind, and
+// next_event() never points past the earliest deadline.
+
+#include <stdbool.h>
+#include <string.h>
+#include "hosted_test.h"
+#include "timer_wheel.h"
+
+#define N_TIMERS 512
+#define STEPS 200000
+
+static timer_wheel_t wheel;
+static timer_entry_t timers[N_TIMERS];
+static uint64_t fired_at[N_TIMERS];
+static uint32_t fire_count[N_TIMERS];
+static uint64_t sim_now;
+
+static uint32_t index_of(timer_entry_t *e) { return (uint32_t)(e - timers); }
+
+static void on_fire(timer_entry_t *e, void *ctx) {
+    (void)ctx;
+    uint32_t i = index_of(e);
+    CHECK(e->expires <= sim_now);           // never early
+    CHECK(!e->pending);
+    fired_at[i] = sim_now;
+    fire_count[i]++;
+}
+
+static uint64_t earliest_pending(void) {
+    uint64_t best = TW_NEVER;
+    for (uint32_t i = 0; i < N_TIMERS; i++)
+        if (timers[i].pending && timers[i].expires < best) best = timers[i].expires;
+    return best;
+}
+
+// Entries armed with a deadline already in the past fire on the next
+// advance, so "nothing due is left" only holds right after one.
+static void check_invariants(bool advanced) {
+    uint32_t pending = 0;
+    for (uint32_t i = 0; i < N_TIMERS; i++) {
+        if (!timers[i].pending) continue;
+        pending++;
+        if (advanced) CHECK(timers[i].expires > sim_now);
+    }
+    CHECK(pending == wheel.pending);
+
+    uint64_t next = timer_wheel_next_event(&wheel);
+    uint64_t first = earliest_pending();
+    CHECK(next <= first);                   // never wakes up late
+}
+
+static void test_basic(void) {
+    memset(timers, 0, sizeof(timers));
+    sim_now = 5000;
+    timer_wheel_init(&wheel, sim_now);
+    CHECK(timer_wheel_next_event(&wheel) == TW_NEVER);
+
+    timer_wheel_add(&wheel, &timers[0], 5000 + 1500);      // same level, sub-tick
+    timer_wheel_add(&wheel, &timers[1], 5000 + 70000);     // level 1
+    timer_wheel_add(&wheel, &timers[2], 5000 + 10000000);  // 10 s, level 2
+    timer_wheel_add(&wheel, &timers[3], 5000 + 1200);
+    timer_wheel_cancel(&wheel, &timers[3]);
+    CHECK(wheel.pending == 3);
+    CHECK(timer_wheel_next_event(&wheel) == 6500);
+
+    sim_now = 6499;
+    CHECK(timer_wheel_advance(&wheel, sim_now, on_fire, NULL) == 0);
+    sim_now = 6500;
+    CHECK(timer_wheel_advance(&wheel, sim_now, on_fire, NULL) == 1);
+    CHECK(fired_at[0] == 6500 && fire_count[3] == 0);
+
+    // Re-arming a pending entry moves it
+    timer_wheel_add(&wheel, &timers[1], 9000);
+    CHECK(wheel.pending == 2 && timer_wheel_next_event(&wheel) == 9000);
+
+    // A tickless loop that always sleeps until next_event() reaches the 10 s
+    // deadline in a handful of wakeups, not one per millisecond.
+    uint32_t wakeups = 0;
+    while (wheel.pending) {
+        sim_now = timer_wheel_next_event(&wheel);
+        timer_wheel_advance(&wheel, sim_now, on_fire, NULL);
+        wakeups++;
+        CHECK(wakeups < 300);
+    }
+    CHECK(fired_at[1] == 9000 && fired_at[2] == 5000 + 10000000);
+    printf("  10 s sleep: %u wakeups\n", wakeups);
+}
+
+// A callback may re-arm its own entry for a later deadline.
+static void rearm(timer_entry_t *e, void *ctx) {
+    uint32_t *left = ctx;
+    fire_count[index_of(e)]++;
+    if (--*left) timer_wheel_add(&wheel, e, sim_now + 2500);
+}
+
+static void test_periodic(void) {
+    memset(timers, 0, sizeof(timers));
+    memset(fire_count, 0, sizeof(fire_count));
+    sim_now = 0;
+    timer_wheel_init(&wheel, 0);
+    uint32_t left = 100;
+    timer_wheel_add(&wheel, &timers[7], 2500);
+    while (wheel.pending) {
+        sim_now += 1000;
+        timer_wheel_advance(&wheel, sim_now, rearm, &left);
+    }
+    CHECK(fire_count[7] == 100 && left == 0);
+}
+
+// Random add/re-arm/cancel and clock jumps from 1 us to minutes.
+static void test_random(void) {
+    uint64_t seed = 0x71CE;
+    memset(timers, 0, sizeof(timers));
+    memset(fire_count, 0, sizeof(fire_count));
+    sim_now = 123456789;
+    timer_wheel_init(&wheel, sim_now);
+
+    uint32_t total_fired = 0, armed = 0, cancelled = 0;
+    for (uint32_t step = 0; step < STEPS; step++) {
+        uint32_t i = rng_below(&seed, N_TIMERS);
+        uint32_t op = rng_below(&seed, 10);
+        bool advanced = false;
+        if (op < 6) {
+            // Deadlines from "already due" to ~1 hour, log-uniform
+            uint64_t delay = rng_next(&seed) % (1ull << rng_below(&seed, 32));
+            if (!timers[i].pending) armed++;
+            timer_wheel_add(&wheel, &timers[i], sim_now + delay - (op == 0 ? delay / 2 : 0));
+        } else if (op < 7) {
+            if (timers[i].pending) cancelled++;
+            timer_wheel_cancel(&wheel, &timers[i]);
+        } else {
+            uint64_t jump = rng_next(&seed) % (1ull << rng_below(&seed, 28));
+            // Sometimes land exactly on the wheel's own wakeup time
+            uint64_t next = timer_wheel_next_event(&wheel);
+            if (op == 9 && next != TW_NEVER && next > sim_now) sim_now = next;
+            else sim_now += jump;
+            total_fired += timer_wheel_advance(&wheel, sim_now, on_fire, NULL);
+            advanced = true;
+        }
+        check_invariants(advanced);
+    }
+    CHECK(total_fired + cancelled + wheel.pending == armed);
+}
+
+int main(void) {
+    test_basic();
+    test_periodic();
+    test_random();
+    printf("test_timer_wheel: ok\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+// timer_wheel.c - MiniOS hierarchical timing wheel for sleep deadlines
+// Kernel:  gcc -m32 -c timer_wheel.c -o timer_wheel.o -ffreestanding -fno-pie -O2 -Wall -Wextra
+// Hosted:  cc -c timer_wheel.c -o timer_wheel.o -O2 -Wall -Wextra
+//
+// Level k holds entries due 64^k..64^(k+1) ticks ahead, bucketed by the
+// k-th group of 6 bits of their tick. When the level-0 index wraps, the
+// matching level-1 slot is cascaded down, and so on. Per-level occupancy
+// bitmaps let advance() jump straight over empty slots, so an idle system
+// that sleeps for seconds costs one visit per 64 ticks, not one per tick.
+
+#include "timer_wheel.h"
+
+#define TW_MASK (TW_SLOTS - 1)
+#define TW_HORIZON (1ull << (TW_SLOT_BITS * TW_LEVELS))
+
+static inline uint64_t ror64(uint64_t x, uint32_t r) {
+    r &= 63;
+    return r ? (x >> r) | (x << (64 - r)) : x;
+}
+
+static void slot_link(timer_wheel_t *w, timer_entry_t *e, uint32_t level, uint32_t slot) {
+    timer_entry_t *head = w->slots[level][slot];
+    e->prev = NULL;
+    e->next = head;
+    if (head) head->prev = e;
+    w->slots[level][slot] = e;
+    w->occupied[level] |= 1ull << slot;
+    e->level = (uint8_t)level;
+    e->slot = (uint8_t)slot;
+}
+
+static void slot_unlink(timer_wheel_t *w, timer_entry_t *e) {
+    if (e->prev) e->prev->next = e->next;
+    else w->slots[e->level][e->slot] = e->next;
+    if (e->next) e->next->prev = e->prev;
+    if (!w->slots[e->level][e->slot]) w->occupied[e->level] &= ~(1ull << e->slot);
+    e->next = NULL;
+    e->prev = NULL;
+}
+
+static void place(timer_wheel_t *w, timer_entry_t *e) {
+    uint64_t t = e->expires / TW_RES_US;
+    if (t < w->tick) t = w->tick;
+
+    uint64_t delta = t - w->tick;
+    if (delta >= TW_HORIZON) {
+        t = w->tick + TW_HORIZON - 1;
+        delta = TW_HORIZON - 1;
+    }
+
+    uint32_t level = 0;
+    while (level < TW_LEVELS - 1 && delta >= (1ull << (TW_SLOT_BITS * (level + 1))))
+        level++;
+
+    slot_link(w, e, level, (uint32_t)(t >> (TW_SLOT_BITS * level)) & TW_MASK);
+}
+
+// Called when the wheel lands on a multiple of 64 ticks.
+static void cascade(timer_wheel_t *w) {
+    for (uint32_t level = 1; level < TW_LEVELS; level++) {
+        uint32_t slot = (uint32_t)(w->tick >> (TW_SLOT_BITS * level)) & TW_MASK;
+
+        timer_entry_t *e = w->slots[level][slot];
+        w->slots[level][slot] = NULL;
+        w->occupied[level] &= ~(1ull << slot);
+        while (e) {
+            timer_entry_t *next = e->next;
+            place(w, e);
+            e = next;
+        }
+
+        if (slot != 0) break;
+    }
+}
+
+// ========== Public API ==========
+void timer_wheel_init(timer_wheel_t *w, uint64_t now_us) {
+    for (uint32_t l = 0; l < TW_LEVELS; l++) {
+        for (uint32_t s = 0; s < TW_SLOTS; s++) w->slots[l][s] = NULL;
+        w->occupied[l] = 0;
+    }
+    w->tick = now_us / TW_RES_US;
+    w->pending = 0;
+}
+
+void timer_wheel_add(timer_wheel_t *w, timer_entry_t *e, uint64_t expires_us) {
+    if (e->pending) slot_unlink(w, e);
+    else w->pending++;
+    e->pending = true;
+    e->expires = expires_us;
+    place(w, e);
+}
+
+void timer_wheel_cancel(timer_wheel_t *w, timer_entry_t *e) {
+    if (!e->pending) return;
+    slot_unlink(w, e);
+    e->pending = false;
+    w->pending--;
+}
+
+uint32_t timer_wheel_advance(timer_wheel_t *w, uint64_t now_us, timer_wheel_fn fn, void *ctx) {
+    uint64_t target = now_us / TW_RES_US;
+    uint32_t fired = 0;
+
+    if (target < w->tick) target = w->tick;
+
+    for (;;) {
+        uint32_t idx = (uint32_t)w->tick & TW_MASK;
+
+        // Detach the slot first so callbacks can safely re-arm entries.
+        timer_entry_t *e = w->slots[0][idx];
+        w->slots[0][idx] = NULL;
+        w->occupied[0] &= ~(1ull << idx);
+        while (e) {
+            timer_entry_t *next = e->next;
+            if (e->expires <= now_us) {
+                e->next = NULL;
+                e->prev = NULL;
+                e->pending = false;
+                w->pending--;
+                fired++;
+                if (fn) fn(e, ctx);
+            } else {
+                slot_link(w, e, 0, idx);     // same tick, later microsecond
+            }
+            e = next;
+        }
+
+        if (w->tick == target) break;
+
+        // Next occupied level-0 slot in this 64-tick block, else the boundary.
+        uint64_t boundary = (w->tick | TW_MASK) + 1;
+        uint64_t later = (idx < TW_MASK) ? w->occupied[0] & (~0ull << (idx + 1)) : 0;
+        uint64_t next_tick = later ? (w->tick & ~(uint64_t)TW_MASK) + __builtin_ctzll(later)
+                                   : boundary;
+        w->tick = next_tick < target ? next_tick : target;
+
+        if ((w->tick & TW_MASK) == 0) cascade(w);
+    }
+    return fired;
+}
+
+uint64_t timer_wheel_next_event(const timer_wheel_t *w) {
+    if (!w->pending) return TW_NEVER;
+
+    uint64_t best = TW_NEVER;
+    if (w->occupied[0]) {
+        uint32_t idx = (uint32_t)w->tick & TW_MASK;
+        uint32_t dist = __builtin_ctzll(ror64(w->occupied[0], idx));
+        for (const timer_entry_t *e = w->slots[0][(idx + dist) & TW_MASK]; e; e = e->next)
+            if (e->expires < best) best = e->expires;
+    }
+
+    // Coarser levels are only known to the granularity of their slot, so
+    // report the boundary at which the earliest of them cascades.
+    for (uint32_t level = 1; level < TW_LEVELS; level++) {
+        if (!w->occupied[level]) continue;
+        uint32_t shift = TW_SLOT_BITS * level;
+        uint32_t idx = (uint32_t)(w->tick >> shift) & TW_MASK;
+        uint32_t dist = 1 + __builtin_ctzll(ror64(w->occupied[level], idx + 1));
+        uint64_t t = (((w->tick >> shift) + dist) << shift) * TW_RES_US;
+        if (t < best) best = t;
+    }
+    return best;
+}
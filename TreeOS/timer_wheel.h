@@ -0,0 +1,62 @@
+// timer_wheel.h - MiniOS hierarchical timing wheel for sleep deadlines
+// Freestanding like slab.h; part of the hosted library (see `make hosted`).
+// Time is an opaque microsecond counter supplied by the caller, so the wheel
+// runs equally well against the PIT or a simulated clock.
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== Configuration ==========
+#define TW_RES_US 1000u                 // one wheel tick
+#define TW_SLOT_BITS 6
+#define TW_SLOTS (1u << TW_SLOT_BITS)
+#define TW_LEVELS 5                     // 2^30 ticks ahead (~12 days)
+#define TW_NEVER UINT64_MAX
+
+typedef struct timer_entry {
+    struct timer_entry *next;
+    struct timer_entry *prev;
+    uint64_t expires;           // absolute deadline in microseconds
+    uint8_t level;
+    uint8_t slot;
+    bool pending;
+} timer_entry_t;
+
+typedef struct {
+    timer_entry_t *slots[TW_LEVELS][TW_SLOTS];
+    uint64_t occupied[TW_LEVELS];       // bit s set = slots[level][s] non-empty
+    uint64_t tick;                      // current wheel tick (TW_RES_US units)
+    uint32_t pending;
+} timer_wheel_t;
+
+typedef void (*timer_wheel_fn)(timer_entry_t *entry, void *ctx);
+
+// ========== API ==========
+void timer_wheel_init(timer_wheel_t *w, uint64_t now_us);
+
+// Arm `e` for absolute time `expires_us`; re-arms if already pending.
+void timer_wheel_add(timer_wheel_t *w, timer_entry_t *e, uint64_t expires_us);
+void timer_wheel_cancel(timer_wheel_t *w, timer_entry_t *e);
+
+// Fire every entry whose deadline is <= now_us, in wheel order. The callback
+// may re-arm the entry it is given for a later deadline. Returns the number
+// of entries fired.
+uint32_t timer_wheel_advance(timer_wheel_t *w, uint64_t now_us, timer_wheel_fn fn, void *ctx);
+
+// Earliest time the wheel needs attention: the nearest deadline if one sits
+// in the finest level, otherwise the next cascade boundary. TW_NEVER if empty.
+uint64_t timer_wheel_next_event(const timer_wheel_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMER_WHEEL_H